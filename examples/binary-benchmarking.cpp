@@ -0,0 +1,120 @@
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include "sys-sage.hpp"
+
+using namespace sys_sage;
+using namespace std::chrono;
+
+using std::cout;
+using std::endl;
+
+////////////////////////////////////////////////////////////////////////
+// PARAMS TO SET
+#define NUM_NUMA 32
+#define CORES_PER_NUMA 10417
+#define THREADS_PER_CORE 2 // 32 * 10417 * (1 + 2) = ~1M components
+#define REPEATS 3
+
+//builds a synthetic Topology -> Node -> NUMA -> Core -> Thread tree with a DataPath from every core to its NUMA region
+Topology* build_synthetic_topology()
+{
+    Topology* topo = new Topology();
+    Node* n = new Node(topo, 0);
+    for(int numa_id = 0; numa_id < NUM_NUMA; numa_id++)
+    {
+        Numa* numa = new Numa(n, numa_id, 1LL << 34);
+        for(int i = 0; i < CORES_PER_NUMA; i++)
+        {
+            int core_id = numa_id * CORES_PER_NUMA + i;
+            Core* core = new Core(numa, core_id);
+            for(int t = 0; t < THREADS_PER_CORE; t++)
+                new Thread(core, core_id * THREADS_PER_CORE + t);
+            new DataPath(core, numa, DataPathOrientation::Oriented, DataPathType::Physical, 1000.0, 100.0 + numa_id);
+        }
+    }
+    return topo;
+}
+
+template <class Export, class Import>
+void time_format(const char* format, Topology* topo, const std::string& path, Export exp, Import imp)
+{
+    uint64_t best_save = UINT64_MAX, best_load = UINT64_MAX;
+    for(int r = 0; r < REPEATS; r++)
+    {
+        high_resolution_clock::time_point t_start = high_resolution_clock::now();
+        if(exp(topo, path) != 0)
+        {
+            cout << format << ": export failed" << endl;
+            return;
+        }
+        uint64_t t_save = duration_cast<microseconds>(high_resolution_clock::now() - t_start).count();
+
+        t_start = high_resolution_clock::now();
+        Component* loaded = imp(path);
+        uint64_t t_load = duration_cast<microseconds>(high_resolution_clock::now() - t_start).count();
+        if(loaded == NULL)
+        {
+            cout << format << ": import failed" << endl;
+            return;
+        }
+        loaded->Delete(true);
+
+        if(t_save < best_save)
+            best_save = t_save;
+        if(t_load < best_load)
+            best_load = t_load;
+    }
+    FILE* f = fopen(path.c_str(), "rb");
+    long size = 0;
+    if(f != NULL)
+    {
+        fseek(f, 0, SEEK_END);
+        size = ftell(f);
+        fclose(f);
+    }
+    std::remove(path.c_str());
+    cout << "  " << format << ": save " << best_save << " us, load " << best_load << " us, file size " << size << " bytes" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string prefix = "synthetic_topology";
+    if(argc > 1)
+        prefix = argv[1];
+
+    Topology* topo = build_synthetic_topology();
+    size_t numComponents = 0;
+    for(Component* c : topo->PreOrder())
+    {
+        (void)c;
+        numComponents++;
+    }
+    cout << "save/load of a synthetic topology, " << numComponents << " components, " << NUM_NUMA * CORES_PER_NUMA << " data paths" << endl;
+
+    time_format("xml   ", topo, prefix + ".xml",
+                [](Component* root, const std::string& p) { return exportToXml(root, p); },
+                [](const std::string& p) { return importFromXml(p); });
+    time_format("binary", topo, prefix + ".bin",
+                [](Component* root, const std::string& p) { return exportToBinary(root, p); },
+                [](const std::string& p) { return importFromBinary(p); });
+
+    //the read-only view does not create any components
+    exportToBinary(topo, prefix + ".bin");
+    high_resolution_clock::time_point t_start = high_resolution_clock::now();
+    BinaryTopologyView v;
+    uint64_t numThreads = 0;
+    if(v.Open(prefix + ".bin") == 0)
+        for(uint32_t i = 0; i < v.GetNumComponents(); i++)
+            if(v.GetComponent(i).componentType == ComponentType::Thread)
+                numThreads++;
+    uint64_t t_view = duration_cast<microseconds>(high_resolution_clock::now() - t_start).count();
+    cout << "  binary view: open + scan " << t_view << " us (" << numThreads << " threads)" << endl;
+    v.Close();
+    std::remove((prefix + ".bin").c_str());
+
+    topo->Delete(true);
+    return 0;
+}
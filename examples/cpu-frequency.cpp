@@ -58,7 +58,7 @@ int main(int argc, char *argv[])
     }
 
     cout << "-- Refresh frequency on all cores of Node 1(and store the timestamp). " << endl;
-    //Frequency gets stored in attrib freq_history (value of type std::vector<std::tuple<long long=timestamp,double=frequency in MHz>>)
+    //Frequency gets stored in attribute freq_history (value of type FrequencyHistory = std::vector<std::tuple<long long=timestamp,double=frequency in MHz>>)
     int repeat = 10;
     for(int i = 0; i<repeat; i++)
     {
@@ -67,7 +67,7 @@ int main(int argc, char *argv[])
     }
 
     cout << "-- Print out frequency history on core 1 of Node 1. " << endl;
-    std::vector<std::tuple<long long,double>>* fh = (std::vector<std::tuple<long long,double>>*)c1->attrib["freq_history"];
+    FrequencyHistory* fh = c1->GetAttribute<FrequencyHistory>(AttributeKey::freq_history);
     for(auto [ ts,freq ] : *fh)
     {
         cout << "    ts: " << ts << " frequency[MHz]: " << freq << endl;
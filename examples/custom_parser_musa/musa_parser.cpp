@@ -1,9 +1,7 @@
 #include <iostream>
-#include <fstream>
 #include <string>
 #include <vector>
 #include <map>
-#include <sstream>
 #include <algorithm>
 
 #include "musa_parser.hpp"
@@ -40,32 +38,34 @@ std::ostream& operator<<(std::ostream& output, std::map<std::string, double>& ma
 }
 
 int MusaParser::ReadData(std::vector<std::string> search) {
-	std::ifstream myfile(datapath);
-	if (!myfile.good()) {
+	//"key = value" rows; sections start with a "[name]" row and end with an empty row
+	TableReader reader("=", true, 0);
+	reader.skipEmptyRows = false;
+	if (reader.Open(datapath) != 0) {
 		std::cout << " Couldn't open data source path " << datapath << std::endl;
 		return 1;
 	}
-	std::string line, subline, word;
-	int offset;
-	std::string value;
-	for (const auto & element : search) {
-		myfile.clear();
-		myfile.seekg(0, myfile.beg);
-		while (!myfile.eof()) {
-			std::getline(myfile, line);
-			if ((offset = line.find(element, 0) != std::string::npos)) {
-				std::map<std::string, std::string> input;
-				do {
-					std::getline(myfile, subline);
-					subline.erase(remove(subline.begin(), subline.end(), '='), subline.end());
-					std::istringstream ss(subline);
-					ss >> word >> value;
-					input.insert({ word,value });
-				} while (!subline.empty());
-
-				mapping.insert({ element, input });
+	std::vector<std::string_view> row;
+	std::map<std::string, std::string>* section = nullptr;
+	while (reader.NextRow(&row)) {
+		std::string_view key = row[0];
+		if (row.size() == 1 && key.size() > 1 && key.front() == '[' && key.back() == ']') {
+			key = key.substr(1, key.size() - 2);
+			section = nullptr;
+			if (std::find(search.begin(), search.end(), key) != search.end()) {
+				auto [it, inserted] = mapping.try_emplace(std::string(key));
+				if (inserted) //the first section of a name is used
+					section = &it->second;
 			}
 		}
+		else if (row.size() == 1 && key.empty()) {
+			section = nullptr;
+		}
+		else if (section != nullptr && row.size() > 1) {
+			//value is the first word; the rest is a comment, e.g. "bandwidth = 153600000000 # [bytes/s]"
+			std::string_view value = row[1].substr(0, row[1].find_first_of(" \t"));
+			section->try_emplace(std::string(key), value);
+		}
 	}
 
 	return 0;
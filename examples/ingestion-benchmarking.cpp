@@ -0,0 +1,131 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "sys-sage.hpp"
+
+using namespace sys_sage;
+using namespace std::chrono;
+
+using std::cout;
+using std::endl;
+
+////////////////////////////////////////////////////////////////////////
+// PARAMS TO SET
+#define NUM_NUMA 16
+#define THREADS_PER_NUMA 625 // 16 * 625 = 10k threads
+#define REPEATS 1
+#define REBUILD_REPEATS 20
+
+//builds a synthetic Topology -> Node -> NUMA -> Core -> Thread tree with NUM_NUMA*THREADS_PER_NUMA threads
+Topology* build_synthetic_topology()
+{
+    Topology* topo = new Topology();
+    Node* n = new Node(topo, 0);
+    for(int numa_id = 0; numa_id < NUM_NUMA; numa_id++)
+    {
+        Numa* numa = new Numa(n, numa_id);
+        for(int i = 0; i < THREADS_PER_NUMA; i++)
+        {
+            int thread_id = numa_id * THREADS_PER_NUMA + i;
+            Core* core = new Core(numa, thread_id);
+            new Thread(core, thread_id);
+        }
+    }
+    return topo;
+}
+
+//writes a caps-numa-benchmark-like file: each thread to its own NUMA region and to NUMA region 0
+void write_synthetic_benchmark(const std::string& path)
+{
+    std::ofstream f(path);
+    f << "src_cpu;target_numa;ldlat(ns);bw(MB/s)\n";
+    for(int numa_id = 0; numa_id < NUM_NUMA; numa_id++)
+    {
+        for(int i = 0; i < THREADS_PER_NUMA; i++)
+        {
+            int thread_id = numa_id * THREADS_PER_NUMA + i;
+            f << thread_id << ";" << numa_id << ";" << 100 + numa_id << ";" << 10000 - numa_id << "\n";
+            f << thread_id << ";" << 0 << ";" << 200 << ";" << 5000 << "\n";
+        }
+    }
+}
+
+//builds and tears down the synthetic topology (with data paths) REBUILD_REPEATS times, optionally in a Topology arena
+uint64_t time_rebuild(bool useArena, bool useHugePages)
+{
+    uint64_t best = UINT64_MAX;
+    for(int r = 0; r < REBUILD_REPEATS; r++)
+    {
+        high_resolution_clock::time_point t_start = high_resolution_clock::now();
+        Topology* topo = new Topology();
+        if(useArena)
+            topo->EnableArena(useHugePages);
+        {
+            ArenaScope scope(topo);
+            Node* n = new Node(topo, 0);
+            for(int numa_id = 0; numa_id < NUM_NUMA; numa_id++)
+            {
+                Numa* numa = new Numa(n, numa_id);
+                for(int i = 0; i < THREADS_PER_NUMA; i++)
+                {
+                    int thread_id = numa_id * THREADS_PER_NUMA + i;
+                    Core* core = new Core(numa, thread_id);
+                    Thread* t = new Thread(core, thread_id);
+                    new DataPath(t, numa, DataPathOrientation::Oriented, DataPathType::Physical, 1.0, 1.0);
+                }
+            }
+        }
+        topo->Delete(true);
+        uint64_t t = duration_cast<microseconds>(high_resolution_clock::now() - t_start).count();
+        if(t < best)
+            best = t;
+    }
+    return best;
+}
+
+uint64_t time_ingestion(const std::string& path, bool useIndex)
+{
+    uint64_t best = UINT64_MAX;
+    for(int r = 0; r < REPEATS; r++)
+    {
+        Topology* topo = build_synthetic_topology();
+        if(useIndex)
+            topo->EnableComponentIndex();
+        Component* n = topo->GetChild(0);
+
+        high_resolution_clock::time_point t_start = high_resolution_clock::now();
+        parseCapsNumaBenchmark(n, path, ";");
+        uint64_t t = duration_cast<microseconds>(high_resolution_clock::now() - t_start).count();
+        if(t < best)
+            best = t;
+
+        topo->Delete(true);
+    }
+    return best;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string path = "synthetic_caps_numa_benchmark.csv";
+    if(argc > 1)
+        path = argv[1];
+    write_synthetic_benchmark(path);
+
+    uint64_t t_dfs = time_ingestion(path, false);
+    uint64_t t_index = time_ingestion(path, true);
+
+    cout << "caps-numa-benchmark ingestion, " << NUM_NUMA * THREADS_PER_NUMA << " threads, " << 2 * NUM_NUMA * THREADS_PER_NUMA << " data paths" << endl;
+    cout << "  without component index: " << t_dfs << " us" << endl;
+    cout << "  with component index:    " << t_index << " us" << endl;
+
+    cout << "topology build + teardown (with " << NUM_NUMA * THREADS_PER_NUMA << " data paths)" << endl;
+    cout << "  heap:                     " << time_rebuild(false, false) << " us" << endl;
+    cout << "  arena:                    " << time_rebuild(true, false) << " us" << endl;
+    cout << "  arena (huge pages):       " << time_rebuild(true, true) << " us" << endl;
+
+    std::remove(path.c_str());
+    return 0;
+}
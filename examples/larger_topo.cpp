@@ -12,12 +12,9 @@ using std::endl;
 
 int main(int argc, char *argv[])
 {
-    //create root Topology and one node
+    //create root Topology
     Topology* topo = new Topology();
     int tot_nodes=8;
-    Node* n = new Node(1);
-    n->SetParent((Component*)topo);
-    topo->InsertChild((Component*)n);
 
     cout << "create topology..." << endl;
     std::string path_prefix(argv[0]);
@@ -25,22 +22,27 @@ int main(int argc, char *argv[])
     path_prefix=path_prefix.substr(0,found) + "/";
     std::string xmlPath = "example_data/skylake_hwloc.xml";
     std::string bwPath = "example_data/skylake_caps_numa_benchmark.csv";
+    //all data sources of all nodes; the nodes are parsed concurrently
+    std::vector<DataSource> manifest;
     for(int n_idx=0; n_idx<tot_nodes; n_idx++)
     {
-        Node* n = new Node(n_idx);
-        n->SetParent((Component*)topo);
-        topo->InsertChild((Component*)n);
-        if(parseHwlocOutput(n, path_prefix+xmlPath) != 0)
-        {
-            cout << "error parsing hwloc in path " << path_prefix+xmlPath << endl;
-            return 1;
-        }
-        if(parseCapsNumaBenchmark((Component*)n, path_prefix+bwPath, ";") != 0)
-        {
-            cout << "failed parsing caps-numa-benchmark in path " << path_prefix+bwPath << endl;
-            return 1;
-        }
+        manifest.push_back({n_idx, DataSourceType::Hwloc, path_prefix+xmlPath});
+        manifest.push_back({n_idx, DataSourceType::CapsNumaBenchmark, path_prefix+bwPath});
     }
+    std::vector<DataSourceResult> results;
+    if(ingestDataSources(topo, manifest, 0, &results) != 0)
+    {
+        cout << "error parsing the data sources" << endl;
+        return 1;
+    }
+    double seconds = 0;
+    for(const DataSourceResult& r : results)
+        seconds += r.seconds;
+    cout << "parsed " << manifest.size() << " data sources in " << seconds << " s (summed over all threads)" << endl;
+
+    //the nodes are identical -> store their subtree once
+    int removed = topo->CollapseIdenticalSubtrees(ComponentType::ToMask(ComponentType::Node));
+    cout << "collapsed identical nodes, removed " << removed << " components" << endl;
 
     std::string output_name = "sys-sage_sample_output.xml";
     cout << "Exporting as XML to " << output_name << endl;
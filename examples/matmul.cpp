@@ -101,17 +101,18 @@ int main(int argc, char *argv[]) {
         //////////////////////////////////// whole L3 size
 #ifndef INTEL_PQOS
 
-        Component * c = (Component*)t;
-        while(c->GetParent() != NULL){
-            //go up until L3 found
-            c = c->GetParent();
-            if(c->GetComponentType() == sys_sage::ComponentType::Cache && ((Cache*)c)->GetCacheLevel() == 3)
+        //caches containing the current hw thread (the thread shares all its ancestors with itself)
+        Cache * l3 = NULL;
+        for(Component * c : t->GetSharedComponents(t, sys_sage::ComponentType::ToMask(sys_sage::ComponentType::Cache))){
+            if(((Cache*)c)->GetCacheLevel() == 3){
+                l3 = (Cache*)c;
                 break;
-        };
-        if(c==NULL || c->GetComponentType() != sys_sage::ComponentType::Cache){
+            }
+        }
+        if(l3==NULL){
             cerr << "L3 cache not found" << endl; return 1;
         }
-        long long available_L3_size = ((Cache*)c)->GetCacheSize();
+        long long available_L3_size = l3->GetCacheSize();
 
         //////////////////////////////////// check CAT settings
 #else
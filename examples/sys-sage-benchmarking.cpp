@@ -93,20 +93,6 @@ int main(int argc, char *argv[])
     Node *n = new Node(t, 1);
     std::vector<Component*> hwlocComponentList, mt4gComponentList, allComponentList;
 
-    // time exportToXML
-    uint64_t time_exportToXml = UINT64_MAX;
-
-    for (int i = 0; i < 1000; i++) {
-        t_start = high_resolution_clock::now();
-        exportToXml(t, "test.xml", search_simple, search_complex);
-        t_end = high_resolution_clock::now();
-        uint64_t time = t_end.time_since_epoch().count() -
-                        t_start.time_since_epoch().count() - timer_overhead;
-        if (time < time_exportToXml) {
-            time_exportToXml = time;
-        }   
-    }
-
     uint64_t time_createNewComponent = UINT64_MAX;
 
     for (int i = 0; i < 1000; i++) {
@@ -120,19 +106,6 @@ int main(int argc, char *argv[])
         time_createNewComponent = time;
         }
     }
-    //time importFromXml
-    uint64_t time_importFromXml = UINT64_MAX;
-    for (int i = 0; i < 1000; i++) {
-        t_start = high_resolution_clock::now();
-        Component *f = importFromXml("test.xml",NULL,NULL);
-        t_end = high_resolution_clock::now();
-        f->Delete(true);
-        uint64_t time = t_end.time_since_epoch().count() -
-                        t_start.time_since_epoch().count() - timer_overhead;
-        if (time < time_importFromXml) {
-        time_importFromXml = time;
-        }
-    }
     //time update an attribute
     
     uint64_t total_time_updateAttribute = 0;
@@ -297,6 +270,33 @@ int main(int argc, char *argv[])
             [[ maybe_unused ]] uint64_t time_GetAllComponentsList = t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
         }
     }
+    // time exportToXML (of the whole topology: hwloc, caps-numa-benchmark and mt4g)
+    uint64_t time_exportToXml = UINT64_MAX;
+
+    for (int i = 0; i < 100; i++) {
+        t_start = high_resolution_clock::now();
+        exportToXml(t, "test.xml", search_simple, search_complex);
+        t_end = high_resolution_clock::now();
+        uint64_t time = t_end.time_since_epoch().count() -
+                        t_start.time_since_epoch().count() - timer_overhead;
+        if (time < time_exportToXml) {
+            time_exportToXml = time;
+        }   
+    }
+
+    //time importFromXml
+    uint64_t time_importFromXml = UINT64_MAX;
+    for (int i = 0; i < 100; i++) {
+        t_start = high_resolution_clock::now();
+        Component *f = importFromXml("test.xml",NULL,NULL);
+        t_end = high_resolution_clock::now();
+        f->Delete(true);
+        uint64_t time = t_end.time_since_epoch().count() -
+                        t_start.time_since_epoch().count() - timer_overhead;
+        if (time < time_importFromXml) {
+        time_importFromXml = time;
+        }
+    }
     //get num mt4g DataPaths
     int mt4g_dataPaths = 0;
     std::vector<DataPath*> componentDataPaths;
@@ -0,0 +1,176 @@
+#include "Arena.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
+#include <sys/mman.h>
+
+#include "Topology.hpp"
+
+static constexpr size_t defaultChunkSize = 2 * 1024 * 1024; //one (x86-64) huge page
+static thread_local sys_sage::TopologyArena* currentArena = nullptr;
+
+//address ranges of the chunks of all arenas, so that _ArenaAwareFree can tell arena blocks from heap blocks without a header in front of every block
+//(end of chunk -> start of chunk, arena); never destroyed, as objects may be deleted during static destruction
+struct ChunkRegistry {
+    std::shared_mutex mutex;
+    std::map<uintptr_t, std::pair<uintptr_t, sys_sage::TopologyArena*>> chunks;
+};
+static ChunkRegistry& _GetChunkRegistry()
+{
+    static ChunkRegistry* registry = new ChunkRegistry();
+    return *registry;
+}
+//number of registered chunks; while it is 0, no lookup is needed
+static std::atomic<size_t> registeredChunks{0};
+
+static sys_sage::TopologyArena* _FindChunkOwner(const void* ptr)
+{
+    if(registeredChunks.load(std::memory_order_acquire) == 0)
+        return nullptr;
+    ChunkRegistry& registry = _GetChunkRegistry();
+    uintptr_t p = reinterpret_cast<uintptr_t>(ptr);
+    std::shared_lock lock(registry.mutex);
+    auto it = registry.chunks.upper_bound(p);
+    if(it == registry.chunks.end() || it->second.first > p)
+        return nullptr;
+    return it->second.second;
+}
+
+sys_sage::TopologyArena::TopologyArena(bool _useHugePages, size_t _chunkSize) : useHugePages(_useHugePages), chunkSize(_chunkSize == 0 ? defaultChunkSize : _chunkSize) {}
+
+sys_sage::TopologyArena::~TopologyArena()
+{
+    Release();
+}
+
+bool sys_sage::TopologyArena::_AddChunk(size_t minSize)
+{
+    size_t size = chunkSize;
+    while(size < minSize)
+        size *= 2;
+
+    void* ptr = nullptr;
+    bool mmapped = false;
+    if(useHugePages)
+    {
+        size = (size + defaultChunkSize - 1) / defaultChunkSize * defaultChunkSize;
+        ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if(ptr == MAP_FAILED)
+        {
+            //no reserved huge pages -> ask for transparent huge pages instead
+            ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if(ptr == MAP_FAILED)
+                return false;
+            madvise(ptr, size, MADV_HUGEPAGE);
+        }
+        mmapped = true;
+    }
+    else
+    {
+        ptr = std::malloc(size);
+        if(ptr == nullptr)
+            return false;
+    }
+
+    chunks.push_back({ptr, size, mmapped});
+    {
+        ChunkRegistry& registry = _GetChunkRegistry();
+        std::unique_lock lock(registry.mutex);
+        registry.chunks.emplace(reinterpret_cast<uintptr_t>(ptr) + size, std::make_pair(reinterpret_cast<uintptr_t>(ptr), this));
+        registeredChunks.fetch_add(1, std::memory_order_release);
+    }
+    cursor = static_cast<char*>(ptr);
+    end = cursor + size;
+    return true;
+}
+
+void* sys_sage::TopologyArena::Allocate(size_t size, size_t align)
+{
+    uintptr_t p = (reinterpret_cast<uintptr_t>(cursor) + align - 1) & ~(static_cast<uintptr_t>(align) - 1);
+    if(cursor == nullptr || p + size > reinterpret_cast<uintptr_t>(end))
+    {
+        if(!_AddChunk(size + align))
+            return nullptr;
+        p = (reinterpret_cast<uintptr_t>(cursor) + align - 1) & ~(static_cast<uintptr_t>(align) - 1);
+    }
+    cursor = reinterpret_cast<char*>(p + size);
+    allocatedBytes += size;
+    return reinterpret_cast<void*>(p);
+}
+
+void sys_sage::TopologyArena::Release()
+{
+    if(!chunks.empty())
+    {
+        ChunkRegistry& registry = _GetChunkRegistry();
+        std::unique_lock lock(registry.mutex);
+        for(Chunk& c : chunks)
+            registry.chunks.erase(reinterpret_cast<uintptr_t>(c.ptr) + c.size);
+        registeredChunks.fetch_sub(chunks.size(), std::memory_order_release);
+    }
+    for(Chunk& c : chunks)
+    {
+        if(c.mmapped)
+            munmap(c.ptr, c.size);
+        else
+            std::free(c.ptr);
+    }
+    chunks.clear();
+    cursor = nullptr;
+    end = nullptr;
+    allocatedBytes = 0;
+}
+
+size_t sys_sage::TopologyArena::GetAllocatedBytes() const { return allocatedBytes; }
+size_t sys_sage::TopologyArena::GetReservedBytes() const
+{
+    size_t ret = 0;
+    for(const Chunk& c : chunks)
+        ret += c.size;
+    return ret;
+}
+bool sys_sage::TopologyArena::UsesHugePages() const { return useHugePages; }
+
+sys_sage::TopologyArena* sys_sage::TopologyArena::GetCurrent() { return currentArena; }
+void sys_sage::TopologyArena::_SetCurrent(TopologyArena* arena) { currentArena = arena; }
+
+sys_sage::ArenaScope::ArenaScope(Topology* topo) : ArenaScope(topo == nullptr ? nullptr : topo->GetArena()) {}
+sys_sage::ArenaScope::ArenaScope(TopologyArena* arena) : previous(TopologyArena::GetCurrent())
+{
+    TopologyArena::_SetCurrent(arena);
+}
+sys_sage::ArenaScope::~ArenaScope()
+{
+    TopologyArena::_SetCurrent(previous);
+}
+
+void* sys_sage::_ArenaAwareAllocate(size_t size)
+{
+    void* block = nullptr;
+    if(currentArena != nullptr)
+        block = currentArena->Allocate(size, alignof(std::max_align_t));
+    if(block == nullptr)
+    {
+        block = std::malloc(size);
+        if(block == nullptr)
+            throw std::bad_alloc();
+    }
+    return block;
+}
+
+void sys_sage::_ArenaAwareFree(void* ptr)
+{
+    //blocks in an arena are reclaimed by TopologyArena::Release()
+    if(ptr != nullptr && _FindChunkOwner(ptr) == nullptr)
+        std::free(ptr);
+}
+
+sys_sage::TopologyArena* sys_sage::_GetOwningArena(const void* ptr)
+{
+    return _FindChunkOwner(ptr);
+}
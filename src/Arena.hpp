@@ -0,0 +1,139 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace sys_sage {
+
+    class Topology;
+
+    /**
+     * @class TopologyArena
+     * @brief Bump-pointer arena for Components and Relations of one Topology.
+     *
+     * Memory is reserved in large chunks (optionally backed by huge pages) and handed out sequentially, so that the objects
+     * of a topology are placed contiguously. Individual deallocations are no-ops; all memory is returned at once by Release()
+     * (or by the destructor), which makes tearing down a whole topology a single step.
+     * \n An arena is usually owned by a Topology (see Topology::EnableArena()) and activated on the current thread with an ArenaScope.
+     * While an arena is active, every Component and Relation created with new on that thread is placed in it.
+     */
+    class TopologyArena {
+    public:
+        /**
+         * @brief Creates an empty arena (no memory is reserved until the first allocation).
+         * @param _useHugePages If true, chunks are mapped with MAP_HUGETLB (falling back to transparent huge pages via madvise if no huge pages are reserved).
+         * @param _chunkSize Size of one chunk in bytes (0 = default: 2 MiB, i.e. one huge page).
+         */
+        TopologyArena(bool _useHugePages = false, size_t _chunkSize = 0);
+        /**
+         * @brief Releases all chunks. Does not run destructors of the objects placed in the arena.
+         */
+        ~TopologyArena();
+        TopologyArena(const TopologyArena&) = delete;
+        TopologyArena& operator=(const TopologyArena&) = delete;
+
+        /**
+         * @brief Allocates size bytes aligned to align from the arena.
+         * @return Pointer to the memory, or nullptr if no chunk could be reserved.
+         */
+        void* Allocate(size_t size, size_t align = alignof(std::max_align_t));
+        /**
+         * @brief Returns all chunks to the system at once. All objects placed in the arena become invalid.
+         */
+        void Release();
+
+        /**
+         * @brief Returns the number of bytes handed out by Allocate() since the last Release().
+         */
+        size_t GetAllocatedBytes() const;
+        /**
+         * @brief Returns the number of bytes reserved in chunks.
+         */
+        size_t GetReservedBytes() const;
+        /**
+         * @brief Returns true if the arena was created with huge page backing.
+         */
+        bool UsesHugePages() const;
+
+        /**
+         * @brief Returns the arena that is active on the calling thread (see ArenaScope), or nullptr.
+         */
+        static TopologyArena* GetCurrent();
+        /**
+         * @private
+         * @brief Sets the arena that is active on the calling thread. Use ArenaScope instead.
+         */
+        static void _SetCurrent(TopologyArena* arena);
+
+    private:
+        struct Chunk {
+            void* ptr;
+            size_t size;
+            bool mmapped;
+        };
+        bool _AddChunk(size_t minSize);
+
+        bool useHugePages;
+        size_t chunkSize;
+        std::vector<Chunk> chunks;
+        char* cursor = nullptr;
+        char* end = nullptr;
+        size_t allocatedBytes = 0;
+    };
+
+    /**
+     * @class ArenaScope
+     * @brief RAII helper that activates the arena of a Topology on the calling thread.
+     *
+     * All Components and Relations created with new on this thread while the scope is alive are placed in the arena.
+     * Scopes can be nested; the previously active arena is restored when the scope ends.
+     * \n Example:
+     * ```cpp
+     * Topology* topo = new Topology();
+     * topo->EnableArena();
+     * {
+     *     ArenaScope scope(topo);
+     *     Node* n = new Node(topo, 1);
+     *     parseHwlocOutput(n, "hwloc.xml");
+     * }
+     * topo->Delete(); // O(1) release of the arena memory
+     * ```
+     */
+    class ArenaScope {
+    public:
+        /**
+         * @param topo Topology whose arena is activated (if topo has no arena, no arena is active within the scope).
+         */
+        ArenaScope(Topology* topo);
+        /**
+         * @param arena Arena to activate (nullptr = no arena within the scope).
+         */
+        ArenaScope(TopologyArena* arena);
+        ~ArenaScope();
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+    private:
+        TopologyArena* previous;
+    };
+
+    /**
+     * @private
+     * @brief Allocation function behind Component::operator new and Relation::operator new.
+     * Places the object in the active arena (if any) or on the heap; heap blocks carry no extra header.
+     */
+    void* _ArenaAwareAllocate(size_t size);
+    /**
+     * @private
+     * @brief Deallocation function behind Component::operator delete and Relation::operator delete.
+     * Frees heap blocks; blocks from an arena (found by the address ranges of the chunks of all arenas) are reclaimed when the arena is released.
+     */
+    void _ArenaAwareFree(void* ptr);
+    /**
+     * @private
+     * @brief Returns the arena in which the object at ptr (allocated by _ArenaAwareAllocate) was placed, or nullptr if it is on the heap.
+     */
+    TopologyArena* _GetOwningArena(const void* ptr);
+
+} //namespace sys_sage
+#endif //ARENA_HPP
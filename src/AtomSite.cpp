@@ -1 +1,15 @@
 #include "AtomSite.hpp"
+
+#include "MemoryFootprint.hpp"
+
+size_t sys_sage::AtomSite::_GetOwnedMemory(MemoryFootprint* footprint) const
+{
+    size_t bytes = QuantumBackend::_GetOwnedMemory(footprint);
+    for(const std::map<std::string, double>* m : {&shuttlingTimes, &shuttlingAverageFidelities})
+    {
+        bytes += MemoryFootprint::_MapBytes(*m);
+        for(const auto& [name, value] : *m)
+            bytes += footprint->_AddString(name);
+    }
+    return bytes;
+}
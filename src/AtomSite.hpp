@@ -27,9 +27,23 @@ namespace sys_sage {
          * 
          * Should normally not be used directly. Used internally for exporting the topology to XML.
          * @see exportToXml(Component* root, string path = "", std::function<int(string,void*,string*)> custom_search_attrib_key_fcn = NULL)
-         * @return Pointer to the created XML subtree node.
          */
-        xmlNodePtr _CreateXmlSubtree() override;
+        void _WriteXml(XmlStreamWriter* w) override;
+        /**
+         * @private
+         * @brief Adds the heap members of this class to QuantumBackend::_GetOwnedMemory().
+         */
+        size_t _GetOwnedMemory(MemoryFootprint* footprint) const override;
+        /**
+         * @private
+         * @brief Stores the members of this class as type-specific fields (see BinaryComponentRecord).
+         */
+        void _WriteBinaryFields(BinaryWriter* w, BinaryComponentRecord* rec) const override;
+        /**
+         * @private
+         * @brief Restores the members stored by _WriteBinaryFields().
+         */
+        void _ReadBinaryFields(const BinaryTopologyView* v, const BinaryComponentRecord* rec) override;
 
         //SVTODO move to private?
         /**
@@ -0,0 +1,182 @@
+#include "Attribute.hpp"
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace {
+    //names and types of the predefined keys; index = key id
+    struct BuiltinKey {
+        const char* name;
+        sys_sage::AttributeType::type type;
+    };
+    constexpr BuiltinKey builtinKeys[sys_sage::AttributeKey::_num_builtin_keys] = {
+        {"", sys_sage::AttributeType::None},
+        {"CATcos", sys_sage::AttributeType::UInt64},
+        {"CATL3mask", sys_sage::AttributeType::UInt64},
+        {"mig_size", sys_sage::AttributeType::LongLong},
+        {"mig_uuid", sys_sage::AttributeType::String},
+        {"Number_of_streaming_multiprocessors", sys_sage::AttributeType::Int},
+        {"Number_of_cores_in_GPU", sys_sage::AttributeType::Int},
+        {"Number_of_cores_per_SM", sys_sage::AttributeType::Int},
+        {"Bus_Width_bit", sys_sage::AttributeType::Int},
+        {"Clock_Frequency", sys_sage::AttributeType::Double},
+        {"GPU_Clock_Rate", sys_sage::AttributeType::Double},
+        {"latency", sys_sage::AttributeType::Float},
+        {"latency_min", sys_sage::AttributeType::Float},
+        {"latency_max", sys_sage::AttributeType::Float},
+        {"CUDA_compute_capability", sys_sage::AttributeType::String},
+        {"freq_history", sys_sage::AttributeType::FrequencyHistory},
+        {"T1_max", sys_sage::AttributeType::Double},
+        {"T2_max", sys_sage::AttributeType::Double},
+        {"q1_fidelity_max", sys_sage::AttributeType::Double},
+        {"readout_fidelity_max", sys_sage::AttributeType::Double},
+        {"two_q_fidelity_max", sys_sage::AttributeType::Double},
+        {"latency_count", sys_sage::AttributeType::UInt64},
+        {"latency_variance", sys_sage::AttributeType::Float},
+    };
+
+    struct KeyRegistry {
+        std::shared_mutex mutex;
+        std::unordered_map<std::string, sys_sage::AttributeKey::type> ids;
+        std::deque<std::string> names; //deque: references returned by GetName stay valid when new keys are interned
+
+        KeyRegistry()
+        {
+            for(sys_sage::AttributeKey::type k = 0; k < sys_sage::AttributeKey::_num_builtin_keys; k++)
+            {
+                names.emplace_back(builtinKeys[k].name);
+                if(k != sys_sage::AttributeKey::Invalid)
+                    ids.emplace(names.back(), k);
+            }
+        }
+    };
+    KeyRegistry& registry()
+    {
+        static KeyRegistry r;
+        return r;
+    }
+}
+
+sys_sage::AttributeKey::type sys_sage::AttributeKey::Intern(const std::string& name)
+{
+    KeyRegistry& r = registry();
+    {
+        std::shared_lock lock(r.mutex);
+        auto it = r.ids.find(name);
+        if(it != r.ids.end())
+            return it->second;
+    }
+    std::unique_lock lock(r.mutex);
+    auto [it, inserted] = r.ids.emplace(name, static_cast<type>(r.names.size()));
+    if(inserted)
+        r.names.push_back(name);
+    return it->second;
+}
+
+sys_sage::AttributeKey::type sys_sage::AttributeKey::Find(const std::string& name)
+{
+    KeyRegistry& r = registry();
+    std::shared_lock lock(r.mutex);
+    auto it = r.ids.find(name);
+    return it == r.ids.end() ? Invalid : it->second;
+}
+
+const std::string& sys_sage::AttributeKey::GetName(type key)
+{
+    KeyRegistry& r = registry();
+    std::shared_lock lock(r.mutex);
+    return key < r.names.size() ? r.names[key] : r.names[Invalid];
+}
+
+sys_sage::AttributeType::type sys_sage::AttributeKey::GetBuiltinType(type key)
+{
+    return key < _num_builtin_keys ? builtinKeys[key].type : AttributeType::None;
+}
+
+sys_sage::AttributeStore::~AttributeStore()
+{
+    if(!ownsValues)
+        return;
+    for(Entry& e : entries)
+        _Destroy(e);
+}
+
+sys_sage::AttributeStore::AttributeStore(const AttributeStore& other)
+{
+    entries.reserve(other.entries.size());
+    for(const Entry& e : other.entries)
+    {
+        Entry copy = e;
+        if(e.ops != nullptr)
+        {
+            if(e.ops->clone == nullptr)
+                continue;
+            copy.value.ptr = e.ops->clone(e.value.ptr);
+        }
+        entries.push_back(copy);
+    }
+}
+
+void sys_sage::AttributeStore::_Destroy(Entry& e)
+{
+    if(e.ops != nullptr)
+        e.ops->destroy(e.value.ptr);
+    e.ops = nullptr;
+    e.type = AttributeType::None;
+}
+
+const sys_sage::AttributeStore::Entry* sys_sage::AttributeStore::_Find(AttributeKey::type key) const
+{
+    for(const Entry& e : entries)
+    {
+        if(e.key == key)
+            return &e;
+    }
+    return nullptr;
+}
+sys_sage::AttributeStore::Entry* sys_sage::AttributeStore::_Find(AttributeKey::type key)
+{
+    return const_cast<Entry*>(static_cast<const AttributeStore*>(this)->_Find(key));
+}
+
+bool sys_sage::AttributeStore::Contains(AttributeKey::type key) const { return _Find(key) != nullptr; }
+
+int sys_sage::AttributeStore::Remove(AttributeKey::type key)
+{
+    for(auto it = entries.begin(); it != entries.end(); ++it)
+    {
+        if(it->key == key)
+        {
+            _Destroy(*it);
+            entries.erase(it);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+size_t sys_sage::AttributeStore::Size() const { return entries.size(); }
+const std::vector<sys_sage::AttributeStore::Entry>& sys_sage::AttributeStore::GetEntries() const { return entries; }
+const sys_sage::AttributeStore::Entry* sys_sage::AttributeStore::GetEntry(AttributeKey::type key) const { return _Find(key); }
+
+sys_sage::AttributeStore* sys_sage::AttributeStore::_ShareValues() const
+{
+    AttributeStore* shared = new AttributeStore();
+    shared->entries = entries;
+    return shared;
+}
+
+void sys_sage::AttributeStore::_DisownValues() { ownsValues = false; }
+
+bool sys_sage::AttributeStore::_Detach(AttributeKey::type key, Entry* out)
+{
+    Entry* e = _Find(key);
+    if(e == nullptr)
+        return false;
+    *out = *e;
+    e->ops = nullptr;
+    e->type = AttributeType::None;
+    return true;
+}
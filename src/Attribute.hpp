@@ -0,0 +1,274 @@
+#ifndef ATTRIBUTE_HPP
+#define ATTRIBUTE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "enums.hpp"
+
+namespace sys_sage {
+    class Component;
+
+    /**
+     * @namespace AttributeKey
+     * @brief Interned attribute keys. Every attribute name is mapped to a small integer id once; lookups in an AttributeStore then compare integers instead of strings.
+     *
+     * The keys used by sys-sage itself (parsers, external interfaces, XML import/export) are predefined with fixed ids and a fixed value type (see GetBuiltinType()).
+     * Any other name is assigned a new id by Intern().
+     */
+    namespace AttributeKey {
+        using type = uint32_t; /**< AttributeKey datatype */
+
+        constexpr type Invalid = 0; /**< Id of no key (e.g. returned by Find() for names that were never interned). */
+        constexpr type CATcos = 1; /**< uint64_t -- L3 CAT class of service (intel_pqos) */
+        constexpr type CATL3mask = 2; /**< uint64_t -- L3 CAT way mask (intel_pqos) */
+        constexpr type mig_size = 3; /**< long long -- size of a MIG partition (nvidia_mig) */
+        constexpr type mig_uuid = 4; /**< std::string -- UUID of a MIG partition (nvidia_mig) */
+        constexpr type Number_of_streaming_multiprocessors = 5; /**< int (mt4g) */
+        constexpr type Number_of_cores_in_GPU = 6; /**< int (mt4g) */
+        constexpr type Number_of_cores_per_SM = 7; /**< int (mt4g) */
+        constexpr type Bus_Width_bit = 8; /**< int (mt4g) */
+        constexpr type Clock_Frequency = 9; /**< double (mt4g) */
+        constexpr type GPU_Clock_Rate = 10; /**< double (mt4g) */
+        constexpr type latency = 11; /**< float -- mean latency (cccbench) */
+        constexpr type latency_min = 12; /**< float -- minimum latency (cccbench) */
+        constexpr type latency_max = 13; /**< float -- maximum latency (cccbench) */
+        constexpr type CUDA_compute_capability = 14; /**< std::string (mt4g) */
+        constexpr type freq_history = 15; /**< FrequencyHistory (proc_cpuinfo) */
+        constexpr type T1_max = 16; /**< double (iqm-parser) */
+        constexpr type T2_max = 17; /**< double (iqm-parser) */
+        constexpr type q1_fidelity_max = 18; /**< double (iqm-parser) */
+        constexpr type readout_fidelity_max = 19; /**< double (iqm-parser) */
+        constexpr type two_q_fidelity_max = 20; /**< double (iqm-parser) */
+        constexpr type latency_count = 21; /**< uint64_t -- number of latency samples (cccbench) */
+        constexpr type latency_variance = 22; /**< float -- variance of the latency samples (cccbench) */
+        constexpr type _num_builtin_keys = 23;
+
+        /**
+         * @brief Returns the id of an attribute name, assigning a new id if the name is not known yet. Thread-safe.
+         */
+        type Intern(const std::string& name);
+        /**
+         * @brief Returns the id of an attribute name, or Invalid if the name was never interned. Thread-safe.
+         */
+        type Find(const std::string& name);
+        /**
+         * @brief Returns the name of an interned key (an empty string for unknown ids).
+         */
+        const std::string& GetName(type key);
+        /**
+         * @brief Returns the value type of a predefined key, or AttributeType::None for user-defined keys.
+         */
+        AttributeType::type GetBuiltinType(type key);
+    }
+
+    /**
+     * @brief Value type of the freq_history attribute: (timestamp, frequency in MHz) samples.
+     */
+    using FrequencyHistory = std::vector<std::tuple<long long,double>>;
+
+    /**
+     * @brief Value of an attribute that is not decoded yet (AttributeType::Lazy): the raw payload and the function that decodes it.
+     * Component::GetAttribute() and Component::DecodeAttribute() replace it by the decoded value on the first access.
+     * @see XmlImportContext::lazyAttributes
+     */
+    struct LazyAttribute {
+        std::string payload; /**< Raw payload, e.g. the XML of an Attribute element. */
+        std::function<int(const std::string& payload, Component* c)> decode; /**< Stores the decoded value in c (as a typed attribute or in the attrib map); returns 0 on success. */
+    };
+
+    /**
+     * @brief Maps a C++ type to its AttributeType tag. Types without a specialization are stored as AttributeType::Custom.
+     */
+    template <class T> struct AttributeTraits { static constexpr AttributeType::type tag = AttributeType::Custom; };
+    template <> struct AttributeTraits<int> { static constexpr AttributeType::type tag = AttributeType::Int; };
+    template <> struct AttributeTraits<long long> { static constexpr AttributeType::type tag = AttributeType::LongLong; };
+    template <> struct AttributeTraits<uint64_t> { static constexpr AttributeType::type tag = AttributeType::UInt64; };
+    template <> struct AttributeTraits<float> { static constexpr AttributeType::type tag = AttributeType::Float; };
+    template <> struct AttributeTraits<double> { static constexpr AttributeType::type tag = AttributeType::Double; };
+    template <> struct AttributeTraits<std::string> { static constexpr AttributeType::type tag = AttributeType::String; };
+    template <> struct AttributeTraits<FrequencyHistory> { static constexpr AttributeType::type tag = AttributeType::FrequencyHistory; };
+    template <> struct AttributeTraits<LazyAttribute> { static constexpr AttributeType::type tag = AttributeType::Lazy; };
+
+    /**
+     * @class AttributeStore
+     * @brief Typed, owning storage for the attributes of a Component or Relation.
+     *
+     * Entries are kept in a small flat vector keyed by interned AttributeKey ids. Scalars (int, long long, uint64_t, float, double) are stored inline in the entry;
+     * all other values are allocated once and owned by the store, i.e. they are destroyed with the store (or when overwritten/removed).
+     * \n Every entry carries its AttributeType tag, so that the XML import/export dispatches on the tag instead of on the key name.
+     * \n Normally used through Component::SetAttribute()/GetAttribute() and Relation::SetAttribute()/GetAttribute().
+     */
+    class AttributeStore {
+    public:
+        /**
+         * @brief Type-erased operations for values stored out of line.
+         */
+        struct Ops {
+            void (*destroy)(void*);
+            void* (*clone)(const void*); /**< nullptr for types that are not copy-constructible */
+            const std::type_info& typeInfo;
+            size_t size; /**< sizeof the value type (for memory accounting) */
+        };
+        /**
+         * @brief One attribute.
+         */
+        struct Entry {
+            AttributeKey::type key;
+            AttributeType::type type;
+            union {
+                int i;
+                long long ll;
+                uint64_t u64;
+                float f;
+                double d;
+                void* ptr;
+            } value;
+            const Ops* ops; /**< Non-null for values stored out of line (String, FrequencyHistory, Custom). */
+
+            /**
+             * @brief Returns a pointer to the value (inline or out of line).
+             */
+            void* Get() { return ops != nullptr ? value.ptr : static_cast<void*>(&value); }
+            const void* Get() const { return ops != nullptr ? value.ptr : static_cast<const void*>(&value); }
+        };
+
+        AttributeStore() = default;
+        /**
+         * @brief Destroys all values owned by the store.
+         */
+        ~AttributeStore();
+        /**
+         * @brief Deep copy (values of types that are not copy-constructible are skipped).
+         */
+        AttributeStore(const AttributeStore& other);
+        AttributeStore& operator=(const AttributeStore&) = delete;
+
+        /**
+         * @brief Returns a pointer to the value of key, or nullptr if there is no such attribute or it holds a different type than T.
+         */
+        template <class T>
+        T* Get(AttributeKey::type key) const
+        {
+            const Entry* e = _Find(key);
+            if(e == nullptr || e->type != AttributeTraits<T>::tag)
+                return nullptr;
+            if constexpr (AttributeTraits<T>::tag == AttributeType::Custom)
+            {
+                if(e->ops->typeInfo != typeid(T))
+                    return nullptr;
+            }
+            return static_cast<T*>(const_cast<void*>(e->Get()));
+        }
+
+        /**
+         * @brief Sets (inserts or overwrites) the value of key; the store takes ownership of the value.
+         * @return Reference to the stored value
+         */
+        template <class T>
+        T& Set(AttributeKey::type key, T value)
+        {
+            Entry* e = _Find(key);
+            if(e == nullptr)
+            {
+                entries.push_back(Entry{key, AttributeType::None, {}, nullptr});
+                e = &entries.back();
+            }
+            else
+                _Destroy(*e);
+
+            e->type = AttributeTraits<T>::tag;
+            if constexpr (_IsInline<T>())
+            {
+                e->ops = nullptr;
+                std::memcpy(&e->value, &value, sizeof(T));
+                return *reinterpret_cast<T*>(&e->value);
+            }
+            else
+            {
+                e->ops = _OpsFor<T>();
+                T* v = new T(std::move(value));
+                e->value.ptr = v;
+                return *v;
+            }
+        }
+
+        /**
+         * @brief Returns true if the store holds an attribute key (of any type).
+         */
+        bool Contains(AttributeKey::type key) const;
+        /**
+         * @brief Removes (and destroys) the attribute key.
+         * @return 1 if the attribute was removed, 0 if there was none
+         */
+        int Remove(AttributeKey::type key);
+        /**
+         * @brief Returns the number of attributes.
+         */
+        size_t Size() const;
+        /**
+         * @brief Returns the entries in insertion order.
+         */
+        const std::vector<Entry>& GetEntries() const;
+        /**
+         * @brief Returns the entry of key, or nullptr.
+         */
+        const Entry* GetEntry(AttributeKey::type key) const;
+
+        /**
+         * @private
+         * @brief Returns a new store with the same entries that shares the out-of-line values with this store (used for copy-on-write, see EpochDomain).
+         * Exactly one of the stores may own the shared values afterwards (see _DisownValues()).
+         */
+        AttributeStore* _ShareValues() const;
+        /**
+         * @private
+         * @brief Makes the destructor leave the out-of-line values alone (they are owned by a store created by _ShareValues()).
+         */
+        void _DisownValues();
+        /**
+         * @private
+         * @brief Takes the value of key out of the store's ownership without destroying it: *out receives the entry, the entry stays in the store as an empty (AttributeType::None) entry.
+         * @return true if the store contains key
+         */
+        bool _Detach(AttributeKey::type key, Entry* out);
+
+    private:
+        template <class T>
+        static constexpr bool _IsInline()
+        {
+            return std::is_arithmetic_v<T> && AttributeTraits<T>::tag != AttributeType::Custom && sizeof(T) <= sizeof(uint64_t);
+        }
+        template <class T>
+        static void _DestroyValue(void* p) { delete static_cast<T*>(p); }
+        template <class T>
+        static void* _CloneValue(const void* p)
+        {
+            if constexpr (std::is_copy_constructible_v<T>)
+                return new T(*static_cast<const T*>(p));
+            else
+                return nullptr;
+        }
+        template <class T>
+        static const Ops* _OpsFor()
+        {
+            static const Ops ops{&_DestroyValue<T>, std::is_copy_constructible_v<T> ? &_CloneValue<T> : nullptr, typeid(T), sizeof(T)};
+            return &ops;
+        }
+        const Entry* _Find(AttributeKey::type key) const;
+        Entry* _Find(AttributeKey::type key);
+        static void _Destroy(Entry& e);
+
+        std::vector<Entry> entries;
+        bool ownsValues = true;
+    };
+
+} //namespace sys_sage
+#endif //ATTRIBUTE_HPP
@@ -59,6 +59,11 @@ namespace sys_sage {
          * @brief Use Delete() or DeleteSubtree() for deleting and deallocating the components.
          */
         ~Cache() override = default;
+        /**
+        * @private
+        * Returns a copy of this Cache (see Component::_CloneInstance()).
+        */
+        Component* _CloneInstance() const override;
 
         /**
          * @brief Get the cache level (e.g., 1 for L1, 2 for L2).
@@ -124,9 +129,23 @@ namespace sys_sage {
          *
          * Should normally not be called from the outside. Used internally for exporting the topology to XML.
          * @see exportToXml(Component* root, string path = "", std::function<int(string,void*,string*)> custom_search_attrib_key_fcn = NULL)
-         * @return Pointer to the created XML subtree node.
          */
-        xmlNodePtr _CreateXmlSubtree() override;
+        void _WriteXml(XmlStreamWriter* w) override;
+        /**
+         * @private
+         * @brief Adds the heap members of this class to Component::_GetOwnedMemory().
+         */
+        size_t _GetOwnedMemory(MemoryFootprint* footprint) const override;
+        /**
+         * @private
+         * @brief Stores the members of this class as type-specific fields (see BinaryComponentRecord).
+         */
+        void _WriteBinaryFields(BinaryWriter* w, BinaryComponentRecord* rec) const override;
+        /**
+         * @private
+         * @brief Restores the members stored by _WriteBinaryFields().
+         */
+        void _ReadBinaryFields(const BinaryTopologyView* v, const BinaryComponentRecord* rec) override;
     private:
         std::string cache_type;           ///< Cache level or cache type (e.g., "L1", "texture")
         long long cache_size;             ///< Size/capacity of the cache in bytes
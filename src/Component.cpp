@@ -17,6 +17,10 @@
 #include "DataPath.hpp"
 #include "QuantumGate.hpp"
 #include "CouplingMap.hpp"
+#include "Arena.hpp"
+#include "MemoryFootprint.hpp"
+#include "Epoch.hpp"
+#include "binary_dump.hpp"
 
 #include <algorithm>
 #include <csignal>
@@ -42,20 +46,25 @@ using std::vector;
 using std::cout;
 using std::endl;
 
+//number of SharedWriteScopes alive on this thread; while it is > 0, writes to shared components are not materialized
+static thread_local int sharedWriteScopes = 0;
+
 void sys_sage::Component::PrintSubtree() const { _PrintSubtree(0); }
 void sys_sage::Component::_PrintSubtree(int level) const
 {
     //TODO maybe print more info based on component type? (override this function?)
     //cout << "---PrintSubtree---" << endl;
-    for (int i = 0; i < level; ++i)
-        std::cout << "  ";
-
-    cout << GetComponentTypeStr() << " (name " << name << ") id " << id << " - children: " << children.size();
-    cout << " level: " << level<<"\n";
-    for(Component* child: children)
+    for(PreOrderIterator it = const_cast<Component*>(this)->PreOrder().begin(); it != std::default_sentinel; ++it)
     {
-        //cout << "size of children: " << child->children.size() << "\n";
-        child->_PrintSubtree(level + 1);
+        Component* c = *it;
+        int l = level + it.Depth();
+        for (int i = 0; i < l; ++i)
+            std::cout << "  ";
+
+        cout << c->GetComponentTypeStr() << " (name " << c->name << ") id " << c->id << " - children: " << c->children.size();
+        if(c->IsCollapsed())
+            cout << " count: " << c->count;
+        cout << " level: " << l <<"\n";
     }
 }
 void sys_sage::Component::PrintAllDataPathsInSubtree()
@@ -64,15 +73,13 @@ void sys_sage::Component::PrintAllDataPathsInSubtree()
 }
 void sys_sage::Component::PrintAllRelationsInSubtree(RelationType::type relationType)
 {
-    vector<Component*> subtreeList;
-    GetComponentsInSubtree(&subtreeList);
-    for(Component * c : subtreeList)
+    for(Component * c : PreOrder())
     {   
         for(RelationType::type rt : RelationType::RelationTypeList)
         {
             if (relationType == rt || relationType == RelationType::Any)
             {
-                vector<Relation*> c_relations = c->GetRelations(rt);
+                const vector<Relation*>& c_relations = c->GetRelations(rt);
                 if(c_relations.size() > 0)
                 {
                     std::cout << RelationType::ToString(rt) << "s regarding Component (" << c->GetComponentTypeStr() << ") id " << c->GetId() << std::endl;
@@ -91,26 +98,117 @@ void sys_sage::Component::PrintAllRelationsInSubtree(RelationType::type relation
 
 void sys_sage::Component::InsertChild(Component * child)
 {
+    _MaterializeIfShared();
+    child->MarkModified();
     child->SetParent(this);
+    child->_SetSubtreeDepth(depth + 1);
+    child->siblingIndex = children.size();
     children.push_back(child);
+    if(childIdMap != nullptr)
+    {
+        if(!childIdMap->emplace(child->id, child).second)
+            childIdMapHasDuplicates = true;
+        childIdMapHasCollapsed |= child->IsCollapsed();
+    }
+    _OnSubtreeAttached(child);
+}
+
+int sys_sage::Component::_FindChildIndex(const Component* child) const
+{
+    int idx = child->siblingIndex;
+    if(idx >= 0 && idx < static_cast<int>(children.size()) && children[idx] == child)
+        return idx;
+    //stale sibling index (children list modified directly) -> linear search
+    auto it = std::find(children.begin(), children.end(), child);
+    return it == children.end() ? -1 : static_cast<int>(it - children.begin());
+}
+
+void sys_sage::Component::_ReindexChildren(size_t from)
+{
+    for(size_t i = from; i < children.size(); i++)
+        children[i]->siblingIndex = i;
+}
+
+void sys_sage::Component::_EraseFromChildIdMap(const Component* child)
+{
+    if(childIdMap == nullptr)
+        return;
+    auto it = childIdMap->find(child->id);
+    if(it == childIdMap->end() || it->second != child)
+        return;
+    if(childIdMapHasDuplicates)
+        _DropChildIdMap(); //another child with the same id may have to take its place
+    else
+        childIdMap->erase(it);
+}
+
+void sys_sage::Component::_DropChildIdMap() const
+{
+    delete childIdMap;
+    childIdMap = nullptr;
+    childIdMapHasDuplicates = false;
+    childIdMapHasCollapsed = false;
+}
+
+void sys_sage::Component::_OnSubtreeAttached(Component* _subtreeRoot)
+{
+    Topology* registry = nullptr;
+    Topology* concurrent = nullptr;
+    for(Component* c = this; c != NULL; c = c->GetParent())
+    {
+        if(c->GetComponentType() == ComponentType::Topology)
+        {
+            Topology* t = static_cast<Topology*>(c);
+            t->_IndexSubtree(_subtreeRoot);
+            if(registry == nullptr && t->IsRelationRegistryEnabled())
+                registry = t;
+            if(concurrent == nullptr && t->GetEpochDomain() != nullptr)
+                concurrent = t;
+        }
+    }
+    if(registry != nullptr)
+        registry->_RegisterSubtreeRelations(_subtreeRoot);
+    if(concurrent != nullptr)
+        concurrent->_AttachToEpochDomain(_subtreeRoot);
+}
+
+void sys_sage::Component::_OnSubtreeDetached(Component* _subtreeRoot)
+{
+    Topology* registry = nullptr;
+    Topology* concurrent = nullptr;
+    for(Component* c = this; c != NULL; c = c->GetParent())
+    {
+        if(c->GetComponentType() == ComponentType::Topology)
+        {
+            Topology* t = static_cast<Topology*>(c);
+            t->_UnindexSubtree(_subtreeRoot);
+            if(registry == nullptr && t->IsRelationRegistryEnabled())
+                registry = t;
+            if(concurrent == nullptr && t->GetEpochDomain() != nullptr)
+                concurrent = t;
+        }
+    }
+    if(registry != nullptr)
+        registry->_UnregisterSubtreeRelations(_subtreeRoot);
+    if(concurrent != nullptr)
+        concurrent->_DetachFromEpochDomain(_subtreeRoot);
 }
 int sys_sage::Component::InsertBetweenParentAndChild(Component* parent, Component* child, bool alreadyParentsChild)
 {
     //consistency check
-    vector<Component*>& p_children = parent->_GetChildren();
     if(child->GetParent() != parent){
-        if(std::find(p_children.begin(), p_children.end(), child) != p_children.end())
+        if(parent->_FindChildIndex(child) >= 0)
             return 1; //child and parent are not child and parent in the component tree
         else
             return 2; //corrupt component tree -> bad thing
     }
     else{
-        if(std::find(p_children.begin(), p_children.end(), child) == p_children.end())
+        if(parent->_FindChildIndex(child) < 0)
             return 3; //corrupt component tree -> bad thing
     }
 
     //remove from grandparent's list; set new parent; insert child into the new component's list
-    p_children.erase(std::remove(p_children.begin(), p_children.end(), child), p_children.end());
+    parent->RemoveChild(child);
     child->SetParent(this);
     this->InsertChild(child);
 
@@ -125,11 +223,10 @@ int sys_sage::Component::InsertBetweenParentAndChild(Component* parent, Componen
 }
 int sys_sage::Component::InsertBetweenParentAndChildren(Component* parent, std::vector<Component*> children, bool alreadyParentsChild)
 {
-    vector<Component*>& p_children = parent->_GetChildren();
     for(Component* child: children) //first just check for consistency
     {
         bool isParent = (child->GetParent() == parent);      
-        if(std::find(p_children.begin(), p_children.end(), child) == p_children.end()){  //child not listed as parent's child
+        if(parent->_FindChildIndex(child) < 0){  //child not listed as parent's child
             if(isParent)
                 return 2; //corrupt component tree -> bad thing
             else
@@ -139,13 +236,8 @@ int sys_sage::Component::InsertBetweenParentAndChildren(Component* parent, std::
             return 3; //corrupt component tree -> bad thing
     }
 
-    for(Component* child: children) //second time do the actual inserting
-    {
-        //remove from grandparent's list; set new parent; insert child into the new component's list
-        p_children.erase(std::remove(p_children.begin(), p_children.end(), child), p_children.end());
-        child->SetParent(this);
-        this->InsertChild(child);
-    }
+    //second time do the actual inserting: remove from grandparent's list (in one pass); set new parent; insert children into the new component's list
+    parent->ReparentChildren(children, this);
 
     //finally, insert new component to grandparent's children list
     if(!alreadyParentsChild)
@@ -156,13 +248,77 @@ int sys_sage::Component::InsertBetweenParentAndChildren(Component* parent, std::
     
     return 0;
 }
-int sys_sage::Component::RemoveChild(Component * child)
+int sys_sage::Component::RemoveChild(Component * child, bool preserveOrder)
 {
-    int orig_size = children.size();
-    children.erase(std::remove(children.begin(), children.end(), child), children.end());
-    return orig_size - children.size();
-    //return std::erase(children, child); -- not supported in some compilers
+    int idx = _FindChildIndex(child);
+    if(idx < 0)
+        return 0;
+    if(preserveOrder)
+    {
+        children.erase(children.begin() + idx);
+        _ReindexChildren(idx);
+    }
+    else
+    {
+        children[idx] = children.back();
+        children[idx]->siblingIndex = idx;
+        children.pop_back();
+        //the first child with a duplicate id may have changed
+        if(childIdMapHasDuplicates)
+            _DropChildIdMap();
+    }
+    child->siblingIndex = -1;
+    child->MarkModified();
+    _EraseFromChildIdMap(child);
+    _OnSubtreeDetached(child);
+    //the child is now the root of its own tree
+    child->SetParent(NULL);
+    child->_SetSubtreeDepth(0);
+    return 1;
+}
+
+int sys_sage::Component::ReparentChildren(const std::vector<Component*>& _children, Component* newParent)
+{
+    std::vector<char> moved(children.size(), 0);
+    std::vector<Component*> toMove; //_children without duplicates
+    toMove.reserve(_children.size());
+    for(Component* child : _children)
+    {
+        int idx = _FindChildIndex(child);
+        if(idx < 0)
+            return 1;
+        if(!moved[idx])
+            toMove.push_back(child);
+        moved[idx] = 1;
+    }
+    if(newParent == this)
+        return 0;
+
+    //compact the remaining children in a single pass
+    size_t w = 0, firstMoved = children.size();
+    for(size_t r = 0; r < children.size(); r++)
+    {
+        if(moved[r])
+        {
+            if(firstMoved == children.size())
+                firstMoved = w;
+            continue;
+        }
+        children[w++] = children[r];
+    }
+    children.resize(w);
+    _ReindexChildren(firstMoved);
+
+    for(Component* child : toMove)
+    {
+        child->siblingIndex = -1;
+        _EraseFromChildIdMap(child);
+        _OnSubtreeDetached(child);
+        newParent->InsertChild(child);
+    }
+    return 0;
 }
+
 sys_sage::Component* sys_sage::Component::GetChild(int _id) const
 {
     return GetChildById(_id);
@@ -170,9 +326,30 @@ sys_sage::Component* sys_sage::Component::GetChild(int _id) const
 
 sys_sage::Component* sys_sage::Component::GetChildById(int _id) const
 {
+    if(childIdMap == nullptr && children.size() > childIdMapThreshold)
+    {
+        childIdMap = new std::unordered_map<int, Component*>();
+        childIdMap->reserve(children.size());
+        for(Component* child: children)
+        {
+            if(!childIdMap->emplace(child->id, child).second)
+                childIdMapHasDuplicates = true;
+            childIdMapHasCollapsed |= child->IsCollapsed();
+        }
+    }
+    if(childIdMap != nullptr)
+    {
+        auto it = childIdMap->find(_id);
+        if(it != childIdMap->end())
+            return it->second;
+        //the map holds the first id of collapsed children only
+        if(!childIdMapHasCollapsed)
+            return NULL;
+    }
+
     for(Component* child: children)
     {
-        if(child->id == _id)
+        if(child->_RepresentsId(_id))
             return child;
     }
     return NULL;
@@ -206,16 +383,13 @@ void sys_sage::Component::GetAllChildrenByType(std::vector <Component *> *_outAr
 
 int sys_sage::Component::GetSubtreeDepth() const
 {
-    if(children.empty()) //is leaf
-        return 0;
     int maxDepth = 0;
-    for(Component* child: children)
+    for(PreOrderIterator it = const_cast<Component*>(this)->PreOrder().begin(); it != std::default_sentinel; ++it)
     {
-        int subtreeDepth = child->GetSubtreeDepth();
-        if(subtreeDepth > maxDepth)
-            maxDepth = subtreeDepth;
+        if(it.Depth() > maxDepth)
+            maxDepth = it.Depth();
     }
-    return maxDepth + 1;
+    return maxDepth;
 }
 
 sys_sage::Component* sys_sage::Component::GetNthAncestor(int n)
@@ -243,20 +417,16 @@ sys_sage::Component* sys_sage::Component::GetNthAncestor(int n)
 
 void sys_sage::Component::GetNthDescendents(std::vector<Component*>* outArray, int depth)
 {
-    
     if(depth <= 0)
-    {   
+    {
         outArray->push_back(this);
-        // depth++;
         return;
     }
-    for(Component* child: children)
-    {   
-        cout << GetComponentTypeStr() << " (name " << name << ") id " << id << " - children: " << children.size();
-        cout << " depth: " << depth<<"\n";
-        child->GetNthDescendents(outArray, depth - 1);
+    for(PreOrderIterator it = PreOrder(ComponentType::AnyMask, depth).begin(); it != std::default_sentinel; ++it)
+    {
+        if(it.Depth() == depth)
+            outArray->push_back(*it);
     }
-    return;
 }
 
 std::vector<sys_sage::Component*> sys_sage::Component::GetNthDescendents(int depth)
@@ -268,13 +438,7 @@ std::vector<sys_sage::Component*> sys_sage::Component::GetNthDescendents(int dep
 
 void sys_sage::Component::GetSubcomponentsByType(std::vector<Component*>* outArray, sys_sage::ComponentType::type _componentType)
 {
-    if(_componentType == componentType){
-        outArray->push_back(this);
-    }
-    for(Component* child: children)
-    {
-        child->GetSubcomponentsByType(outArray, _componentType);
-    }
+    GetAllSubcomponentsByType(outArray, _componentType);
 }
 
 std::vector<sys_sage::Component*> sys_sage::Component::GetSubcomponentsByType(sys_sage::ComponentType::type _componentType)
@@ -286,12 +450,8 @@ std::vector<sys_sage::Component*> sys_sage::Component::GetSubcomponentsByType(sy
 
 void sys_sage::Component::GetComponentsInSubtree(std::vector<Component*>* outArray)
 {
-    outArray->push_back(this);
-    for(Component * child : children)
-    {
-        child->GetComponentsInSubtree(outArray);
-    }
-    return;
+    for(Component* c : PreOrder())
+        outArray->push_back(c);
 }
 
 std::vector<sys_sage::Component*> sys_sage::Component::GetComponentsInSubtree()
@@ -303,17 +463,27 @@ std::vector<sys_sage::Component*> sys_sage::Component::GetComponentsInSubtree()
 
 sys_sage::Component* sys_sage::Component::GetSubcomponentById(int _id, int _componentType)
 {
-    if(componentType == _componentType && id == _id){
-        return this;
-    }
-    for(Component * child : children)
+    //use the index of the closest Topology ancestor with an enabled component index
+    for(Component* c = this; c != NULL; c = c->GetParent())
     {
-        Component* ret = child->GetSubcomponentById(_id, _componentType);
-        if(ret != NULL)
+        if(c->GetComponentType() == ComponentType::Topology && static_cast<Topology*>(c)->IsComponentIndexEnabled())
         {
-            return ret;
+            Component* ret;
+            if(static_cast<Topology*>(c)->_FindInIndex(this, _id, _componentType, &ret))
+                return ret;
+            break;
         }
     }
+    return _GetSubcomponentByIdDfs(_id, _componentType);
+}
+
+sys_sage::Component* sys_sage::Component::_GetSubcomponentByIdDfs(int _id, int _componentType)
+{
+    for(Component* c : PreOrder(ComponentType::ToMask(_componentType)))
+    {
+        if(c->componentType == _componentType && c->_RepresentsId(_id))
+            return c;
+    }
     return NULL;
 }
 
@@ -325,48 +495,50 @@ std::vector<sys_sage::Component*> sys_sage::Component::GetAllSubcomponentsByType
 }
 void sys_sage::Component::GetAllSubcomponentsByType(std::vector<Component*>* outArray, int _componentType)
 {
-    if(componentType == _componentType){
-        outArray->push_back(this);
-    }
-    for(Component * child : children)
+    for(Component* c : PreOrder(ComponentType::ToMask(_componentType)))
     {
-        child->GetAllSubcomponentsByType(outArray, _componentType);
+        if(c->componentType == _componentType)
+            outArray->push_back(c);
     }
-    return;
 }
 
-int sys_sage::Component::CountAllSubcomponents() const
+//sums the number of represented components (see Component::SetCount()) of the subtree of root (without root) for which match(c) holds;
+//the subtree of a collapsed component is counted once per represented component
+template <class Fcn>
+static long long _CountRepresented(sys_sage::Component* root, Fcn match)
 {
-    int cnt = children.size();
-    for(Component * child : children)
+    long long cnt = 0;
+    std::vector<long long> multiplicity{1}; //multiplicity[d]: product of the counts on the path from root to the current component at depth d
+    for(sys_sage::PreOrderIterator it = root->PreOrder().begin(); it != std::default_sentinel; ++it)
     {
-        cnt += child->CountAllSubcomponents();
+        int d = it.Depth();
+        if(d == 0)
+            continue;
+        multiplicity.resize(d + 1);
+        multiplicity[d] = multiplicity[d - 1] * (*it)->GetCount();
+        if(match(*it))
+            cnt += multiplicity[d];
     }
     return cnt;
 }
 
-int sys_sage::Component::CountAllSubcomponentsByType(int _componentType) const
+long long sys_sage::Component::CountAllSubcomponents() const
 {
-    int cnt = 0;
-    for(Component * child : children)
-    {
-        if(child->GetComponentType() == _componentType)
-            cnt++;
-    }
-    for(Component * child : children)
-    {
-        cnt += child->CountAllSubcomponentsByType(_componentType);
-    }
-    return cnt;
+    return _CountRepresented(const_cast<Component*>(this), [](Component*) { return true; });
 }
 
-int sys_sage::Component::CountAllChildrenByType(int _componentType) const
+long long sys_sage::Component::CountAllSubcomponentsByType(int _componentType) const
 {
-    int cnt = 0;
+    return _CountRepresented(const_cast<Component*>(this), [_componentType](Component* c) { return c->componentType == _componentType; });
+}
+
+long long sys_sage::Component::CountAllChildrenByType(int _componentType) const
+{
+    long long cnt = 0;
     for(Component * child : children)
     {
         if(child->GetComponentType() == _componentType)
-            cnt++;
+            cnt += child->GetCount();
     }
 
     return cnt;
@@ -383,19 +555,112 @@ sys_sage::Component* sys_sage::Component::GetAncestorByType(int _componentType)
     return NULL;
 }
 
-void sys_sage::Component::_AddRelation(int32_t relationType, Relation* r)
+int32_t sys_sage::Component::_AddRelation(int32_t relationType, Relation* r)
 {
-    if(!relations)
-        relations = new std::array<std::vector<Relation*>*, RelationType::_num_relation_types>();
-    if(!(*relations)[relationType])
-        (*relations)[relationType] = new std::vector<Relation*>();
-    
-    (*relations)[relationType]->push_back(r);
+    relations[relationType].push_back(r);
+    if(publishedRelations != nullptr)
+        _MarkRelationsChanged();
+    return static_cast<int32_t>(relations[relationType].size()) - 1;
+}
+
+void sys_sage::Component::_RemoveRelation(RelationType::type relationType, int32_t slot)
+{
+    std::vector<Relation*>& rv = relations[relationType];
+    int32_t last = static_cast<int32_t>(rv.size()) - 1;
+    if(slot != last)
+    {
+        rv[slot] = rv[last];
+        rv[slot]->_UpdateComponentSlot(this, last, slot);
+    }
+    rv.pop_back();
+    if(publishedRelations != nullptr)
+        _MarkRelationsChanged();
+}
+
+sys_sage::Topology* sys_sage::Component::_FindRelationRegistry() const
+{
+    for(const Component* c = this; c != NULL; c = c->GetParent())
+    {
+        if(c->GetComponentType() == ComponentType::Topology && static_cast<const Topology*>(c)->IsRelationRegistryEnabled())
+            return const_cast<Topology*>(static_cast<const Topology*>(c));
+    }
+    return nullptr;
+}
+
+sys_sage::Topology* sys_sage::Component::_FindChangeTracking() const
+{
+    for(const Component* c = this; c != NULL; c = c->GetParent())
+    {
+        if(c->GetComponentType() == ComponentType::Topology && static_cast<const Topology*>(c)->IsChangeTrackingEnabled())
+            return const_cast<Topology*>(static_cast<const Topology*>(c));
+    }
+    return nullptr;
+}
+
+sys_sage::EpochDomain* sys_sage::Component::_FindEpochDomain() const
+{
+    if(!EpochDomain::_AnyDomain())
+        return nullptr;
+    for(const Component* c = this; c != NULL; c = c->GetParent())
+    {
+        if(c->GetComponentType() == ComponentType::Topology && static_cast<const Topology*>(c)->GetEpochDomain() != nullptr)
+            return static_cast<const Topology*>(c)->GetEpochDomain();
+    }
+    return nullptr;
+}
+
+void sys_sage::Component::_MarkRelationsChanged()
+{
+    EpochDomain* domain = _FindEpochDomain();
+    if(domain != nullptr)
+        domain->_MarkChanged(this);
+}
+
+sys_sage::Component::RelationArray* sys_sage::Component::_PublishRelations()
+{
+    return std::atomic_ref<RelationArray*>(publishedRelations).exchange(new RelationArray(relations), std::memory_order_acq_rel);
+}
+
+sys_sage::Component::RelationArray* sys_sage::Component::_UnpublishRelations()
+{
+    return std::atomic_ref<RelationArray*>(publishedRelations).exchange(nullptr, std::memory_order_acq_rel);
+}
+
+sys_sage::Component* sys_sage::Component::GetLowestCommonAncestor(const Component* other) const
+{
+    const Component* a = this;
+    const Component* b = other;
+    while(a != NULL && b != NULL && a->depth > b->depth)
+        a = a->GetParent();
+    while(a != NULL && b != NULL && b->depth > a->depth)
+        b = b->GetParent();
+    while(a != b && a != NULL && b != NULL)
+    {
+        a = a->GetParent();
+        b = b->GetParent();
+    }
+    return a == b ? const_cast<Component*>(a) : NULL;
+}
+
+std::vector<sys_sage::Component*> sys_sage::Component::GetSharedComponents(const Component* other, ComponentType::mask typeMask) const
+{
+    std::vector<Component*> outArray;
+    GetSharedComponents(&outArray, other, typeMask);
+    return outArray;
+}
+
+void sys_sage::Component::GetSharedComponents(std::vector<Component*>* outArray, const Component* other, ComponentType::mask typeMask) const
+{
+    for(Component* c = GetLowestCommonAncestor(other); c != NULL; c = c->GetParent())
+    {
+        if(ComponentType::InMask(c->GetComponentType(), typeMask))
+            outArray->push_back(c);
+    }
 }
 
 sys_sage::DataPath* sys_sage::Component::GetDataPathByType(DataPathType::type  dp_type, DataPathDirection::type direction) const
 {
-    for(Relation* r: *(*relations)[RelationType::DataPath])
+    for(Relation* r: GetRelations(RelationType::DataPath))
     {
         //either unordered -> check; or orientation is any -> check; or orientation is incoming & DP is incoming or the same outgoing
         if(!r->IsOrdered() || 
@@ -413,25 +678,21 @@ sys_sage::DataPath* sys_sage::Component::GetDataPathByType(DataPathType::type  d
 
 std::vector<sys_sage::Relation*>& sys_sage::Component::_GetRelations(RelationType::type relationType) const
 {
-    if (relations &&
-        relationType >= 0 && 
-        relationType < RelationType::_num_relation_types &&
-        (*relations)[relationType]) 
-    {
-        return *(*relations)[relationType];
-    }
+    if (relationType >= 0 && relationType < RelationType::_num_relation_types)
+        return const_cast<std::vector<Relation*>&>(relations[relationType]);
 
     static std::vector<Relation*> empty;
     return empty;
 }
 const std::vector<sys_sage::Relation*>& sys_sage::Component::GetRelations(RelationType::type relationType) const
 {
-    if (relations &&
-        relationType >= 0 && 
-        relationType < RelationType::_num_relation_types &&
-        (*relations)[relationType]) 
+    if (relationType >= 0 && relationType < RelationType::_num_relation_types)
     {
-        return *(*relations)[relationType];
+        //concurrent readers get the published copy; writers (and everybody else) the live vector
+        const RelationArray* published = std::atomic_ref<RelationArray*>(const_cast<RelationArray*&>(publishedRelations)).load(std::memory_order_acquire);
+        if(published != nullptr && !EpochDomain::_IsWriting())
+            return (*published)[relationType];
+        return relations[relationType];
     }
 
     static const std::vector<Relation*> empty;
@@ -445,7 +706,7 @@ std::vector<sys_sage::Relation*> sys_sage::Component::GetAllRelationsBy(Relation
     {
         if(relationType == RelationType::Any || relationType == curr_rt)
         {
-            for(Relation* r : *(*relations)[curr_rt])
+            for(Relation* r : GetRelations(curr_rt))
             {
                 if(!r->IsOrdered() || (r->IsOrdered() && (thisComponentPosition==-1 || r->GetComponent(thisComponentPosition) == this)))
                 {
@@ -459,10 +720,7 @@ std::vector<sys_sage::Relation*> sys_sage::Component::GetAllRelationsBy(Relation
 
 void sys_sage::Component::GetAllDataPaths(std::vector<DataPath*>* outDpArr, DataPathType::type dp_type, DataPathDirection::type direction) const
 {
-    if (relations == nullptr || (*relations)[RelationType::DataPath] == nullptr)
-        return;
-
-    for(Relation* r: *(*relations)[RelationType::DataPath])
+    for(Relation* r: GetRelations(RelationType::DataPath))
     {
         //either unordered -> check; or orientation is any -> check; or orientation is incoming & DP is incoming or the same outgoing
         if(!r->IsOrdered() || 
@@ -494,127 +752,55 @@ std::string sys_sage::Component::GetComponentTypeStr() const
 int sys_sage::Component::CheckComponentTreeConsistency() const
 {
     int errors = 0;
-    for(Component * child : children){
-        if(child->GetParent() != this){
-            // std::cerr << "Component " << child->GetComponentTypeStr() << " id " << child->GetId() << " has wrong parent" << std::endl;
-            errors++;
+    for(Component* c : const_cast<Component*>(this)->PreOrder())
+    {
+        for(Component * child : c->children){
+            if(child->GetParent() != c){
+                // std::cerr << "Component " << child->GetComponentTypeStr() << " id " << child->GetId() << " has wrong parent" << std::endl;
+                errors++;
+            }
         }
     }
-    for(Component * child : children){
-        errors += child->CheckComponentTreeConsistency();
-    }
     return errors;
 }
 
 int sys_sage::Component::GetTopologySize(unsigned * out_component_size, unsigned * out_RelationSize) const
 {
-    return _GetTopologySize(out_component_size, out_RelationSize, NULL);
-}
-
-int sys_sage::Component::_GetTopologySize(unsigned * out_component_size, unsigned * out_RelationSize, std::set<Relation*>* countedRelations) const
-{
-    if(countedRelations == NULL)
-        countedRelations = new std::set<Relation*>();
-
-    int component_size = 0;
-    switch(componentType)
-    {
-        case ComponentType::None:
-            component_size += sizeof(Component);
-        break;
-        case ComponentType::Thread:
-            component_size += sizeof(Thread);
-        break;
-        case ComponentType::Core:
-            component_size += sizeof(Core);
-        break;
-        case ComponentType::Cache:
-            component_size += sizeof(Cache);
-        break;
-        case ComponentType::Subdivision:
-            component_size += sizeof(Subdivision);
-        break;
-        case ComponentType::Numa:
-            component_size += sizeof(Numa);
-        break;
-        case ComponentType::Chip:
-            component_size += sizeof(Chip);
-        break;
-        case ComponentType::Memory:
-            component_size += sizeof(Memory);
-        break;
-        case ComponentType::Storage:
-            component_size += sizeof(Storage);
-        break;
-        case ComponentType::Node:
-            component_size += sizeof(Node);
-        break;
-        case ComponentType::Topology:
-            component_size += sizeof(Topology);
-        break;
-    }
-    component_size += attrib.size()*(sizeof(std::string)+sizeof(void*)); //TODO improve
-    component_size += children.size()*sizeof(Component*);
-    //relations -- only counting the vector/array sizes
-    if(relations)
-    {
-        component_size += sizeof(std::array<std::vector<Relation*>*, RelationType::_num_relation_types>);
-        for(int i = 0; i<RelationType::_num_relation_types; i++)
-        {
-            if((*relations)[i] != NULL)
-            {
-                component_size += sizeof(*(*relations)[i]);
-            }
-        }
-    }
-    (*out_component_size) += component_size;
-
-    int relationsSize = 0;
-
-
-    for(RelationType::type rt : RelationType::RelationTypeList)
-    {
-        std::vector<Relation*> rv = GetRelations(rt);
-        for(Relation* r: rv)
-        {
-            if(countedRelations->find(r) == countedRelations->end())
-            {
-                switch(rt)
-                {
-                    case RelationType::Relation:
-                        relationsSize += sizeof(Relation);
-                        relationsSize += r->attrib.size() * (sizeof(string)+sizeof(void*)); //TODO improve
-                        break;
-                    case RelationType::DataPath:
-                        relationsSize += sizeof(DataPath);
-                        relationsSize += r->attrib.size() * (sizeof(string)+sizeof(void*)); //TODO improve
-                        break;
-                    case RelationType::QuantumGate:
-                        relationsSize += sizeof(QuantumGate);
-                        relationsSize += r->attrib.size() * (sizeof(string)+sizeof(void*)); //TODO improve
-                        break;
-                    case RelationType::CouplingMap:
-                        relationsSize += sizeof(CouplingMap);
-                        relationsSize += r->attrib.size() * (sizeof(string)+sizeof(void*)); //TODO improve
-                        break;
-                }
-                countedRelations->insert(r);
-            }
-        }
-    }
-    (*out_RelationSize) += relationsSize;
+    MemoryFootprint footprint = GetMemoryFootprint(this);
+    for(const auto& [componentType, bytes] : footprint.componentBytes)
+        (*out_component_size) += bytes;
+    (*out_component_size) += footprint.indexBytes + footprint.arenaSlackBytes;
+    for(const auto& [relationType, bytes] : footprint.relationBytes)
+        (*out_RelationSize) += bytes;
+    return static_cast<int>(footprint.totalBytes);
+}
 
-    int subtreeSize = 0;
-    for(Component * c : children)
+size_t sys_sage::Component::_GetOwnedMemory(MemoryFootprint* footprint) const
+{
+    size_t bytes = footprint->_AddString(name) + footprint->_AddVector(children);
+    for(const std::vector<Relation*>& rv : relations)
+        bytes += footprint->_AddVector(rv);
+    if(publishedRelations != nullptr) //copy published for concurrent readers
     {
-        subtreeSize += c->_GetTopologySize(out_component_size, out_RelationSize, countedRelations);
+        bytes += sizeof(*publishedRelations);
+        for(const std::vector<Relation*>& rv : *publishedRelations)
+            bytes += footprint->_AddVector(rv);
     }
+    bytes += footprint->_AddAttributes(attributes, attrib);
+    if(childIdMap != nullptr)
+        footprint->indexBytes += sizeof(*childIdMap) + MemoryFootprint::_UnorderedMapBytes(*childIdMap);
+    return bytes;
+}
 
-    if(countedRelations != NULL)
-        delete countedRelations;
-    return component_size + relationsSize + subtreeSize;
+void sys_sage::Component::_SetSubtreeDepth(int _depth)
+{
+    if(depth == _depth)
+        return;
+    for(PreOrderIterator it = PreOrder().begin(); it != std::default_sentinel; ++it)
+        (*it)->depth = _depth + it.Depth();
 }
 
+
 int sys_sage::Component::GetDepth(bool refresh)
 {
     if(refresh)
@@ -657,16 +843,9 @@ void sys_sage::Component::DeleteAllRelations(RelationType::type relationType)
     {
         if(relationType == RelationType::Any || relationType == rt)
         {
-            while(true)
-            {
-                vector<Relation*> vec_r = GetRelations(rt);
-                if(vec_r.size() > 0)
-                {
-                    DeleteRelation(vec_r[0]);
-                }
-                else
-                    break;
-            }
+            //deleting the last Relation is O(1) (no copies, no shifting of the vector)
+            while(!relations[rt].empty())
+                DeleteRelation(relations[rt].back());
         }
     }
 }
@@ -682,15 +861,36 @@ void sys_sage::Component::DeleteAllDataPaths()
 }
 void sys_sage::Component::DeleteSubtree() const
 {
-    while(children.size() > 0)
-    {       
-        children[0]->Delete(true); // Recursively free children
+    //detach all children at once (instead of erasing them one by one from the front of the vector)
+    Component* self = const_cast<Component*>(this);
+    std::vector<Component*> detached;
+    detached.swap(self->children);
+    self->_DropChildIdMap();
+    for(Component* child : detached)
+    {
+        self->_OnSubtreeDetached(child);
+        child->SetParent(NULL);
+    }
+    for(Component* child : detached)
+    {
+        child->Delete(true); // Recursively free children
     }
     return;
 }
 
 void sys_sage::Component::Delete(bool withSubtree)
 {
+    //recorded before the subtree is detached (only its root is recorded)
+    Topology* tracking = GetParent() != NULL ? GetParent()->_FindChangeTracking() : nullptr;
+    if(tracking != nullptr)
+        tracking->_RecordDeletion(this, false, withSubtree);
+
+    if (withSubtree && componentType == ComponentType::Topology && static_cast<Topology*>(this)->GetArena() != nullptr)
+    {
+        static_cast<Topology*>(this)->_DeleteWithArena();
+        return;
+    }
+
     // Delete subtree and all data paths
     if (withSubtree)
     {
@@ -715,24 +915,359 @@ void sys_sage::Component::Delete(bool withSubtree)
     }
     else //if(GetParent() == NULL && !withSubtree)
     {
-        while(children.size() > 0)
-        {       
-            RemoveChild(children[0]); // Recursively free children
-            children[0]->SetParent(NULL);
+        for(Component* child : children)
+        {
+            _OnSubtreeDetached(child);
+            child->SetParent(NULL);
+            child->siblingIndex = -1;
+            child->_SetSubtreeDepth(0);
         }
+        children.clear();
+        _DropChildIdMap();
     }
     // Delete the component itself
     delete this;
 }
 
 const std::string& sys_sage::Component::GetName() const {return name;}
-void sys_sage::Component::SetName(std::string _name){ name = _name; }
+void sys_sage::Component::SetName(std::string _name){ name = _name; MarkModified(); }
+uint64_t sys_sage::Component::GetVersion() const { return std::atomic_ref<uint64_t>(const_cast<uint64_t&>(version)).load(std::memory_order_relaxed); }
+void sys_sage::Component::MarkModified() { std::atomic_ref<uint64_t>(version).store(_NextVersion(), std::memory_order_relaxed); }
 sys_sage::Component* sys_sage::Component::GetParent() const {return parent;}
 void sys_sage::Component::SetParent(Component* _parent){parent = _parent;}
 const std::vector<sys_sage::Component*>& sys_sage::Component::GetChildren() const {return children;}
+sys_sage::PreOrderRange sys_sage::Component::PreOrder(ComponentType::mask typeMask, int maxDepth) { return PreOrderRange(this, typeMask, maxDepth); }
+sys_sage::PostOrderRange sys_sage::Component::PostOrder(ComponentType::mask typeMask, int maxDepth) { return PostOrderRange(this, typeMask, maxDepth); }
+sys_sage::BreadthFirstRange sys_sage::Component::BreadthFirst(ComponentType::mask typeMask, int maxDepth) { return BreadthFirstRange(this, typeMask, maxDepth); }
 std::vector<sys_sage::Component*>& sys_sage::Component::_GetChildren() {return children;}
 sys_sage::ComponentType::type sys_sage::Component::GetComponentType() const {return componentType;}
 int sys_sage::Component::GetId() const {return id;}
+int sys_sage::Component::GetCount() const {return count > 1 ? count : 1;}
+bool sys_sage::Component::IsCollapsed() const {return count > 1;}
+bool sys_sage::Component::IsShared() const
+{
+    for(const Component* c = this; c != NULL; c = c->GetParent())
+    {
+        if(c->IsCollapsed())
+            return true;
+    }
+    return false;
+}
+
+int sys_sage::Component::SetCount(int _count)
+{
+    _SetCount(_count > 1 ? _count : -1);
+    MarkModified();
+    return 0;
+}
+
+void sys_sage::Component::_SetCount(int _count)
+{
+    bool wasCollapsed = count > 1;
+    count = _count;
+    if(wasCollapsed == (count > 1))
+        return;
+    //the id lookups of the parent and of the indexed Topologies match the id ranges of their collapsed components separately
+    if(parent != NULL && parent->childIdMap != nullptr)
+        parent->childIdMapHasCollapsed |= count > 1;
+    for(Component* c = this; c != NULL; c = c->GetParent())
+    {
+        if(c->GetComponentType() == ComponentType::Topology)
+            static_cast<Topology*>(c)->_OnCountChanged(this);
+    }
+}
+
+bool sys_sage::Component::_RepresentsId(int _id) const
+{
+    return _id == id || (count > 1 && _id > id && static_cast<int64_t>(_id) < static_cast<int64_t>(id) + count);
+}
+
+sys_sage::Component* sys_sage::Component::SplitCollapsed(int _id)
+{
+    if(!_RepresentsId(_id))
+        return nullptr;
+    if(_id == id)
+        return this;
+    //the split does not change what the component tree represents; the copies are written as they are
+    SharedWriteScope scope;
+    std::unordered_map<Component*, Component*> copies;
+    Component* c = _CloneSubtree(&copies);
+    if(c == nullptr)
+        return nullptr;
+    int total = GetCount();
+    c->id = _id;
+    c->_SetCount(id + total - _id > 1 ? id + total - _id : -1);
+    _SetCount(_id - id > 1 ? _id - id : -1);
+    MarkModified();
+    if(parent != NULL)
+        parent->_InsertChildAfter(this, c);
+    //the copies take part in the same Relations; each Relation is copied once, at its first component in the subtree
+    //(iterate over copies of the relation vectors, as the vectors of the components outside of the subtree grow)
+    for(Component* orig : PreOrder())
+    {
+        for(RelationType::type rt : RelationType::RelationTypeList)
+        {
+            std::vector<Relation*> rs = orig->relations[rt];
+            for(Relation* r : rs)
+            {
+                const std::vector<Component*>& rc = r->GetComponents();
+                if(*std::find_if(rc.begin(), rc.end(), [&copies](Component* x) { return copies.count(x) != 0; }) == orig)
+                    r->_CloneReplacing(copies);
+            }
+        }
+    }
+    return c;
+}
+
+void sys_sage::Component::_MaterializeIfShared()
+{
+    if(sharedWriteScopes > 0 || !IsShared())
+        return;
+    std::vector<Component*> collapsed;
+    for(Component* c = this; c != NULL; c = c->GetParent())
+    {
+        if(c->IsCollapsed())
+            collapsed.push_back(c);
+    }
+    for(auto c = collapsed.rbegin(); c != collapsed.rend(); ++c)
+    {
+        if((*c)->SplitCollapsed((*c)->id + 1) == nullptr)
+            std::cerr << "WARNING: sys_sage::Component::_MaterializeIfShared: the subtree of collapsed " << (*c)->GetComponentTypeStr() << " " << (*c)->id << " cannot be copied; the change applies to all " << (*c)->GetCount() << " represented components" << std::endl;
+    }
+}
+
+sys_sage::SharedWriteScope::SharedWriteScope() { sharedWriteScopes++; }
+sys_sage::SharedWriteScope::~SharedWriteScope() { sharedWriteScopes--; }
+bool sys_sage::SharedWriteScope::IsActive() { return sharedWriteScopes > 0; }
+
+sys_sage::Component* sys_sage::Component::ExpandInstance(int _id)
+{
+    Component* c = SplitCollapsed(_id);
+    if(c == nullptr || !c->IsCollapsed())
+        return c;
+    //split off the instances after _id
+    return c->SplitCollapsed(_id + 1) != nullptr ? c : nullptr;
+}
+
+std::vector<sys_sage::Component*> sys_sage::Component::ExpandAll()
+{
+    std::vector<Component*> ret{this};
+    while(ret.back()->IsCollapsed())
+    {
+        Component* c = ret.back()->SplitCollapsed(ret.back()->id + 1);
+        if(c == nullptr)
+            break;
+        ret.push_back(c);
+    }
+    return ret;
+}
+
+void sys_sage::Component::_InsertChildAfter(Component* after, Component* child)
+{
+    InsertChild(child);
+    int idx = _FindChildIndex(after);
+    if(idx < 0)
+        return;
+    std::rotate(children.begin() + idx + 1, children.end() - 1, children.end());
+    _ReindexChildren(idx + 1);
+}
+
+sys_sage::Component* sys_sage::Component::_CloneInstance() const
+{
+    //subclasses without a copy override must not be sliced into a generic Component
+    return componentType == ComponentType::None ? new Component(*this) : nullptr;
+}
+
+sys_sage::Component* sys_sage::Component::_CloneSubtree(std::unordered_map<Component*, Component*>* copies) const
+{
+    Component* root = _CloneInstance();
+    if(root == nullptr)
+        return nullptr;
+    copies->emplace(const_cast<Component*>(this), root);
+    for(Component* child : children)
+    {
+        Component* c = child->_CloneSubtree(copies);
+        if(c == nullptr)
+        {
+            root->Delete(true);
+            return nullptr;
+        }
+        root->InsertChild(c);
+    }
+    return root;
+}
+
+//true if SplitCollapsed() can copy the subtree of root (the classes overriding _CloneInstance() and the Relation types overriding _CloneReplacing())
+static bool _IsCopyableSubtree(sys_sage::Component* root)
+{
+    using namespace sys_sage;
+    for(Component* c : root->PreOrder())
+    {
+        switch(c->GetComponentType())
+        {
+            case ComponentType::None: case ComponentType::Node: case ComponentType::Thread: case ComponentType::Core: case ComponentType::Cache:
+            case ComponentType::Subdivision: case ComponentType::Numa: case ComponentType::Chip: case ComponentType::Memory: case ComponentType::Storage:
+                break;
+            default:
+                return false;
+        }
+        for(RelationType::type rt : RelationType::RelationTypeList)
+        {
+            if(rt != RelationType::Relation && rt != RelationType::DataPath && !c->GetRelations(rt).empty())
+                return false;
+        }
+    }
+    return true;
+}
+
+int sys_sage::Component::CollapseIdenticalSubtrees(ComponentType::mask typeMask)
+{
+    //bottom-up, so that the subtrees are collapsed inside before they are compared
+    std::vector<Component*> parents;
+    for(Component* c : PreOrder())
+    {
+        if(c->children.size() > 1)
+            parents.push_back(c);
+    }
+    BinaryWriter w; //shared string table, so that equal strings get equal offsets
+    std::vector<uint64_t> headSignature, signature;
+    int deleted = 0;
+    for(auto p = parents.rbegin(); p != parents.rend(); ++p)
+    {
+        //each child is compared with the first child of the current run; the runs are collapsed afterwards
+        std::vector<std::pair<Component*, std::vector<Component*>>> runs;
+        bool headOk = false;
+        for(Component* c : (*p)->children)
+        {
+            bool ok = (typeMask & ComponentType::ToMask(c->componentType)) != 0 && _IsCopyableSubtree(c);
+            signature.clear();
+            ok = ok && _AppendSubtreeSignature(&w, c, &signature);
+            if(ok && headOk && !runs.empty())
+            {
+                Component* head = runs.back().first;
+                const std::vector<Component*>& members = runs.back().second;
+                Component* last = members.empty() ? head : members.back();
+                if(c->componentType == head->componentType && static_cast<long long>(last->id) + last->GetCount() == c->id && signature == headSignature)
+                {
+                    runs.back().second.push_back(c);
+                    continue;
+                }
+            }
+            runs.push_back({c, {}});
+            headOk = ok;
+            headSignature.swap(signature);
+        }
+
+        for(auto& [head, members] : runs)
+        {
+            if(members.empty())
+                continue;
+            long long count = head->GetCount();
+            for(Component* c : members)
+            {
+                count += c->GetCount();
+                for(Component* d : c->PreOrder())
+                {
+                    (void)d;
+                    deleted++;
+                }
+                c->Delete(true);
+            }
+            head->SetCount(static_cast<int>(count));
+        }
+    }
+    return deleted;
+}
+
+static std::atomic<uint64_t> currentVersion{0};
+uint64_t sys_sage::GetCurrentVersion() { return currentVersion.load(std::memory_order_relaxed); }
+uint64_t sys_sage::_NextVersion() { return currentVersion.fetch_add(1, std::memory_order_relaxed) + 1; }
+
+sys_sage::Component::~Component()
+{
+    delete childIdMap;
+    delete publishedRelations;
+    delete attributes;
+}
+
+bool sys_sage::Component::HasAttribute(AttributeKey::type key) const
+{
+    const AttributeStore* store = GetAttributes();
+    return store != nullptr && store->Contains(key);
+}
+bool sys_sage::Component::HasAttribute(const std::string& key) const { return HasAttribute(AttributeKey::Find(key)); }
+int sys_sage::Component::RemoveAttribute(AttributeKey::type key)
+{
+    if(!HasAttribute(key))
+        return 0;
+    AttributeStore* store = _BeginAttributeWrite(key);
+    int ret = store->Remove(key);
+    _EndAttributeWrite(store);
+    return ret;
+}
+int sys_sage::Component::RemoveAttribute(const std::string& key) { return RemoveAttribute(AttributeKey::Find(key)); }
+int sys_sage::Component::DecodeAttribute(AttributeKey::type key)
+{
+    const AttributeStore* store = GetAttributes();
+    const AttributeStore::Entry* e = store != nullptr ? store->GetEntry(key) : nullptr;
+    if(e == nullptr || e->type != AttributeType::Lazy)
+        return 0;
+    //the decoder stores the value under the same key (replacing the LazyAttribute) or in the attrib map; the LazyAttribute is kept until decoding succeeded
+    //decoding is a read, so a shared component is not materialized
+    SharedWriteScope scope;
+    LazyAttribute lazy = *static_cast<const LazyAttribute*>(e->Get());
+    if(lazy.decode(lazy.payload, this) != 0)
+    {
+        std::cerr << "WARNING: sys_sage::Component::DecodeAttribute could not decode attribute " << AttributeKey::GetName(key) << std::endl;
+        return -1;
+    }
+    store = GetAttributes();
+    e = store != nullptr ? store->GetEntry(key) : nullptr;
+    if(e != nullptr && e->type == AttributeType::Lazy)
+        RemoveAttribute(key);
+    return 1;
+}
+int sys_sage::Component::DecodeAttribute(const std::string& key) { return DecodeAttribute(AttributeKey::Find(key)); }
+int sys_sage::Component::DecodeAllAttributes(bool withSubtree)
+{
+    int ret = 0;
+    for(Component* c : PreOrder(ComponentType::AnyMask, withSubtree ? -1 : 0))
+    {
+        const AttributeStore* store = c->GetAttributes();
+        if(store == nullptr)
+            continue;
+        std::vector<AttributeKey::type> lazyKeys;
+        for(const AttributeStore::Entry& e : store->GetEntries())
+            if(e.type == AttributeType::Lazy)
+                lazyKeys.push_back(e.key);
+        for(AttributeKey::type key : lazyKeys)
+            if(c->DecodeAttribute(key) > 0)
+                ret++;
+    }
+    return ret;
+}
+const sys_sage::AttributeStore* sys_sage::Component::GetAttributes() const { return std::atomic_ref<AttributeStore*>(const_cast<AttributeStore*&>(attributes)).load(std::memory_order_acquire); }
+
+sys_sage::AttributeStore* sys_sage::Component::_BeginAttributeWrite(AttributeKey::type key)
+{
+    _MaterializeIfShared();
+    EpochDomain* domain = _FindEpochDomain();
+    if(domain != nullptr)
+        return domain->_BeginAttributeWrite(attributes, key);
+    if(attributes == nullptr)
+        attributes = new AttributeStore();
+    return attributes;
+}
+
+void sys_sage::Component::_EndAttributeWrite(AttributeStore* store)
+{
+    if(store != attributes)
+        _FindEpochDomain()->_PublishAttributes(&attributes, store);
+    MarkModified();
+}
+
+void* sys_sage::Component::operator new(size_t size) { return _ArenaAwareAllocate(size); }
+void sys_sage::Component::operator delete(void* ptr) { _ArenaAwareFree(ptr); }
 
 sys_sage::Component::Component(int _id, std::string _name, ComponentType::type _componentType) : id(_id), name(_name), componentType(_componentType)
 {
@@ -747,5 +1282,13 @@ sys_sage::Component::Component(Component * parent, int _id, std::string _name, C
         parent->InsertChild(this);
     }
 }
+sys_sage::Component::Component(const Component& other) : id(other.id), name(other.name), componentType(other.componentType)
+{
+    _SetCount(other.count);
+    SetParent(NULL);
+    const AttributeStore* store = other.GetAttributes();
+    if(store != nullptr)
+        attributes = new AttributeStore(*store);
+}
 sys_sage::Component::Component(int _id, std::string _name): Component(_id, _name, sys_sage::ComponentType::None) {}
 sys_sage::Component::Component(Component * parent, int _id, std::string _name): Component(parent, _id, _name, sys_sage::ComponentType::None) {}
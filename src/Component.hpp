@@ -2,13 +2,17 @@
 #define COMPONENT
 
 #include <array>
+#include <atomic>
 #include <iostream>
 #include <vector>
 #include <map>
 #include <set>
+#include <unordered_map>
 
 #include "defines.hpp"
 #include "enums.hpp"
+#include "Attribute.hpp"
+#include "ComponentTraversal.hpp"
 #include "DataPath.hpp"
 #include <libxml/parser.h>
 
@@ -16,6 +20,12 @@
 
 namespace sys_sage { //forward declaration
     class Topology;
+    class XmlStreamWriter;
+    class BinaryWriter;
+    class BinaryTopologyView;
+    struct BinaryComponentRecord;
+    class EpochDomain;
+    struct MemoryFootprint;
 
     class Relation;
     class DataPath;
@@ -26,6 +36,18 @@ namespace sys_sage { //forward declaration
 namespace sys_sage {
     //SVTODO make sure parameters such as ComponentType are of the correct type
 
+    /**
+     * @brief Returns the current value of the global modification counter. Every change of a Component or Relation advances the counter and stores its new value as the version of the changed object
+     * (see Component::GetVersion(), Relation::GetVersion()).
+     * \n A value taken right before an export can be passed as sinceVersion to the next exportDeltaToXml().
+     */
+    uint64_t GetCurrentVersion();
+    /**
+     * @private
+     * @brief Advances the global modification counter and returns its new value.
+     */
+    uint64_t _NextVersion();
+
     /**
      * @class Component
      * @brief Generic class for all hardware and logical components in sys-sage.
@@ -60,7 +82,15 @@ namespace sys_sage {
          * @private
          * @brief Use Delete() or DeleteSubtree() for deleting and deallocating the components.
          */
-        virtual ~Component() = default;
+        virtual ~Component();
+        /**
+         * @brief Allocates a Component. If an arena is active on the calling thread (see ArenaScope), the Component is placed in it.
+         */
+        static void* operator new(size_t size);
+        /**
+         * @brief Deallocates a Component (a no-op for Components placed in an arena, which are reclaimed with the arena).
+         */
+        static void operator delete(void* ptr);
         /**
          * @brief Inserts a child component to this component (in the Component Tree).
          * The child pointer will be inserted at the end of the children vector.
@@ -100,17 +130,25 @@ namespace sys_sage {
         */
         int InsertBetweenParentAndChildren(Component* parent, std::vector<Component*> children, bool alreadyParentsChild);
 
-        /**
-        Removes the passed component from the list of children, without completely deleting (and deallocating) the child itself
-        @param child - child to remove
-        @return how many elements were deleted (normally, 0 or 1 should be possible)
-        */
         /**
          * @brief Removes the passed component from the list of children, without completely deleting (and deallocating) the child itself
+         * \n Finding the child is O(1) (through its stored sibling index). By default, the order of the remaining children is preserved, which makes the removal
+         * O(number of children) (the following children move one position forward). With preserveOrder = false, the last child takes the place of the removed one, which is O(1).
+         * \n The removed child becomes the root of its own tree: its parent is set to NULL and the depths of its subtree are reset.
          * @param child Child to remove
+         * @param preserveOrder If true (default), the remaining children keep their order; if false, the last child is moved to the position of the removed child.
          * @return Number of elements deleted (normally 0 or 1)
          */
-        int RemoveChild(Component * child);
+        int RemoveChild(Component * child, bool preserveOrder = true);
+        /**
+         * @brief Moves a set of children of this component to a new parent in a single pass over the children list.
+         * The relative order of the remaining children is preserved; the moved children are appended to newParent's children in the order given.
+         * @param _children Children of this component to move
+         * @param newParent The new parent of _children
+         * @return 0 on success; 1 if one or more of _children are not children of this component (nothing is moved in that case).
+         * @see InsertBetweenParentAndChildren()
+         */
+        int ReparentChildren(const std::vector<Component*>& _children, Component* newParent);
         /**
          * @brief Set a parent to the component.
          * This is usually used when inserting a component in the tree (by calling InsertChild on the parent, and calling SetParent on the child).
@@ -161,12 +199,90 @@ namespace sys_sage {
          * @see name
          */
         void SetName(std::string _name);
+        /**
+         * @brief Returns the version of the component: the value of the global modification counter (see GetCurrentVersion()) at its last change.
+         * The version is updated on creation, by the property setters (SetName(), Cache::SetCacheSize(), ...), by writes of typed attributes and when the component is moved in the Component Tree (InsertChild(), RemoveChild(), ...).
+         * @see exportDeltaToXml()
+         */
+        uint64_t GetVersion() const;
+        /**
+         * @brief Updates the version of the component (see GetVersion()). Needed after changes that sys-sage does not see, e.g. of the legacy attrib map.
+         */
+        void MarkModified();
         /**
          * @brief Returns id of the component.
          * @return id
          * @see id
          */
         int GetId() const;
+        /**
+         * @brief Returns the number of identical components represented by this component (1, unless it is collapsed; see SetCount()).
+         * @see count
+         */
+        int GetCount() const;
+        /**
+         * @brief Collapses identical siblings into this component: it then stands for _count components with the ids id, id+1, ..., id+_count-1,
+         * which share all properties, attributes, and Relations of this component, as well as its subtree (which is stored once for all of them).
+         * \n Counting queries (CountAllSubcomponents(), CountAllSubcomponentsByType(), CountAllChildrenByType()) count all represented components (and the subtree once per represented component),
+         * and GetChildById() and GetSubcomponentById() return this component for each of the represented ids. Enumerating queries (GetChildren(), GetAllSubcomponentsByType(), PreOrder(), ...) return it (and its subtree) once.
+         * \n Writes are copy-on-write: a typed attribute written with SetAttribute()/RemoveAttribute(), a child inserted with InsertChild(), or a Relation added to a shared component (see IsShared())
+         * first materializes a private copy (see SplitCollapsed()), so that the change applies to the first represented instance only (the one with the id of the collapsed component).
+         * Within a SharedWriteScope, such changes apply to all represented components instead.
+         * \n CollapseIdenticalSubtrees() finds and collapses identical siblings automatically.
+         * @param _count Number of represented components; values below 2 make this a single component again.
+         * @return 0
+         * @see count
+         */
+        int SetCount(int _count);
+        /**
+         * @brief Returns true if this component represents more than one component (see SetCount()).
+         */
+        bool IsCollapsed() const;
+        /**
+         * @brief Returns true if changes of this component apply to more than one represented component, i.e. if it is collapsed itself or lies in the subtree of a collapsed component
+         * (which is stored once for all represented components; see SetCount()). Writes to a shared component materialize a private copy first. O(depth).
+         */
+        bool IsShared() const;
+        /**
+         * @brief Splits a collapsed component (see SetCount()): this component keeps the ids below _id, a new sibling (placed right after it) represents the ids from _id on.
+         * The new component is a deep copy of this one: the properties and typed attributes of all components of the subtree, and the Relations of type Relation and DataPath of the subtree
+         * (with the components of the subtree replaced by their copies; Relations between the subtree and other components are copied, too). The legacy attrib maps are not copied.
+         * @param _id First id of the second part, in [GetId(), GetId() + GetCount()).
+         * @return The component representing the ids from _id on (this component if _id == GetId()), or nullptr if _id is not represented by this component
+         * or the subtree cannot be copied (only generic Components and the hardware components Node, Thread, Core, Cache, Subdivision, Numa, Chip, Memory, and Storage can).
+         */
+        Component* SplitCollapsed(int _id);
+        /**
+         * @private
+         * @brief Copy-on-write step before a write to this component (see SetCount()): if it is shared and no SharedWriteScope is active, every collapsed component on the path from the root
+         * to this component (the top-most first) is split after its first instance, so that this component then stands for a single, private instance.
+         */
+        void _MaterializeIfShared();
+        /**
+         * @brief Materializes one instance of a collapsed component (see SetCount()), e.g. to attach a Relation or an attribute to it alone.
+         * The instances around _id stay collapsed in this component and (if there are instances after _id) in a new sibling; see SplitCollapsed().
+         * @param _id Id of the instance, in [GetId(), GetId() + GetCount()).
+         * @return The component representing only the instance _id, or nullptr if _id is not represented by this component or the component cannot be copied.
+         */
+        Component* ExpandInstance(int _id);
+        /**
+         * @brief Materializes all instances of a collapsed component (see ExpandInstance()).
+         * @return The components of all instances ordered by id (this component first); only this component if it cannot be copied.
+         */
+        std::vector<Component*> ExpandAll();
+        /**
+         * @brief Detects identical subtrees in the subtree of this component and stores each of them once: every run of siblings with consecutive ids whose subtrees are identical
+         * is collapsed into its first component (see SetCount()), and the other components of the run are deleted together with their subtrees.
+         * \n Two subtrees are identical if they differ only in the id (and count) of their roots: same component types, ids, names, class members, typed attributes, and children,
+         * and the same Relations (with the same properties and attributes, between corresponding components, or to the same components outside of the subtrees).
+         * The subtrees are compared by their binary encoding (see exportToBinary()).
+         * Subtrees holding data that cannot be compared or copied (legacy attrib entries, attributes of AttributeType::Custom, QuantumGates, CouplingMaps, quantum components) are not collapsed.
+         * \n Example: after parsing the same hwloc output into 4000 Nodes with the ids 0...3999, topo->CollapseIdenticalSubtrees(ComponentType::ToMask(ComponentType::Node)) keeps one Node with count 4000.
+         * A Node that gets its own attributes or measured DataPaths is materialized when they are written (see SetCount()).
+         * @param typeMask Only runs of components of these types are collapsed (see ComponentType::ToMask()).
+         * @return The number of deleted components.
+         */
+        int CollapseIdenticalSubtrees(ComponentType::mask typeMask = ComponentType::AnyMask);
         /**
          * @brief Returns component type of the component.
          * The component type denotes which class the instance is (often stored as Component*, even though they are a member of one of the child classes).
@@ -207,6 +323,11 @@ namespace sys_sage {
         * Should there be more children with the same id, the first match will be retrieved (i.e. the one with lower index in the children array.)
         */
         Component* GetChildById(int _id) const;
+        /**
+         * @brief Number of children above which GetChild/GetChildById build an id -> child hash map for this component.
+         * The map is built lazily on the first lookup and kept up to date by InsertChild and RemoveChild.
+         */
+        static constexpr size_t childIdMapThreshold = 32;
 
         /**
         * @brief Retrieve a Component* to a child matching the given component type.
@@ -233,12 +354,18 @@ namespace sys_sage {
         void GetAllChildrenByType(std::vector<Component *> *_outArray, ComponentType::type _componentType) const;
         /**
         * @brief Searches the subtree to find a component with a matching id and componentType, i.e. looks for a certain component with a matching ID. The search is a DFS. The search starts with the calling component.
+        * \n If the component resides in a Topology with an enabled component index (see Topology::EnableComponentIndex()), the lookup is answered from the index (the DFS is only used when the subtree contains multiple matches).
         * @return Returns first occurence that matches these criteria.
         * @param _id - the id to look for
         * @param _componentType - the component type where to look for the id
         * @return Component * matching the criteria. Returns the first match. NULL if no match found
         */
         Component* GetSubcomponentById(int _id, ComponentType::type _componentType);
+        /**
+         * @private
+         * @brief Helper of GetSubcomponentById() -- DFS over the subtree, does not use any index.
+         */
+        Component* _GetSubcomponentByIdDfs(int _id, ComponentType::type _componentType);
 
         /**
          * @brief Searches for all the subcomponents (children, their children and so on) matching the given component type.
@@ -262,21 +389,21 @@ namespace sys_sage {
          * @brief Counts number of subcomponents (children, grandchildren, etc.).
          * @return Number of subcomponents
          */
-        int CountAllSubcomponents() const;
+        long long CountAllSubcomponents() const;
         
         /**
          * @brief Counts number of subcomponents (children, their children and so on) matching the requested component type.
          * @param _componentType - ComponentType to look for.
          * @return Returns number of subcomponents matching the requested component type.
          */
-        int CountAllSubcomponentsByType(ComponentType::type _componentType) const;
+        long long CountAllSubcomponentsByType(ComponentType::type _componentType) const;
 
         /**
         * @brief Counts number of children matching the requested component type.
         * @param _componentType - ComponentType to look for.
         * @return Returns number of children matching the requested component type.
         */
-        int CountAllChildrenByType(ComponentType::type _componentType) const;
+        long long CountAllChildrenByType(ComponentType::type _componentType) const;
 
         /**
          * @brief Moves up the tree until a parent of the given type is found.
@@ -284,6 +411,25 @@ namespace sys_sage {
          * @return Pointer to the ancestor, or nullptr if not found
          */
         Component* GetAncestorByType(ComponentType::type _componentType);
+        /**
+         * @brief Returns the lowest common ancestor of this component and other, i.e. the deepest component whose subtree contains both (may be this or other itself).
+         * Uses the cached depths, i.e. it walks up only from the deeper component to the LCA: O(distance to the LCA).
+         * @param other The other component
+         * @return The lowest common ancestor, or nullptr if the components are in different trees
+         */
+        Component* GetLowestCommonAncestor(const Component* other) const;
+        /**
+         * @brief Returns the components shared by this component and other: the lowest common ancestor and all its ancestors (up to the root), filtered by typeMask.
+         * E.g. GetSharedComponents(t2, ComponentType::ToMask(ComponentType::Cache)) returns the caches shared by two hardware threads.
+         * @param other The other component
+         * @param typeMask Component types to return (default: all)
+         * @return The shared components, ordered from the lowest common ancestor upwards (empty if the components are in different trees)
+         */
+        std::vector<Component*> GetSharedComponents(const Component* other, ComponentType::mask typeMask = ComponentType::AnyMask) const;
+        /**
+         * @brief Pushes back the components shared by this component and other (see GetSharedComponents(const Component* other, ComponentType::mask typeMask)).
+         */
+        void GetSharedComponents(std::vector<Component*>* outArray, const Component* other, ComponentType::mask typeMask = ComponentType::AnyMask) const;
         /**
          * @brief Retrieves maximal distance to a leaf (i.e. the depth of the subtree).
          * 0=leaf, 1=children are leaves, 2=at most children's children are leaves .....
@@ -350,11 +496,57 @@ namespace sys_sage {
          */
         std::vector<Component*> GetComponentsInSubtree();
 
+        /**
+         * @brief Returns a range over the subtree of this component (including this component) in pre-order (DFS; parent first, children in the order of the children vector).
+         * The traversal uses an explicit stack and does not allocate. Usable in range-based for loops and with std::ranges algorithms.
+         * @param typeMask Only components of the selected types are returned, e.g. ComponentType::ToMask(ComponentType::Thread) (default: all types)
+         * @param maxDepth Components more than maxDepth levels below this component are skipped (default: -1 = unlimited)
+         * @return Range of Component* (see PreOrderIterator)
+         * \n Example: for(Component* c : node->PreOrder(ComponentType::ToMask(ComponentType::Core))) {...}
+         */
+        PreOrderRange PreOrder(ComponentType::mask typeMask = ComponentType::AnyMask, int maxDepth = -1);
+        /**
+         * @brief Returns a range over the subtree of this component (including this component) in post-order (DFS; children first, this component last).
+         * The traversal uses an explicit stack and does not allocate. Usable in range-based for loops and with std::ranges algorithms.
+         * @param typeMask Only components of the selected types are returned (default: all types)
+         * @param maxDepth Components more than maxDepth levels below this component are skipped (default: -1 = unlimited)
+         * @return Range of Component* (see PostOrderIterator)
+         */
+        PostOrderRange PostOrder(ComponentType::mask typeMask = ComponentType::AnyMask, int maxDepth = -1);
+        /**
+         * @brief Returns a range over the subtree of this component (including this component) in breadth-first order (level by level).
+         * The traversal does not allocate. Usable in range-based for loops and with std::ranges algorithms.
+         * @param typeMask Only components of the selected types are returned (default: all types)
+         * @param maxDepth Components more than maxDepth levels below this component are skipped (default: -1 = unlimited)
+         * @return Range of Component* (see BreadthFirstIterator)
+         */
+        BreadthFirstRange BreadthFirst(ComponentType::mask typeMask = ComponentType::AnyMask, int maxDepth = -1);
+
+        /**
+         * @brief Calls a visitor on every component of the subtree (including this component) in pre-order, until the visitor asks to stop.
+         * @param visitor Callable taking a Component* and returning bool -- true to continue, false to terminate the traversal.
+         * @param typeMask The visitor is only called for components of the selected types (default: all types)
+         * @return true if the whole subtree was visited; false if the visitor terminated the traversal early.
+         * \n Example: Component* first = nullptr; root->VisitSubtree([&](Component* c){ first = c; return false; }, ComponentType::ToMask(ComponentType::Thread));
+         */
+        template <class Visitor>
+        bool VisitSubtree(Visitor&& visitor, ComponentType::mask typeMask = ComponentType::AnyMask)
+        {
+            for(Component* c : PreOrder(typeMask))
+            {
+                if(!visitor(c))
+                    return false;
+            }
+            return true;
+        }
+
         /**
          * @brief Returns a (const) reference to the internal vector of relations for a given type.
          * @param relationType Type of relation (see RelationType for available types). Only use specific Relation Types, not RelationType::Any (you will get an empty vector).
          * @return const std::vector<Relation*>& (reference to internal structure)
          * @note The vector is const so that the Relations of a Component cannot be manipulated this way. Use new Relation()/DeleteRelation() to modify the list of Relations, or access the Relations' API directly.
+         * @note Deleting a Relation moves the last Relation of the vector to the freed position, i.e. the order of the vector is not stable across deletions.
+         * @note If concurrent reads are enabled (see Topology::EnableConcurrentReads()), threads without a WriteGuard get the published (immutable) copy of the vector, which stays valid while they hold a ReadGuard.
          * @see FindAllRelationsBy(RelationType::type relationType = RelationType::Any, int thisComponentPosition = -1) as an alternative offering more flexibility at the price of increased overhead through generating a new output vector.
          */
         const std::vector<Relation*>& GetRelations(RelationType::type relationType) const;
@@ -380,8 +572,54 @@ namespace sys_sage {
          * @brief Only called by Relation's AddComponent/UpdateComponent.
          * @param relationType Type of relation
          * @param r Pointer to the relation
+         * @return Position of r in this component's vector of relations of relationType (stored by the Relation as a back-index).
          */
-        void _AddRelation(RelationType::type relationType, Relation* r);
+        int32_t _AddRelation(RelationType::type relationType, Relation* r);
+        /**
+         * @private
+         * @brief Removes the relation at position slot from this component's vector of relations of relationType in O(1):
+         * the last relation of the vector is moved to slot, and its back-index is updated. Only called by Relation.
+         */
+        void _RemoveRelation(RelationType::type relationType, int32_t slot);
+        /**
+         * @private
+         * @brief Returns the nearest Topology ancestor (including this) with an enabled relation registry, or nullptr.
+         * @see Topology::EnableRelationRegistry()
+         */
+        Topology* _FindRelationRegistry() const;
+        /**
+         * @private
+         * @brief Returns the nearest Topology ancestor (including this) with enabled change tracking, or nullptr.
+         * @see Topology::EnableChangeTracking()
+         */
+        Topology* _FindChangeTracking() const;
+        /**
+         * @private
+         * @brief Returns the EpochDomain of the nearest Topology ancestor (including this) with enabled concurrent reads, or nullptr.
+         * @see Topology::EnableConcurrentReads()
+         */
+        EpochDomain* _FindEpochDomain() const;
+        /**
+         * @brief The relation vectors of a component, indexed by RelationType::type.
+         */
+        using RelationArray = std::array<std::vector<Relation*>, RelationType::_num_relation_types>;
+        /**
+         * @private
+         * @brief Publishes a copy of the relation vectors for concurrent readers. Called by EpochDomain and Topology.
+         * @return The previously published copy (to be retired), or nullptr
+         */
+        RelationArray* _PublishRelations();
+        /**
+         * @private
+         * @brief Withdraws the published copy of the relation vectors. Called by EpochDomain and Topology.
+         * @return The previously published copy (to be retired), or nullptr
+         */
+        RelationArray* _UnpublishRelations();
+        /**
+         * @private
+         * @brief Marks the relation vectors as changed in the EpochDomain (they are republished when the outermost WriteGuard is released).
+         */
+        void _MarkRelationsChanged();
 
         /**
          * @brief Retrieves a DataPath* from the list of this component's data paths with matching DataPathType and DataPathDirection.
@@ -425,40 +663,78 @@ namespace sys_sage {
         */
         int CheckComponentTreeConsistency() const;
         /**
-         * @brief Calculates approximate memory footprint of the subtree of this element (including the relevant Relations).
-         * @param out_component_size output parameter (contains the footprint of the component tree elements); an already allocated unsigned * is the input, the value is expected to be 0 (the result is accumulated here)
-         * @param out_dataPathSize output parameter (contains the footprint of the data-path graph elements); an already allocated unsigned * is the input, the value is expected to be 0 (the result is accumulated here)
+         * @brief Calculates the memory footprint of the subtree of this element (including the relevant Relations, each counted once).
+         * \n For a breakdown by component type, relation type, attribute key, strings and vector slack, use GetMemoryFootprint(const Component* root).
+         * @param out_component_size output parameter (contains the footprint of the component tree elements, including their attributes and lookup indices); an already allocated unsigned * is the input, the value is expected to be 0 (the result is accumulated here)
+         * @param out_dataPathSize output parameter (contains the footprint of the Relations, including their attributes); an already allocated unsigned * is the input, the value is expected to be 0 (the result is accumulated here)
          * @return The total size in bytes
+         * @see GetMemoryFootprint(const Component* root)
          */
         int GetTopologySize(unsigned * out_component_size, unsigned * out_dataPathSize) const;
-        /**
-         * @private
-         * Helper function of int GetTopologySize(unsigned * out_component_size, unsigned * out_dataPathSize); -- normally you would call this one.
-         * \n Calculates approximate memory footprint of the subtree of this element (including the relevant data paths). Does not count DataPaths stored in counted_dataPaths.
-         * @param out_component_size - output parameter (contains the footprint of the component tree elements); an already allocated unsigned * is the input, the value is expected to be 0 (the result is accumulated here)
-         * @param out_dataPathSize - output parameter (contains the footprint of the data-path graph elements); an already allocated unsigned * is the input, the value is expected to be 0 (the result is accumulated here)
-         * @param counted_dataPaths - std::set<DataPath*>* of data paths that should not be counted
-         * @return The total size in bytes
-         * @see GetTopologySize(unsigned * out_component_size, unsigned * out_dataPathSize);
-         */
-        int _GetTopologySize(unsigned * out_component_size, unsigned * out_RelationSize, std::set<Relation*>* countedRelations) const;
 
         /**
          * @brief Retrieves the depth (level) of a component in the topology.
-         * @param refresh If true, recalculate the position (depth) of the component in the tree; if false, return the already stored value
+         * The depth is cached and kept up to date by InsertChild (and thus by all functions that (re)attach components), so the stored value can be used directly.
+         * @param refresh If true, recalculate the position (depth) of the component in the tree by walking up to the root (only needed if the tree was modified via SetParent()/_GetChildren() directly); if false, return the stored value
          * @return Depth (level) of the component in the topology
          * @see depth
          */
-        int GetDepth(bool refresh);
+        int GetDepth(bool refresh = false);
+        /**
+         * @private
+         * @brief Sets the cached depth of this component to _depth and updates the depths in its subtree (no-op if the depth is already correct).
+         */
+        void _SetSubtreeDepth(int _depth);
 
         /**
          * @private
-         * @brief Helper for XML dump generation.
+         * @brief Helper for XML dump generation: writes the XML element of this component, including its attributes and its subtree, to w.
+         * Subclasses write their own XML attributes between _WriteXmlStart() and _WriteXmlContent().
          * Should normally not be used directly. Used internally for exporting the topology to XML.
          * @see exportToXml(Component* root, string path = "", std::function<int(string,void*,string*)> custom_search_attrib_key_fcn = NULL)
-         * @return Pointer to the created XML subtree node.
          */
-        virtual xmlNodePtr _CreateXmlSubtree();
+        virtual void _WriteXml(XmlStreamWriter* w);
+        /**
+         * @private
+         * @brief Opens the XML element of this component and writes the common XML attributes (id, name, count, addr).
+         */
+        void _WriteXmlStart(XmlStreamWriter* w);
+        /**
+         * @private
+         * @brief Writes the (typed and legacy) attributes and the child components into the open XML element of this component; the element stays open.
+         */
+        void _WriteXmlContent(XmlStreamWriter* w);
+        /**
+         * @private
+         * @brief Helper for the binary export: stores the common members (id, name, count) and the members of the subclass (as type-specific fields with BinaryWriter::AddField(), see BinaryComponentRecord).
+         * Overrides call the implementation of their base class first.
+         * @see exportToBinary(Component* root, std::string path)
+         */
+        virtual void _WriteBinaryFields(BinaryWriter* w, BinaryComponentRecord* rec) const;
+        /**
+         * @private
+         * @brief Helper for the binary import: restores the members stored by _WriteBinaryFields(). Overrides call the implementation of their base class first.
+         * @see importFromBinary(std::string path)
+         */
+        virtual void _ReadBinaryFields(const BinaryTopologyView* v, const BinaryComponentRecord* rec);
+        /**
+         * @private
+         * @brief Returns a new component (without parent, children, and Relations) with the same class, properties, and typed attributes as this one, or nullptr if the class does not support copies.
+         * Used by SplitCollapsed(). Overridden by the classes that support copies.
+         */
+        virtual Component* _CloneInstance() const;
+        /**
+         * @private
+         * @brief Returns a copy of the subtree of this component (see _CloneInstance(); without Relations), or nullptr if a component of the subtree cannot be copied.
+         * @param copies Output: maps the components of the subtree to their copies.
+         */
+        Component* _CloneSubtree(std::unordered_map<Component*, Component*>* copies) const;
+        /**
+         * @private
+         * @brief Returns the heap memory owned by this component (not including the object itself); used by GetMemoryFootprint().
+         * Subclasses with heap members extend it. Lookup structures (e.g. the child id map) are added to footprint->indexBytes instead of the return value.
+         */
+        virtual size_t _GetOwnedMemory(MemoryFootprint* footprint) const;
         
         /**
          * @brief Deletes a Relation from this component as well as the Relation itself.
@@ -492,12 +768,151 @@ namespace sys_sage {
         /**
          * @brief Deletes a component, its children (if withSubtree = true), and all associated Relations.
          * If only the component itself is deleted, its children are inserted into its parent's children list.
+         * \n Deleting a Topology with an arena (see Topology::EnableArena()) together with its subtree releases the whole arena at once.
          * @param withSubtree If true, the whole subtree is deleted; otherwise only the component itself.
          */
         void Delete(bool withSubtree = true);
 
+        /**
+         * @private
+         * @brief Notifies all Topology ancestors (including this) that the subtree of _subtreeRoot was attached below this component, so that their (componentType, id) indices and relation registries stay up to date.
+         * Called by InsertChild(); should normally not be called directly.
+         * @see Topology::EnableComponentIndex()
+         */
+        void _OnSubtreeAttached(Component* _subtreeRoot);
+        /**
+         * @private
+         * @brief Notifies all Topology ancestors (including this) that the subtree of _subtreeRoot was detached from this component, so that their (componentType, id) indices and relation registries stay up to date.
+         * Called by RemoveChild(); should normally not be called directly.
+         * @see Topology::EnableComponentIndex()
+         */
+        void _OnSubtreeDetached(Component* _subtreeRoot);
+        /**
+         * @private
+         * @brief Returns the position of child in this component's children list, or -1 if it is not a child.
+         * O(1) via the stored sibling index; falls back to a linear search if the children list was modified directly (via _GetChildren()).
+         */
+        int _FindChildIndex(const Component* child) const;
+        /**
+         * @private
+         * @brief Refreshes the stored sibling indices of children[from...].
+         */
+        void _ReindexChildren(size_t from);
+        /**
+         * @private
+         * @brief Keeps the id -> child map (if built) consistent after child was removed from the children list.
+         */
+        void _EraseFromChildIdMap(const Component* child);
+        /**
+         * @private
+         * @brief Deallocates the id -> child map; it is rebuilt by the next GetChildById call if needed.
+         */
+        void _DropChildIdMap() const;
+        /**
+         * @private
+         * @brief Sets count and tells the parent's childIdMap and the indexed Topologies above about a component that became collapsed (or stopped being collapsed), see SetCount().
+         */
+        void _SetCount(int _count);
+        /**
+         * @private
+         * @brief Returns true if _id is one of the ids represented by this component (see SetCount()).
+         */
+        bool _RepresentsId(int _id) const;
+        /**
+         * @private
+         * @brief Inserts child into the children list right after the existing child after.
+         */
+        void _InsertChildAfter(Component* after, Component* child);
+
+        /**
+         * @brief Sets (inserts or overwrites) a typed attribute. The Component owns the value; it is destroyed together with the Component.
+         * Scalars (int, long long, uint64_t, float, double) are stored inline; other types are allocated once.
+         * \n Example: c->SetAttribute(AttributeKey::Clock_Frequency, 1.2e9); c->SetAttribute("my_key", std::string("value"));
+         * @param key Attribute key (see AttributeKey for the predefined keys)
+         * @param value The value
+         * @return Reference to the stored value
+         */
+        template <class T>
+        T& SetAttribute(AttributeKey::type key, T value)
+        {
+            static_assert(!std::is_same_v<T, const char*> && !std::is_same_v<T, char*>, "store strings as std::string");
+            AttributeStore* store = _BeginAttributeWrite(key);
+            T& ret = store->Set<T>(key, std::move(value));
+            _EndAttributeWrite(store);
+            return ret;
+        }
+        /**
+         * @brief Sets (inserts or overwrites) a typed attribute; the key name is interned.
+         */
+        template <class T>
+        T& SetAttribute(const std::string& key, T value) { return SetAttribute<T>(AttributeKey::Intern(key), std::move(value)); }
+        /**
+         * @brief Returns a pointer to the value of a typed attribute, or nullptr if the attribute does not exist or holds a different type than T.
+         * \n Example: double* f = c->GetAttribute<double>(AttributeKey::Clock_Frequency);
+         */
+        template <class T>
+        T* GetAttribute(AttributeKey::type key) const
+        {
+            const AttributeStore* store = GetAttributes();
+            if(store == nullptr)
+                return nullptr;
+            T* ret = store->Get<T>(key);
+            //a lazily imported value is decoded on the first access
+            if constexpr (AttributeTraits<T>::tag != AttributeType::Lazy)
+            {
+                if(ret == nullptr && const_cast<Component*>(this)->DecodeAttribute(key) > 0)
+                    ret = GetAttributes()->Get<T>(key);
+            }
+            return ret;
+        }
+        /**
+         * @brief Returns a pointer to the value of a typed attribute (looked up by name), or nullptr.
+         */
+        template <class T>
+        T* GetAttribute(const std::string& key) const { return GetAttribute<T>(AttributeKey::Find(key)); }
+        /**
+         * @brief Returns true if a typed attribute with the given key exists.
+         */
+        bool HasAttribute(AttributeKey::type key) const;
+        bool HasAttribute(const std::string& key) const;
+        /**
+         * @brief Removes (and destroys) a typed attribute.
+         * @return 1 if the attribute was removed, 0 if it did not exist
+         */
+        int RemoveAttribute(AttributeKey::type key);
+        int RemoveAttribute(const std::string& key);
+        /**
+         * @brief Decodes a lazily imported attribute (see XmlImportContext::lazyAttributes): the value is stored as a typed attribute or, if a custom import function handles it, in the attrib map.
+         * GetAttribute() calls this automatically; call it before reading a lazily imported attribute from the attrib map.
+         * \n Decoding writes to the component, so it must not run concurrently with other accesses to its attributes.
+         * @return 1 if the attribute was decoded, 0 if there is no lazy attribute with this key, -1 if decoding failed (the lazy attribute is kept)
+         */
+        int DecodeAttribute(AttributeKey::type key);
+        int DecodeAttribute(const std::string& key);
+        /**
+         * @brief Decodes all lazily imported attributes of this component (see DecodeAttribute()).
+         * @param withSubtree If true, the attributes of the whole subtree are decoded.
+         * @return Number of successfully decoded attributes
+         */
+        int DecodeAllAttributes(bool withSubtree = false);
+        /**
+         * @brief Returns the typed attributes of this Component (nullptr if it has none).
+         */
+        const AttributeStore* GetAttributes() const;
+        /**
+         * @private
+         * @brief Returns the store that SetAttribute()/RemoveAttribute() modify: the own store, or -- with concurrent reads enabled -- a copy-on-write copy (see EpochDomain).
+         */
+        AttributeStore* _BeginAttributeWrite(AttributeKey::type key);
+        /**
+         * @private
+         * @brief Publishes the store returned by _BeginAttributeWrite() (if it is a copy).
+         */
+        void _EndAttributeWrite(AttributeStore* store);
+
         /**
         * A map for storing arbitrary pieces of information or data.
+        * \n This is the legacy, untyped attribute map; its values are NOT owned (nor deallocated) by sys-sage. Prefer the typed attributes (SetAttribute()/GetAttribute()), which sys-sage uses for all its own attributes.
         * - The `key` denotes the name of the attribute.
         * - The `value` points to the data, stored as a `void*`.
         *
@@ -588,10 +1003,17 @@ namespace sys_sage {
          */
         Component(Component * parent, int _id, std::string _name, ComponentType::type _componentType);
 
+        /**
+         * @brief Copies the properties (id, name, count, component type) and the typed attributes of other; the copy is not inserted in the Component Tree and has no Relations.
+         * Used by _CloneInstance() (through the implicit copy constructors of the subclasses).
+         */
+        Component(const Component& other);
+        Component& operator=(const Component&) = delete;
+
         int id; /**< Numeric ID of the component. There is no requirement for uniqueness of the ID, however it is advised to have unique IDs at least in the realm of parent's children (siblings). Some tree search functions, which take the id as a search parameter search for first match, so the user is responsible to manage uniqueness in the realm of the search subtree (or should be aware of the consequences of not doing so). Component's ID is set by the constructor, and is retrieved via int GetId(); */
-        int depth; /**< Depth (level) of the Component in the Component Tree */
+        int depth{0}; /**< Depth (level) of the Component in the Component Tree (0 = root). Maintained by InsertChild. */
         std::string name; /**< Name of the component (as a std::string). */
-        int count{-1}; /**< Can be used to represent multiple Components with the same properties. By default, it represents only 1 component, and is set to -1. */
+        int count{-1}; /**< Can be used to represent multiple Components with the same properties (see SetCount()). By default, it represents only 1 component, and is set to -1. */
         /**
         Component type of the component. The component type denotes of which class the instance is (often the components are stored as Component*, even though they are a member of one of the child classes)
         Component type is constant, set by constructor, readonly. 
@@ -599,14 +1021,39 @@ namespace sys_sage {
         const ComponentType::type componentType;
         std::vector<Component*> children; /**< Contains the list (std::vector) of pointers to children of the component in the component tree. */
         Component* parent { nullptr }; /**< Contains pointer to the parent component in the component tree. If this component is the root, parent will be nullptr.*/
+        int siblingIndex{-1}; /**< Position of this component in its parent's children list (maintained by InsertChild, RemoveChild and ReparentChildren). */
+        mutable std::unordered_map<int, Component*>* childIdMap = nullptr; /**< id -> first child with that id. Lazily built by GetChildById for components with more than childIdMapThreshold children. */
+        mutable bool childIdMapHasDuplicates = false; /**< True if some children share an id; removing a mapped child then drops the whole childIdMap. */
+        mutable bool childIdMapHasCollapsed = false; /**< True if a child was collapsed while the childIdMap existed; the map holds their first id only, so a miss then falls back to matching the id ranges. */
         
         /**
-         * Contains a list (std::array) of different Relation types. 
-         * Initially nullptr, it is allocated on the first call to AddRelation() or new Relation().
-         * The array size is RelationType::_num_relation_types, which is defined in RelationType.
-         * Each element of the array is a pointer to a std::vector<Relation*> that contains all Relations of that type. (also lazy-allocated)
+         * Contains the Relations of this component, one std::vector<Relation*> per Relation type (indexed by RelationType::type).
+         * The vectors are stored inline; every Relation keeps its position in the vector (back-index), so that it can be removed in O(1).
+         * The order of the Relations in a vector is therefore not preserved when Relations are deleted.
+         */
+        RelationArray relations;
+        RelationArray* publishedRelations = nullptr; /**< Immutable copy of relations for concurrent readers (see Topology::EnableConcurrentReads()); swapped atomically. */
+        uint64_t version{_NextVersion()}; /**< Version of the last change (see GetVersion()). Accessed atomically, as the setters may be called by a writer thread with concurrent reads enabled. */
+        AttributeStore* attributes = nullptr; /**< Typed attributes owned by this Component. Allocated on the first SetAttribute(). Swapped atomically (copy-on-write) when concurrent reads are enabled. */
+    };
+
+    /**
+     * @class SharedWriteScope
+     * @brief RAII helper that turns off the copy-on-write of shared components (see Component::SetCount()) on the calling thread.
+     *
+     * While the scope is alive, attributes, children, and Relations written to a shared component apply to all components it represents,
+     * e.g. when a parser describes all cores of a collapsed Thread at once. Scopes can be nested.
+     */
+    class SharedWriteScope {
+    public:
+        SharedWriteScope();
+        ~SharedWriteScope();
+        SharedWriteScope(const SharedWriteScope&) = delete;
+        SharedWriteScope& operator=(const SharedWriteScope&) = delete;
+        /**
+         * @brief Returns true if a SharedWriteScope is active on the calling thread.
          */
-        std::array<std::vector<Relation*>*, RelationType::_num_relation_types>* relations = nullptr;
+        static bool IsActive();
     };
 
 } //namespace sys_sage 
@@ -0,0 +1,248 @@
+#include "ComponentTraversal.hpp"
+
+#include <ranges>
+
+#include "Component.hpp"
+
+static_assert(std::forward_iterator<sys_sage::PreOrderIterator>);
+static_assert(std::forward_iterator<sys_sage::PostOrderIterator>);
+static_assert(std::forward_iterator<sys_sage::BreadthFirstIterator>);
+static_assert(std::ranges::forward_range<sys_sage::PreOrderRange>);
+static_assert(std::ranges::forward_range<sys_sage::PostOrderRange>);
+static_assert(std::ranges::forward_range<sys_sage::BreadthFirstRange>);
+
+////////////////////////////////////////////////////////////////////////
+// TraversalStack
+
+void sys_sage::TraversalStack::Push(Component* c)
+{
+    if(size < kInlineFrames)
+        inlineFrames[size] = {c, 0};
+    else
+        overflowFrames.push_back({c, 0});
+    size++;
+}
+void sys_sage::TraversalStack::Pop()
+{
+    if(size > kInlineFrames)
+        overflowFrames.pop_back();
+    size--;
+}
+sys_sage::TraversalStack::Frame& sys_sage::TraversalStack::Top()
+{
+    return size > kInlineFrames ? overflowFrames.back() : inlineFrames[size - 1];
+}
+const sys_sage::TraversalStack::Frame& sys_sage::TraversalStack::Top() const
+{
+    return size > kInlineFrames ? overflowFrames.back() : inlineFrames[size - 1];
+}
+size_t sys_sage::TraversalStack::Size() const { return size; }
+bool sys_sage::TraversalStack::Empty() const { return size == 0; }
+void sys_sage::TraversalStack::Clear()
+{
+    overflowFrames.clear();
+    size = 0;
+}
+
+//One pre-order DFS step: moves the top of the stack to the next component in pre-order, not descending below maxDepth (-1 = unlimited).
+//Leaves the stack empty when the traversal is finished.
+static void _DfsStep(sys_sage::TraversalStack& stack, int maxDepth, bool skipChildren)
+{
+    sys_sage::TraversalStack::Frame& top = stack.Top();
+    const std::vector<sys_sage::Component*>& children = top.component->GetChildren();
+    if(!skipChildren && !children.empty() && (maxDepth < 0 || static_cast<int>(stack.Size()) - 1 < maxDepth))
+    {
+        top.childIdx = 0;
+        stack.Push(children[0]);
+        return;
+    }
+
+    stack.Pop();
+    while(!stack.Empty())
+    {
+        sys_sage::TraversalStack::Frame& f = stack.Top();
+        f.childIdx++;
+        const std::vector<sys_sage::Component*>& siblings = f.component->GetChildren();
+        if(f.childIdx < siblings.size())
+        {
+            stack.Push(siblings[f.childIdx]);
+            return;
+        }
+        stack.Pop();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////
+// PreOrderIterator
+
+sys_sage::PreOrderIterator::PreOrderIterator(Component* root, ComponentType::mask _typeMask, int _maxDepth) : typeMask(_typeMask), maxDepth(_maxDepth)
+{
+    if(root == nullptr)
+        return;
+    stack.Push(root);
+    if(!ComponentType::InMask(root->GetComponentType(), typeMask))
+        _Advance();
+}
+
+void sys_sage::PreOrderIterator::_Advance()
+{
+    do {
+        _DfsStep(stack, maxDepth, skipChildren);
+        skipChildren = false;
+    } while(!stack.Empty() && !ComponentType::InMask(stack.Top().component->GetComponentType(), typeMask));
+}
+
+sys_sage::Component* sys_sage::PreOrderIterator::operator*() const { return stack.Top().component; }
+sys_sage::PreOrderIterator& sys_sage::PreOrderIterator::operator++()
+{
+    _Advance();
+    return *this;
+}
+sys_sage::PreOrderIterator sys_sage::PreOrderIterator::operator++(int)
+{
+    PreOrderIterator ret = *this;
+    _Advance();
+    return ret;
+}
+bool sys_sage::PreOrderIterator::operator==(const PreOrderIterator& other) const
+{
+    if(stack.Empty() || other.stack.Empty())
+        return stack.Empty() == other.stack.Empty();
+    return stack.Top().component == other.stack.Top().component;
+}
+bool sys_sage::PreOrderIterator::operator==(std::default_sentinel_t) const { return stack.Empty(); }
+int sys_sage::PreOrderIterator::Depth() const { return static_cast<int>(stack.Size()) - 1; }
+void sys_sage::PreOrderIterator::SkipChildren() { skipChildren = true; }
+
+////////////////////////////////////////////////////////////////////////
+// PostOrderIterator
+
+sys_sage::PostOrderIterator::PostOrderIterator(Component* root, ComponentType::mask _typeMask, int _maxDepth) : typeMask(_typeMask), maxDepth(_maxDepth)
+{
+    if(root == nullptr)
+        return;
+    stack.Push(root);
+    _DescendToFirstLeaf();
+    if(!ComponentType::InMask(stack.Top().component->GetComponentType(), typeMask))
+        _Advance();
+}
+
+void sys_sage::PostOrderIterator::_DescendToFirstLeaf()
+{
+    while(true)
+    {
+        TraversalStack::Frame& top = stack.Top();
+        const std::vector<Component*>& children = top.component->GetChildren();
+        if(children.empty() || (maxDepth >= 0 && static_cast<int>(stack.Size()) - 1 >= maxDepth))
+            return;
+        top.childIdx = 0;
+        stack.Push(children[0]);
+    }
+}
+
+void sys_sage::PostOrderIterator::_Advance()
+{
+    do {
+        stack.Pop();
+        if(stack.Empty())
+            return;
+        TraversalStack::Frame& f = stack.Top();
+        f.childIdx++;
+        const std::vector<Component*>& siblings = f.component->GetChildren();
+        if(f.childIdx < siblings.size())
+        {
+            stack.Push(siblings[f.childIdx]);
+            _DescendToFirstLeaf();
+        }
+    } while(!ComponentType::InMask(stack.Top().component->GetComponentType(), typeMask));
+}
+
+sys_sage::Component* sys_sage::PostOrderIterator::operator*() const { return stack.Top().component; }
+sys_sage::PostOrderIterator& sys_sage::PostOrderIterator::operator++()
+{
+    _Advance();
+    return *this;
+}
+sys_sage::PostOrderIterator sys_sage::PostOrderIterator::operator++(int)
+{
+    PostOrderIterator ret = *this;
+    _Advance();
+    return ret;
+}
+bool sys_sage::PostOrderIterator::operator==(const PostOrderIterator& other) const
+{
+    if(stack.Empty() || other.stack.Empty())
+        return stack.Empty() == other.stack.Empty();
+    return stack.Top().component == other.stack.Top().component;
+}
+bool sys_sage::PostOrderIterator::operator==(std::default_sentinel_t) const { return stack.Empty(); }
+int sys_sage::PostOrderIterator::Depth() const { return static_cast<int>(stack.Size()) - 1; }
+
+////////////////////////////////////////////////////////////////////////
+// BreadthFirstIterator
+
+sys_sage::BreadthFirstIterator::BreadthFirstIterator(Component* _root, ComponentType::mask _typeMask, int _maxDepth) : root(_root), typeMask(_typeMask), maxDepth(_maxDepth)
+{
+    if(root == nullptr)
+        return;
+    stack.Push(root);
+    levelHadComponents = true;
+    if(!ComponentType::InMask(root->GetComponentType(), typeMask))
+        _Advance();
+}
+
+//moves to the next component on the current level (with a matching type); returns false if the level is exhausted
+bool sys_sage::BreadthFirstIterator::_NextOnLevel()
+{
+    while(true)
+    {
+        _DfsStep(stack, level, false);
+        if(stack.Empty())
+            return false;
+        if(Depth() == level)
+        {
+            levelHadComponents = true;
+            if(ComponentType::InMask(stack.Top().component->GetComponentType(), typeMask))
+                return true;
+        }
+    }
+}
+
+void sys_sage::BreadthFirstIterator::_Advance()
+{
+    while(!stack.Empty() || levelHadComponents)
+    {
+        if(stack.Empty())
+        {
+            //previous level is exhausted -> restart the DFS from the root one level deeper
+            level++;
+            levelHadComponents = false;
+            if(maxDepth >= 0 && level > maxDepth)
+                return;
+            stack.Push(root);
+        }
+        if(_NextOnLevel())
+            return;
+    }
+}
+
+sys_sage::Component* sys_sage::BreadthFirstIterator::operator*() const { return stack.Top().component; }
+sys_sage::BreadthFirstIterator& sys_sage::BreadthFirstIterator::operator++()
+{
+    _Advance();
+    return *this;
+}
+sys_sage::BreadthFirstIterator sys_sage::BreadthFirstIterator::operator++(int)
+{
+    BreadthFirstIterator ret = *this;
+    _Advance();
+    return ret;
+}
+bool sys_sage::BreadthFirstIterator::operator==(const BreadthFirstIterator& other) const
+{
+    if(stack.Empty() || other.stack.Empty())
+        return stack.Empty() == other.stack.Empty();
+    return stack.Top().component == other.stack.Top().component;
+}
+bool sys_sage::BreadthFirstIterator::operator==(std::default_sentinel_t) const { return stack.Empty(); }
+int sys_sage::BreadthFirstIterator::Depth() const { return static_cast<int>(stack.Size()) - 1; }
@@ -0,0 +1,196 @@
+#ifndef COMPONENT_TRAVERSAL_HPP
+#define COMPONENT_TRAVERSAL_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include "enums.hpp"
+
+namespace sys_sage {
+
+    class Component;
+
+    /**
+     * @private
+     * @brief Explicit traversal stack of the subtree iterators.
+     * Each frame holds a component on the path from the traversal root to the current component, and the index of its child that is currently being visited.
+     * The first kInlineFrames frames are stored inline, so that traversals of trees up to that depth do not allocate.
+     */
+    class TraversalStack {
+    public:
+        struct Frame {
+            Component* component;
+            size_t childIdx;
+        };
+
+        void Push(Component* c);
+        void Pop();
+        Frame& Top();
+        const Frame& Top() const;
+        size_t Size() const;
+        bool Empty() const;
+        void Clear();
+
+    private:
+        static constexpr size_t kInlineFrames = 24;
+        Frame inlineFrames[kInlineFrames] = {};
+        std::vector<Frame> overflowFrames; /**< Only used for trees deeper than kInlineFrames. */
+        size_t size = 0;
+    };
+
+    /**
+     * @brief Iterator over a subtree in pre-order (DFS, parent before its children, children in the order of the children vector).
+     * Uses an explicit stack (no recursion) and does not allocate for subtrees up to 24 levels deep.
+     * \n Models std::forward_iterator; the end of the traversal is std::default_sentinel.
+     * @see Component::PreOrder()
+     */
+    class PreOrderIterator {
+    public:
+        using value_type = Component*;
+        using reference = Component*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        PreOrderIterator() = default;
+        /**
+         * @param root Root of the traversed subtree (included in the traversal).
+         * @param typeMask Only components of the selected types are returned (the others are still descended into).
+         * @param maxDepth Components deeper than maxDepth levels below root are not visited (-1 = unlimited).
+         */
+        PreOrderIterator(Component* root, ComponentType::mask typeMask = ComponentType::AnyMask, int maxDepth = -1);
+
+        Component* operator*() const;
+        PreOrderIterator& operator++();
+        PreOrderIterator operator++(int);
+        bool operator==(const PreOrderIterator& other) const;
+        bool operator==(std::default_sentinel_t) const;
+
+        /**
+         * @brief Returns the depth of the current component relative to the root of the traversal (root = 0).
+         */
+        int Depth() const;
+        /**
+         * @brief The children of the current component will not be visited by the next increment.
+         */
+        void SkipChildren();
+
+    private:
+        void _Advance();
+
+        TraversalStack stack;
+        ComponentType::mask typeMask = ComponentType::AnyMask;
+        int maxDepth = -1;
+        bool skipChildren = false;
+    };
+
+    /**
+     * @brief Iterator over a subtree in post-order (DFS, children before their parent, children in the order of the children vector).
+     * Uses an explicit stack (no recursion) and does not allocate for subtrees up to 24 levels deep.
+     * \n Models std::forward_iterator; the end of the traversal is std::default_sentinel.
+     * @see Component::PostOrder()
+     */
+    class PostOrderIterator {
+    public:
+        using value_type = Component*;
+        using reference = Component*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        PostOrderIterator() = default;
+        /**
+         * @param root Root of the traversed subtree (included in the traversal, as the last component).
+         * @param typeMask Only components of the selected types are returned (the others are still descended into).
+         * @param maxDepth Components deeper than maxDepth levels below root are not visited (-1 = unlimited).
+         */
+        PostOrderIterator(Component* root, ComponentType::mask typeMask = ComponentType::AnyMask, int maxDepth = -1);
+
+        Component* operator*() const;
+        PostOrderIterator& operator++();
+        PostOrderIterator operator++(int);
+        bool operator==(const PostOrderIterator& other) const;
+        bool operator==(std::default_sentinel_t) const;
+
+        /**
+         * @brief Returns the depth of the current component relative to the root of the traversal (root = 0).
+         */
+        int Depth() const;
+
+    private:
+        void _DescendToFirstLeaf();
+        void _Advance();
+
+        TraversalStack stack;
+        ComponentType::mask typeMask = ComponentType::AnyMask;
+        int maxDepth = -1;
+    };
+
+    /**
+     * @brief Iterator over a subtree in breadth-first order (level by level, each level in DFS order).
+     * The traversal is an iterative deepening over the explicit DFS stack, so it does not allocate (for subtrees up to 24 levels deep),
+     * at the price of re-walking the upper levels once per level. Sys-sage trees are shallow, so this is usually cheaper than maintaining a queue.
+     * \n Models std::forward_iterator; the end of the traversal is std::default_sentinel.
+     * @see Component::BreadthFirst()
+     */
+    class BreadthFirstIterator {
+    public:
+        using value_type = Component*;
+        using reference = Component*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        BreadthFirstIterator() = default;
+        /**
+         * @param root Root of the traversed subtree (included in the traversal, as the first component).
+         * @param typeMask Only components of the selected types are returned (the others are still descended into).
+         * @param maxDepth Components deeper than maxDepth levels below root are not visited (-1 = unlimited).
+         */
+        BreadthFirstIterator(Component* root, ComponentType::mask typeMask = ComponentType::AnyMask, int maxDepth = -1);
+
+        Component* operator*() const;
+        BreadthFirstIterator& operator++();
+        BreadthFirstIterator operator++(int);
+        bool operator==(const BreadthFirstIterator& other) const;
+        bool operator==(std::default_sentinel_t) const;
+
+        /**
+         * @brief Returns the depth of the current component relative to the root of the traversal (root = 0).
+         */
+        int Depth() const;
+
+    private:
+        bool _NextOnLevel();
+        void _Advance();
+
+        Component* root = nullptr;
+        TraversalStack stack;
+        ComponentType::mask typeMask = ComponentType::AnyMask;
+        int maxDepth = -1;
+        int level = 0;
+        bool levelHadComponents = false; /**< Whether the current level reached any component (if not, the traversal ends). */
+    };
+
+    /**
+     * @brief A (C++20) range over a subtree, usable in range-based for loops and with std::ranges algorithms.
+     * The range is a lightweight view; the subtree must not be modified while it is being iterated.
+     */
+    template <class Iterator>
+    class SubtreeRange {
+    public:
+        SubtreeRange(Component* _root, ComponentType::mask _typeMask = ComponentType::AnyMask, int _maxDepth = -1)
+            : root(_root), typeMask(_typeMask), maxDepth(_maxDepth) {}
+        Iterator begin() const { return Iterator(root, typeMask, maxDepth); }
+        std::default_sentinel_t end() const { return std::default_sentinel; }
+
+    private:
+        Component* root;
+        ComponentType::mask typeMask;
+        int maxDepth;
+    };
+
+    using PreOrderRange = SubtreeRange<PreOrderIterator>;
+    using PostOrderRange = SubtreeRange<PostOrderIterator>;
+    using BreadthFirstRange = SubtreeRange<BreadthFirstIterator>;
+
+} //namespace sys_sage
+#endif //COMPONENT_TRAVERSAL_HPP
@@ -31,6 +31,11 @@ namespace sys_sage {
         * Use Delete() or DeleteSubtree() for deleting and deallocating the components. 
         */
         ~Core() override = default;
+        /**
+        * @private
+        * Returns a copy of this Core (see Component::_CloneInstance()).
+        */
+        Component* _CloneInstance() const override;
     private:
 
     #ifdef PROC_CPUINFO
@@ -49,6 +54,16 @@ namespace sys_sage {
         * Gets the frequency of the core.
         */
         double GetFreq() const;
+        /**
+        * @private
+        * Helper function of the binary export: stores freq as type-specific field (see BinaryComponentRecord).
+        */
+        void _WriteBinaryFields(BinaryWriter* w, BinaryComponentRecord* rec) const override;
+        /**
+        * @private
+        * Helper function of the binary import: restores freq.
+        */
+        void _ReadBinaryFields(const BinaryTopologyView* v, const BinaryComponentRecord* rec) override;
     private:
         double freq;
     #endif
@@ -10,7 +10,7 @@ sys_sage::CouplingMap::CouplingMap(Qubit* q1, Qubit* q2) : Relation(sys_sage::Re
 }
 sys_sage::CouplingMap::CouplingMap(const std::vector<Component*>& components, int _id, bool _ordered): Relation(components, _id, _ordered, sys_sage::RelationType::CouplingMap) {}
 
-void sys_sage::CouplingMap::SetFidelity(double _fidelity){fidelity = _fidelity;}
+void sys_sage::CouplingMap::SetFidelity(double _fidelity){fidelity = _fidelity; MarkModified();}
 double sys_sage::CouplingMap::GetFidelity() const {return fidelity;}
 void sys_sage::CouplingMap::Delete()
 {
@@ -57,9 +57,8 @@ namespace sys_sage {
          * @brief Helper function for XML export.
          *
          * Should normally not be used directly. Used internally for exporting the coupling map to XML.
-         * @return Pointer to the created XML entry node.
          */
-        xmlNodePtr _CreateXmlEntry() override;
+        void _WriteXmlEntry(XmlStreamWriter* w) override;
     private:
         double fidelity; ///< Fidelity of the coupling (e.g., two-qubit gate fidelity)
     };
@@ -12,9 +12,9 @@ using std::endl;
 sys_sage::Component * sys_sage::DataPath::GetSource() const {return components[0];}
 sys_sage::Component * sys_sage::DataPath::GetTarget() const {return components[1];}
 double sys_sage::DataPath::GetBandwidth() const {return bw;}
-void sys_sage::DataPath::SetBandwidth(double _bandwidth) { bw = _bandwidth;}
+void sys_sage::DataPath::SetBandwidth(double _bandwidth) { bw = _bandwidth; MarkModified();}
 double sys_sage::DataPath::GetLatency() const {return latency;}
-void sys_sage::DataPath::SetLatency(double _latency) { latency = _latency; }
+void sys_sage::DataPath::SetLatency(double _latency) { latency = _latency; MarkModified(); }
 sys_sage::DataPathType::type sys_sage::DataPath::GetDataPathType() const {return dp_type;}
 sys_sage::DataPathOrientation::type sys_sage::DataPath::GetOrientation() const {return ordered ? sys_sage::DataPathOrientation::Oriented : sys_sage::DataPathOrientation::Bidirectional;}
 
@@ -41,7 +41,25 @@ sys_sage::DataPath::DataPath(Component* _source, Component* _target, sys_sage::D
     if (_source != _target)
         AddComponent(_target);
     else
+    {
         components.emplace_back(_target);
+        componentSlots.push_back(-1);
+    }
+}
+
+sys_sage::Relation* sys_sage::DataPath::_CloneReplacing(const std::unordered_map<Component*, Component*>& copies) const
+{
+    auto copy = [&copies](Component* c) {
+        auto it = copies.find(c);
+        return it == copies.end() ? c : it->second;
+    };
+    Component* source = copy(components[0]);
+    Component* target = copy(components[1]);
+    DataPath* dp = new DataPath(source, target, ordered ? DataPathOrientation::Oriented : DataPathOrientation::Bidirectional, dp_type, bw, latency);
+    const AttributeStore* store = GetAttributes();
+    if(store != nullptr)
+        dp->attributes = new AttributeStore(*store);
+    return dp;
 }
 
 void sys_sage::DataPath::Delete()
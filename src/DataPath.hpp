@@ -125,9 +125,13 @@ namespace sys_sage {
          * @private
          * @brief Helper function for XML export.
          * Should normally not be used directly. Used internally for exporting the DataPath to XML.
-         * @return Pointer to the created XML entry node.
          */
-        xmlNodePtr _CreateXmlEntry() override;
+        void _WriteXmlEntry(XmlStreamWriter* w) override;
+        /**
+         * @private
+         * @brief Returns a new DataPath with the same properties (and typed attributes) whose source and target are replaced as given by copies; see Relation::_CloneReplacing().
+         */
+        Relation* _CloneReplacing(const std::unordered_map<Component*, Component*>& copies) const override;
         /**
          * @brief Deletes and de-allocates the DataPath pointer from the list (std::vector) of outgoing and incoming DataPaths of source and target Components.
          */
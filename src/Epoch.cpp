@@ -0,0 +1,198 @@
+#include "Epoch.hpp"
+
+#include <limits>
+#include <thread>
+
+#include "Component.hpp"
+#include "Topology.hpp"
+
+namespace {
+    std::atomic<int> numDomains{0};
+    thread_local int writeGuardDepth = 0; //WriteGuards held by this thread
+    thread_local unsigned slotHint = 0; //slot used by the last ReadGuard of this thread
+}
+
+sys_sage::EpochDomain::EpochDomain() { numDomains.fetch_add(1, std::memory_order_relaxed); }
+
+sys_sage::EpochDomain::~EpochDomain()
+{
+    {
+        std::lock_guard<std::recursive_mutex> lock(writeMutex);
+        changed.clear(); //the components may be gone already; their published lists are destroyed with them
+        uint64_t e = epoch.load();
+        for(std::function<void()>& p : pending)
+            retired.emplace_back(e, std::move(p));
+        pending.clear();
+        epoch.fetch_add(1);
+        while(!retired.empty())
+        {
+            _Reclaim();
+            if(!retired.empty())
+                std::this_thread::yield();
+        }
+    }
+    numDomains.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool sys_sage::EpochDomain::_IsWriting() { return writeGuardDepth > 0; }
+bool sys_sage::EpochDomain::_AnyDomain() { return numDomains.load(std::memory_order_relaxed) > 0; }
+
+int sys_sage::EpochDomain::_EnterRead()
+{
+    uint64_t e = epoch.load(std::memory_order_acquire);
+    for(;;)
+    {
+        for(int i = 0; i < numSlots; i++)
+        {
+            int idx = (slotHint + i) % numSlots;
+            uint64_t expected = 0;
+            if(slots[idx].epoch.compare_exchange_strong(expected, e))
+            {
+                slotHint = idx;
+                //pairs with the fence in _Reclaim(): either the writer sees this slot, or this reader sees everything published before the writer scanned the slots
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                return idx;
+            }
+        }
+        //all slots taken by other readers
+        std::this_thread::yield();
+        e = epoch.load(std::memory_order_acquire);
+    }
+}
+
+void sys_sage::EpochDomain::_ExitRead(int slot) { slots[slot].epoch.store(0, std::memory_order_release); }
+
+void sys_sage::EpochDomain::_BeginWrite()
+{
+    writeMutex.lock();
+    writeDepth++;
+    writeGuardDepth++;
+}
+
+void sys_sage::EpochDomain::_EndWrite()
+{
+    if(--writeDepth == 0)
+        _Publish();
+    writeGuardDepth--;
+    writeMutex.unlock();
+}
+
+void sys_sage::EpochDomain::_MarkChanged(Component* c)
+{
+    std::lock_guard<std::recursive_mutex> lock(writeMutex);
+    changed.insert(c);
+}
+
+void sys_sage::EpochDomain::_Forget(Component* c)
+{
+    std::lock_guard<std::recursive_mutex> lock(writeMutex);
+    changed.erase(c);
+    Component::RelationArray* old = c->_UnpublishRelations();
+    if(old != nullptr)
+        pending.push_back([old]{ delete old; });
+}
+
+void sys_sage::EpochDomain::Retire(std::function<void()> reclaim)
+{
+    std::lock_guard<std::recursive_mutex> lock(writeMutex);
+    pending.push_back(std::move(reclaim));
+}
+
+sys_sage::AttributeStore* sys_sage::EpochDomain::_BeginAttributeWrite(const AttributeStore* published, AttributeKey::type key)
+{
+    AttributeStore* store = published != nullptr ? published->_ShareValues() : new AttributeStore();
+    AttributeStore::Entry detached;
+    if(store->_Detach(key, &detached) && detached.ops != nullptr)
+        Retire([detached]{ detached.ops->destroy(detached.value.ptr); });
+    return store;
+}
+
+void sys_sage::EpochDomain::_PublishAttributes(AttributeStore** published, AttributeStore* store)
+{
+    AttributeStore* old = std::atomic_ref<AttributeStore*>(*published).exchange(store, std::memory_order_acq_rel);
+    if(old != nullptr)
+    {
+        old->_DisownValues(); //the values now belong to the new store (or were retired by _BeginAttributeWrite)
+        Retire([old]{ delete old; });
+    }
+}
+
+void sys_sage::EpochDomain::_Publish()
+{
+    std::lock_guard<std::recursive_mutex> lock(writeMutex);
+    for(Component* c : changed)
+    {
+        Component::RelationArray* old = c->_PublishRelations();
+        if(old != nullptr)
+            pending.push_back([old]{ delete old; });
+    }
+    changed.clear();
+    if(!pending.empty())
+    {
+        //everything pending is unlinked now; readers that enter from the next epoch on cannot see it
+        uint64_t e = epoch.load();
+        for(std::function<void()>& p : pending)
+            retired.emplace_back(e, std::move(p));
+        pending.clear();
+        epoch.fetch_add(1);
+    }
+    _Reclaim();
+}
+
+void sys_sage::EpochDomain::_Reclaim()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t minActive = std::numeric_limits<uint64_t>::max();
+    for(const Slot& s : slots)
+    {
+        uint64_t e = s.epoch.load();
+        if(e != 0 && e < minActive)
+            minActive = e;
+    }
+    //an object retired in epoch e may still be seen by readers that entered in epoch e or earlier
+    while(!retired.empty() && retired.front().first < minActive)
+    {
+        std::function<void()> reclaim = std::move(retired.front().second);
+        retired.pop_front();
+        reclaim();
+    }
+}
+
+void sys_sage::EpochDomain::Synchronize()
+{
+    std::lock_guard<std::recursive_mutex> lock(writeMutex);
+    _Publish();
+    while(!retired.empty())
+    {
+        std::this_thread::yield();
+        _Reclaim();
+    }
+}
+
+size_t sys_sage::EpochDomain::GetNumRetired()
+{
+    std::lock_guard<std::recursive_mutex> lock(writeMutex);
+    return pending.size() + retired.size();
+}
+
+sys_sage::ReadGuard::ReadGuard(const Component* c) : domain(c != nullptr ? c->_FindEpochDomain() : nullptr)
+{
+    if(domain != nullptr)
+        slot = domain->_EnterRead();
+}
+sys_sage::ReadGuard::~ReadGuard()
+{
+    if(domain != nullptr)
+        domain->_ExitRead(slot);
+}
+
+sys_sage::WriteGuard::WriteGuard(const Component* c) : domain(c != nullptr ? c->_FindEpochDomain() : nullptr)
+{
+    if(domain != nullptr)
+        domain->_BeginWrite();
+}
+sys_sage::WriteGuard::~WriteGuard()
+{
+    if(domain != nullptr)
+        domain->_EndWrite();
+}
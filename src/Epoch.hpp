@@ -0,0 +1,178 @@
+#ifndef EPOCH_HPP
+#define EPOCH_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "Attribute.hpp"
+
+namespace sys_sage {
+
+    class Component;
+    class Topology;
+
+    /**
+     * @class EpochDomain
+     * @brief Epoch-based (RCU-style) publication and reclamation for concurrent readers of one Topology.
+     *
+     * Readers (see ReadGuard) announce themselves in a per-domain slot array without taking any lock; writers (see WriteGuard) are serialized by a mutex.
+     * Writers never modify what readers can see in place:
+     * - The relation lists of every component are published as immutable copies. Writers modify the live lists; when the outermost WriteGuard is released,
+     *   the changed components get a new copy, which is swapped in atomically. Component::GetRelations() returns the published copy to readers and the live list to writers.
+     * - Typed attributes (AttributeStore) are copied on write: the new store shares the unchanged values with the old one and is swapped in atomically.
+     * - Deleted Relations, replaced attribute values and replaced copies are retired, i.e. destroyed only after all readers that might still see them have left.
+     *
+     * Not covered: changes of the component tree itself (InsertChild, RemoveChild, Delete of components, ...), Relation::UpdateComponent(), the legacy attrib maps and in-place modification
+     * of attribute values through the references returned by SetAttribute(). Perform these only when no readers are active.
+     * \n A domain is usually owned by a Topology (see Topology::EnableConcurrentReads()).
+     */
+    class EpochDomain {
+    public:
+        EpochDomain();
+        /**
+         * @brief Waits for the active readers to leave and destroys everything retired.
+         */
+        ~EpochDomain();
+        EpochDomain(const EpochDomain&) = delete;
+        EpochDomain& operator=(const EpochDomain&) = delete;
+
+        /**
+         * @brief Registers an object for deferred destruction: reclaim is called once no reader can see the object anymore.
+         * The object must already be unlinked (or be unlinked by the current write, i.e. before the outermost WriteGuard is released).
+         */
+        void Retire(std::function<void()> reclaim);
+        /**
+         * @brief Publishes pending changes, waits until all readers that may see retired objects have left, and destroys the retired objects.
+         * Must not be called by a thread that holds a ReadGuard of this domain.
+         */
+        void Synchronize();
+        /**
+         * @brief Returns the number of retired objects that are not destroyed yet.
+         */
+        size_t GetNumRetired();
+
+        /**
+         * @private
+         * @brief Announces a reader; returns its slot. Lock-free. Use ReadGuard instead.
+         */
+        int _EnterRead();
+        /**
+         * @private
+         * @brief Removes the reader announcement of a slot. Use ReadGuard instead.
+         */
+        void _ExitRead(int slot);
+        /**
+         * @private
+         * @brief Locks the domain for writing. Use WriteGuard instead.
+         */
+        void _BeginWrite();
+        /**
+         * @private
+         * @brief Unlocks the domain; the outermost call publishes the changes made since the outermost _BeginWrite(). Use WriteGuard instead.
+         */
+        void _EndWrite();
+        /**
+         * @private
+         * @brief Marks the relation list of c as changed; it is republished when the outermost WriteGuard is released.
+         */
+        void _MarkChanged(Component* c);
+        /**
+         * @private
+         * @brief Removes c from the domain: drops (retires) its published relation list. Called when c leaves the subtree of the Topology.
+         */
+        void _Forget(Component* c);
+        /**
+         * @private
+         * @brief Copy-on-write of an AttributeStore: returns a new store that shares the values of published, except for the value of key, which is detached and retired.
+         */
+        AttributeStore* _BeginAttributeWrite(const AttributeStore* published, AttributeKey::type key);
+        /**
+         * @private
+         * @brief Atomically replaces *published with store and retires the old store (without its shared values).
+         */
+        void _PublishAttributes(AttributeStore** published, AttributeStore* store);
+
+        /**
+         * @private
+         * @brief Returns true if the calling thread holds a WriteGuard (of any domain).
+         */
+        static bool _IsWriting();
+        /**
+         * @private
+         * @brief Returns true if any EpochDomain exists (fast path for the code that looks up the domain of a component).
+         */
+        static bool _AnyDomain();
+
+    private:
+        void _Publish();
+        void _Reclaim();
+
+        static constexpr int numSlots = 128;
+        struct alignas(64) Slot {
+            std::atomic<uint64_t> epoch{0}; /**< epoch observed by the reader in this slot; 0 = free */
+        };
+        Slot slots[numSlots];
+        std::atomic<uint64_t> epoch{1};
+
+        std::recursive_mutex writeMutex;
+        int writeDepth = 0;
+        std::unordered_set<Component*> changed; /**< components whose relation list is republished by the next _Publish() */
+        std::vector<std::function<void()>> pending; /**< retired since the last _Publish() */
+        std::deque<std::pair<uint64_t, std::function<void()>>> retired; /**< (epoch of retirement, reclaim function), in epoch order */
+    };
+
+    /**
+     * @class ReadGuard
+     * @brief RAII reader section of the EpochDomain of a Topology (lock-free).
+     *
+     * Pointers and references obtained within the guard (Relations from GetRelations(), attribute values from GetAttribute(), ...) stay valid until the guard is destroyed,
+     * even if a writer deletes or replaces them meanwhile. Without an enabled domain, the guard does nothing.
+     * \n Example:
+     * ```cpp
+     * {
+     *     ReadGuard guard(topo);
+     *     for(Relation* r : chip->GetRelations(RelationType::DataPath))
+     *         ...
+     * }
+     * ```
+     */
+    class ReadGuard {
+    public:
+        /**
+         * @param c Component whose nearest Topology ancestor (or c itself) with enabled concurrent reads provides the domain.
+         */
+        ReadGuard(const Component* c);
+        ~ReadGuard();
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+    private:
+        EpochDomain* domain;
+        int slot = -1;
+    };
+
+    /**
+     * @class WriteGuard
+     * @brief RAII writer section of the EpochDomain of a Topology. Writers are serialized; guards can be nested.
+     * Changes become visible to readers when the outermost guard is released. Without an enabled domain, the guard does nothing.
+     */
+    class WriteGuard {
+    public:
+        /**
+         * @param c Component whose nearest Topology ancestor (or c itself) with enabled concurrent reads provides the domain.
+         */
+        WriteGuard(const Component* c);
+        ~WriteGuard();
+        WriteGuard(const WriteGuard&) = delete;
+        WriteGuard& operator=(const WriteGuard&) = delete;
+    private:
+        EpochDomain* domain;
+    };
+
+} //namespace sys_sage
+#endif //EPOCH_HPP
@@ -0,0 +1,176 @@
+#include "FrozenTopology.hpp"
+
+#include <algorithm>
+
+#include "Component.hpp"
+#include "DataPath.hpp"
+
+sys_sage::FrozenTopology sys_sage::FreezeTopology(Component* root)
+{
+    FrozenTopology ft;
+    if(root == nullptr)
+    {
+        ft.dpOffsets.push_back(0);
+        return ft;
+    }
+
+    //components in pre-order
+    std::vector<int32_t> lastChild; //helper for building the sibling links
+    for(PreOrderIterator it = root->PreOrder().begin(); it != std::default_sentinel; ++it)
+    {
+        Component* c = *it;
+        int32_t idx = static_cast<int32_t>(ft.components.size());
+        int32_t p = (c == root) ? FrozenTopology::npos : ft.indexOf.at(c->GetParent());
+
+        ft.components.push_back(c);
+        ft.indexOf.emplace(c, idx);
+        ft.type.push_back(c->GetComponentType());
+        ft.id.push_back(c->GetId());
+        ft.parent.push_back(p);
+        ft.depth.push_back(it.Depth());
+        ft.firstChild.push_back(FrozenTopology::npos);
+        ft.nextSibling.push_back(FrozenTopology::npos);
+        ft.subtreeEnd.push_back(idx + 1);
+        ft.count.push_back(c->GetCount());
+        ft.multiplicity.push_back((p == FrozenTopology::npos ? 1 : ft.multiplicity[p]) * c->GetCount());
+        ft.hasCollapsed |= c->IsCollapsed();
+        lastChild.push_back(FrozenTopology::npos);
+
+        if(p != FrozenTopology::npos)
+        {
+            if(lastChild[p] == FrozenTopology::npos)
+                ft.firstChild[p] = idx;
+            else
+                ft.nextSibling[lastChild[p]] = idx;
+            lastChild[p] = idx;
+        }
+    }
+    //subtree ranges: in reverse pre-order, every component's range end is known before its parent's
+    for(int32_t idx = ft.Size() - 1; idx > 0; idx--)
+        ft.subtreeEnd[ft.parent[idx]] = std::max(ft.subtreeEnd[ft.parent[idx]], ft.subtreeEnd[idx]);
+
+    //DataPath CSR: count the edges per component, then fill
+    int32_t n = ft.Size();
+    ft.dpOffsets.assign(n + 1, 0);
+    auto forEachEdge = [&](auto&& edgeFcn) {
+        for(int32_t idx = 0; idx < n; idx++)
+        {
+            for(Relation* r : ft.components[idx]->GetRelations(RelationType::DataPath))
+            {
+                DataPath* dp = static_cast<DataPath*>(r);
+                if(dp->GetSource() != ft.components[idx])
+                    continue; //every DataPath is processed once, at its source
+                int32_t target = ft.GetIndex(dp->GetTarget());
+                if(target == FrozenTopology::npos)
+                    continue;
+                edgeFcn(idx, target, dp);
+                if(!dp->IsOrdered() && target != idx)
+                    edgeFcn(target, idx, dp);
+            }
+        }
+    };
+    forEachEdge([&](int32_t from, int32_t, DataPath*) { ft.dpOffsets[from + 1]++; });
+    for(int32_t idx = 0; idx < n; idx++)
+        ft.dpOffsets[idx + 1] += ft.dpOffsets[idx];
+
+    int32_t numEdges = ft.dpOffsets[n];
+    ft.dpTarget.resize(numEdges);
+    ft.dpBw.resize(numEdges);
+    ft.dpLatency.resize(numEdges);
+    ft.dpType.resize(numEdges);
+    ft.dataPaths.resize(numEdges);
+    std::vector<int32_t> fill(ft.dpOffsets.begin(), ft.dpOffsets.end() - 1);
+    forEachEdge([&](int32_t from, int32_t to, DataPath* dp) {
+        int32_t e = fill[from]++;
+        ft.dpTarget[e] = to;
+        ft.dpBw[e] = dp->GetBandwidth();
+        ft.dpLatency[e] = dp->GetLatency();
+        ft.dpType[e] = dp->GetDataPathType();
+        ft.dataPaths[e] = dp;
+    });
+
+    return ft;
+}
+
+int32_t sys_sage::FrozenTopology::Size() const { return static_cast<int32_t>(components.size()); }
+int32_t sys_sage::FrozenTopology::GetIndex(const Component* c) const
+{
+    auto it = indexOf.find(c);
+    return it == indexOf.end() ? npos : it->second;
+}
+sys_sage::Component* sys_sage::FrozenTopology::GetComponent(int32_t idx) const { return components[idx]; }
+sys_sage::ComponentType::type sys_sage::FrozenTopology::GetType(int32_t idx) const { return type[idx]; }
+int32_t sys_sage::FrozenTopology::GetId(int32_t idx) const { return id[idx]; }
+int32_t sys_sage::FrozenTopology::GetParent(int32_t idx) const { return parent[idx]; }
+int32_t sys_sage::FrozenTopology::GetDepth(int32_t idx) const { return depth[idx]; }
+int32_t sys_sage::FrozenTopology::GetFirstChild(int32_t idx) const { return firstChild[idx]; }
+int32_t sys_sage::FrozenTopology::GetNextSibling(int32_t idx) const { return nextSibling[idx]; }
+int32_t sys_sage::FrozenTopology::GetSubtreeEnd(int32_t idx) const { return subtreeEnd[idx]; }
+int32_t sys_sage::FrozenTopology::GetCount(int32_t idx) const { return count[idx]; }
+
+const std::vector<sys_sage::ComponentType::type>& sys_sage::FrozenTopology::GetTypeColumn() const { return type; }
+const std::vector<int32_t>& sys_sage::FrozenTopology::GetIdColumn() const { return id; }
+const std::vector<int32_t>& sys_sage::FrozenTopology::GetParentColumn() const { return parent; }
+const std::vector<int32_t>& sys_sage::FrozenTopology::GetDepthColumn() const { return depth; }
+const std::vector<int32_t>& sys_sage::FrozenTopology::GetSubtreeEndColumn() const { return subtreeEnd; }
+const std::vector<int32_t>& sys_sage::FrozenTopology::GetCountColumn() const { return count; }
+
+bool sys_sage::FrozenTopology::IsAncestor(int32_t ancestor, int32_t descendant) const
+{
+    return ancestor <= descendant && descendant < subtreeEnd[ancestor];
+}
+
+int32_t sys_sage::FrozenTopology::GetAncestorByType(int32_t idx, ComponentType::type componentType) const
+{
+    while(idx != npos && type[idx] != componentType)
+        idx = parent[idx];
+    return idx;
+}
+
+int64_t sys_sage::FrozenTopology::CountByType(int32_t idx, ComponentType::type componentType) const
+{
+    //plain contiguous scan (vectorized by the compiler)
+    const ComponentType::type* t = type.data();
+    if(!hasCollapsed)
+    {
+        int32_t cnt = 0;
+        for(int32_t i = idx; i < subtreeEnd[idx]; i++)
+            cnt += (t[i] == componentType);
+        return cnt;
+    }
+    //the multiplicities are relative to the snapshot root; divide by the part above idx
+    const int64_t* m = multiplicity.data();
+    int64_t cnt = 0;
+    for(int32_t i = idx; i < subtreeEnd[idx]; i++)
+        cnt += (t[i] == componentType) ? m[i] : 0;
+    return cnt / (m[idx] / count[idx]);
+}
+
+int32_t sys_sage::FrozenTopology::FindById(int32_t idx, int32_t _id, ComponentType::type componentType) const
+{
+    for(int32_t i = idx; i < subtreeEnd[idx]; i++)
+    {
+        if(type[i] == componentType && (id[i] == _id || (count[i] > 1 && _id > id[i] && static_cast<int64_t>(_id) < static_cast<int64_t>(id[i]) + count[i])))
+            return i;
+    }
+    return npos;
+}
+
+void sys_sage::FrozenTopology::GetSubcomponentsByType(int32_t idx, ComponentType::type componentType, std::vector<int32_t>* outIndices) const
+{
+    for(int32_t i = idx; i < subtreeEnd[idx]; i++)
+    {
+        if(type[i] == componentType)
+            outIndices->push_back(i);
+    }
+}
+
+std::pair<int32_t, int32_t> sys_sage::FrozenTopology::GetDataPathRange(int32_t idx) const { return {dpOffsets[idx], dpOffsets[idx + 1]}; }
+int32_t sys_sage::FrozenTopology::GetNumDataPathEdges() const { return static_cast<int32_t>(dpTarget.size()); }
+int32_t sys_sage::FrozenTopology::GetDataPathTarget(int32_t edge) const { return dpTarget[edge]; }
+double sys_sage::FrozenTopology::GetDataPathBw(int32_t edge) const { return dpBw[edge]; }
+double sys_sage::FrozenTopology::GetDataPathLatency(int32_t edge) const { return dpLatency[edge]; }
+sys_sage::DataPathType::type sys_sage::FrozenTopology::GetDataPathType(int32_t edge) const { return dpType[edge]; }
+sys_sage::DataPath* sys_sage::FrozenTopology::GetDataPath(int32_t edge) const { return dataPaths[edge]; }
+const std::vector<double>& sys_sage::FrozenTopology::GetDataPathBwColumn() const { return dpBw; }
+const std::vector<double>& sys_sage::FrozenTopology::GetDataPathLatencyColumn() const { return dpLatency; }
@@ -0,0 +1,140 @@
+#ifndef FROZEN_TOPOLOGY_HPP
+#define FROZEN_TOPOLOGY_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "enums.hpp"
+
+namespace sys_sage {
+
+    class Component;
+    class DataPath;
+
+    /**
+     * @class FrozenTopology
+     * @brief Compact, read-only snapshot of a component subtree and its DataPaths, for hot-path queries.
+     *
+     * Components are numbered in pre-order (the snapshot root has index 0) and stored as struct-of-arrays columns,
+     * so that subtree, ancestor and type queries run over contiguous arrays instead of chasing pointers:
+     * the subtree of component i is the index range [i, GetSubtreeEnd(i)).
+     * \n Collapsed components (see Component::SetCount()) are stored once, with their count; CountByType() and FindById() account for the represented components.
+     * \n DataPaths between components of the snapshot are stored as a CSR adjacency (per-component edge ranges with contiguous
+     * target, bandwidth, latency and type arrays). Oriented DataPaths are stored at their source; unoriented ones at both ends.
+     * \n The snapshot keeps a mapping to the live Component* and DataPath* objects, but it is not updated when the live topology changes
+     * -- create a new snapshot with FreezeTopology() after modifying the topology.
+     * @see FreezeTopology(Component* root)
+     */
+    class FrozenTopology {
+    public:
+        static constexpr int32_t npos = -1; /**< Index value for "no component" (e.g. parent of the root). */
+
+        /**
+         * @brief Returns the number of components in the snapshot.
+         */
+        int32_t Size() const;
+        /**
+         * @brief Returns the snapshot index of a live component, or npos if it is not part of the snapshot.
+         */
+        int32_t GetIndex(const Component* c) const;
+        /**
+         * @brief Returns the live Component* of a snapshot index.
+         */
+        Component* GetComponent(int32_t idx) const;
+
+        ComponentType::type GetType(int32_t idx) const; /**< @brief Returns the component type of a snapshot index. */
+        int32_t GetId(int32_t idx) const; /**< @brief Returns the component id of a snapshot index. */
+        int32_t GetParent(int32_t idx) const; /**< @brief Returns the index of the parent (npos for the snapshot root). */
+        int32_t GetDepth(int32_t idx) const; /**< @brief Returns the depth relative to the snapshot root (root = 0). */
+        int32_t GetFirstChild(int32_t idx) const; /**< @brief Returns the index of the first child (npos for leaves). */
+        int32_t GetNextSibling(int32_t idx) const; /**< @brief Returns the index of the next sibling (npos for the last child). */
+        int32_t GetSubtreeEnd(int32_t idx) const; /**< @brief Returns the end of the subtree range, i.e. the subtree of idx is [idx, GetSubtreeEnd(idx)). */
+        int32_t GetCount(int32_t idx) const; /**< @brief Returns the number of components represented by a snapshot index (see Component::GetCount()). */
+
+        /**
+         * @brief Returns the columns of the snapshot (indexed by snapshot index) for custom scans.
+         */
+        const std::vector<ComponentType::type>& GetTypeColumn() const;
+        const std::vector<int32_t>& GetIdColumn() const;
+        const std::vector<int32_t>& GetParentColumn() const;
+        const std::vector<int32_t>& GetDepthColumn() const;
+        const std::vector<int32_t>& GetSubtreeEndColumn() const;
+        const std::vector<int32_t>& GetCountColumn() const;
+
+        /**
+         * @brief Checks in O(1) whether ancestor is an ancestor of (or the same component as) descendant.
+         */
+        bool IsAncestor(int32_t ancestor, int32_t descendant) const;
+        /**
+         * @brief Moves up from idx (including idx itself) until a component of the given type is found.
+         * @return Index of the ancestor, or npos if not found
+         */
+        int32_t GetAncestorByType(int32_t idx, ComponentType::type componentType) const;
+        /**
+         * @brief Counts the components of the given type in the subtree of idx (including idx itself).
+         * Like Component::CountAllSubcomponentsByType(), a collapsed component counts as GetCount() components, and its subtree once per represented component
+         * (i.e. every component counts with the product of the counts on the path from idx to it).
+         */
+        int64_t CountByType(int32_t idx, ComponentType::type componentType) const;
+        /**
+         * @brief Finds the first component (in pre-order) in the subtree of idx with a matching id and type.
+         * A collapsed component matches all ids it represents, i.e. [GetId(), GetId() + GetCount()).
+         * @return Index of the match, or npos
+         */
+        int32_t FindById(int32_t idx, int32_t id, ComponentType::type componentType) const;
+        /**
+         * @brief Pushes back the indices of all components of the given type in the subtree of idx (in pre-order).
+         * Collapsed components and their subtrees appear once (see GetCount()).
+         */
+        void GetSubcomponentsByType(int32_t idx, ComponentType::type componentType, std::vector<int32_t>* outIndices) const;
+
+        /**
+         * @brief Returns the range [first, last) of the DataPath edges of component idx in the CSR arrays.
+         * The edges are GetDataPathTarget(e), GetDataPathBw(e), ... for first <= e < last.
+         */
+        std::pair<int32_t, int32_t> GetDataPathRange(int32_t idx) const;
+        int32_t GetNumDataPathEdges() const; /**< @brief Returns the total number of DataPath edges in the CSR. */
+        int32_t GetDataPathTarget(int32_t edge) const; /**< @brief Returns the snapshot index of the other end of an edge. */
+        double GetDataPathBw(int32_t edge) const; /**< @brief Returns the bandwidth of an edge. */
+        double GetDataPathLatency(int32_t edge) const; /**< @brief Returns the latency of an edge. */
+        DataPathType::type GetDataPathType(int32_t edge) const; /**< @brief Returns the DataPathType of an edge. */
+        DataPath* GetDataPath(int32_t edge) const; /**< @brief Returns the live DataPath* of an edge. */
+        const std::vector<double>& GetDataPathBwColumn() const; /**< @brief Returns the contiguous bandwidth array of all edges. */
+        const std::vector<double>& GetDataPathLatencyColumn() const; /**< @brief Returns the contiguous latency array of all edges. */
+
+    private:
+        friend FrozenTopology FreezeTopology(Component* root);
+
+        std::vector<ComponentType::type> type;
+        std::vector<int32_t> id;
+        std::vector<int32_t> parent;
+        std::vector<int32_t> depth;
+        std::vector<int32_t> firstChild;
+        std::vector<int32_t> nextSibling;
+        std::vector<int32_t> subtreeEnd;
+        std::vector<int32_t> count;
+        std::vector<int64_t> multiplicity; /**< Product of the counts on the path from the snapshot root to the component (both included). */
+        bool hasCollapsed = false; /**< True if any count is > 1; otherwise the queries ignore the counts. */
+        std::vector<Component*> components;
+        std::unordered_map<const Component*, int32_t> indexOf;
+
+        std::vector<int32_t> dpOffsets; /**< CSR offsets (Size()+1 entries) */
+        std::vector<int32_t> dpTarget;
+        std::vector<double> dpBw;
+        std::vector<double> dpLatency;
+        std::vector<DataPathType::type> dpType;
+        std::vector<DataPath*> dataPaths;
+    };
+
+    /**
+     * @brief Creates a read-only struct-of-arrays snapshot of the subtree of root (including root) and of the DataPaths between its components.
+     * @param root Root of the snapshot
+     * @return The snapshot
+     * @see FrozenTopology
+     */
+    FrozenTopology FreezeTopology(Component* root);
+
+} //namespace sys_sage
+#endif //FROZEN_TOPOLOGY_HPP
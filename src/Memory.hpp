@@ -36,6 +36,11 @@ namespace sys_sage {
         * Use Delete() or DeleteSubtree() for deleting and deallocating the components. 
         */
         ~Memory() override = default;
+        /**
+        * @private
+        * Returns a copy of this Memory (see Component::_CloneInstance()).
+        */
+        Component* _CloneInstance() const override;
         /**
          * Retrieves size/capacity of the memory element
          * @return size
@@ -63,7 +68,17 @@ namespace sys_sage {
         !!Should normally not be used!! Helper function of XML dump generation.
         @see exportToXml(Component* root, string path = "", std::function<int(string,void*,string*)> custom_search_attrib_key_fcn = NULL);
         */
-        xmlNodePtr _CreateXmlSubtree() override;
+        void _WriteXml(XmlStreamWriter* w) override;
+        /**
+        @private
+        !!Should normally not be used!! Helper function of the binary export: stores the members of this class as type-specific fields (see BinaryComponentRecord).
+        */
+        void _WriteBinaryFields(BinaryWriter* w, BinaryComponentRecord* rec) const override;
+        /**
+        @private
+        !!Should normally not be used!! Helper function of the binary import: restores the members stored by _WriteBinaryFields().
+        */
+        void _ReadBinaryFields(const BinaryTopologyView* v, const BinaryComponentRecord* rec) override;
     private:
         long long size; /**< size/capacity of the memory element*/
         bool is_volatile; /**< is volatile? */
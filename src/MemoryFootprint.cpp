@@ -0,0 +1,156 @@
+#include "MemoryFootprint.hpp"
+
+#include <iostream>
+#include <unordered_set>
+
+#include "Attribute.hpp"
+#include "Component.hpp"
+#include "Topology.hpp"
+#include "Thread.hpp"
+#include "Core.hpp"
+#include "Cache.hpp"
+#include "Subdivision.hpp"
+#include "Numa.hpp"
+#include "Chip.hpp"
+#include "Memory.hpp"
+#include "Storage.hpp"
+#include "Node.hpp"
+#include "QuantumBackend.hpp"
+#include "Qubit.hpp"
+#include "AtomSite.hpp"
+#include "Relation.hpp"
+#include "DataPath.hpp"
+#include "QuantumGate.hpp"
+#include "CouplingMap.hpp"
+
+//sizeof the most derived class of c
+static size_t _ComponentObjectSize(const sys_sage::Component* c)
+{
+    using namespace sys_sage;
+    switch(c->GetComponentType())
+    {
+        case ComponentType::Thread: return sizeof(Thread);
+        case ComponentType::Core: return sizeof(Core);
+        case ComponentType::Cache: return sizeof(Cache);
+        case ComponentType::Subdivision: return sizeof(Subdivision);
+        case ComponentType::Numa: return sizeof(Numa);
+        case ComponentType::Chip: return sizeof(Chip);
+        case ComponentType::Memory: return sizeof(Memory);
+        case ComponentType::Storage: return sizeof(Storage);
+        case ComponentType::Node: return sizeof(Node);
+        case ComponentType::QuantumBackend: //AtomSite does not set its own component type
+            return dynamic_cast<const AtomSite*>(c) != nullptr ? sizeof(AtomSite) : sizeof(QuantumBackend);
+        case ComponentType::AtomSite: return sizeof(AtomSite);
+        case ComponentType::Qubit: return sizeof(Qubit);
+        case ComponentType::Topology: return sizeof(Topology);
+        default: return sizeof(Component);
+    }
+}
+
+static size_t _RelationObjectSize(const sys_sage::Relation* r)
+{
+    using namespace sys_sage;
+    switch(r->GetType())
+    {
+        case RelationType::DataPath: return sizeof(DataPath);
+        case RelationType::QuantumGate: return sizeof(QuantumGate);
+        case RelationType::CouplingMap: return sizeof(CouplingMap);
+        default: return sizeof(Relation);
+    }
+}
+
+sys_sage::MemoryFootprint sys_sage::GetMemoryFootprint(const Component* root)
+{
+    MemoryFootprint footprint;
+    if(root == nullptr)
+        return footprint;
+
+    std::unordered_set<const Relation*> countedRelations;
+    for(Component* c : const_cast<Component*>(root)->PreOrder())
+    {
+        size_t bytes = _ComponentObjectSize(c) + c->_GetOwnedMemory(&footprint);
+        footprint.componentBytes[c->GetComponentType()] += bytes;
+        footprint.componentCounts[c->GetComponentType()]++;
+        footprint.componentCount++;
+        footprint.totalBytes += bytes;
+
+        for(RelationType::type rt : RelationType::RelationTypeList)
+        {
+            for(Relation* r : c->GetRelations(rt))
+            {
+                if(!countedRelations.insert(r).second)
+                    continue;
+                size_t relationBytes = _RelationObjectSize(r) + r->_GetOwnedMemory(&footprint);
+                footprint.relationBytes[rt] += relationBytes;
+                footprint.relationCounts[rt]++;
+                footprint.relationCount++;
+                footprint.totalBytes += relationBytes;
+            }
+        }
+    }
+    footprint.totalBytes += footprint.indexBytes + footprint.arenaSlackBytes;
+    return footprint;
+}
+
+size_t sys_sage::MemoryFootprint::_AddString(const std::string& s)
+{
+    //strings whose characters live inside the string object (small-string optimization) own no heap memory
+    const char* self = reinterpret_cast<const char*>(&s);
+    if(s.data() >= self && s.data() < self + sizeof(std::string))
+        return 0;
+    size_t bytes = s.capacity() + 1;
+    stringBytes += bytes;
+    return bytes;
+}
+
+size_t sys_sage::MemoryFootprint::_AddAttributes(const AttributeStore* store, const std::map<std::string, void*>& attrib)
+{
+    size_t bytes = 0;
+    if(store != nullptr)
+    {
+        const std::vector<AttributeStore::Entry>& entries = store->GetEntries();
+        bytes += sizeof(AttributeStore) + _AddVector(entries);
+        for(const AttributeStore::Entry& e : entries)
+        {
+            size_t entryBytes = sizeof(AttributeStore::Entry);
+            if(e.ops != nullptr)
+            {
+                entryBytes += e.ops->size;
+                if(e.type == AttributeType::String)
+                    entryBytes += _AddString(*static_cast<const std::string*>(e.Get()));
+                else if(e.type == AttributeType::FrequencyHistory)
+                    entryBytes += _AddVector(*static_cast<const FrequencyHistory*>(e.Get()));
+                else if(e.type == AttributeType::Lazy)
+                    entryBytes += _AddString(static_cast<const LazyAttribute*>(e.Get())->payload);
+                //Custom values: only sizeof(T) is known
+            }
+            attributeBytes[AttributeKey::GetName(e.key)] += entryBytes;
+            bytes += entryBytes - sizeof(AttributeStore::Entry); //the entry itself is part of the vector capacity
+        }
+    }
+    for(const auto& [key, value] : attrib)
+    {
+        size_t entryBytes = _rbNodeHeader + sizeof(std::pair<const std::string, void*>) + _AddString(key);
+        attributeBytes[key] += entryBytes;
+        bytes += entryBytes;
+    }
+    return bytes;
+}
+
+void sys_sage::MemoryFootprint::Print() const
+{
+    std::cout << "Memory footprint: " << totalBytes << " bytes (" << componentCount << " components, " << relationCount << " relations)" << std::endl;
+    std::cout << "  components:" << std::endl;
+    for(const auto& [componentType, bytes] : componentBytes)
+        std::cout << "    " << ComponentType::ToString(componentType) << ": " << bytes << " bytes (" << componentCounts.at(componentType) << "x)" << std::endl;
+    std::cout << "  relations:" << std::endl;
+    for(const auto& [relationType, bytes] : relationBytes)
+        std::cout << "    " << RelationType::ToString(relationType) << ": " << bytes << " bytes (" << relationCounts.at(relationType) << "x)" << std::endl;
+    std::cout << "  attributes:" << std::endl;
+    for(const auto& [key, bytes] : attributeBytes)
+        std::cout << "    " << key << ": " << bytes << " bytes" << std::endl;
+    std::cout << "  strings: " << stringBytes << " bytes" << std::endl;
+    std::cout << "  vector slack: " << vectorSlackBytes << " bytes" << std::endl;
+    std::cout << "  indices: " << indexBytes << " bytes" << std::endl;
+    std::cout << "  arena slack: " << arenaSlackBytes << " bytes" << std::endl;
+}
@@ -0,0 +1,100 @@
+#ifndef MEMORY_FOOTPRINT_HPP
+#define MEMORY_FOOTPRINT_HPP
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "enums.hpp"
+
+namespace sys_sage {
+
+    class Component;
+    class AttributeStore;
+
+    /**
+     * @struct MemoryFootprint
+     * @brief Memory footprint of a component subtree and of the Relations of its components, broken down by component type, relation type and attribute key.
+     *
+     * The sizes are computed by precise size functions: every object counts its sizeof plus the heap memory it owns
+     * (string buffers outside of the small-string buffer, vector capacities, maps, typed attribute values).
+     * Node-based containers (std::map, std::unordered_map) are counted with the node layout of libstdc++; allocator (malloc) overhead is not included.
+     * \n The partition is: totalBytes = sum(componentBytes) + sum(relationBytes) + indexBytes + arenaSlackBytes.
+     * attributeBytes, stringBytes and vectorSlackBytes are cross-cutting views -- their bytes are already contained in the bytes of the owning component or relation.
+     * @see GetMemoryFootprint(const Component* root)
+     */
+    struct MemoryFootprint {
+        size_t totalBytes = 0; /**< Total footprint in bytes. */
+        size_t componentCount = 0; /**< Number of components in the subtree. */
+        size_t relationCount = 0; /**< Number of Relations with at least one component in the subtree (each counted once). */
+        std::map<ComponentType::type, size_t> componentBytes; /**< Bytes per component type: objects and the heap memory they own (including their attributes). */
+        std::map<ComponentType::type, size_t> componentCounts; /**< Number of components per component type. */
+        std::map<RelationType::type, size_t> relationBytes; /**< Bytes per relation type: objects and the heap memory they own (including their attributes). */
+        std::map<RelationType::type, size_t> relationCounts; /**< Number of Relations per relation type. */
+        std::map<std::string, size_t> attributeBytes; /**< Bytes per attribute key (typed attributes and entries of the legacy attrib maps). Opaque values of the legacy attrib maps count as the pointer only. */
+        size_t stringBytes = 0; /**< Heap buffers of strings (names, attribute keys and values, ...). */
+        size_t vectorSlackBytes = 0; /**< Unused vector capacity (capacity - size). */
+        size_t indexBytes = 0; /**< Lookup structures: Topology component index, relation registry and LCA index, child id maps. */
+        size_t arenaSlackBytes = 0; /**< Memory reserved by Topology arenas but not handed out to objects (plus the arena objects themselves). */
+
+        /**
+         * @brief Prints the footprint (totals and per-category breakdown) to std::cout.
+         */
+        void Print() const;
+
+        /**
+         * @private
+         * @brief Returns the heap bytes of a string (0 if it fits in the small-string buffer) and adds them to stringBytes.
+         */
+        size_t _AddString(const std::string& s);
+        /**
+         * @private
+         * @brief Returns the heap bytes of a vector (its capacity) and adds the unused capacity to vectorSlackBytes.
+         */
+        template <class T>
+        size_t _AddVector(const std::vector<T>& v)
+        {
+            vectorSlackBytes += (v.capacity() - v.size()) * sizeof(T);
+            return v.capacity() * sizeof(T);
+        }
+        /**
+         * @private
+         * @brief Returns the bytes of the nodes of a std::map (keys and values are counted by sizeof only).
+         */
+        template <class K, class V, class C>
+        static size_t _MapBytes(const std::map<K, V, C>& m)
+        {
+            return m.size() * (_rbNodeHeader + sizeof(typename std::map<K, V, C>::value_type));
+        }
+        /**
+         * @private
+         * @brief Returns the bytes of the bucket array and nodes of an unordered (multi)map (keys and values are counted by sizeof only).
+         */
+        template <class Map>
+        static size_t _UnorderedMapBytes(const Map& m)
+        {
+            return m.bucket_count() * sizeof(void*) + m.size() * (sizeof(void*) + sizeof(typename Map::value_type));
+        }
+        /**
+         * @private
+         * @brief Returns the bytes of an attribute store and of a legacy attrib map, and adds them per key to attributeBytes.
+         */
+        size_t _AddAttributes(const AttributeStore* store, const std::map<std::string, void*>& attrib);
+
+    private:
+        static constexpr size_t _rbNodeHeader = 4 * sizeof(void*); /**< color + parent/left/right pointers of a red-black tree node */
+    };
+
+    /**
+     * @brief Computes the memory footprint of the subtree of root (including root) and of all Relations of its components.
+     * Relations shared by several components of the subtree are counted once.
+     * @param root Root of the subtree
+     * @return The footprint
+     * @see MemoryFootprint
+     */
+    MemoryFootprint GetMemoryFootprint(const Component* root);
+
+} //namespace sys_sage
+#endif //MEMORY_FOOTPRINT_HPP
@@ -3,3 +3,4 @@
 
 sys_sage::Node::Node(int _id, std::string _name):Component(_id, _name, sys_sage::ComponentType::Node){}
 sys_sage::Node::Node(Component * parent, int _id, std::string _name):Component(parent, _id, _name, sys_sage::ComponentType::Node){}
+sys_sage::Component* sys_sage::Node::_CloneInstance() const { return new Node(*this); }
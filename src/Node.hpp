@@ -31,6 +31,11 @@ namespace sys_sage {
         * Use Delete() or DeleteSubtree() for deleting and deallocating the components. 
         */
         ~Node() override = default;
+        /**
+        * @private
+        * Returns a copy of this Node (see Component::_CloneInstance()).
+        */
+        Component* _CloneInstance() const override;
     #ifdef PROC_CPUINFO
     public:
         /**
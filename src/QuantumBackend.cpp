@@ -1,13 +1,14 @@
 #include "QuantumBackend.hpp"
 
 #include "Qubit.hpp"
+#include "MemoryFootprint.hpp"
 
 
 
 sys_sage::QuantumBackend::QuantumBackend(int _id, std::string _name):Component(_id, _name, sys_sage::ComponentType::QuantumBackend){}
 sys_sage::QuantumBackend::QuantumBackend(Component * _parent, int _id, std::string _name):Component(_parent, _id, _name, sys_sage::ComponentType::QuantumBackend){}
 
-void sys_sage::QuantumBackend::SetNumQubits(int _num_qubits) { num_qubits = _num_qubits; }
+void sys_sage::QuantumBackend::SetNumQubits(int _num_qubits) { num_qubits = _num_qubits; MarkModified(); }
 
 int sys_sage::QuantumBackend::GetNumQubits() const { return num_qubits; }
 
@@ -66,10 +67,17 @@ std::vector<sys_sage::Qubit *> sys_sage::QuantumBackend::GetAllQubits()
     return qubits;
 }
 
+size_t sys_sage::QuantumBackend::_GetOwnedMemory(MemoryFootprint* footprint) const
+{
+    //the gates themselves are Relations and are counted as such
+    return Component::_GetOwnedMemory(footprint) + footprint->_AddVector(gate_types);
+}
+
 #ifdef QDMI
 void sys_sage::QuantumBackend::SetQDMIDevice(QDMI_Device dev)
 {
     device = dev;
+    MarkModified();
 }
 
 QDMI_Device sys_sage::QuantumBackend::GetQDMIDevice(){ return device; }
@@ -126,7 +126,22 @@ namespace sys_sage {
         !!Should normally not be used!! Helper function of XML dump generation.
         @see exportToXml(Component* root, string path = "", std::function<int(string,void*,string*)> custom_search_attrib_key_fcn = NULL);
         */
-        xmlNodePtr _CreateXmlSubtree() override;
+        void _WriteXml(XmlStreamWriter* w) override;
+        /**
+         * @private
+         * @brief Adds the heap members of this class to Component::_GetOwnedMemory().
+         */
+        size_t _GetOwnedMemory(MemoryFootprint* footprint) const override;
+        /**
+         * @private
+         * @brief Stores the members of this class as type-specific fields (see BinaryComponentRecord).
+         */
+        void _WriteBinaryFields(BinaryWriter* w, BinaryComponentRecord* rec) const override;
+        /**
+         * @private
+         * @brief Restores the members stored by _WriteBinaryFields().
+         */
+        void _ReadBinaryFields(const BinaryTopologyView* v, const BinaryComponentRecord* rec) override;
 
         /** Destructor for QuantumBackend. */
         ~QuantumBackend() override = default;
@@ -3,6 +3,8 @@
 
 #include <iostream>
 
+#include "MemoryFootprint.hpp"
+
 sys_sage::QuantumGate::QuantumGate(size_t _gate_size, std::string _name, double _fidelity, std::string _unitary) : Relation(sys_sage::RelationType::QuantumGate), gate_size(_gate_size), name(_name), fidelity(_fidelity), unitary(_unitary) {}
 sys_sage::QuantumGate::QuantumGate(size_t _gate_size, const std::vector<Qubit *> & _qubits) : QuantumGate(_gate_size, _qubits, "QuantumGate", 0.0, ""){}
 sys_sage::QuantumGate::QuantumGate(size_t _gate_size, const std::vector<Qubit *> & _qubits, std::string _name, double _fidelity, std::string _unitary) : Relation(sys_sage::RelationType::QuantumGate), gate_size(_gate_size), fidelity(_fidelity), unitary(_unitary) 
@@ -21,6 +23,7 @@ void sys_sage::QuantumGate::SetGateProperties(std::string _name, double _fidelit
     fidelity = _fidelity;
     unitary = _unitary;
     SetQuantumGateType();
+    MarkModified();
 }
 
 void sys_sage::QuantumGate::SetQuantumGateType()
@@ -53,11 +56,13 @@ void sys_sage::QuantumGate::SetQuantumGateType()
 void sys_sage::QuantumGate::SetName(std::string _name)
 {
     name = _name;
+    MarkModified();
 }
 
 void sys_sage::QuantumGate::SetGateSize(size_t gateSize)
 {
     gate_size = gateSize;
+    MarkModified();
 }
 
 int sys_sage::QuantumGate::GetGateLength() const
@@ -68,16 +73,19 @@ int sys_sage::QuantumGate::GetGateLength() const
 void sys_sage::QuantumGate::SetGateLength(int GateLength)
 {
     gate_length = GateLength;
+    MarkModified();
 }
 
 void sys_sage::QuantumGate::SetFidelity(double gateFidelity)
 {
     fidelity = gateFidelity;
+    MarkModified();
 }
 
 void sys_sage::QuantumGate::SetUnitary(const std::string & gateUnitary)
 {
     unitary = gateUnitary;
+    MarkModified();
 }
 
 sys_sage::QuantumGateType::type sys_sage::QuantumGate::GetQuantumGateType() const { return gate_type; }
@@ -95,4 +103,7 @@ void sys_sage::QuantumGate::Print() const
     std::cout << std::endl;
 }
 
-
+size_t sys_sage::QuantumGate::_GetOwnedMemory(MemoryFootprint* footprint) const
+{
+    return Relation::_GetOwnedMemory(footprint) + footprint->_AddString(name) + footprint->_AddString(unitary);
+}
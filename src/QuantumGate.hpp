@@ -163,9 +163,13 @@ namespace sys_sage {
          * @brief Helper function for XML export.
          *
          * Should normally not be used directly. Used internally for exporting the quantum gate to XML.
-         * @return Pointer to the created XML entry node.
          */
-        xmlNodePtr _CreateXmlEntry() override;
+        void _WriteXmlEntry(XmlStreamWriter* w) override;
+        /**
+         * @private
+         * @brief Adds the heap members of this class to Relation::_GetOwnedMemory().
+         */
+        size_t _GetOwnedMemory(MemoryFootprint* footprint) const override;
 
     private:
 
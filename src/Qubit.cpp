@@ -1,5 +1,7 @@
 #include "Qubit.hpp"
 
+#include "MemoryFootprint.hpp"
+
 
 
 sys_sage::Qubit::Qubit(int _id, std::string _name):Component(_id, _name, sys_sage::ComponentType::Qubit){}
@@ -13,7 +15,7 @@ void sys_sage::Qubit::SetProperties(double _t1, double _t2, double _readout_fide
     readout_fidelity = _readout_fidelity;
     q1_fidelity = _q1_fidelity;
     readout_length = _readout_length;
-
+    MarkModified();
 }
 
 double sys_sage::Qubit::GetT1() const { return t1; }    
@@ -23,3 +25,8 @@ double sys_sage::Qubit::Get1QFidelity() const { return q1_fidelity;}
 double sys_sage::Qubit::GetReadoutLength() const { return readout_length; }
 double sys_sage::Qubit::GetFrequency() const { return frequency; }
 const std::string& sys_sage::Qubit::GetCalibrationTime() const { return calibration_time; }
+
+size_t sys_sage::Qubit::_GetOwnedMemory(MemoryFootprint* footprint) const
+{
+    return Component::_GetOwnedMemory(footprint) + footprint->_AddString(calibration_time);
+}
@@ -2,11 +2,19 @@
 #include "Relation.hpp"
 #include <iostream>
 #include "Component.hpp"
+#include "Topology.hpp"
+#include "Arena.hpp"
+#include "MemoryFootprint.hpp"
+#include "Epoch.hpp"
 
 using std::cout;
 using std::endl;
 
 sys_sage::Relation::Relation(RelationType::type _relation_type): type(_relation_type) {}
+sys_sage::Relation::~Relation()
+{
+    delete attributes;
+}
 sys_sage::Relation::Relation(const std::vector<Component*>& components, int _id, bool _ordered, RelationType::type _relation_type): ordered(_ordered), id(_id), type(_relation_type)
 {
     for (Component* c : components) {
@@ -15,8 +23,36 @@ sys_sage::Relation::Relation(const std::vector<Component*>& components, int _id,
 }
 sys_sage::Relation::Relation(const std::vector<Component*>& components, int _id, bool _ordered): Relation(components, _id, _ordered, sys_sage::RelationType::Relation) {}
 
-void sys_sage::Relation::SetId(int _id) {id = _id;}
+void* sys_sage::Relation::operator new(size_t size) { return _ArenaAwareAllocate(size); }
+void sys_sage::Relation::operator delete(void* ptr) { _ArenaAwareFree(ptr); }
+
+size_t sys_sage::Relation::_GetOwnedMemory(MemoryFootprint* footprint) const
+{
+    return footprint->_AddVector(components) + footprint->_AddVector(componentSlots) + footprint->_AddAttributes(attributes, attrib);
+}
+
+sys_sage::Relation* sys_sage::Relation::_CloneReplacing(const std::unordered_map<Component*, Component*>& copies) const
+{
+    if(type != RelationType::Relation)
+        return nullptr;
+    std::vector<Component*> newComponents;
+    newComponents.reserve(components.size());
+    for(Component* c : components)
+    {
+        auto it = copies.find(c);
+        newComponents.push_back(it == copies.end() ? c : it->second);
+    }
+    Relation* r = new Relation(newComponents, id, ordered);
+    const AttributeStore* store = GetAttributes();
+    if(store != nullptr)
+        r->attributes = new AttributeStore(*store);
+    return r;
+}
+
+void sys_sage::Relation::SetId(int _id) {id = _id; MarkModified();}
 int sys_sage::Relation::GetId() const{ return id; }
+uint64_t sys_sage::Relation::GetVersion() const { return std::atomic_ref<uint64_t>(const_cast<uint64_t&>(version)).load(std::memory_order_relaxed); }
+void sys_sage::Relation::MarkModified() { std::atomic_ref<uint64_t>(version).store(_NextVersion(), std::memory_order_relaxed); }
 bool sys_sage::Relation::IsOrdered() const{ return ordered; }
 bool sys_sage::Relation::ContainsComponent(Component* c) const
 {
@@ -40,8 +76,39 @@ const std::vector<sys_sage::Component*>& sys_sage::Relation::GetComponents() con
 
 void sys_sage::Relation::AddComponent(Component* c)
 {
+    c->_MaterializeIfShared();
     components.emplace_back(c);
-    c->_AddRelation(type, this);
+    componentSlots.push_back(c->_AddRelation(type, this));
+    MarkModified();
+    //the first component determines the Topology registry
+    if(components.size() == 1)
+    {
+        Topology* t = c->_FindRelationRegistry();
+        if(t != nullptr)
+            t->_RegisterRelation(this);
+    }
+}
+
+int32_t sys_sage::Relation::_GetComponentSlot(int index) const { return componentSlots[index]; }
+
+void sys_sage::Relation::_UpdateComponentSlot(const Component* c, int32_t oldSlot, int32_t newSlot)
+{
+    for(size_t i = 0; i < components.size(); i++)
+    {
+        if(components[i] == c && componentSlots[i] == oldSlot)
+        {
+            componentSlots[i] = newSlot;
+            return;
+        }
+    }
+}
+
+sys_sage::Topology* sys_sage::Relation::_GetRegistry() const { return registry; }
+int32_t sys_sage::Relation::_GetRegistryIndex() const { return registryIndex; }
+void sys_sage::Relation::_SetRegistryEntry(Topology* _registry, int32_t _registryIndex)
+{
+    registry = _registry;
+    registryIndex = _registryIndex;
 }
 
 
@@ -55,6 +122,26 @@ void sys_sage::Relation::_PrintRelationComponentInfo() const
 }
 void sys_sage::Relation::_PrintRelationAttrib() const
 {
+    const AttributeStore* store = GetAttributes();
+    if(store != nullptr && store->Size() > 0)
+    {
+        cout << " -- attributes: ";
+        for(const AttributeStore::Entry& e : store->GetEntries())
+        {
+            std::cout << AttributeKey::GetName(e.key) << " = ";
+            switch(e.type)
+            {
+                case AttributeType::Int: std::cout << e.value.i; break;
+                case AttributeType::LongLong: std::cout << e.value.ll; break;
+                case AttributeType::UInt64: std::cout << e.value.u64; break;
+                case AttributeType::Float: std::cout << e.value.f; break;
+                case AttributeType::Double: std::cout << e.value.d; break;
+                case AttributeType::String: std::cout << *static_cast<const std::string*>(e.Get()); break;
+                default: std::cout << "(complex)"; break;
+            }
+            std::cout << "; ";
+        }
+    }
     if(!attrib.empty())
     {
         cout << " -- attrib: ";
@@ -74,12 +161,24 @@ void sys_sage::Relation::Print() const
 
 void sys_sage::Relation::Delete()
 {
-    for(Component* c : components)
+    Topology* tracking = components.empty() ? nullptr : components[0]->_FindChangeTracking();
+    if(tracking != nullptr)
+        tracking->_RecordDeletion(this, true, false);
+    //O(1) per component thanks to the back-indices (componentSlots is updated while unlinking if this Relation is listed multiple times by the same component)
+    for(size_t i = 0; i < components.size(); i++)
     {
-        std::vector<Relation*>& component_relation_vector = c->_GetRelations(type);
-        component_relation_vector.erase(std::remove(component_relation_vector.begin(), component_relation_vector.end(), this), component_relation_vector.end());
+        if(componentSlots[i] >= 0)
+            components[i]->_RemoveRelation(type, componentSlots[i]);
+        componentSlots[i] = -1;
     }
-    delete this;
+    if(registry != nullptr)
+        registry->_UnregisterRelation(this);
+    //concurrent readers may still hold this Relation (see EpochDomain)
+    EpochDomain* domain = _FindEpochDomain();
+    if(domain != nullptr)
+        domain->Retire([this]{ delete this; });
+    else
+        delete this;
 }
 sys_sage::RelationType::type sys_sage::Relation::GetType() const{ return type;}
 std::string sys_sage::Relation::GetTypeStr() const
@@ -96,11 +195,25 @@ int sys_sage::Relation::UpdateComponent(int index, Component * _new_component)
         std::cerr << "WARNING: sys_sage::Relation::UpdateComponent index out of bounds -- nothing updated." << std::endl;
         return 1;
     }
-    std::vector<Relation*>& component_relation_vector = components[index]->_GetRelations(type);
-    component_relation_vector.erase(std::remove(component_relation_vector.begin(), component_relation_vector.end(), this), component_relation_vector.end());
+    _new_component->_MaterializeIfShared();
+    if(componentSlots[index] >= 0)
+        components[index]->_RemoveRelation(type, componentSlots[index]);
 
-    _new_component->_AddRelation(type, this);
+    componentSlots[index] = _new_component->_AddRelation(type, this);
     components[index] = _new_component;
+    MarkModified();
+    //a new first component may belong to a different Topology registry
+    if(index == 0)
+    {
+        Topology* t = _new_component->_FindRelationRegistry();
+        if(t != registry)
+        {
+            if(registry != nullptr)
+                registry->_UnregisterRelation(this);
+            if(t != nullptr)
+                t->_RegisterRelation(this);
+        }
+    }
     return 0;
 }
 
@@ -115,3 +228,51 @@ int sys_sage::Relation::UpdateComponent(Component* _old_component, Component * _
     int index = it - components.begin();
     return UpdateComponent(index, _new_component);
 }
+
+bool sys_sage::Relation::HasAttribute(AttributeKey::type key) const
+{
+    const AttributeStore* store = GetAttributes();
+    return store != nullptr && store->Contains(key);
+}
+bool sys_sage::Relation::HasAttribute(const std::string& key) const { return HasAttribute(AttributeKey::Find(key)); }
+int sys_sage::Relation::RemoveAttribute(AttributeKey::type key)
+{
+    if(!HasAttribute(key))
+        return 0;
+    AttributeStore* store = _BeginAttributeWrite(key);
+    int ret = store->Remove(key);
+    _EndAttributeWrite(store);
+    return ret;
+}
+int sys_sage::Relation::RemoveAttribute(const std::string& key) { return RemoveAttribute(AttributeKey::Find(key)); }
+const sys_sage::AttributeStore* sys_sage::Relation::GetAttributes() const { return std::atomic_ref<AttributeStore*>(const_cast<AttributeStore*&>(attributes)).load(std::memory_order_acquire); }
+
+sys_sage::AttributeStore* sys_sage::Relation::_BeginAttributeWrite(AttributeKey::type key)
+{
+    EpochDomain* domain = _FindEpochDomain();
+    if(domain != nullptr)
+        return domain->_BeginAttributeWrite(attributes, key);
+    if(attributes == nullptr)
+        attributes = new AttributeStore();
+    return attributes;
+}
+
+void sys_sage::Relation::_EndAttributeWrite(AttributeStore* store)
+{
+    if(store != attributes)
+        _FindEpochDomain()->_PublishAttributes(&attributes, store);
+    MarkModified();
+}
+
+sys_sage::EpochDomain* sys_sage::Relation::_FindEpochDomain() const
+{
+    if(!EpochDomain::_AnyDomain())
+        return nullptr;
+    for(Component* c : components)
+    {
+        EpochDomain* domain = c->_FindEpochDomain();
+        if(domain != nullptr)
+            return domain;
+    }
+    return nullptr;
+}
@@ -13,16 +13,24 @@
  */
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include <libxml/parser.h>
 
 #include "defines.hpp"
+#include "Attribute.hpp"
 #include "enums.hpp"
 
 namespace sys_sage { //forward declaration
     class Component;
     class Qubit;
+    class Topology;
+    class EpochDomain;
+    class XmlStreamWriter;
+    struct MemoryFootprint;
+
+    uint64_t _NextVersion(); //see Component.hpp
 }
 
 namespace sys_sage {
@@ -65,6 +73,16 @@ namespace sys_sage {
          * @return The current id of the relationship.
          */
         int GetId() const;
+        /**
+         * @brief Returns the version of the relation: the value of the global modification counter (see GetCurrentVersion()) at its last change.
+         * The version is updated on creation, by the property setters, by writes of typed attributes and when components are added or replaced (AddComponent(), UpdateComponent()).
+         * @see exportDeltaToXml()
+         */
+        uint64_t GetVersion() const;
+        /**
+         * @brief Updates the version of the relation (see GetVersion()). Needed after changes that sys-sage does not see, e.g. of the legacy attrib map.
+         */
+        void MarkModified();
         /**
          * @brief Get the type of the relation.
          * @return The current type of the relation (as sys_sage::RelationType::type).
@@ -121,10 +139,36 @@ namespace sys_sage {
         */ 
         void _PrintRelationComponentInfo() const;
         /**
-         * @brief Add a new component to the relation.
+         * @brief Add a new component to the relation. A shared component (see Component::IsShared()) is materialized first.
          * @param c Component to append to the internal list.
          */
         void AddComponent(Component* c);
+        /**
+         * @private
+         * @brief Returns the position of this Relation in the relation vector of GetComponent(index) (back-index), or -1 if that component does not list this Relation.
+         */
+        int32_t _GetComponentSlot(int index) const;
+        /**
+         * @private
+         * @brief Called by Component::_RemoveRelation when this Relation was moved from position oldSlot to newSlot in c's relation vector.
+         */
+        void _UpdateComponentSlot(const Component* c, int32_t oldSlot, int32_t newSlot);
+        /**
+         * @private
+         * @brief Returns the Topology whose relation registry contains this Relation (nullptr if none).
+         * @see Topology::EnableRelationRegistry()
+         */
+        Topology* _GetRegistry() const;
+        /**
+         * @private
+         * @brief Returns the position of this Relation in its Topology's relation registry.
+         */
+        int32_t _GetRegistryIndex() const;
+        /**
+         * @private
+         * @brief Only called by Topology when (un)registering this Relation or moving it within the registry.
+         */
+        void _SetRegistryEntry(Topology* _registry, int32_t _registryIndex);
         /**
          * @brief Replace a component at the given index.
          * @param index The index of the component to replace.
@@ -145,24 +189,55 @@ namespace sys_sage {
 
         /**
          * @private
-         * @brief Serialize this relation to XML.
-         * @return A libxml node representing the relation.
+         * @brief Serialize this relation to XML: writes its XML element to w.
+         * Subclasses write their own XML attributes between _WriteXmlEntryStart() and _WriteXmlEntryContent().
          *
          * Should normally not be used directly. Used internally for exporting the relation to XML.
          */
-        virtual xmlNodePtr _CreateXmlEntry();
+        virtual void _WriteXmlEntry(XmlStreamWriter* w);
+        /**
+         * @private
+         * @brief Opens the XML element of this relation and writes the common XML attributes (components, ordered, id).
+         */
+        void _WriteXmlEntryStart(XmlStreamWriter* w);
+        /**
+         * @private
+         * @brief Writes the (typed and legacy) attributes into the open XML element of this relation; the element stays open.
+         */
+        void _WriteXmlEntryContent(XmlStreamWriter* w);
+        /**
+         * @private
+         * @brief Returns the heap memory owned by this relation (not including the object itself); used by GetMemoryFootprint().
+         */
+        virtual size_t _GetOwnedMemory(MemoryFootprint* footprint) const;
+        /**
+         * @private
+         * @brief Returns a new relation of the same type and properties (and typed attributes) whose components are replaced as given by copies (components not in copies are kept),
+         * or nullptr if the relation type does not support copies (QuantumGate, CouplingMap).
+         * Used by Component::SplitCollapsed().
+         */
+        virtual Relation* _CloneReplacing(const std::unordered_map<Component*, Component*>& copies) const;
         /**
          * @brief Virtual function to delete the relation.
          *
          * Should be overridden in subclasses if custom destruction logic is needed.
+         * With concurrent reads enabled (see Topology::EnableConcurrentReads()), the Relation is unlinked immediately but destroyed only after all readers have left.
          */
         virtual void Delete();//TODO
         /**
          * @brief Destructor for the Relation class.
          * 
-         * This is a virtual destructor to ensure proper cleanup of derived classes.
+         * This is a virtual destructor to ensure proper cleanup of derived classes. Destroys the typed attributes.
          */
-        virtual ~Relation() = default;
+        virtual ~Relation();
+        /**
+         * @brief Allocates a Relation. If an arena is active on the calling thread (see ArenaScope), the Relation is placed in it.
+         */
+        static void* operator new(size_t size);
+        /**
+         * @brief Deallocates a Relation (a no-op for Relations placed in an arena, which are reclaimed with the arena).
+         */
+        static void operator delete(void* ptr);
     protected:
         /**
          * @private
@@ -189,7 +264,7 @@ namespace sys_sage {
          *
          * This member variable stores the unique identifier for the relationship.
          */
-        int id;
+        int id = 0;
         /**
          * @brief The type of the relationship (see RelationType::type).
          *
@@ -205,8 +280,77 @@ namespace sys_sage {
         std::vector<Component*> components;
 
     public:
+        /**
+         * @brief Sets (inserts or overwrites) a typed attribute. The Relation owns the value; it is destroyed together with the Relation.
+         * Scalars (int, long long, uint64_t, float, double) are stored inline; other types are allocated once.
+         * \n Example: c->SetAttribute(AttributeKey::Clock_Frequency, 1.2e9); c->SetAttribute("my_key", std::string("value"));
+         * @param key Attribute key (see AttributeKey for the predefined keys)
+         * @param value The value
+         * @return Reference to the stored value
+         */
+        template <class T>
+        T& SetAttribute(AttributeKey::type key, T value)
+        {
+            static_assert(!std::is_same_v<T, const char*> && !std::is_same_v<T, char*>, "store strings as std::string");
+            AttributeStore* store = _BeginAttributeWrite(key);
+            T& ret = store->Set<T>(key, std::move(value));
+            _EndAttributeWrite(store);
+            return ret;
+        }
+        /**
+         * @brief Sets (inserts or overwrites) a typed attribute; the key name is interned.
+         */
+        template <class T>
+        T& SetAttribute(const std::string& key, T value) { return SetAttribute<T>(AttributeKey::Intern(key), std::move(value)); }
+        /**
+         * @brief Returns a pointer to the value of a typed attribute, or nullptr if the attribute does not exist or holds a different type than T.
+         * \n Example: double* f = c->GetAttribute<double>(AttributeKey::Clock_Frequency);
+         */
+        template <class T>
+        T* GetAttribute(AttributeKey::type key) const
+        {
+            const AttributeStore* store = GetAttributes();
+            return store == nullptr ? nullptr : store->Get<T>(key);
+        }
+        /**
+         * @brief Returns a pointer to the value of a typed attribute (looked up by name), or nullptr.
+         */
+        template <class T>
+        T* GetAttribute(const std::string& key) const { return GetAttribute<T>(AttributeKey::Find(key)); }
+        /**
+         * @brief Returns true if a typed attribute with the given key exists.
+         */
+        bool HasAttribute(AttributeKey::type key) const;
+        bool HasAttribute(const std::string& key) const;
+        /**
+         * @brief Removes (and destroys) a typed attribute.
+         * @return 1 if the attribute was removed, 0 if it did not exist
+         */
+        int RemoveAttribute(AttributeKey::type key);
+        int RemoveAttribute(const std::string& key);
+        /**
+         * @brief Returns the typed attributes of this Relation (nullptr if it has none).
+         */
+        const AttributeStore* GetAttributes() const;
+        /**
+         * @private
+         * @brief Returns the store that SetAttribute()/RemoveAttribute() modify: the own store, or -- with concurrent reads enabled -- a copy-on-write copy (see EpochDomain).
+         */
+        AttributeStore* _BeginAttributeWrite(AttributeKey::type key);
+        /**
+         * @private
+         * @brief Publishes the store returned by _BeginAttributeWrite() (if it is a copy).
+         */
+        void _EndAttributeWrite(AttributeStore* store);
+        /**
+         * @private
+         * @brief Returns the EpochDomain of the first component of this Relation that belongs to a Topology with enabled concurrent reads, or nullptr.
+         */
+        EpochDomain* _FindEpochDomain() const;
+
         /**
         * A map for storing arbitrary pieces of information or data.
+        * \n This is the legacy, untyped attribute map; its values are NOT owned (nor deallocated) by sys-sage. Prefer the typed attributes (SetAttribute()/GetAttribute()), which sys-sage uses for all its own attributes.
         * - The `key` denotes the name of the attribute.
         * - The `value` points to the data, stored as a `void*`.
         *
@@ -278,6 +422,16 @@ namespace sys_sage {
         *   type when retrieving values from the map.
         */
         std::map<std::string, void*> attrib;
+    protected:
+        AttributeStore* attributes = nullptr; /**< Typed attributes owned by this Relation. Allocated on the first SetAttribute(). Swapped atomically (copy-on-write) when concurrent reads are enabled. */
+        /**
+         * @brief Back-indices: componentSlots[i] is the position of this Relation in the relation vector of components[i] (-1 if components[i] does not list this Relation, e.g. the target of a DataPath from a component to itself).
+         * Allows Delete() and UpdateComponent() to unlink the Relation in O(1) per component.
+         */
+        std::vector<int32_t> componentSlots;
+        Topology* registry = nullptr; /**< Topology whose relation registry contains this Relation (see Topology::EnableRelationRegistry()). */
+        int32_t registryIndex = -1; /**< Position of this Relation in the registry. */
+        uint64_t version{_NextVersion()}; /**< Version of the last change (see GetVersion()). Accessed atomically, like Component::version. */
     };
 
 }
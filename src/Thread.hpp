@@ -32,6 +32,11 @@ namespace sys_sage {
         * Use Delete() or DeleteSubtree() for deleting and deallocating the components. 
         */
         ~Thread() override = default;
+        /**
+        * @private
+        * Returns a copy of this Thread (see Component::_CloneInstance()).
+        */
+        Component* _CloneInstance() const override;
 
     #ifdef PROC_CPUINFO //defined in proc_cpuinfo.cpp
     public:
@@ -1,4 +1,517 @@
-
 #include "Topology.hpp"
 
+#include <algorithm>
+
+#include "Relation.hpp"
+#include "MemoryFootprint.hpp"
+
 sys_sage::Topology::Topology():Component(0, "sys-sage Topology", sys_sage::ComponentType::Topology){}
+
+sys_sage::Topology::~Topology()
+{
+    delete epochDomain; //waits for the readers that are still active
+    delete componentIndex;
+    delete componentIndexOrder;
+    delete deletionLog;
+    if(relationRegistry != nullptr)
+    {
+        for(Relation* r : *relationRegistry)
+            r->_SetRegistryEntry(nullptr, -1);
+        delete relationRegistry;
+    }
+    delete arena;
+}
+
+int sys_sage::Topology::EnableArena(bool useHugePages, size_t chunkSize)
+{
+    if(arena != nullptr)
+        return 1;
+    arena = new TopologyArena(useHugePages, chunkSize);
+    return 0;
+}
+
+sys_sage::TopologyArena* sys_sage::Topology::GetArena() const { return arena; }
+
+size_t sys_sage::Topology::_GetOwnedMemory(MemoryFootprint* footprint) const
+{
+    size_t indexBytes = 0;
+    if(componentIndex != nullptr)
+        indexBytes += sizeof(*componentIndex) + MemoryFootprint::_UnorderedMapBytes(*componentIndex);
+    if(componentIndexOrder != nullptr)
+    {
+        indexBytes += sizeof(*componentIndexOrder) + MemoryFootprint::_UnorderedMapBytes(componentIndexOrder->interval) + MemoryFootprint::_UnorderedMapBytes(componentIndexOrder->byKey);
+        for(const auto& [key, candidates] : componentIndexOrder->byKey)
+            indexBytes += footprint->_AddVector(candidates);
+    }
+    if(relationRegistry != nullptr)
+        indexBytes += sizeof(*relationRegistry) + footprint->_AddVector(*relationRegistry);
+    if(deletionLog != nullptr)
+        indexBytes += sizeof(*deletionLog) + footprint->_AddVector(*deletionLog);
+    footprint->indexBytes += indexBytes;
+    if(arena != nullptr)
+        footprint->arenaSlackBytes += sizeof(*arena) + arena->GetReservedBytes() - arena->GetAllocatedBytes();
+    return Component::_GetOwnedMemory(footprint) + (epochDomain != nullptr ? sizeof(*epochDomain) : 0);
+}
+
+//is c in the subtree of root?
+static bool _IsInSubtree(const sys_sage::Component* c, const sys_sage::Component* root)
+{
+    while(c != NULL && c != root)
+        c = c->GetParent();
+    return c != NULL;
+}
+
+void sys_sage::Topology::_DeleteWithArena()
+{
+    if(GetParent() != NULL)
+        GetParent()->RemoveChild(this);
+    delete epochDomain; //waits for the readers that are still active
+    epochDomain = nullptr;
+
+    //Relations fully inside the topology are destroyed once (by their first component); the others are unlinked regularly.
+    std::vector<Relation*> internalRelations;
+    for(Component* c : PreOrder())
+    {
+        for(RelationType::type rt : RelationType::RelationTypeList)
+        {
+            const std::vector<Relation*>& rv = c->GetRelations(rt);
+            for(size_t i = 0; i < rv.size(); )
+            {
+                Relation* r = rv[i];
+                bool internal = true;
+                for(Component* member : r->GetComponents())
+                {
+                    if(!_IsInSubtree(member, this))
+                    {
+                        internal = false;
+                        break;
+                    }
+                }
+                if(!internal)
+                {
+                    r->Delete(); //removes r from rv
+                    continue;
+                }
+                if(r->GetComponent(0) == c)
+                    internalRelations.push_back(r);
+                i++;
+            }
+        }
+    }
+    for(Relation* r : internalRelations)
+    {
+        if(r->_GetRegistry() != nullptr)
+            r->_GetRegistry()->_UnregisterRelation(r); //O(1); the registry may belong to a Topology outside of this subtree
+        delete r;
+    }
+
+    //children before parents; no unlinking from the parents' children vectors needed
+    for(Component* c : PostOrder())
+    {
+        if(c != this)
+            delete c;
+    }
+    children.clear();
+
+    delete componentIndex;
+    componentIndex = nullptr;
+    delete componentIndexOrder;
+    componentIndexOrder = nullptr;
+    delete arena; //releases all chunks at once
+    arena = nullptr;
+    delete this;
+}
+
+uint64_t sys_sage::Topology::_IndexKey(int _id, ComponentType::type _componentType)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(_componentType)) << 32) | static_cast<uint32_t>(_id);
+}
+
+int sys_sage::Topology::EnableComponentIndex()
+{
+    if(componentIndex == nullptr)
+    {
+        componentIndex = new std::unordered_multimap<uint64_t, Component*>();
+        componentIndexOrder = new ComponentIndexOrder();
+    }
+    else
+    {
+        componentIndex->clear();
+        componentIndexOrder->collapsed.clear();
+    }
+
+    _IndexSubtree(this);
+    return componentIndex->size();
+}
+
+void sys_sage::Topology::DisableComponentIndex()
+{
+    delete componentIndex;
+    componentIndex = nullptr;
+    delete componentIndexOrder;
+    componentIndexOrder = nullptr;
+}
+
+bool sys_sage::Topology::IsComponentIndexEnabled() const { return componentIndex != nullptr; }
+
+void sys_sage::Topology::_IndexSubtree(Component* _subtreeRoot)
+{
+    if(componentIndex == nullptr)
+        return;
+    for(Component* c : _subtreeRoot->PreOrder())
+    {
+        componentIndex->emplace(_IndexKey(c->GetId(), c->GetComponentType()), c);
+        if(c->IsCollapsed())
+            componentIndexOrder->collapsed.insert(c);
+    }
+    componentIndexOrder->valid.store(false, std::memory_order_relaxed);
+}
+
+void sys_sage::Topology::_UnindexSubtree(Component* _subtreeRoot)
+{
+    if(componentIndex == nullptr)
+        return;
+    for(Component* c : _subtreeRoot->PreOrder())
+    {
+        if(c->IsCollapsed())
+            componentIndexOrder->collapsed.erase(c);
+        auto range = componentIndex->equal_range(_IndexKey(c->GetId(), c->GetComponentType()));
+        for(auto it = range.first; it != range.second; ++it)
+        {
+            if(it->second == c)
+            {
+                componentIndex->erase(it);
+                break;
+            }
+        }
+    }
+    componentIndexOrder->valid.store(false, std::memory_order_relaxed);
+}
+
+void sys_sage::Topology::_RebuildIndexOrder()
+{
+    ComponentIndexOrder* order = componentIndexOrder;
+    order->interval.clear();
+    order->byKey.clear();
+    order->interval.reserve(componentIndex->size());
+    uint32_t pre = 0;
+    for(Component* c : PreOrder())
+    {
+        order->interval[c] = {pre, pre};
+        order->byKey[_IndexKey(c->GetId(), c->GetComponentType())].emplace_back(pre, c);
+        pre++;
+    }
+    //the subtree of c ends where the subtree of its last child ends
+    for(Component* c : PostOrder())
+    {
+        const std::vector<Component*>& ch = c->GetChildren();
+        if(!ch.empty())
+            order->interval[c].second = order->interval[ch.back()].second;
+    }
+    order->staleWork = 0;
+    order->valid.store(true, std::memory_order_release);
+}
+
+bool sys_sage::Topology::_FindInIndex(const Component* _subtreeRoot, int _id, ComponentType::type _componentType, Component** out_component)
+{
+    if(componentIndex == nullptr)
+        return false;
+
+    ComponentIndexOrder* order = componentIndexOrder;
+    std::unique_lock<std::mutex> lock(order->mutex, std::defer_lock);
+    if(!order->valid.load(std::memory_order_acquire))
+    {
+        lock.lock();
+        if(!order->valid.load(std::memory_order_relaxed))
+        {
+            //walk from each candidate up to _subtreeRoot; a unique candidate is the answer
+            Component* found = NULL;
+            bool ambiguous = false;
+            auto range = componentIndex->equal_range(_IndexKey(_id, _componentType));
+            for(auto it = range.first; it != range.second && !ambiguous; ++it)
+            {
+                const Component* c = it->second;
+                for(; c != NULL && c != _subtreeRoot; c = c->GetParent())
+                    order->staleWork++;
+                if(c == NULL)
+                    continue;
+                ambiguous = found != NULL;
+                found = it->second;
+            }
+            if(!ambiguous && order->staleWork < componentIndex->size())
+            {
+                *out_component = found;
+                return found != NULL || _FindCollapsedInIndex(_subtreeRoot, _id, _componentType, out_component);
+            }
+            //several candidates (only the pre-order knows the first one) or the walks add up to a rebuild
+            _RebuildIndexOrder();
+        }
+    }
+
+    auto root = order->interval.find(_subtreeRoot);
+    if(root == order->interval.end())
+        return false;
+    *out_component = NULL;
+    auto candidates = order->byKey.find(_IndexKey(_id, _componentType));
+    if(candidates != order->byKey.end())
+    {
+        //first candidate at or after _subtreeRoot in pre-order; it is a match if it lies within the subtree's interval
+        auto it = std::lower_bound(candidates->second.begin(), candidates->second.end(), root->second.first,
+            [](const std::pair<uint32_t, Component*>& candidate, uint32_t pre) { return candidate.first < pre; });
+        if(it != candidates->second.end() && it->first <= root->second.second)
+            *out_component = it->second;
+    }
+    return *out_component != NULL || _FindCollapsedInIndex(_subtreeRoot, _id, _componentType, out_component);
+}
+
+bool sys_sage::Topology::_FindCollapsedInIndex(const Component* _subtreeRoot, int _id, ComponentType::type _componentType, Component** out_component) const
+{
+    *out_component = NULL;
+    for(Component* c : componentIndexOrder->collapsed)
+    {
+        if(c->GetComponentType() != _componentType || !c->_RepresentsId(_id))
+            continue;
+        const Component* a = c;
+        while(a != NULL && a != _subtreeRoot)
+            a = a->GetParent();
+        if(a == NULL)
+            continue;
+        if(*out_component != NULL)
+            return false;
+        *out_component = c;
+    }
+    return true;
+}
+
+void sys_sage::Topology::_OnCountChanged(Component* _component)
+{
+    if(componentIndex == nullptr)
+        return;
+    if(_component->IsCollapsed())
+        componentIndexOrder->collapsed.insert(_component);
+    else
+        componentIndexOrder->collapsed.erase(_component);
+}
+
+//calls fcn for every Relation whose first component is c and which is listed at c's position 0 link (i.e. each Relation once)
+template <class Fcn>
+static void _ForEachOwnedRelation(sys_sage::Component* c, Fcn fcn)
+{
+    for(sys_sage::RelationType::type rt : sys_sage::RelationType::RelationTypeList)
+    {
+        const std::vector<sys_sage::Relation*>& rv = c->GetRelations(rt);
+        for(size_t i = 0; i < rv.size(); i++)
+        {
+            if(rv[i]->GetComponent(0) == c && rv[i]->_GetComponentSlot(0) == static_cast<int32_t>(i))
+                fcn(rv[i]);
+        }
+    }
+}
+
+//visits the subtree of _subtreeRoot, skipping subtrees of (nested) Topologies with their own relation registry
+template <class Fcn>
+static void _ForEachRegistryComponent(sys_sage::Component* _subtreeRoot, Fcn fcn)
+{
+    std::vector<sys_sage::Component*> stack{_subtreeRoot};
+    while(!stack.empty())
+    {
+        sys_sage::Component* c = stack.back();
+        stack.pop_back();
+        if(c != _subtreeRoot && c->GetComponentType() == sys_sage::ComponentType::Topology && static_cast<sys_sage::Topology*>(c)->IsRelationRegistryEnabled())
+            continue;
+        fcn(c);
+        const std::vector<sys_sage::Component*>& ch = c->GetChildren();
+        stack.insert(stack.end(), ch.rbegin(), ch.rend());
+    }
+}
+
+int sys_sage::Topology::EnableRelationRegistry()
+{
+    if(relationRegistry == nullptr)
+        relationRegistry = new std::vector<Relation*>();
+    else
+    {
+        for(Relation* r : *relationRegistry)
+            r->_SetRegistryEntry(nullptr, -1);
+        relationRegistry->clear();
+    }
+
+    _RegisterSubtreeRelations(this);
+    return relationRegistry->size();
+}
+
+void sys_sage::Topology::DisableRelationRegistry()
+{
+    if(relationRegistry == nullptr)
+        return;
+    for(Relation* r : *relationRegistry)
+        r->_SetRegistryEntry(nullptr, -1);
+    delete relationRegistry;
+    relationRegistry = nullptr;
+
+    Topology* outer = GetParent() != NULL ? GetParent()->_FindRelationRegistry() : nullptr;
+    if(outer != nullptr)
+        outer->_RegisterSubtreeRelations(this);
+}
+
+bool sys_sage::Topology::IsRelationRegistryEnabled() const { return relationRegistry != nullptr; }
+
+const std::vector<sys_sage::Relation*>& sys_sage::Topology::GetRegisteredRelations() const
+{
+    if(relationRegistry != nullptr)
+        return *relationRegistry;
+    static const std::vector<Relation*> empty;
+    return empty;
+}
+
+void sys_sage::Topology::_RegisterRelation(Relation* r)
+{
+    r->_SetRegistryEntry(this, relationRegistry->size());
+    relationRegistry->push_back(r);
+}
+
+void sys_sage::Topology::_UnregisterRelation(Relation* r)
+{
+    int32_t idx = r->_GetRegistryIndex();
+    Relation* last = relationRegistry->back();
+    (*relationRegistry)[idx] = last;
+    last->_SetRegistryEntry(this, idx);
+    relationRegistry->pop_back();
+    r->_SetRegistryEntry(nullptr, -1);
+}
+
+void sys_sage::Topology::_RegisterSubtreeRelations(Component* _subtreeRoot)
+{
+    if(relationRegistry == nullptr)
+        return;
+    //a nested Topology with its own registry keeps its Relations
+    if(_subtreeRoot != this && _subtreeRoot->GetComponentType() == ComponentType::Topology && static_cast<Topology*>(_subtreeRoot)->IsRelationRegistryEnabled())
+        return;
+    _ForEachRegistryComponent(_subtreeRoot, [this](Component* c) {
+        _ForEachOwnedRelation(c, [this](Relation* r) {
+            if(r->_GetRegistry() == this)
+                return;
+            if(r->_GetRegistry() != nullptr)
+                r->_GetRegistry()->_UnregisterRelation(r);
+            _RegisterRelation(r);
+        });
+    });
+}
+
+void sys_sage::Topology::_UnregisterSubtreeRelations(Component* _subtreeRoot)
+{
+    if(relationRegistry == nullptr)
+        return;
+    if(_subtreeRoot->GetComponentType() == ComponentType::Topology && static_cast<Topology*>(_subtreeRoot)->IsRelationRegistryEnabled())
+        return;
+    _ForEachRegistryComponent(_subtreeRoot, [this](Component* c) {
+        _ForEachOwnedRelation(c, [this](Relation* r) {
+            if(r->_GetRegistry() == this)
+                _UnregisterRelation(r);
+        });
+    });
+}
+
+int sys_sage::Topology::EnableChangeTracking()
+{
+    if(deletionLog != nullptr)
+        return 1;
+    deletionLog = new std::vector<DeletionRecord>();
+    return 0;
+}
+
+void sys_sage::Topology::DisableChangeTracking()
+{
+    delete deletionLog;
+    deletionLog = nullptr;
+}
+
+bool sys_sage::Topology::IsChangeTrackingEnabled() const { return deletionLog != nullptr; }
+
+const std::vector<sys_sage::DeletionRecord>& sys_sage::Topology::GetDeletionLog() const
+{
+    if(deletionLog != nullptr)
+        return *deletionLog;
+    static const std::vector<DeletionRecord> empty;
+    return empty;
+}
+
+void sys_sage::Topology::TrimDeletionLog(uint64_t upToVersion)
+{
+    if(deletionLog == nullptr)
+        return;
+    //the log is ordered by version
+    auto end = std::upper_bound(deletionLog->begin(), deletionLog->end(), upToVersion, [](uint64_t v, const DeletionRecord& d) { return v < d.version; });
+    deletionLog->erase(deletionLog->begin(), end);
+}
+
+void sys_sage::Topology::_RecordDeletion(const void* addr, bool isRelation, bool withSubtree)
+{
+    deletionLog->push_back({_NextVersion(), reinterpret_cast<uintptr_t>(addr), isRelation, withSubtree});
+}
+
+//visits the subtree of _subtreeRoot, skipping subtrees of (nested) Topologies with their own EpochDomain
+template <class Fcn>
+static void _ForEachEpochComponent(sys_sage::Component* _subtreeRoot, Fcn fcn)
+{
+    std::vector<sys_sage::Component*> stack{_subtreeRoot};
+    while(!stack.empty())
+    {
+        sys_sage::Component* c = stack.back();
+        stack.pop_back();
+        if(c != _subtreeRoot && c->GetComponentType() == sys_sage::ComponentType::Topology && static_cast<sys_sage::Topology*>(c)->IsConcurrentReadsEnabled())
+            continue;
+        fcn(c);
+        const std::vector<sys_sage::Component*>& ch = c->GetChildren();
+        stack.insert(stack.end(), ch.rbegin(), ch.rend());
+    }
+}
+
+int sys_sage::Topology::EnableConcurrentReads()
+{
+    if(epochDomain != nullptr)
+        return 1;
+    epochDomain = new EpochDomain();
+    _AttachToEpochDomain(this);
+    return 0;
+}
+
+void sys_sage::Topology::DisableConcurrentReads()
+{
+    if(epochDomain == nullptr)
+        return;
+    _ForEachEpochComponent(this, [this](Component* c) {
+        Component::RelationArray* published = c->_UnpublishRelations();
+        if(published != nullptr)
+            epochDomain->Retire([published]{ delete published; });
+    });
+    EpochDomain* domain = epochDomain;
+    epochDomain = nullptr;
+    delete domain; //waits for the readers that are still active
+}
+
+bool sys_sage::Topology::IsConcurrentReadsEnabled() const { return epochDomain != nullptr; }
+
+sys_sage::EpochDomain* sys_sage::Topology::GetEpochDomain() const { return epochDomain; }
+
+void sys_sage::Topology::_AttachToEpochDomain(Component* _subtreeRoot)
+{
+    if(epochDomain == nullptr)
+        return;
+    if(_subtreeRoot != this && _subtreeRoot->GetComponentType() == ComponentType::Topology && static_cast<Topology*>(_subtreeRoot)->IsConcurrentReadsEnabled())
+        return;
+    _ForEachEpochComponent(_subtreeRoot, [this](Component* c) {
+        Component::RelationArray* old = c->_PublishRelations();
+        if(old != nullptr)
+            epochDomain->Retire([old]{ delete old; });
+    });
+}
+
+void sys_sage::Topology::_DetachFromEpochDomain(Component* _subtreeRoot)
+{
+    if(epochDomain == nullptr)
+        return;
+    if(_subtreeRoot->GetComponentType() == ComponentType::Topology && static_cast<Topology*>(_subtreeRoot)->IsConcurrentReadsEnabled())
+        return;
+    _ForEachEpochComponent(_subtreeRoot, [this](Component* c) { epochDomain->_Forget(c); });
+}
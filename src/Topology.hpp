@@ -1,10 +1,28 @@
 #ifndef TOPOLOGY_HPP
 #define TOPOLOGY_HPP
 
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "Component.hpp"
+#include "Arena.hpp"
+#include "Epoch.hpp"
 
 namespace sys_sage {
 
+    /**
+     * @brief A deletion recorded by a Topology with enabled change tracking (see Topology::EnableChangeTracking()).
+     */
+    struct DeletionRecord {
+        uint64_t version; /**< Value of the global modification counter at the deletion (see GetCurrentVersion()). */
+        uintptr_t addr; /**< Address of the deleted Component or Relation, as in the "addr" XML attribute of exportToXml(). */
+        bool isRelation; /**< True for a Relation, false for a Component. */
+        bool withSubtree; /**< For Components: true if the whole subtree was deleted (Delete(true)), false if only the component itself (its children moved to its parent). */
+    };
+
     /**
     Class Topology - the root of the topology.
     \n It is not required to have an instance of this class at the root of the topology. Any component can be the root. This class is a child of Component class, therefore inherits its attributes and methods.
@@ -20,11 +38,244 @@ namespace sys_sage {
         Topology();
         /**
         * @private
-        * Use Delete() or DeleteSubtree() for deleting and deallocating the components. 
+        * Use Delete() or DeleteSubtree() for deleting and deallocating the components.
         */
-        ~Topology() override = default;
+        ~Topology() override;
+
+        /**
+         * @brief Enables the (componentType, id) index of this Topology.
+         * The index covers the whole subtree of this Topology and is kept up to date by InsertChild, RemoveChild,
+         * InsertBetweenParentAndChild(ren) and Delete. Once enabled, GetSubcomponentById called on any component of the subtree
+         * is answered from the index instead of a DFS over the subtree.
+         * \n Next to the (componentType, id) -> Component* table, which is updated in O(subtree size) per attached/detached subtree, the index keeps the pre-order interval
+         * of every component. With it, a lookup finds the first match within the subtree of the queried component by a binary search over the candidates, i.e. in O(log m)
+         * for m components with the same (componentType, id). The intervals are invalidated by every change of the tree and rebuilt (O(n), n indexed components) lazily by a later lookup:
+         * until then, lookups walk from each candidate up to the queried component (O(m * depth)), and the rebuild happens once this work adds up to n
+         * or a lookup has several candidates within the subtree. Hence the worst case is a lookup with several candidates right after each change of the tree, which costs O(n)
+         * like the DFS it replaces; lookups of unique (componentType, id) pairs stay cheap while the tree is being built.
+         * \n Calling this on a Topology with an already enabled index rebuilds the index.
+         * @return Number of indexed components.
+         * @see DisableComponentIndex()
+         * @see GetSubcomponentById(int _id, ComponentType::type _componentType)
+         */
+        int EnableComponentIndex();
+        /**
+         * @brief Disables (and deallocates) the (componentType, id) index of this Topology.
+         */
+        void DisableComponentIndex();
+        /**
+         * @brief Returns true if the (componentType, id) index of this Topology is enabled.
+         */
+        bool IsComponentIndexEnabled() const;
+
+        /**
+         * @private
+         * @brief Adds all components of the subtree of _subtreeRoot to the index (no-op if the index is disabled).
+         */
+        void _IndexSubtree(Component* _subtreeRoot);
+        /**
+         * @private
+         * @brief Removes all components of the subtree of _subtreeRoot from the index (no-op if the index is disabled).
+         */
+        void _UnindexSubtree(Component* _subtreeRoot);
+        /**
+         * @private
+         * @brief Looks up a component with matching id and componentType in the subtree of _subtreeRoot using the index.
+         * @param _subtreeRoot Component whose subtree is searched (must be within this Topology's subtree)
+         * @param _id id to look for
+         * @param _componentType component type to look for
+         * @param out_component output parameter -- the match (or NULL if there is none)
+         * @return true if the index gave a definite answer (the first match in pre-order); false if the index is disabled or _subtreeRoot is not indexed, in which case the caller has to fall back to a DFS.
+         */
+        bool _FindInIndex(const Component* _subtreeRoot, int _id, ComponentType::type _componentType, Component** out_component);
+        /**
+         * @private
+         * @brief Updates the indexed collapsed components after the count of _component (within this Topology's subtree) changed (no-op if the index is disabled).
+         */
+        void _OnCountChanged(Component* _component);
+
+        /**
+         * @brief Enables the relation registry of this Topology: a list of all Relations whose first component lies in the subtree of this Topology
+         * (excluding subtrees of nested Topologies with their own registry), in which every Relation appears exactly once.
+         * Relations are added when they are created and removed when they are deleted (O(1), via a back-index stored in the Relation);
+         * InsertChild, RemoveChild and Delete move the Relations of attached/detached subtrees between registries.
+         * \n Calling this on a Topology with an already enabled registry rebuilds the registry.
+         * @return Number of registered Relations.
+         * @see GetRegisteredRelations()
+         * @see DisableRelationRegistry()
+         */
+        int EnableRelationRegistry();
+        /**
+         * @brief Disables (and deallocates) the relation registry of this Topology. Its Relations move to the registry of the nearest Topology ancestor with an enabled registry (if any).
+         */
+        void DisableRelationRegistry();
+        /**
+         * @brief Returns true if the relation registry of this Topology is enabled.
+         */
+        bool IsRelationRegistryEnabled() const;
+        /**
+         * @brief Returns the registered Relations (each exactly once; in no particular order). Empty if the registry is disabled.
+         * @see EnableRelationRegistry()
+         */
+        const std::vector<Relation*>& GetRegisteredRelations() const;
+        /**
+         * @private
+         * @brief Appends r to the registry (O(1)). Called when a Relation gets its first component.
+         */
+        void _RegisterRelation(Relation* r);
+        /**
+         * @private
+         * @brief Removes r from the registry (O(1) swap-remove via the Relation's registry index).
+         */
+        void _UnregisterRelation(Relation* r);
+        /**
+         * @private
+         * @brief Registers the Relations owned (i.e. having their first component) in the subtree of _subtreeRoot in this registry.
+         * Subtrees of Topologies with an enabled registry keep their Relations.
+         */
+        void _RegisterSubtreeRelations(Component* _subtreeRoot);
+        /**
+         * @private
+         * @brief Removes the Relations owned by the subtree of _subtreeRoot from this registry.
+         */
+        void _UnregisterSubtreeRelations(Component* _subtreeRoot);
+
+        /**
+         * @brief Enables change tracking of this Topology: deletions of Components of its subtree (excluding subtrees of nested Topologies with their own change tracking) and of the Relations
+         * whose first component lies there are recorded in a deletion log, so that exportDeltaToXml() can export them.
+         * Modifications and new objects need no log; they are found by their version (see Component::GetVersion()).
+         * \n Deleting a subtree records its root only.
+         * @return 0 on success; 1 if change tracking is already enabled (nothing changed).
+         * @see GetDeletionLog()
+         * @see DisableChangeTracking()
+         */
+        int EnableChangeTracking();
+        /**
+         * @brief Disables change tracking and deallocates the deletion log.
+         */
+        void DisableChangeTracking();
+        /**
+         * @brief Returns true if change tracking is enabled for this Topology.
+         */
+        bool IsChangeTrackingEnabled() const;
+        /**
+         * @brief Returns the recorded deletions (ordered by version). Empty if change tracking is disabled.
+         * @see EnableChangeTracking()
+         */
+        const std::vector<DeletionRecord>& GetDeletionLog() const;
+        /**
+         * @brief Drops the recorded deletions with version <= upToVersion, e.g. the ones covered by the oldest delta that a consumer may still need.
+         */
+        void TrimDeletionLog(uint64_t upToVersion);
+        /**
+         * @private
+         * @brief Appends a deletion to the log. Called by Component::Delete() and Relation::Delete() before the object is destroyed.
+         */
+        void _RecordDeletion(const void* addr, bool isRelation, bool withSubtree);
+
+        /**
+         * @brief Enables concurrent reads: lock-free readers (ReadGuard) may traverse the Relations and typed attributes of this Topology's subtree
+         * while a writer (WriteGuard), e.g. a background thread calling Node::RefreshCpuCoreFrequency(), Chip::UpdateMIGSettings() or Node::UpdateL3CATCoreCOS(), replaces them.
+         * Readers see immutable published copies; replaced Relations and attribute values are destroyed only after all readers that might see them have left (epoch-based reclamation, see EpochDomain).
+         * Subtrees of nested Topologies with their own enabled concurrent reads are covered by their own domain.
+         * 
+         * Must be called before any readers or writers are started. Changes of the component tree itself (including the copy-on-write of shared components, see Component::SetCount()) are not covered; perform them only when no readers are active.
+         * @return 0 on success; 1 if concurrent reads are already enabled (nothing changed).
+         * @see DisableConcurrentReads()
+         * @see ReadGuard
+         * @see WriteGuard
+         */
+        int EnableConcurrentReads();
+        /**
+         * @brief Disables concurrent reads: waits until the active readers have left, then destroys all retired objects and the published copies.
+         * Must not be called while a writer is active or new readers may still be started.
+         */
+        void DisableConcurrentReads();
+        /**
+         * @brief Returns true if concurrent reads are enabled for this Topology.
+         */
+        bool IsConcurrentReadsEnabled() const;
+        /**
+         * @brief Returns the EpochDomain of this Topology, or nullptr if concurrent reads are disabled.
+         */
+        EpochDomain* GetEpochDomain() const;
+        /**
+         * @private
+         * @brief Publishes the relation lists of all components of the subtree of _subtreeRoot for concurrent readers. Called when the subtree is attached.
+         * Subtrees of nested Topologies with their own domain are skipped.
+         */
+        void _AttachToEpochDomain(Component* _subtreeRoot);
+        /**
+         * @private
+         * @brief Drops (retires) the published relation lists of all components of the subtree of _subtreeRoot. Called when the subtree is detached.
+         */
+        void _DetachFromEpochDomain(Component* _subtreeRoot);
+
+        /**
+         * @brief Creates an arena owned by this Topology, in which its Components and Relations can be placed contiguously.
+         * Objects are placed in the arena when they are created on a thread with an active ArenaScope for this Topology.
+         * Delete() (with subtree) on a Topology with an arena tears down the whole topology in one step: destructors run without any
+         * per-object unlinking, and the arena memory is released at once.
+         * \n Objects placed in the arena must not outlive the Topology (e.g. by being moved to another tree).
+         * @param useHugePages If true, the arena is backed by huge pages (MAP_HUGETLB, falling back to transparent huge pages).
+         * @param chunkSize Size of the arena chunks in bytes (0 = default, 2 MiB).
+         * @return 0 on success; 1 if the Topology already has an arena (nothing changed).
+         * @see ArenaScope
+         */
+        int EnableArena(bool useHugePages = false, size_t chunkSize = 0);
+        /**
+         * @brief Returns the arena of this Topology, or nullptr if EnableArena() was not called.
+         */
+        TopologyArena* GetArena() const;
+        /**
+         * @private
+         * @brief Bulk teardown of a Topology with an arena; called by Delete(true).
+         * Relations leaving the subtree are unlinked regularly; everything else is destroyed without unlinking, then the arena is released.
+         */
+        void _DeleteWithArena();
+        /**
+         * @private
+         * @brief Adds the component index, relation registry and deletion log to footprint->indexBytes and the unused arena memory to footprint->arenaSlackBytes.
+         */
+        size_t _GetOwnedMemory(MemoryFootprint* footprint) const override;
     private:
+        /**
+         * @private
+         * @brief Packs componentType and id into a single index key.
+         */
+        static uint64_t _IndexKey(int _id, ComponentType::type _componentType);
+
+        /**
+         * @private
+         * @brief Pre-order intervals of the indexed components; rebuilt lazily after changes of the tree (see EnableComponentIndex()).
+         */
+        struct ComponentIndexOrder {
+            std::unordered_map<const Component*, std::pair<uint32_t, uint32_t>> interval; /**< Component -> (pre-order number, last pre-order number within its subtree) */
+            std::unordered_map<uint64_t, std::vector<std::pair<uint32_t, Component*>>> byKey; /**< index key -> (pre-order number, Component*) of all components with the key, in pre-order */
+            std::atomic<bool> valid{false}; /**< False after a change of the tree, until the next rebuild. */
+            size_t staleWork = 0; /**< Steps of the candidate walks done since the intervals became invalid. */
+            std::mutex mutex; /**< Serializes the lookups while the intervals are invalid (the rebuild and staleWork). */
+            std::unordered_set<Component*> collapsed; /**< Indexed collapsed components; the index holds their first id only, so their id ranges are matched separately. */
+        };
+        /**
+         * @private
+         * @brief Looks up a collapsed component in the subtree of _subtreeRoot that represents _id (see _FindInIndex()).
+         * @return false if several collapsed components match (the caller has to fall back to a DFS for the first one in pre-order).
+         */
+        bool _FindCollapsedInIndex(const Component* _subtreeRoot, int _id, ComponentType::type _componentType, Component** out_component) const;
+        /**
+         * @private
+         * @brief Rebuilds componentIndexOrder from the subtree of this Topology.
+         */
+        void _RebuildIndexOrder();
+
+        std::unordered_multimap<uint64_t, Component*>* componentIndex = nullptr; /**< (componentType, id) -> Component* index over the subtree. Lazily allocated by EnableComponentIndex(). */
+        ComponentIndexOrder* componentIndexOrder = nullptr; /**< Pre-order intervals for the lookups in componentIndex. Allocated together with componentIndex. */
+        TopologyArena* arena = nullptr; /**< Arena for the Components and Relations of this Topology. Allocated by EnableArena(). */
+        std::vector<Relation*>* relationRegistry = nullptr; /**< Relations owned by the subtree of this Topology. Allocated by EnableRelationRegistry(). */
+        EpochDomain* epochDomain = nullptr; /**< Publication and deferred reclamation for concurrent readers. Allocated by EnableConcurrentReads(). */
+        std::vector<DeletionRecord>* deletionLog = nullptr; /**< Deletions in the subtree. Allocated by EnableChangeTracking(). */
     };
 }
 
-#endif
\ No newline at end of file
+#endif
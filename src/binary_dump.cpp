@@ -0,0 +1,466 @@
+#include "binary_dump.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#include "Topology.hpp"
+#include "Thread.hpp"
+#include "Core.hpp"
+#include "Cache.hpp"
+#include "Subdivision.hpp"
+#include "Numa.hpp"
+#include "Chip.hpp"
+#include "Memory.hpp"
+#include "Storage.hpp"
+#include "Node.hpp"
+#include "QuantumBackend.hpp"
+#include "Qubit.hpp"
+#include "AtomSite.hpp"
+#include "Relation.hpp"
+#include "DataPath.hpp"
+#include "QuantumGate.hpp"
+#include "CouplingMap.hpp"
+
+//signed integers are stored sign-extended to 64 bits
+static uint64_t _Int(long long v) { return static_cast<uint64_t>(v); }
+
+static uint64_t _Align8(uint64_t v) { return (v + 7) & ~uint64_t{7}; }
+
+sys_sage::BinaryWriter::BinaryWriter()
+{
+    strings.push_back('\0'); //offset 0 = empty string
+    stringOffsets.emplace(std::string(), 0);
+}
+
+uint32_t sys_sage::BinaryWriter::AddString(const std::string& s)
+{
+    auto [it, inserted] = stringOffsets.try_emplace(s, static_cast<uint32_t>(strings.size()));
+    if(inserted)
+    {
+        strings.append(s);
+        strings.push_back('\0');
+    }
+    return it->second;
+}
+
+uint64_t sys_sage::BinaryWriter::AddBlob(const void* data, size_t size)
+{
+    uint64_t offset = _Align8(blobs.size());
+    blobs.resize(offset + size);
+    std::memcpy(blobs.data() + offset, data, size);
+    return offset;
+}
+
+//stores a uint64_t count followed by the entries as one blob
+template <class T>
+static uint64_t _AddCountedBlob(sys_sage::BinaryWriter* w, const std::vector<T>& entries)
+{
+    std::vector<char> blob(sizeof(uint64_t) + entries.size() * sizeof(T));
+    uint64_t count = entries.size();
+    std::memcpy(blob.data(), &count, sizeof(count));
+    if(!entries.empty())
+        std::memcpy(blob.data() + sizeof(count), entries.data(), entries.size() * sizeof(T));
+    return w->AddBlob(blob.data(), blob.size());
+}
+
+static uint64_t _AddNamedValues(sys_sage::BinaryWriter* w, const std::map<std::string, double>& values)
+{
+    std::vector<sys_sage::BinaryNamedValue> entries;
+    entries.reserve(values.size());
+    for(const auto& [name, value] : values)
+        entries.push_back({w->AddString(name), 0, sys_sage::BinaryFormat::EncodeDouble(value)});
+    return _AddCountedBlob(w, entries);
+}
+
+//appends one attribute record; attributes of types that cannot be stored (Custom, None) are skipped
+static void _AddAttribute(sys_sage::BinaryWriter* w, const std::string& key, sys_sage::AttributeType::type type, const void* value, std::vector<sys_sage::BinaryAttributeRecord>* out)
+{
+    using namespace sys_sage;
+    BinaryAttributeRecord a{};
+    a.type = type;
+    switch(type)
+    {
+        case AttributeType::Int: a.value = _Int(*static_cast<const int*>(value)); break;
+        case AttributeType::LongLong: a.value = _Int(*static_cast<const long long*>(value)); break;
+        case AttributeType::UInt64: a.value = *static_cast<const uint64_t*>(value); break;
+        case AttributeType::Float: a.value = BinaryFormat::EncodeDouble(*static_cast<const float*>(value)); break;
+        case AttributeType::Double: a.value = BinaryFormat::EncodeDouble(*static_cast<const double*>(value)); break;
+        case AttributeType::String: a.value = w->AddString(*static_cast<const std::string*>(value)); break;
+        case AttributeType::FrequencyHistory:
+        {
+            const FrequencyHistory* fh = static_cast<const FrequencyHistory*>(value);
+            std::vector<BinaryFrequencySample> samples;
+            samples.reserve(fh->size());
+            for(const auto& [timestamp, frequency] : *fh)
+                samples.push_back({timestamp, BinaryFormat::EncodeDouble(frequency)});
+            a.value = _AddCountedBlob(w, samples);
+            break;
+        }
+        default:
+            return;
+    }
+    a.key = w->AddString(key);
+    out->push_back(a);
+}
+
+//typed attributes and the legacy attrib entries with a predefined key (like the XML export)
+static uint32_t _AddAttributes(sys_sage::BinaryWriter* w, const sys_sage::AttributeStore* store, const std::map<std::string, void*>& attrib, std::vector<sys_sage::BinaryAttributeRecord>* out)
+{
+    using namespace sys_sage;
+    size_t first = out->size();
+    if(store != nullptr)
+    {
+        for(const AttributeStore::Entry& e : store->GetEntries())
+            _AddAttribute(w, AttributeKey::GetName(e.key), e.type, e.Get(), out);
+    }
+    for(const auto& [key, value] : attrib)
+        _AddAttribute(w, key, AttributeKey::GetBuiltinType(AttributeKey::Find(key)), value, out);
+    return static_cast<uint32_t>(out->size() - first);
+}
+
+void sys_sage::Component::_WriteBinaryFields(BinaryWriter* w, BinaryComponentRecord* rec) const
+{
+    rec->id = id;
+    rec->name = w->AddString(name);
+    rec->count = count;
+}
+#ifdef PROC_CPUINFO
+void sys_sage::Core::_WriteBinaryFields(BinaryWriter* w, BinaryComponentRecord* rec) const
+{
+    Component::_WriteBinaryFields(w, rec);
+    w->AddField(BinaryFormat::EncodeDouble(freq));
+}
+#endif
+void sys_sage::Cache::_WriteBinaryFields(BinaryWriter* w, BinaryComponentRecord* rec) const
+{
+    Component::_WriteBinaryFields(w, rec);
+    w->AddField(w->AddString(cache_type));
+    w->AddField(_Int(cache_size));
+    w->AddField(_Int(cache_associativity_ways));
+    w->AddField(_Int(cache_line_size));
+}
+void sys_sage::Subdivision::_WriteBinaryFields(BinaryWriter* w, BinaryComponentRecord* rec) const
+{
+    Component::_WriteBinaryFields(w, rec);
+    w->AddField(_Int(type));
+}
+void sys_sage::Numa::_WriteBinaryFields(BinaryWriter* w, BinaryComponentRecord* rec) const
+{
+    Component::_WriteBinaryFields(w, rec);
+    w->AddField(_Int(size));
+}
+void sys_sage::Chip::_WriteBinaryFields(BinaryWriter* w, BinaryComponentRecord* rec) const
+{
+    Component::_WriteBinaryFields(w, rec);
+    w->AddField(w->AddString(vendor));
+    w->AddField(w->AddString(model));
+    w->AddField(_Int(type));
+}
+void sys_sage::Memory::_WriteBinaryFields(BinaryWriter* w, BinaryComponentRecord* rec) const
+{
+    Component::_WriteBinaryFields(w, rec);
+    w->AddField(_Int(size));
+    w->AddField(is_volatile ? 1 : 0);
+}
+void sys_sage::Storage::_WriteBinaryFields(BinaryWriter* w, BinaryComponentRecord* rec) const
+{
+    Component::_WriteBinaryFields(w, rec);
+    w->AddField(_Int(size));
+}
+void sys_sage::QuantumBackend::_WriteBinaryFields(BinaryWriter* w, BinaryComponentRecord* rec) const
+{
+    //SVTODO gate_types are not stored
+    Component::_WriteBinaryFields(w, rec);
+    w->AddField(_Int(num_qubits));
+}
+void sys_sage::Qubit::_WriteBinaryFields(BinaryWriter* w, BinaryComponentRecord* rec) const
+{
+    Component::_WriteBinaryFields(w, rec);
+    w->AddField(BinaryFormat::EncodeDouble(q1_fidelity));
+    w->AddField(BinaryFormat::EncodeDouble(t1));
+    w->AddField(BinaryFormat::EncodeDouble(t2));
+    w->AddField(BinaryFormat::EncodeDouble(readout_fidelity));
+    w->AddField(BinaryFormat::EncodeDouble(readout_length));
+    w->AddField(BinaryFormat::EncodeDouble(frequency));
+    w->AddField(w->AddString(calibration_time));
+}
+void sys_sage::AtomSite::_WriteBinaryFields(BinaryWriter* w, BinaryComponentRecord* rec) const
+{
+    QuantumBackend::_WriteBinaryFields(w, rec);
+    w->AddField(_Int(properties.nRows));
+    w->AddField(_Int(properties.nColumns));
+    w->AddField(_Int(properties.nAods));
+    w->AddField(_Int(properties.nAodIntermediateLevels));
+    w->AddField(_Int(properties.nAodCoordinates));
+    w->AddField(BinaryFormat::EncodeDouble(properties.interQubitDistance));
+    w->AddField(BinaryFormat::EncodeDouble(properties.interactionRadius));
+    w->AddField(BinaryFormat::EncodeDouble(properties.blockingFactor));
+    w->AddField(_AddNamedValues(w, shuttlingTimes));
+    w->AddField(_AddNamedValues(w, shuttlingAverageFidelities));
+}
+
+//type-specific fields of the relation types
+static void _WriteRelationFields(sys_sage::BinaryWriter* w, const sys_sage::Relation* r)
+{
+    using namespace sys_sage;
+    switch(r->GetType())
+    {
+        case RelationType::DataPath:
+        {
+            const DataPath* dp = static_cast<const DataPath*>(r);
+            w->AddField(_Int(dp->GetDataPathType()));
+            w->AddField(BinaryFormat::EncodeDouble(dp->GetBandwidth()));
+            w->AddField(BinaryFormat::EncodeDouble(dp->GetLatency()));
+            break;
+        }
+        case RelationType::QuantumGate:
+        {
+            const QuantumGate* qg = static_cast<const QuantumGate*>(r);
+            w->AddField(qg->GetGateSize());
+            w->AddField(w->AddString(qg->GetName()));
+            w->AddField(_Int(qg->GetGateLength()));
+            w->AddField(_Int(qg->GetQuantumGateType()));
+            w->AddField(BinaryFormat::EncodeDouble(qg->GetFidelity()));
+            w->AddField(w->AddString(qg->GetUnitary()));
+            break;
+        }
+        case RelationType::CouplingMap:
+            w->AddField(BinaryFormat::EncodeDouble(static_cast<const CouplingMap*>(r)->GetFidelity()));
+            break;
+    }
+}
+
+bool sys_sage::_AppendSubtreeSignature(BinaryWriter* w, Component* root, std::vector<uint64_t>* out)
+{
+    std::unordered_map<const Component*, uint64_t> indexOf;
+    std::vector<Component*> order;
+    for(Component* c : root->PreOrder())
+    {
+        indexOf.emplace(c, order.size());
+        order.push_back(c);
+    }
+    std::vector<BinaryAttributeRecord> attributes;
+    //false if an attribute cannot be stored (and therefore not compared)
+    auto addAttributes = [&](const AttributeStore* store, const std::map<std::string, void*>& attrib) {
+        attributes.clear();
+        size_t expected = (store != nullptr ? store->GetEntries().size() : 0) + attrib.size();
+        if(_AddAttributes(w, store, attrib, &attributes) != expected)
+            return false;
+        out->push_back(attributes.size());
+        for(const BinaryAttributeRecord& a : attributes)
+            out->insert(out->end(), {a.key, a.type, a.value});
+        return true;
+    };
+    auto addFields = [&]() {
+        out->push_back(w->fields.size());
+        out->insert(out->end(), w->fields.begin(), w->fields.end());
+        w->fields.clear();
+    };
+
+    for(Component* c : order)
+    {
+        c->DecodeAllAttributes();
+        BinaryComponentRecord rec{};
+        c->_WriteBinaryFields(w, &rec);
+        //the id and count of the root may differ
+        out->insert(out->end(), {static_cast<uint64_t>(c->GetComponentType()), c == root ? 0 : _Int(rec.id), rec.name, c == root ? 0 : _Int(c->GetCount()), c->GetChildren().size()});
+        addFields();
+        if(!addAttributes(c->GetAttributes(), c->attrib))
+            return false;
+        for(RelationType::type rt : RelationType::RelationTypeList)
+        {
+            for(Relation* r : c->GetRelations(rt))
+            {
+                //each Relation once, at its first component in the subtree
+                const std::vector<Component*>& rc = r->GetComponents();
+                if(*std::find_if(rc.begin(), rc.end(), [&indexOf](Component* x) { return indexOf.count(x) != 0; }) != c)
+                    continue;
+                out->insert(out->end(), {static_cast<uint64_t>(rt), _Int(r->GetId()), r->IsOrdered(), rc.size()});
+                //components outside of the subtree by address: they have to be the same ones
+                for(Component* x : rc)
+                {
+                    auto it = indexOf.find(x);
+                    out->insert(out->end(), {it == indexOf.end() ? uint64_t{1} : uint64_t{0}, it == indexOf.end() ? reinterpret_cast<uintptr_t>(x) : it->second});
+                }
+                _WriteRelationFields(w, r);
+                addFields();
+                if(!addAttributes(r->GetAttributes(), r->attrib))
+                    return false;
+            }
+        }
+        out->push_back(UINT64_MAX); //end of the Relations of c
+    }
+    return true;
+}
+
+int sys_sage::exportToBinary(Component* root, std::string path)
+{
+    if(root == NULL)
+    {
+        std::cerr << "exportToBinary: root is NULL." << std::endl;
+        return 1;
+    }
+
+    BinaryWriter w;
+    std::vector<Component*> order;
+    for(Component* c : root->PreOrder())
+    {
+        c->DecodeAllAttributes(); //the binary format stores decoded values only
+        order.push_back(c);
+    }
+    if(order.size() >= BinaryFormat::npos)
+    {
+        std::cerr << "exportToBinary: too many components." << std::endl;
+        return 1;
+    }
+    //only components with Relations are looked up by pointer
+    std::unordered_map<const Component*, uint32_t> indexOf;
+    std::vector<uint32_t> withRelations;
+
+    std::vector<BinaryComponentRecord> components(order.size());
+    std::vector<BinaryAttributeRecord> attributes;
+    std::vector<uint32_t> ancestors; //indices of the components on the path from the root to the current one
+    for(uint32_t i = 0; i < order.size(); i++)
+    {
+        Component* c = order[i];
+        for(RelationType::type rt : RelationType::RelationTypeList)
+        {
+            if(!c->GetRelations(rt).empty())
+            {
+                indexOf.emplace(c, i);
+                withRelations.push_back(i);
+                break;
+            }
+        }
+        //in pre-order, the parent is on the ancestor stack; the subtrees of the components popped before reaching it end here
+        while(!ancestors.empty() && order[ancestors.back()] != c->GetParent())
+        {
+            components[ancestors.back()].subtreeEnd = i;
+            ancestors.pop_back();
+        }
+        BinaryComponentRecord& rec = components[i];
+        rec.componentType = c->GetComponentType();
+        if(rec.componentType == ComponentType::QuantumBackend && dynamic_cast<const AtomSite*>(c) != nullptr) //AtomSite does not set its own component type
+            rec.componentType = ComponentType::AtomSite;
+        rec.parent = ancestors.empty() ? BinaryFormat::npos : ancestors.back();
+        ancestors.push_back(i);
+        rec.firstAttribute = static_cast<uint32_t>(attributes.size());
+        rec.numAttributes = _AddAttributes(&w, c->GetAttributes(), c->attrib, &attributes);
+        rec.firstField = static_cast<uint32_t>(w.fields.size());
+        c->_WriteBinaryFields(&w, &rec);
+        rec.numFields = static_cast<uint32_t>(w.fields.size() - rec.firstField);
+    }
+    for(uint32_t a : ancestors)
+        components[a].subtreeEnd = static_cast<uint32_t>(order.size());
+
+    //each Relation once, at its first component (in the same order as the XML export)
+    std::vector<BinaryRelationRecord> relations;
+    std::vector<uint32_t> relationComponents;
+    size_t numSkipped = 0;
+    for(uint32_t i : withRelations)
+    {
+        Component* c = order[i];
+        for(RelationType::type rt : RelationType::RelationTypeList)
+        {
+            const std::vector<Relation*>& rList = c->GetRelations(rt);
+            for(size_t j = 0; j < rList.size(); j++)
+            {
+                Relation* r = rList[j];
+                if(r->GetComponent(0) != c || r->_GetComponentSlot(0) != static_cast<int32_t>(j))
+                    continue;
+                BinaryRelationRecord rec{};
+                rec.relationType = r->GetType();
+                rec.id = r->GetId();
+                rec.ordered = r->IsOrdered() ? 1 : 0;
+                rec.firstComponent = static_cast<uint32_t>(relationComponents.size());
+                bool complete = true;
+                for(Component* rc : r->GetComponents())
+                {
+                    auto it = indexOf.find(rc);
+                    if(it == indexOf.end())
+                    {
+                        complete = false;
+                        break;
+                    }
+                    relationComponents.push_back(it->second);
+                }
+                if(!complete)
+                {
+                    relationComponents.resize(rec.firstComponent);
+                    numSkipped++;
+                    continue;
+                }
+                rec.numComponents = static_cast<uint32_t>(relationComponents.size() - rec.firstComponent);
+                rec.firstAttribute = static_cast<uint32_t>(attributes.size());
+                rec.numAttributes = _AddAttributes(&w, r->GetAttributes(), r->attrib, &attributes);
+                rec.firstField = static_cast<uint32_t>(w.fields.size());
+                _WriteRelationFields(&w, r);
+                rec.numFields = static_cast<uint32_t>(w.fields.size() - rec.firstField);
+                relations.push_back(rec);
+            }
+        }
+    }
+    if(numSkipped > 0)
+        std::cerr << "exportToBinary: skipped " << numSkipped << " Relations with components outside of the exported subtree." << std::endl;
+    if(w.strings.size() >= BinaryFormat::npos || w.fields.size() >= BinaryFormat::npos || attributes.size() >= BinaryFormat::npos || relationComponents.size() >= BinaryFormat::npos)
+    {
+        std::cerr << "exportToBinary: topology too large for the binary format." << std::endl;
+        return 1;
+    }
+
+    BinaryHeader h{};
+    std::memcpy(h.magic, BinaryFormat::magic, sizeof(h.magic));
+    h.version = BinaryFormat::version;
+    h.byteOrderMark = BinaryFormat::byteOrderMark;
+    uint64_t offset = sizeof(BinaryHeader);
+    auto place = [&offset](uint64_t bytes) { uint64_t o = offset; offset = _Align8(offset + bytes); return o; };
+    h.numComponents = components.size();
+    h.componentsOffset = place(components.size() * sizeof(BinaryComponentRecord));
+    h.numRelations = relations.size();
+    h.relationsOffset = place(relations.size() * sizeof(BinaryRelationRecord));
+    h.numRelationComponents = relationComponents.size();
+    h.relationComponentsOffset = place(relationComponents.size() * sizeof(uint32_t));
+    h.numFields = w.fields.size();
+    h.fieldsOffset = place(w.fields.size() * sizeof(uint64_t));
+    h.numAttributes = attributes.size();
+    h.attributesOffset = place(attributes.size() * sizeof(BinaryAttributeRecord));
+    h.blobsSize = w.blobs.size();
+    h.blobsOffset = place(w.blobs.size());
+    h.stringsSize = w.strings.size();
+    h.stringsOffset = place(w.strings.size());
+    h.fileSize = offset;
+
+    FILE* f = fopen(path.c_str(), "wb");
+    if(f == NULL)
+    {
+        std::cerr << "exportToBinary: cannot open " << path << " for writing." << std::endl;
+        return 1;
+    }
+    uint64_t written = 0;
+    bool ok = true;
+    auto write = [&](uint64_t at, const void* data, uint64_t bytes) {
+        static const char zeros[8] = {};
+        if(written < at)
+            ok = ok && fwrite(zeros, 1, at - written, f) == at - written;
+        if(bytes > 0)
+            ok = ok && fwrite(data, 1, bytes, f) == bytes;
+        written = at + bytes;
+    };
+    write(0, &h, sizeof(h));
+    write(h.componentsOffset, components.data(), components.size() * sizeof(BinaryComponentRecord));
+    write(h.relationsOffset, relations.data(), relations.size() * sizeof(BinaryRelationRecord));
+    write(h.relationComponentsOffset, relationComponents.data(), relationComponents.size() * sizeof(uint32_t));
+    write(h.fieldsOffset, w.fields.data(), w.fields.size() * sizeof(uint64_t));
+    write(h.attributesOffset, attributes.data(), attributes.size() * sizeof(BinaryAttributeRecord));
+    write(h.blobsOffset, w.blobs.data(), w.blobs.size());
+    write(h.stringsOffset, w.strings.data(), w.strings.size());
+    write(h.fileSize, nullptr, 0);
+    if(fclose(f) != 0 || !ok)
+    {
+        std::cerr << "exportToBinary: failed to write " << path << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+#ifndef BINARY_DUMP_HPP
+#define BINARY_DUMP_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "binary_format.hpp"
+#include "Component.hpp"
+
+namespace sys_sage {
+    /**
+     * @brief Exports the Component Tree and its Relations to a binary file (see BinaryFormat).
+     *
+     * Stores all components of the subtree of root (including the members of the component subclasses), the Relations whose components all lie in the subtree,
+     * and the typed attributes of both (as well as entries of the legacy attrib maps with a predefined key, like exportToXml()).
+     * Attributes of AttributeType::Custom and other legacy attrib entries cannot be stored and are skipped.
+     * \n The file can be loaded with importFromBinary() or used in place through a BinaryTopologyView.
+     *
+     * @param root Pointer to the root Component of the tree to export.
+     * @param path Output file path.
+     * @return 0 on success, nonzero on error.
+     * @see importFromBinary(std::string path)
+     */
+    int exportToBinary(Component* root, std::string path);
+
+    /**
+     * @private
+     * @brief String table and blob section of a binary topology file under construction. Used by exportToBinary() and Component::_WriteBinaryFields().
+     */
+    class BinaryWriter {
+    public:
+        BinaryWriter();
+        /**
+         * @brief Returns the string offset of s, adding s to the string table if it is not there yet.
+         */
+        uint32_t AddString(const std::string& s);
+        /**
+         * @brief Appends size bytes to the blob section (at an 8-byte aligned offset) and returns the offset.
+         */
+        uint64_t AddBlob(const void* data, size_t size);
+        /**
+         * @brief Appends the next type-specific field of the current component or Relation.
+         */
+        void AddField(uint64_t value) { fields.push_back(value); }
+
+        std::string strings; /**< string section: NUL-terminated strings */
+        std::vector<char> blobs; /**< blob section */
+        std::vector<uint64_t> fields; /**< fields section */
+    private:
+        std::unordered_map<std::string, uint32_t> stringOffsets;
+    };
+
+    /**
+     * @private
+     * @brief Appends an encoding of the subtree of root to out: the binary encoding (see BinaryFormat) of its components, typed attributes, and Relations, without the id and count of root.
+     * Two subtrees are identical (see Component::CollapseIdenticalSubtrees()) if their encodings with the same w are equal. Components of Relations outside of the subtree are encoded by address.
+     * Lazily imported attributes are decoded.
+     * @return false if the subtree holds attributes that the binary format cannot store (the encoding is incomplete then).
+     */
+    bool _AppendSubtreeSignature(BinaryWriter* w, Component* root, std::vector<uint64_t>* out);
+} //namespace sys_sage
+#endif //BINARY_DUMP_HPP
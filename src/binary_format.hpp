@@ -0,0 +1,150 @@
+#ifndef BINARY_FORMAT_HPP
+#define BINARY_FORMAT_HPP
+
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+namespace sys_sage {
+
+    /**
+     * @namespace BinaryFormat
+     * @brief Constants of the binary topology format (see exportToBinary() and BinaryTopologyView).
+     *
+     * A file consists of a BinaryHeader followed by the sections it points to, each starting at a multiple of 8 bytes:
+     * - components: BinaryComponentRecord[numComponents], in pre-order (the root has index 0);
+     * - relations: BinaryRelationRecord[numRelations];
+     * - relation components: uint32_t[numRelationComponents], the component indices of all relations;
+     * - fields: uint64_t[numFields], the type-specific fields of all components and relations (only as many as the type has);
+     * - attributes: BinaryAttributeRecord[numAttributes], the typed attributes of all components and relations;
+     * - blobs: variable-sized values (frequency histories, ...), 8-byte aligned;
+     * - strings: NUL-terminated strings, referenced by their offset in the section (offset 0 is the empty string).
+     *
+     * All integers are stored in the byte order of the machine that wrote the file; doubles as their IEEE-754 bit pattern.
+     * \n The files are meant to be mapped into memory and used in place, so the records have a fixed size and contain no pointers.
+     */
+    namespace BinaryFormat {
+        constexpr char magic[8] = {'S', 'Y', 'S', 'S', 'A', 'G', 'E', 'B'}; /**< First 8 bytes of every file. */
+        constexpr uint32_t version = 1; /**< Incremented on every incompatible change of the format. */
+        constexpr uint32_t byteOrderMark = 0x01020304; /**< Stored as written by the exporting machine; reads back differently on a machine with another byte order. */
+        constexpr uint32_t npos = UINT32_MAX; /**< Index value for "none" (e.g. parent of the root). */
+
+        /**
+         * @brief Encodes a double as a field value (bit pattern).
+         */
+        inline uint64_t EncodeDouble(double d) { return std::bit_cast<uint64_t>(d); }
+        /**
+         * @brief Decodes a field value written by EncodeDouble().
+         */
+        inline double DecodeDouble(uint64_t v) { return std::bit_cast<double>(v); }
+    }
+
+    /**
+     * @struct BinaryHeader
+     * @brief Header at the start of a binary topology file. Offsets are in bytes from the start of the file.
+     */
+    struct BinaryHeader {
+        char magic[8]; /**< BinaryFormat::magic */
+        uint32_t version; /**< BinaryFormat::version */
+        uint32_t byteOrderMark; /**< BinaryFormat::byteOrderMark */
+        uint64_t fileSize; /**< Size of the whole file */
+        uint64_t numComponents, componentsOffset;
+        uint64_t numRelations, relationsOffset;
+        uint64_t numRelationComponents, relationComponentsOffset;
+        uint64_t numFields, fieldsOffset;
+        uint64_t numAttributes, attributesOffset;
+        uint64_t blobsSize, blobsOffset;
+        uint64_t stringsSize, stringsOffset;
+    };
+
+    /**
+     * @struct BinaryComponentRecord
+     * @brief One component of a binary topology file.
+     *
+     * The subtree of component i is the index range [i, subtreeEnd); its first child (if any) is i+1, and the next sibling of a child c is c's subtreeEnd.
+     * \n The type-specific fields are stored in the fields section, in this order (strings as string offsets, doubles as BinaryFormat::EncodeDouble(),
+     * signed integers sign-extended; fields missing from the record read as 0):
+     * - Core: freq
+     * - Cache: cache_type, cache_size, cache_associativity_ways, cache_line_size
+     * - Subdivision: type
+     * - Numa, Storage: size
+     * - Chip: vendor, model, type
+     * - Memory: size, is_volatile
+     * - QuantumBackend: num_qubits
+     * - Qubit: q1_fidelity, t1, t2, readout_fidelity, readout_length, frequency, calibration_time
+     * - AtomSite: num_qubits, the 8 SiteProperties (in declaration order), blob offsets of shuttlingTimes and shuttlingAverageFidelities
+     *   (each as uint64_t count followed by count BinaryNamedValue entries)
+     */
+    struct BinaryComponentRecord {
+        uint32_t componentType; /**< ComponentType::type (ComponentType::AtomSite for AtomSites) */
+        int32_t id;
+        uint32_t name; /**< string offset */
+        int32_t count;
+        uint32_t parent; /**< index of the parent, BinaryFormat::npos for the root */
+        uint32_t subtreeEnd; /**< end of the pre-order range of the subtree */
+        uint32_t firstAttribute; /**< index of the first BinaryAttributeRecord */
+        uint32_t numAttributes;
+        uint32_t firstField; /**< index of the first type-specific field in the fields section */
+        uint32_t numFields;
+    };
+
+    /**
+     * @struct BinaryRelationRecord
+     * @brief One Relation of a binary topology file.
+     *
+     * The type-specific fields (see BinaryComponentRecord) are:
+     * - DataPath: dp_type, bw, latency
+     * - QuantumGate: gate_size, name, gate_length, gate_type, fidelity, unitary
+     * - CouplingMap: fidelity
+     */
+    struct BinaryRelationRecord {
+        uint32_t relationType; /**< RelationType::type */
+        int32_t id;
+        uint32_t ordered;
+        uint32_t numComponents;
+        uint32_t firstComponent; /**< index of the first component index in the relation components section */
+        uint32_t firstAttribute; /**< index of the first BinaryAttributeRecord */
+        uint32_t numAttributes;
+        uint32_t firstField; /**< index of the first type-specific field in the fields section */
+        uint32_t numFields;
+        uint32_t reserved; /**< 0 (padding) */
+    };
+
+    /**
+     * @struct BinaryAttributeRecord
+     * @brief One typed attribute of a component or relation.
+     *
+     * The value is stored by type: Int, LongLong and UInt64 as the integer; Float and Double with BinaryFormat::EncodeDouble(); String as string offset;
+     * FrequencyHistory as blob offset of a uint64_t count followed by count (int64_t timestamp, double frequency) pairs.
+     */
+    struct BinaryAttributeRecord {
+        uint32_t key; /**< string offset of the attribute name */
+        uint32_t type; /**< AttributeType::type */
+        uint64_t value;
+    };
+
+    /**
+     * @struct BinaryFrequencySample
+     * @brief One sample of a FrequencyHistory blob.
+     */
+    struct BinaryFrequencySample {
+        int64_t timestamp;
+        uint64_t frequency; /**< BinaryFormat::EncodeDouble() */
+    };
+
+    /**
+     * @struct BinaryNamedValue
+     * @brief One entry of a name -> double map blob (AtomSite shuttling tables).
+     */
+    struct BinaryNamedValue {
+        uint32_t name; /**< string offset */
+        uint32_t padding;
+        uint64_t value; /**< BinaryFormat::EncodeDouble() */
+    };
+
+    static_assert(sizeof(BinaryHeader) % 8 == 0 && sizeof(BinaryComponentRecord) % 8 == 0 && sizeof(BinaryRelationRecord) % 8 == 0 && sizeof(BinaryAttributeRecord) % 8 == 0,
+                  "binary records must keep 8-byte alignment");
+    static_assert(std::is_trivially_copyable_v<BinaryComponentRecord> && std::is_trivially_copyable_v<BinaryRelationRecord> && std::is_trivially_copyable_v<BinaryAttributeRecord>);
+
+} //namespace sys_sage
+#endif //BINARY_FORMAT_HPP
@@ -0,0 +1,453 @@
+#include "binary_load.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Topology.hpp"
+#include "Thread.hpp"
+#include "Core.hpp"
+#include "Cache.hpp"
+#include "Subdivision.hpp"
+#include "Numa.hpp"
+#include "Chip.hpp"
+#include "Memory.hpp"
+#include "Storage.hpp"
+#include "Node.hpp"
+#include "QuantumBackend.hpp"
+#include "Qubit.hpp"
+#include "AtomSite.hpp"
+#include "Relation.hpp"
+#include "DataPath.hpp"
+#include "QuantumGate.hpp"
+#include "CouplingMap.hpp"
+
+sys_sage::BinaryTopologyView::~BinaryTopologyView()
+{
+    Close();
+}
+
+int sys_sage::BinaryTopologyView::Open(std::string path)
+{
+    Close();
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        std::cerr << "BinaryTopologyView: cannot open " << path << std::endl;
+        return 1;
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(BinaryHeader)))
+    {
+        std::cerr << "BinaryTopologyView: " << path << " is not a binary topology file (too small)." << std::endl;
+        close(fd);
+        return 1;
+    }
+    void* m = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); //the mapping stays valid
+    if(m == MAP_FAILED)
+    {
+        std::cerr << "BinaryTopologyView: cannot map " << path << std::endl;
+        return 1;
+    }
+    data = static_cast<const char*>(m);
+    size = st.st_size;
+    header = reinterpret_cast<const BinaryHeader*>(data);
+    if(_Validate() != 0)
+    {
+        std::cerr << "BinaryTopologyView: " << path << " is not a valid binary topology file." << std::endl;
+        Close();
+        return 1;
+    }
+    return 0;
+}
+
+void sys_sage::BinaryTopologyView::Close()
+{
+    if(data != nullptr)
+        munmap(const_cast<char*>(data), size);
+    data = nullptr;
+    size = 0;
+    header = nullptr;
+}
+
+bool sys_sage::BinaryTopologyView::IsOpen() const
+{
+    return data != nullptr;
+}
+
+int sys_sage::BinaryTopologyView::_Validate() const
+{
+    const BinaryHeader* h = header;
+    if(std::memcmp(h->magic, BinaryFormat::magic, sizeof(h->magic)) != 0)
+        return 1;
+    if(h->byteOrderMark != BinaryFormat::byteOrderMark)
+    {
+        std::cerr << "BinaryTopologyView: the file was written on a machine with a different byte order." << std::endl;
+        return 1;
+    }
+    if(h->version != BinaryFormat::version)
+    {
+        std::cerr << "BinaryTopologyView: unsupported version " << h->version << " (expected " << BinaryFormat::version << ")." << std::endl;
+        return 1;
+    }
+    if(h->fileSize != size)
+        return 1;
+    //every section must be 8-byte aligned and lie within the file (the counts are bounded first so that count * record size cannot overflow)
+    auto inFile = [this](uint64_t offset, uint64_t count, uint64_t recordSize) {
+        return offset % 8 == 0 && offset >= sizeof(BinaryHeader) && offset <= size && count <= (size - offset) / recordSize;
+    };
+    if(!inFile(h->componentsOffset, h->numComponents, sizeof(BinaryComponentRecord)) || h->numComponents == 0 || h->numComponents >= BinaryFormat::npos
+       || !inFile(h->relationsOffset, h->numRelations, sizeof(BinaryRelationRecord)) || h->numRelations >= BinaryFormat::npos
+       || !inFile(h->relationComponentsOffset, h->numRelationComponents, sizeof(uint32_t))
+       || !inFile(h->fieldsOffset, h->numFields, sizeof(uint64_t))
+       || !inFile(h->attributesOffset, h->numAttributes, sizeof(BinaryAttributeRecord))
+       || !inFile(h->blobsOffset, h->blobsSize, 1)
+       || !inFile(h->stringsOffset, h->stringsSize, 1))
+        return 1;
+    //the string section starts with the empty string and ends with a terminator, so that every offset yields a terminated string
+    if(h->stringsSize == 0 || data[h->stringsOffset] != '\0' || data[h->stringsOffset + h->stringsSize - 1] != '\0')
+        return 1;
+    return 0;
+}
+
+uint32_t sys_sage::BinaryTopologyView::GetNumComponents() const
+{
+    return header != nullptr ? static_cast<uint32_t>(header->numComponents) : 0;
+}
+
+uint32_t sys_sage::BinaryTopologyView::GetNumRelations() const
+{
+    return header != nullptr ? static_cast<uint32_t>(header->numRelations) : 0;
+}
+
+const sys_sage::BinaryComponentRecord& sys_sage::BinaryTopologyView::GetComponent(uint32_t i) const
+{
+    return _Section<BinaryComponentRecord>(header->componentsOffset)[i];
+}
+
+const sys_sage::BinaryRelationRecord& sys_sage::BinaryTopologyView::GetRelation(uint32_t i) const
+{
+    return _Section<BinaryRelationRecord>(header->relationsOffset)[i];
+}
+
+const uint32_t* sys_sage::BinaryTopologyView::GetRelationComponents(const BinaryRelationRecord& r) const
+{
+    if(uint64_t{r.firstComponent} + r.numComponents > header->numRelationComponents)
+        return nullptr;
+    return _Section<uint32_t>(header->relationComponentsOffset) + r.firstComponent;
+}
+
+const sys_sage::BinaryAttributeRecord* sys_sage::BinaryTopologyView::GetAttributes(uint32_t first, uint32_t num) const
+{
+    if(uint64_t{first} + num > header->numAttributes)
+        return nullptr;
+    return _Section<BinaryAttributeRecord>(header->attributesOffset) + first;
+}
+
+std::string_view sys_sage::BinaryTopologyView::GetString(uint64_t offset) const
+{
+    if(header == nullptr || offset >= header->stringsSize)
+        return std::string_view();
+    return std::string_view(data + header->stringsOffset + offset); //terminated within the section (checked by Open())
+}
+
+const void* sys_sage::BinaryTopologyView::GetBlob(uint64_t offset, uint64_t size) const
+{
+    if(header == nullptr || offset > header->blobsSize || size > header->blobsSize - offset)
+        return nullptr;
+    return data + header->blobsOffset + offset;
+}
+
+uint64_t sys_sage::BinaryTopologyView::GetField(const BinaryComponentRecord& r, uint32_t i) const
+{
+    return _GetField(r.firstField, r.numFields, i);
+}
+
+uint64_t sys_sage::BinaryTopologyView::GetField(const BinaryRelationRecord& r, uint32_t i) const
+{
+    return _GetField(r.firstField, r.numFields, i);
+}
+
+uint64_t sys_sage::BinaryTopologyView::_GetField(uint32_t first, uint32_t num, uint32_t i) const
+{
+    if(i >= num || uint64_t{first} + i >= header->numFields)
+        return 0;
+    return _Section<uint64_t>(header->fieldsOffset)[first + i];
+}
+
+//reads the uint64_t count of a counted blob (see BinaryFormat) and returns its entries, or nullptr if the blob lies outside of the section
+template <class T>
+static const T* _GetCountedBlob(const sys_sage::BinaryTopologyView* v, uint64_t offset, uint64_t* count)
+{
+    const void* c = v->GetBlob(offset, sizeof(uint64_t));
+    if(c == nullptr)
+        return nullptr;
+    std::memcpy(count, c, sizeof(uint64_t));
+    if(*count > (UINT64_MAX - sizeof(uint64_t)) / sizeof(T))
+        return nullptr;
+    const void* entries = v->GetBlob(offset, sizeof(uint64_t) + *count * sizeof(T));
+    return entries == nullptr ? nullptr : reinterpret_cast<const T*>(static_cast<const char*>(entries) + sizeof(uint64_t));
+}
+
+//reads a name -> double map blob
+static void _ReadNamedValues(const sys_sage::BinaryTopologyView* v, uint64_t offset, std::map<std::string, double>* values)
+{
+    uint64_t count;
+    const sys_sage::BinaryNamedValue* entries = _GetCountedBlob<sys_sage::BinaryNamedValue>(v, offset, &count);
+    if(entries == nullptr)
+        return;
+    for(uint64_t i = 0; i < count; i++)
+        (*values)[std::string(v->GetString(entries[i].name))] = sys_sage::BinaryFormat::DecodeDouble(entries[i].value);
+}
+
+void sys_sage::Component::_ReadBinaryFields(const BinaryTopologyView* v, const BinaryComponentRecord* rec)
+{
+    id = rec->id;
+    name = v->GetString(rec->name);
+    _SetCount(rec->count);
+}
+#ifdef PROC_CPUINFO
+void sys_sage::Core::_ReadBinaryFields(const BinaryTopologyView* v, const BinaryComponentRecord* rec)
+{
+    Component::_ReadBinaryFields(v, rec);
+    freq = BinaryFormat::DecodeDouble(v->GetField(*rec, 0));
+}
+#endif
+void sys_sage::Cache::_ReadBinaryFields(const BinaryTopologyView* v, const BinaryComponentRecord* rec)
+{
+    Component::_ReadBinaryFields(v, rec);
+    cache_type = v->GetString(v->GetField(*rec, 0));
+    cache_size = static_cast<long long>(v->GetField(*rec, 1));
+    cache_associativity_ways = static_cast<int>(v->GetField(*rec, 2));
+    cache_line_size = static_cast<int>(v->GetField(*rec, 3));
+}
+void sys_sage::Subdivision::_ReadBinaryFields(const BinaryTopologyView* v, const BinaryComponentRecord* rec)
+{
+    Component::_ReadBinaryFields(v, rec);
+    type = static_cast<int>(v->GetField(*rec, 0));
+}
+void sys_sage::Numa::_ReadBinaryFields(const BinaryTopologyView* v, const BinaryComponentRecord* rec)
+{
+    Component::_ReadBinaryFields(v, rec);
+    size = static_cast<long long>(v->GetField(*rec, 0));
+}
+void sys_sage::Chip::_ReadBinaryFields(const BinaryTopologyView* v, const BinaryComponentRecord* rec)
+{
+    Component::_ReadBinaryFields(v, rec);
+    vendor = v->GetString(v->GetField(*rec, 0));
+    model = v->GetString(v->GetField(*rec, 1));
+    type = static_cast<int>(v->GetField(*rec, 2));
+}
+void sys_sage::Memory::_ReadBinaryFields(const BinaryTopologyView* v, const BinaryComponentRecord* rec)
+{
+    Component::_ReadBinaryFields(v, rec);
+    size = static_cast<long long>(v->GetField(*rec, 0));
+    is_volatile = v->GetField(*rec, 1) != 0;
+}
+void sys_sage::Storage::_ReadBinaryFields(const BinaryTopologyView* v, const BinaryComponentRecord* rec)
+{
+    Component::_ReadBinaryFields(v, rec);
+    size = static_cast<long long>(v->GetField(*rec, 0));
+}
+void sys_sage::QuantumBackend::_ReadBinaryFields(const BinaryTopologyView* v, const BinaryComponentRecord* rec)
+{
+    Component::_ReadBinaryFields(v, rec);
+    num_qubits = static_cast<int>(v->GetField(*rec, 0));
+}
+void sys_sage::Qubit::_ReadBinaryFields(const BinaryTopologyView* v, const BinaryComponentRecord* rec)
+{
+    Component::_ReadBinaryFields(v, rec);
+    q1_fidelity = BinaryFormat::DecodeDouble(v->GetField(*rec, 0));
+    t1 = BinaryFormat::DecodeDouble(v->GetField(*rec, 1));
+    t2 = BinaryFormat::DecodeDouble(v->GetField(*rec, 2));
+    readout_fidelity = BinaryFormat::DecodeDouble(v->GetField(*rec, 3));
+    readout_length = BinaryFormat::DecodeDouble(v->GetField(*rec, 4));
+    frequency = BinaryFormat::DecodeDouble(v->GetField(*rec, 5));
+    calibration_time = v->GetString(v->GetField(*rec, 6));
+}
+void sys_sage::AtomSite::_ReadBinaryFields(const BinaryTopologyView* v, const BinaryComponentRecord* rec)
+{
+    QuantumBackend::_ReadBinaryFields(v, rec);
+    properties.nRows = static_cast<int>(v->GetField(*rec, 1));
+    properties.nColumns = static_cast<int>(v->GetField(*rec, 2));
+    properties.nAods = static_cast<int>(v->GetField(*rec, 3));
+    properties.nAodIntermediateLevels = static_cast<int>(v->GetField(*rec, 4));
+    properties.nAodCoordinates = static_cast<int>(v->GetField(*rec, 5));
+    properties.interQubitDistance = BinaryFormat::DecodeDouble(v->GetField(*rec, 6));
+    properties.interactionRadius = BinaryFormat::DecodeDouble(v->GetField(*rec, 7));
+    properties.blockingFactor = BinaryFormat::DecodeDouble(v->GetField(*rec, 8));
+    _ReadNamedValues(v, v->GetField(*rec, 9), &shuttlingTimes);
+    _ReadNamedValues(v, v->GetField(*rec, 10), &shuttlingAverageFidelities);
+}
+
+static sys_sage::Component* _NewComponent(sys_sage::ComponentType::type type)
+{
+    using namespace sys_sage;
+    switch(type)
+    {
+        case ComponentType::None: return new Component();
+        case ComponentType::Thread: return new Thread();
+        case ComponentType::Core: return new Core();
+        case ComponentType::Cache: return new Cache();
+        case ComponentType::Subdivision: return new Subdivision();
+        case ComponentType::Numa: return new Numa();
+        case ComponentType::Chip: return new Chip();
+        case ComponentType::Memory: return new Memory();
+        case ComponentType::Storage: return new Storage();
+        case ComponentType::Node: return new Node();
+        case ComponentType::QuantumBackend: return new QuantumBackend();
+        case ComponentType::AtomSite: return new AtomSite();
+        case ComponentType::Qubit: return new Qubit();
+        case ComponentType::Topology: return new Topology();
+    }
+    return nullptr;
+}
+
+//restores the typed attributes of a component or Relation; returns 1 if a record is invalid
+template <class T>
+static int _SetAttributes(const sys_sage::BinaryTopologyView* v, uint32_t first, uint32_t num, std::unordered_map<uint64_t, sys_sage::AttributeKey::type>* keys, T* target)
+{
+    using namespace sys_sage;
+    const BinaryAttributeRecord* attrs = v->GetAttributes(first, num);
+    if(attrs == nullptr)
+        return 1;
+    for(uint32_t i = 0; i < num; i++)
+    {
+        const BinaryAttributeRecord& a = attrs[i];
+        //intern each distinct key string once per import
+        auto [it, inserted] = keys->try_emplace(a.key, AttributeKey::Invalid);
+        if(inserted)
+            it->second = AttributeKey::Intern(std::string(v->GetString(a.key)));
+        AttributeKey::type key = it->second;
+        switch(a.type)
+        {
+            case AttributeType::Int: target->SetAttribute(key, static_cast<int>(a.value)); break;
+            case AttributeType::LongLong: target->SetAttribute(key, static_cast<long long>(a.value)); break;
+            case AttributeType::UInt64: target->SetAttribute(key, static_cast<uint64_t>(a.value)); break;
+            case AttributeType::Float: target->SetAttribute(key, static_cast<float>(BinaryFormat::DecodeDouble(a.value))); break;
+            case AttributeType::Double: target->SetAttribute(key, BinaryFormat::DecodeDouble(a.value)); break;
+            case AttributeType::String: target->SetAttribute(key, std::string(v->GetString(a.value))); break;
+            case AttributeType::FrequencyHistory:
+            {
+                uint64_t count;
+                const BinaryFrequencySample* samples = _GetCountedBlob<BinaryFrequencySample>(v, a.value, &count);
+                if(samples == nullptr)
+                    return 1;
+                FrequencyHistory fh;
+                fh.reserve(count);
+                for(uint64_t s = 0; s < count; s++)
+                    fh.emplace_back(samples[s].timestamp, BinaryFormat::DecodeDouble(samples[s].frequency));
+                target->SetAttribute(key, std::move(fh));
+                break;
+            }
+            default:
+                return 1;
+        }
+    }
+    return 0;
+}
+
+//creates one Relation from its record; returns 1 if the record is invalid
+static int _CreateRelation(const sys_sage::BinaryTopologyView* v, const sys_sage::BinaryRelationRecord& rec, const std::vector<sys_sage::Component*>& components, std::unordered_map<uint64_t, sys_sage::AttributeKey::type>* keys)
+{
+    using namespace sys_sage;
+    const uint32_t* indices = v->GetRelationComponents(rec);
+    if(indices == nullptr)
+        return 1;
+    std::vector<Component*> rc(rec.numComponents);
+    for(uint32_t i = 0; i < rec.numComponents; i++)
+    {
+        if(indices[i] >= components.size())
+            return 1;
+        rc[i] = components[indices[i]];
+    }
+    bool ordered = rec.ordered != 0;
+    Relation* r;
+    switch(rec.relationType)
+    {
+        case RelationType::DataPath:
+        {
+            //a DataPath from a component to itself has a single component
+            if(rc.empty() || rc.size() > 2)
+                return 1;
+            DataPathOrientation::type dpo = ordered ? DataPathOrientation::Oriented : DataPathOrientation::Bidirectional;
+            r = new DataPath(rc.front(), rc.back(), dpo, static_cast<DataPathType::type>(v->GetField(rec, 0)), BinaryFormat::DecodeDouble(v->GetField(rec, 1)), BinaryFormat::DecodeDouble(v->GetField(rec, 2)));
+            r->SetId(rec.id);
+            break;
+        }
+        case RelationType::QuantumGate:
+            r = new QuantumGate(rc, rec.id, ordered, v->GetField(rec, 0), std::string(v->GetString(v->GetField(rec, 1))), static_cast<int>(v->GetField(rec, 2)),
+                                static_cast<QuantumGateType::type>(v->GetField(rec, 3)), BinaryFormat::DecodeDouble(v->GetField(rec, 4)), std::string(v->GetString(v->GetField(rec, 5))));
+            break;
+        case RelationType::CouplingMap:
+        {
+            CouplingMap* cm = new CouplingMap(rc, rec.id, ordered);
+            cm->SetFidelity(BinaryFormat::DecodeDouble(v->GetField(rec, 0)));
+            r = cm;
+            break;
+        }
+        default:
+            r = new Relation(rc, rec.id, ordered);
+            break;
+    }
+    return _SetAttributes(v, rec.firstAttribute, rec.numAttributes, keys, r);
+}
+
+sys_sage::Component* sys_sage::BinaryTopologyView::CreateTopology() const
+{
+    if(!IsOpen())
+        return NULL;
+    uint32_t n = GetNumComponents();
+    std::vector<Component*> components;
+    components.reserve(n);
+    std::unordered_map<uint64_t, AttributeKey::type> keys;
+    bool valid = true;
+    //collapsed components are restored with their shared subtrees and Relations
+    SharedWriteScope scope;
+    for(uint32_t i = 0; i < n && valid; i++)
+    {
+        const BinaryComponentRecord& rec = GetComponent(i);
+        //components are stored in pre-order: the parent was created before
+        if(i == 0 ? rec.parent != BinaryFormat::npos : rec.parent >= i)
+        {
+            valid = false;
+            break;
+        }
+        Component* c = _NewComponent(rec.componentType);
+        if(c == nullptr)
+        {
+            valid = false;
+            break;
+        }
+        c->_ReadBinaryFields(this, &rec);
+        if(i > 0)
+            components[rec.parent]->InsertChild(c);
+        components.push_back(c);
+        valid = _SetAttributes(this, rec.firstAttribute, rec.numAttributes, &keys, c) == 0;
+    }
+    for(uint32_t i = 0; i < GetNumRelations() && valid; i++)
+        valid = _CreateRelation(this, GetRelation(i), components, &keys) == 0;
+    if(!valid)
+    {
+        std::cerr << "BinaryTopologyView: invalid record -- the topology cannot be created." << std::endl;
+        if(!components.empty())
+            components[0]->Delete(true);
+        return NULL;
+    }
+    return components[0];
+}
+
+sys_sage::Component* sys_sage::importFromBinary(std::string path)
+{
+    BinaryTopologyView v;
+    if(v.Open(path) != 0)
+        return NULL;
+    return v.CreateTopology();
+}
@@ -0,0 +1,114 @@
+#ifndef BINARY_LOAD_HPP
+#define BINARY_LOAD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "binary_format.hpp"
+#include "Component.hpp"
+
+namespace sys_sage {
+    /**
+     * @brief Imports a topology from a binary file written by exportToBinary().
+     *
+     * Maps the file into memory (a single mmap) and creates the components and Relations from the records (see BinaryTopologyView::CreateTopology()).
+     * @param path Path to the binary file.
+     * @return Pointer to the root Component of the imported tree, or NULL if the file cannot be read or is not a valid binary topology file.
+     * @see exportToBinary(Component* root, std::string path)
+     */
+    Component* importFromBinary(std::string path);
+
+    /**
+     * @class BinaryTopologyView
+     * @brief Read-only, zero-copy view of a binary topology file (see BinaryFormat).
+     *
+     * The file is mapped into memory and its records are accessed in place, without creating any Component or Relation; strings are returned as views into the mapping.
+     * The header and the section bounds are validated by Open(); record contents (indices, offsets) are checked by the accessors and by CreateTopology().
+     * \n Example:
+     * ```cpp
+     * BinaryTopologyView v;
+     * if(v.Open("topo.bin") == 0)
+     *     for(uint32_t i = 0; i < v.GetNumComponents(); i++)
+     *         if(v.GetComponent(i).componentType == ComponentType::Thread)
+     *             std::cout << v.GetString(v.GetComponent(i).name) << std::endl;
+     * ```
+     */
+    class BinaryTopologyView {
+    public:
+        BinaryTopologyView() = default;
+        /**
+         * @brief Unmaps the file.
+         */
+        ~BinaryTopologyView();
+        BinaryTopologyView(const BinaryTopologyView&) = delete;
+        BinaryTopologyView& operator=(const BinaryTopologyView&) = delete;
+
+        /**
+         * @brief Maps a binary topology file and validates its header.
+         * @return 0 on success, nonzero on error (the view is closed then).
+         */
+        int Open(std::string path);
+        /**
+         * @brief Unmaps the file. All records and strings obtained from the view become invalid.
+         */
+        void Close();
+        /**
+         * @brief Returns true if a file is mapped.
+         */
+        bool IsOpen() const;
+
+        uint32_t GetNumComponents() const; /**< @brief Returns the number of component records. */
+        uint32_t GetNumRelations() const; /**< @brief Returns the number of relation records. */
+        /**
+         * @brief Returns the record of component i (0 <= i < GetNumComponents()); the root has index 0, the components are in pre-order.
+         */
+        const BinaryComponentRecord& GetComponent(uint32_t i) const;
+        /**
+         * @brief Returns the record of Relation i (0 <= i < GetNumRelations()).
+         */
+        const BinaryRelationRecord& GetRelation(uint32_t i) const;
+        /**
+         * @brief Returns the component indices of a Relation (r.numComponents entries), or nullptr if the record points outside of the file.
+         */
+        const uint32_t* GetRelationComponents(const BinaryRelationRecord& r) const;
+        /**
+         * @brief Returns the attribute records [first, first + num), or nullptr if the range lies outside of the file.
+         */
+        const BinaryAttributeRecord* GetAttributes(uint32_t first, uint32_t num) const;
+        /**
+         * @brief Returns the string at a string offset (an empty view for invalid offsets).
+         */
+        std::string_view GetString(uint64_t offset) const;
+        /**
+         * @brief Returns a pointer to size bytes of the blob section at offset, or nullptr if they lie outside of the section.
+         */
+        const void* GetBlob(uint64_t offset, uint64_t size) const;
+        /**
+         * @brief Returns type-specific field i of a component (see BinaryComponentRecord), or 0 if the record has fewer fields.
+         */
+        uint64_t GetField(const BinaryComponentRecord& r, uint32_t i) const;
+        /**
+         * @brief Returns type-specific field i of a Relation (see BinaryRelationRecord), or 0 if the record has fewer fields.
+         */
+        uint64_t GetField(const BinaryRelationRecord& r, uint32_t i) const;
+
+        /**
+         * @brief Creates the components and Relations stored in the file ("pointer fix-up": component indices become Component pointers).
+         * @return Pointer to the root Component, or NULL if a record is invalid.
+         */
+        Component* CreateTopology() const;
+
+    private:
+        int _Validate() const;
+        uint64_t _GetField(uint32_t first, uint32_t num, uint32_t i) const;
+        template <class T>
+        const T* _Section(uint64_t offset) const { return reinterpret_cast<const T*>(data + offset); }
+
+        const char* data = nullptr;
+        size_t size = 0;
+        const BinaryHeader* header = nullptr;
+    };
+} //namespace sys_sage
+#endif //BINARY_LOAD_HPP
@@ -68,6 +68,30 @@ namespace sys_sage {
             if (it != names.end()) return it->second;
             return "Unknown";
         }
+
+        using mask = uint64_t; /**< Bit mask of component types (bit N set = ComponentType N is selected). Used for filtering subtree traversals. */
+        constexpr mask AnyMask = ~mask{0}; /**< Mask selecting all component types (including user-defined types that do not fit into the mask). */
+        constexpr mask OtherTypesMask = mask{1} << 63; /**< Bit shared by all types outside of [0, 62] (user-defined types); a mask with this bit selects all of them. */
+
+        /**
+         * @brief Converts a ComponentType value to a (single-bit) mask. Masks can be combined with operator|.
+         * \n Types outside of [0, 62] (e.g. user-defined types) share the bit OtherTypesMask, so ToMask(t) selects all of them; compare the type to tell them apart.
+         * @param t ComponentType value
+         * @return Mask with the bit of t set.
+         */
+        constexpr mask ToMask(type t) {
+            return (t >= 0 && t < 63) ? (mask{1} << t) : OtherTypesMask;
+        }
+
+        /**
+         * @brief Checks whether a ComponentType value is selected by a mask.
+         * @param t ComponentType value
+         * @param m Mask (e.g. ToMask(Thread) | ToMask(Core), or AnyMask)
+         * @return true if t is selected by m
+         */
+        constexpr bool InMask(type t, mask m) {
+            return m == AnyMask || (ToMask(t) & m) != 0;
+        }
     }
 
     /**
@@ -121,6 +145,28 @@ namespace sys_sage {
             CouplingMap
         };
 
+        using mask = uint64_t; /**< Bit mask of relation types (bit N set = RelationType N is selected). */
+        constexpr mask AnyMask = ~mask{0}; /**< Mask selecting all relation types. */
+
+        /**
+         * @brief Converts a RelationType value to a (single-bit) mask. Masks can be combined with operator|.
+         * @param t RelationType value
+         * @return Mask with the bit of t set (0 for types outside of [0, 63], e.g. Any).
+         */
+        constexpr mask ToMask(type t) {
+            return (t >= 0 && t < 64) ? (mask{1} << t) : mask{0};
+        }
+
+        /**
+         * @brief Checks whether a RelationType value is selected by a mask.
+         * @param t RelationType value
+         * @param m Mask (e.g. ToMask(DataPath), or AnyMask)
+         * @return true if t is selected by m
+         */
+        constexpr bool InMask(type t, mask m) {
+            return m == AnyMask || (ToMask(t) & m) != 0;
+        }
+
         //SVTODO this should remain private???
         static const std::unordered_map<type, const char*> names = {
             {Any, "Any"},
@@ -144,6 +190,25 @@ namespace sys_sage {
         }
     }
 
+    /**
+     * @namespace AttributeType
+     * @brief Type tags of the values in an AttributeStore (see Component::SetAttribute()).
+     */
+    namespace AttributeType{
+        using type = int32_t; /**< AttributeType datatype -- to indicate a parameter should be from this enum/namespace (as there are no hard restrictions from C++). */
+
+        constexpr type None = 0; /**< No value. */
+        constexpr type Int = 1; /**< int (stored inline) */
+        constexpr type LongLong = 2; /**< long long (stored inline) */
+        constexpr type UInt64 = 3; /**< uint64_t (stored inline) */
+        constexpr type Float = 4; /**< float (stored inline) */
+        constexpr type Double = 5; /**< double (stored inline) */
+        constexpr type String = 6; /**< std::string */
+        constexpr type FrequencyHistory = 7; /**< std::vector<std::tuple<long long,double>> -- (timestamp, frequency in MHz) samples */
+        constexpr type Custom = 8; /**< Any other (user-defined) type. Exported to XML only through the custom export functions. */
+        constexpr type Lazy = 9; /**< LazyAttribute -- a value that is decoded on the first access (see XmlImportContext::lazyAttributes). */
+    }
+
     /**
      * @namespace DataPathType
      * @brief Enumerates types of DataPaths (logical, physical, etc.).
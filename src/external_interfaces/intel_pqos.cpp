@@ -10,6 +10,7 @@
 #include <limits> //numeric_limits
 
 #include "Component.hpp"
+#include "Epoch.hpp"
 
 using namespace std;
 
@@ -86,6 +87,7 @@ uint64_t getCoreCOS(unsigned int socketId, unsigned int coreId, unsigned * socke
 }
 
 int Node::UpdateL3CATCoreCOS(){
+    WriteGuard guard(this); //concurrent readers keep seeing the previous DataPaths until the update is complete
 
     struct pqos_config cfg;
     const struct pqos_cpuinfo *p_cpu = NULL;
@@ -126,15 +128,13 @@ int Node::UpdateL3CATCoreCOS(){
         {
             Thread* thread = *it_threads;
             //std::cout << "  thread " << thread->GetComponentTypeStr() << " id " << thread->GetId() << std::endl;
-            uint64_t* cos = new uint64_t();
-            uint64_t* mask = new uint64_t();
-            *cos = getCoreCOS(socket->GetId(), thread->GetId(), p_l3cat_ids, l3cat_id_count, p_cpu);
-            if(*cos == std::numeric_limits<uint64_t>::max()){
+            uint64_t cos = getCoreCOS(socket->GetId(), thread->GetId(), p_l3cat_ids, l3cat_id_count, p_cpu);
+            if(cos == std::numeric_limits<uint64_t>::max()){
                 cerr << "getCoreCOS failed" << endl;
                 continue;
             }
-            *mask = getCOSL3Bitmask(socket->GetId(), *cos, p_l3cat_ids, l3cat_id_count);
-            if(*mask == std::numeric_limits<uint64_t>::max()){
+            uint64_t mask = getCOSL3Bitmask(socket->GetId(), cos, p_l3cat_ids, l3cat_id_count);
+            if(mask == std::numeric_limits<uint64_t>::max()){
                 cerr << "getCOSL3Bitmask failed" << endl;
                 continue;
             }
@@ -155,8 +155,8 @@ int Node::UpdateL3CATCoreCOS(){
 
             //add DataPath to thread and L3
             DataPath* d = NewDataPath(thread, c, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_L3CAT);
-            d->attrib.insert({"CATcos", (void*)cos});
-            d->attrib.insert({"CATL3mask", (void*)mask});
+            d->SetAttribute(AttributeKey::CATcos, cos);
+            d->SetAttribute(AttributeKey::CATL3mask, mask);
         }
     }
     return 1;
@@ -168,11 +168,10 @@ long long Thread::GetCATAwareL3Size()
     for(auto it = std::begin(dp_outgoing); it != std::end(dp_outgoing); ++it)
     {
         DataPath* dp = *it;
-        auto search = dp->attrib.find("CATL3mask");
-        if (search == dp->attrib.end()) {
+        uint64_t* mask = dp->GetAttribute<uint64_t>(AttributeKey::CATL3mask);
+        if (mask == nullptr) {
             continue;
         }
-        uint64_t* mask = (uint64_t*)search->second;
 
         Cache* c = (Cache*)dp->GetTarget();
         int available_cache_associativity_ways = 0;
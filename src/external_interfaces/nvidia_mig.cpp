@@ -16,13 +16,22 @@
 #include "Memory.hpp"
 #include "Cache.hpp"
 #include "Subdivision.hpp"
+#include "Epoch.hpp"
 
 
-//SVTODO refactor to std::map<std::string, std::any> attrib;
+//true if dp is a MIG DataPath describing the MIG instance uuid
+static bool isMigDataPathOf(sys_sage::DataPath* dp, const std::string& uuid)
+{
+    if(dp->GetDataPathType() != sys_sage::DataPathType::MIG)
+        return false;
+    std::string* mig_uuid = dp->GetAttribute<std::string>(sys_sage::AttributeKey::mig_uuid);
+    return mig_uuid != nullptr && *mig_uuid == uuid;
+}
 
 //nvmlReturn_t nvmlDeviceGetMigDeviceHandleByIndex ( nvmlDevice_t device, unsigned int  index, nvmlDevice_t* migDevice ) --> look for all mig devices and add/update them
 int sys_sage::Chip::UpdateMIGSettings(std::string uuid)
 {
+    WriteGuard guard(this); //concurrent readers keep seeing the previous MIG DataPaths until the update is complete
     int ret = 0;
     if(uuid.empty())
     {
@@ -53,14 +62,14 @@ int sys_sage::Chip::UpdateMIGSettings(std::string uuid)
     
     //main memory, expects the memory as a child of
     Memory* m = (Memory*)GetChildByType(ComponentType::Memory);
-    long long* mig_size;
+    long long mig_size = 0;
     if(m != NULL){
         DataPath * d = NULL;
         //iterate over dp_outgoing to check if DP already exists
         for(Relation* r : GetRelations(RelationType::DataPath))
         {
             DataPath * dp = reinterpret_cast<DataPath*>(r);
-            if( dp->GetDataPathType() == DataPathType::MIG && *(static_cast<std::string*>(dp->attrib["mig_uuid"])) == uuid)
+            if(isMigDataPathOf(dp, uuid))
             {
                 d = dp;
                 break;
@@ -68,10 +77,9 @@ int sys_sage::Chip::UpdateMIGSettings(std::string uuid)
         }
 
         d = new DataPath(this, m, DataPathOrientation::Bidirectional, DataPathType::MIG);
-        std::string* mig_uuid = new std::string(uuid);
-        mig_size = new long long(attributes.memorySizeMB*1000000);
-        d->attrib.insert({"mig_uuid",(void*)mig_uuid});
-        d->attrib.insert({"mig_size",(void*)mig_size});
+        mig_size = attributes.memorySizeMB*1000000;
+        d->SetAttribute(AttributeKey::mig_uuid, uuid);
+        d->SetAttribute(AttributeKey::mig_size, mig_size);
     } else {
         std::cerr << "Chip::UpdateMIGSettings: Component Type Memory not found as a child of this Chip. Memory info will not be updated." << std::endl;
         ret = 1;
@@ -79,8 +87,8 @@ int sys_sage::Chip::UpdateMIGSettings(std::string uuid)
 
     //L2 cache(s)
     unsigned int L2_fraction = 1; //which fraction of L2 is in MIG partition (the same fraction as the fraction of main memory)
-    if(m->GetSize() > *mig_size){
-        L2_fraction = (m->GetSize() + (*mig_size/2)) / *mig_size; //divide and round up or down
+    if(m->GetSize() > mig_size){
+        L2_fraction = (m->GetSize() + (mig_size/2)) / mig_size; //divide and round up or down
     }
     std::vector<Component*> caches;
     GetSubcomponentsByType(&caches, ComponentType::Cache);
@@ -95,13 +103,11 @@ int sys_sage::Chip::UpdateMIGSettings(std::string uuid)
         int cache_id = 0;
         for(Cache* c : L2_caches){
             DataPath * d = new DataPath(this, c, DataPathOrientation::Bidirectional, DataPathType::MIG);
-            std::string* mig_uuid = new std::string(uuid);
-            mig_size = new long long();
-            *mig_size = c->GetCacheSize() * ( (float)num_caches/(float)L2_fraction-(float)cache_id/(float)num_caches);
-            if(*mig_size <0)
-                *mig_size=0;
-            d->attrib.insert({"mig_uuid",(void*)mig_uuid});
-            d->attrib.insert({"mig_size",(void*)mig_size});
+            long long cache_mig_size = c->GetCacheSize() * ( (float)num_caches/(float)L2_fraction-(float)cache_id/(float)num_caches);
+            if(cache_mig_size <0)
+                cache_mig_size=0;
+            d->SetAttribute(AttributeKey::mig_uuid, uuid);
+            d->SetAttribute(AttributeKey::mig_size, cache_mig_size);
             cache_id++;
         }
     } else {
@@ -120,8 +126,7 @@ int sys_sage::Chip::UpdateMIGSettings(std::string uuid)
     for(Subdivision* sm: sms){
         if(sm->GetId() < (int)attributes.multiprocessorCount){
             DataPath * d = new DataPath(this, sm, DataPathOrientation::Bidirectional, DataPathType::MIG);
-            std::string* mig_uuid = new std::string(uuid);
-            d->attrib.insert({"mig_uuid",(void*)mig_uuid});
+            d->SetAttribute(AttributeKey::mig_uuid, uuid);
         }
     }
 
@@ -154,7 +159,7 @@ int sys_sage::Chip::GetMIGNumSMs(std::string uuid)
         for(Relation* r : GetRelations(RelationType::DataPath))
         {
             DataPath * dp = reinterpret_cast<DataPath*>(r);
-            if(dp->GetDataPathType() == DataPathType::MIG && *(std::string*)dp->attrib["mig_uuid"] == uuid){
+            if(isMigDataPathOf(dp, uuid)){
                 Component* target = dp->GetTarget();
                 if(target->GetComponentType() == ComponentType::Subdivision && ((Subdivision*)target)->GetSubdivisionType() == SubdivisionType::GpuSM ){
                     num_sm++;
@@ -191,7 +196,7 @@ int sys_sage::Chip::GetMIGNumCores(std::string uuid)
         for(Relation* r : GetRelations(RelationType::DataPath))
         {
             DataPath * dp = reinterpret_cast<DataPath*>(r);
-            if(dp->GetDataPathType() == DataPathType::MIG && *(std::string*)dp->attrib["mig_uuid"] == uuid){
+            if(isMigDataPathOf(dp, uuid)){
                 Component* target = dp->GetTarget();
                 if(target->GetComponentType() == ComponentType::Subdivision && ((Subdivision*)target)->GetSubdivisionType() == SubdivisionType::GpuSM ){
                     sms.push_back((Subdivision*)target);
@@ -225,10 +230,9 @@ long long sys_sage::Memory::GetMIGSize(std::string uuid) const
     for(Relation* r : GetRelations(RelationType::DataPath))
     {
         DataPath * dp = reinterpret_cast<DataPath*>(r);
-        if(dp->GetDataPathType() == DataPathType::MIG && *(std::string*)dp->attrib["mig_uuid"] == uuid){
-            if (dp->attrib.count("mig_size")){
-                long long r = *(long long*)dp->attrib["mig_size"];
-                return r;
+        if(isMigDataPathOf(dp, uuid)){
+            if (long long* r = dp->GetAttribute<long long>(AttributeKey::mig_size)){
+                return *r;
             }
         }
     }
@@ -254,10 +258,9 @@ long long sys_sage::Cache::GetMIGSize(std::string uuid) const
         for(Relation* r : GetRelations(RelationType::DataPath))
         {
             DataPath * dp = reinterpret_cast<DataPath*>(r);
-            if(dp->GetDataPathType() == DataPathType::MIG && *(std::string*)dp->attrib["mig_uuid"] == uuid){
-                if (dp->attrib.count("mig_size")){
-                    long long r = *(long long*)dp->attrib["mig_size"];
-                    return r;
+            if(isMigDataPathOf(dp, uuid)){
+                if (long long* r = dp->GetAttribute<long long>(AttributeKey::mig_size)){
+                    return *r;
                 }
             }
         }
@@ -13,12 +13,14 @@
 #include <algorithm>
 #include <tuple>
 #include <chrono>
+#include <atomic>
 
 #include "Component.hpp"
 #include "Thread.hpp"
 #include "Core.hpp"
 #include "Node.hpp"
 #include "Chip.hpp"
+#include "Epoch.hpp"
 
 using std::cout;
 using std::endl;
@@ -83,11 +85,22 @@ int _readCpuinfoFreq(std::vector<sys_sage::Thread*> threads, bool keep_history =
                     if(keep_history)
                     {
                         //check if freq_history exists; if not, create it -- vector of tuples <timestamp,frequency>
-                        if (c->attrib.find("freq_history") == c->attrib.end()) {
-                            c->attrib["freq_history"] = (void*) new std::vector<std::tuple<long long,double>>();
-                        }
+                        sys_sage::FrequencyHistory* fh = c->GetAttribute<sys_sage::FrequencyHistory>(sys_sage::AttributeKey::freq_history);
                         long long ts = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-                        ((std::vector<std::tuple<long long,double>>*)c->attrib["freq_history"])->push_back(std::make_tuple(ts,freq));
+                        if(c->_FindEpochDomain() != nullptr)
+                        {
+                            //concurrent readers may be iterating the published history -- publish an extended copy instead
+                            sys_sage::FrequencyHistory updated = fh != nullptr ? *fh : sys_sage::FrequencyHistory();
+                            updated.push_back(std::make_tuple(ts,freq));
+                            c->SetAttribute(sys_sage::AttributeKey::freq_history, std::move(updated));
+                        }
+                        else
+                        {
+                            if (fh == nullptr) {
+                                fh = &c->SetAttribute(sys_sage::AttributeKey::freq_history, sys_sage::FrequencyHistory());
+                            }
+                            fh->push_back(std::make_tuple(ts,freq));
+                        }
                     }
                     //cout << "----------------Core " << c->GetId() << " (HW thread " << threads[current_thread_pos]->GetId() << ") frequency: " << freq << endl;
                     threads_processed++;
@@ -108,6 +121,7 @@ int _readCpuinfoFreq(std::vector<sys_sage::Thread*> threads, bool keep_history =
 
 int sys_sage::Node::RefreshCpuCoreFrequency(bool keep_history)
 {
+    WriteGuard guard(this);
     std::vector<Component*> sockets = this->GetAllChildrenByType(ComponentType::Chip);
     std::vector<Thread*> cpu_hw_threads, hw_threads_to_refresh;
     for(Component * socket : sockets)
@@ -135,6 +149,7 @@ int sys_sage::Node::RefreshCpuCoreFrequency(bool keep_history)
 
 int sys_sage::Core::RefreshFreq(bool keep_history)
 {
+    WriteGuard guard(this);
     std::vector<Thread*> cpu_hw_threads;
     Thread* hw_thread = (Thread*)this->GetChildByType(sys_sage::ComponentType::Thread);
     if(hw_thread != NULL)
@@ -144,13 +159,15 @@ int sys_sage::Core::RefreshFreq(bool keep_history)
 
 int sys_sage::Thread::RefreshFreq(bool keep_history)
 {
+    WriteGuard guard(this);
     std::vector<Thread*> cpu_hw_threads;
     cpu_hw_threads.push_back(this);
     return _readCpuinfoFreq(cpu_hw_threads, keep_history);
 }
 
-double sys_sage::Core::GetFreq() const {return freq;}
-void sys_sage::Core::SetFreq(double _freq) {freq = _freq;}
+//relaxed atomic access: concurrent readers may query the frequency while a refresher updates it
+double sys_sage::Core::GetFreq() const {return std::atomic_ref<double>(const_cast<double&>(freq)).load(std::memory_order_relaxed);}
+void sys_sage::Core::SetFreq(double _freq) {std::atomic_ref<double>(freq).store(_freq, std::memory_order_relaxed); MarkModified();}
 double sys_sage::Thread::GetFreq()
 {
     Core * c = (Core*)this->GetAncestorByType(sys_sage::ComponentType::Core);
@@ -1,115 +1,137 @@
 #include <iostream>
 #include <cassert>
 #include <algorithm>
-#include <numeric>
-#include <fstream>
+#include <climits>
+#include <limits>
 #include <string>
 #include <vector>
 #include <exception>
 //#include <bits/stdc++.h>
-#include <sstream>
 #include "cccbench.hpp"
+#include "table-reader.hpp"
 
 using namespace std;
 
+sys_sage::LatencyMatrix::LatencyMatrix(unsigned int _dimension)
+    : dimension(_dimension), count((size_t)_dimension * _dimension, 0), mean(count.size(), 0.0), m2(count.size(), 0.0),
+      min(count.size(), std::numeric_limits<float>::infinity()), max(count.size(), -std::numeric_limits<float>::infinity())
+{}
+
+void sys_sage::LatencyMatrix::Add(unsigned int x, unsigned int y, float sample)
+{
+    size_t i = _Index(x, y);
+    count[i]++;
+    double delta = sample - mean[i];
+    mean[i] += delta / count[i];
+    m2[i] += delta * (sample - mean[i]);
+    min[i] = std::min(min[i], sample);
+    max[i] = std::max(max[i], sample);
+}
+
+float sys_sage::LatencyMatrix::GetVariance(unsigned int x, unsigned int y) const
+{
+    size_t i = _Index(x, y);
+    return count[i] < 2 ? 0.0f : (float)(m2[i] / (count[i] - 1));
+}
+
+//returns the number of data rows; header is the column indices of xcore, ycore, and the metric
+template <class F>
+static unsigned int _read_cccbench_rows(sys_sage::TableReader* reader, const int header[3], F f)
+{
+    vector<std::string_view> row;
+    unsigned int lines = 0;
+    reader->NextRow(&row); //header
+    while(reader->NextRow(&row))
+    {
+        unsigned int x, y;
+        float value;
+        if((int)row.size() <= std::max({header[0], header[1], header[2]}) ||
+           !sys_sage::TableReader::ParseNumber(row[header[0]], &x) || !sys_sage::TableReader::ParseNumber(row[header[1]], &y) ||
+           !sys_sage::TableReader::ParseNumber(row[header[2]], &value))
+        {
+            throw "malformed line in cccbench output";
+        }
+        f(x, y, value);
+        lines++;
+    }
+    return lines;
+}
+
 sys_sage::CccbenchParser::CccbenchParser(const char *csv_path)
-    : c2cDatapoints((Vec2DArray<float> *)0)
 {
-    fstream fs;
-    string line, token;
-    vector <std::string>ltokens;
-    vector <std::string>columns;
-    int i=0, metric_i=-1, xcore_i=-1, ycore_i=-1, elements_per_line = -1;
+    vector<std::string_view> row;
+    int metric_i=-1, xcore_i=-1, ycore_i=-1;
 
-    //c2cDatapoints;
     this->firstCore = INT_MAX;
     this->lastCore = 0;
-    fs.open(csv_path, ios::in);
-    if(!fs.is_open())
+    TableReader reader(",", true, 0);
+    if(reader.Open(csv_path) != 0)
     {
         //throw std::runtime_error();
         throw "failed to open file";
     }
-    while(getline(fs, line))
+    //empty lines are allowed and discarded
+    if(reader.NextRow(&row))
     {
-        if(line.empty())// || 
-           //std::all_of(line.begin(), line.end(), [](char c){return std::isspace(c);}))
-            continue; //allow and discard empty lines
-        int within_line_i = 0;
-        unsigned int tok_int=0;
-        std::stringstream linestream(line);
-        if(0 == i++)
-        {
-            while(std::getline(linestream, token, ','))
-            {
-                columns.push_back(token);
-                if(token == this->metric_name)
-                    metric_i = within_line_i;
-                if(token == this->xcore_name)
-                    xcore_i = within_line_i;
-                if(token == this->ycore_name)
-                    ycore_i = within_line_i;
-                within_line_i++;
-            }
-            elements_per_line = within_line_i;
-            continue;
-        }
-        //assertions used for things related to the expected data source format
-        assert(xcore_i > -1);
-        assert(ycore_i > -1);
-        assert(metric_i > -1);
-        while(std::getline(linestream, token, ','))
+        for(int i=0; i<(int)row.size(); i++)
         {
-            //assuming x and y are in the same range (all to all) 
-            if(xcore_i == within_line_i || ycore_i == within_line_i)
-            {
-                tok_int = std::stoi(token);
-                this->firstCore = (this->firstCore > tok_int) ? tok_int: this->firstCore;
-                this->lastCore = (this->lastCore < tok_int) ? tok_int: this->lastCore;
-            }
-            ltokens.push_back(token);
-            within_line_i++;
+            if(row[i] == this->metric_name)
+                metric_i = i;
+            if(row[i] == this->xcore_name)
+                xcore_i = i;
+            if(row[i] == this->ycore_name)
+                ycore_i = i;
         }
-        assert(within_line_i <= elements_per_line);
-    }
-    fs.close();
-    this->lines = i-1; //ignore header line
-    int dimension = 1 + this->lastCore - this->firstCore;
-    this->c2cDatapoints = new Vec2DArray<float>(dimension, dimension);
-    for(unsigned int i=0; i<lines; ++i)
-    {
-        auto xi = std::stoi(ltokens[xcore_i + i*elements_per_line]) - this->firstCore;
-        auto yi = std::stoi(ltokens[ycore_i + i*elements_per_line]) - this->firstCore;
-        (*this->c2cDatapoints)[xi][yi].push_back(std::stof(ltokens[metric_i + i*elements_per_line]));
     }
+    //assertions used for things related to the expected data source format
+    assert(xcore_i > -1);
+    assert(ycore_i > -1);
+    assert(metric_i > -1);
+    const int header[3] = {xcore_i, ycore_i, metric_i};
+
+    //first pass: range of core ids (assuming x and y are in the same range (all to all))
+    reader.OpenBuffer(reader.GetText());
+    this->lines = _read_cccbench_rows(&reader, header, [this](unsigned int x, unsigned int y, float) {
+        this->firstCore = std::min({this->firstCore, x, y});
+        this->lastCore = std::max({this->lastCore, x, y});
+    });
+    if(this->lines == 0)
+        return;
+
+    //second pass: fold the samples into the statistics
+    this->c2cDatapoints = LatencyMatrix(1 + this->lastCore - this->firstCore);
+    reader.OpenBuffer(reader.GetText());
+    _read_cccbench_rows(&reader, header, [this](unsigned int x, unsigned int y, float value) {
+        this->c2cDatapoints.Add(xtoi(x), ytoi(y), value);
+    });
 }
 
 void sys_sage::CccbenchParser::applyDataPaths(Component *root)
 {
-    auto corev = new vector<Component *>();
-    root->GetAllSubcomponentsByType(corev, sys_sage::ComponentType::Core);
-    //auto corev = root->GetAllChildrenByType(SYS_SAGE_COMPONENT_CORE);
+    vector<Component *> corev;
+    root->GetAllSubcomponentsByType(&corev, sys_sage::ComponentType::Core);
 
-    for(auto xcore : *corev)
+    for(auto xcore : corev)
     {
-        for(auto ycore : *corev)
+        for(auto ycore : corev)
         {
-            auto xci = xcore->GetId();
-            auto yci = ycore->GetId();
-            if(xci == yci)
+            unsigned int xci = xcore->GetId();
+            unsigned int yci = ycore->GetId();
+            if(xci == yci || xci < this->firstCore || yci < this->firstCore || xtoi(xci) >= c2cDatapoints.GetDimension() || ytoi(yci) >= c2cDatapoints.GetDimension())
             {
                 continue;
             }
-            auto xtoylatv = (*this->c2cDatapoints)[xci][yci];
-            auto sum = accumulate(xtoylatv.begin(), xtoylatv.end(), 0.0);
-            auto mean = new float(sum / xtoylatv.size());
-            auto max = new float(*max_element(xtoylatv.begin(), xtoylatv.end()));
-            auto min = new float(*min_element(xtoylatv.begin(), xtoylatv.end()));
+            unsigned int xi = xtoi(xci), yi = ytoi(yci);
+            if(c2cDatapoints.GetCount(xi, yi) == 0)
+                continue;
+            float mean = c2cDatapoints.GetMean(xi, yi);
             auto dtp = new DataPath(xcore, ycore, sys_sage::DataPathOrientation::Oriented,
-                                   sys_sage::DataPathType::C2C, 0, *mean);
-            dtp->attrib.insert(std::pair<string, void *>("latency_max", (void *)max));
-            dtp->attrib.insert(std::pair<string, void *>("latency_min", (void *)min));
-            dtp->attrib.insert(std::pair<string, void *>("latency", (void *)mean));
+                                   sys_sage::DataPathType::C2C, 0, mean);
+            dtp->SetAttribute(AttributeKey::latency_max, c2cDatapoints.GetMax(xi, yi));
+            dtp->SetAttribute(AttributeKey::latency_min, c2cDatapoints.GetMin(xi, yi));
+            dtp->SetAttribute(AttributeKey::latency, mean);
+            dtp->SetAttribute(AttributeKey::latency_count, (uint64_t)c2cDatapoints.GetCount(xi, yi));
+            dtp->SetAttribute(AttributeKey::latency_variance, c2cDatapoints.GetVariance(xi, yi));
         }
     }
 }
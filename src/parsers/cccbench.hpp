@@ -1,6 +1,7 @@
 #ifndef CCCBENCH_PARSER
 #define CCCBENCH_PARSER
 
+#include <cstdint>
 #include <vector>
 
 #include "enums.hpp"
@@ -14,28 +15,37 @@
 namespace sys_sage {
     int parseCccbenchOutput(Node* , std::string );
 
-    template <typename T>class Vec2DArray
+    /**
+     * @brief Statistics of the latency samples of every (x, y) pair of cores, stored as a dense dimension x dimension matrix (one array per statistic, row-major).
+     * Samples are folded in one by one (Welford's algorithm), so the memory does not grow with the number of repetitions.
+     */
+    class LatencyMatrix
     {
-        Vec2DArray(){}
-        std::vector<T> *array;
-        unsigned int size, xdim, ydim;
     public:
-        Vec2DArray(unsigned xdim, unsigned ydim);
-        std::vector<T> *operator [](unsigned int xindex);
-    };
-
-    template <typename T>Vec2DArray<T>::Vec2DArray(unsigned int _xdim, unsigned int _ydim)
-    {
-        this->size = _xdim * _ydim;
-        this->xdim = _xdim;
-        this->ydim = _ydim;
-        this->array = new std::vector<T> [this->size];
-    }
+        LatencyMatrix(unsigned int _dimension = 0);
+        /**
+         * @brief Adds one sample of pair (x, y). x and y are indices (0..dimension-1), not core ids.
+         */
+        void Add(unsigned int x, unsigned int y, float sample);
+        unsigned int GetDimension() const { return dimension; }
+        uint32_t GetCount(unsigned int x, unsigned int y) const { return count[_Index(x, y)]; }
+        float GetMean(unsigned int x, unsigned int y) const { return (float)mean[_Index(x, y)]; }
+        float GetMin(unsigned int x, unsigned int y) const { return min[_Index(x, y)]; }
+        float GetMax(unsigned int x, unsigned int y) const { return max[_Index(x, y)]; }
+        /**
+         * @brief Returns the sample variance (0 for less than 2 samples).
+         */
+        float GetVariance(unsigned int x, unsigned int y) const;
+    private:
+        size_t _Index(unsigned int x, unsigned int y) const { return (size_t)x * dimension + y; }
 
-    template <typename T>std::vector<T> *Vec2DArray<T>::operator [](unsigned int xindex)
-    {
-        return &(this->array[this->xdim*xindex]);
-    }
+        unsigned int dimension;
+        std::vector<uint32_t> count;
+        std::vector<double> mean;
+        std::vector<double> m2; /**< Sum of squared differences from the mean. */
+        std::vector<float> min;
+        std::vector<float> max;
+    };
 
     class CccbenchParser{
         unsigned int firstCore;
@@ -44,14 +54,18 @@ namespace sys_sage {
         const char *metric_name = "xylat";
         const char *xcore_name = "xcore";
         const char *ycore_name = "ycore";
-        Vec2DArray<float> *c2cDatapoints;
-        CccbenchParser():c2cDatapoints((Vec2DArray<float> *)0){}
+        LatencyMatrix c2cDatapoints;
+        CccbenchParser(){}
     public:
-        virtual ~CccbenchParser(){if(this->c2cDatapoints) {delete [] c2cDatapoints;}}
+        virtual ~CccbenchParser(){}
         unsigned int xtoi(unsigned int _x){return _x - this->firstCore;}
         unsigned int ytoi(unsigned int _y){return _y - this->firstCore;}
         CccbenchParser(const char *csv_path);
         void applyDataPaths(Component *root);
+        /**
+         * @brief Returns the latency statistics; index i corresponds to core id i + first core id in the file.
+         */
+        const LatencyMatrix& GetLatencyMatrix() const { return c2cDatapoints; }
     };
 
 } //namespace sys_sage
@@ -1,6 +1,8 @@
 
 #include <iostream>
 #include <algorithm>
+#include <string_view>
+#include <unordered_map>
 
 #include "hwloc.hpp"
 
@@ -39,60 +41,123 @@ string sys_sage::xmlGetPropStr(xmlNode* node, string key)
     return val;
 }
 
-sys_sage::Component* sys_sage::createChildC(string type, xmlNode* node)
+namespace {
+    //the fields of an hwloc object used by the parser -- read from an XML element (parseHwlocOutput) or from the hwloc object itself (parseHwlocTopology)
+    struct HwlocObjectFields {
+        sys_sage::ComponentType::type type = sys_sage::ComponentType::None; //component to create: Node (Machine), Chip (Package), Cache, Numa, Core, Thread; None for other relevant types (Group)
+        int os_index = 0;
+        int gp_index = 0;
+        unsigned long long cache_size = 0;
+        int cache_depth = 0;
+        int cache_associativity = 0;
+        int cache_linesize = 0;
+        long long local_memory = 0;
+    };
+}
+
+static sys_sage::Component* _create_hwloc_component(const HwlocObjectFields& o)
 {
-    Component* c = NULL;
-    string s;
-    if(!type.compare("Machine"))
-    {
-        c = (Component*)new Node();
-    }
-    else if(!type.compare("Package"))
+    using namespace sys_sage;
+    switch(o.type)
     {
-        s = xmlGetPropStr(node, "os_index");
-        int id = stoi(s.empty()?"0":s);
-        c = (Component*)new Chip(id, "socket", sys_sage::ChipType::CpuSocket);
+        case ComponentType::Node:
+            return new Node();
+        case ComponentType::Chip:
+            return new Chip(o.os_index, "socket", ChipType::CpuSocket);
+        case ComponentType::Cache:
+            return new Cache(o.gp_index, o.cache_depth, o.cache_size, o.cache_associativity, o.cache_linesize);
+        case ComponentType::Numa:
+            return new Numa(o.os_index, o.local_memory);
+        case ComponentType::Core:
+            return new Core(o.os_index);
+        case ComponentType::Thread:
+            return new Thread(o.os_index, "HW_thread");
+        default:
+            return new Component();
     }
-    else if(!type.compare("Cache") || !type.compare("L3Cache") || !type.compare("L2Cache") || !type.compare("L1Cache"))
-    {
-        s = xmlGetPropStr(node, "gp_index");
-        int id = stoi(s.empty()?"0":s);
-        s = xmlGetPropStr(node, "cache_size");
-        unsigned long long size = stoul(s.empty()?"0":s);
-        s = xmlGetPropStr(node, "depth");
-        int cache_level = stoi(s.empty()?"0":s);
-        s = xmlGetPropStr(node, "cache_associativity");
-        int associativity = stoi(s.empty()?"0":s);
-        s = xmlGetPropStr(node, "cache_linesize");
-        int cache_line_size = stoi(s.empty()?"0":s);
-        c = (Component*)new Cache(id, cache_level, size, associativity, cache_line_size);
-    }
-    else if(!type.compare("NUMANode"))
-    {
-        s = xmlGetPropStr(node, "os_index");
-        int id = stoi(s.empty()?"0":s);
-        s = xmlGetPropStr(node, "local_memory");
-        long long size = stol(s.empty()?"0":s);
+}
 
-        c = (Component*)new Numa(id, size);
+//inserts childC below c; a cache and a NUMA node that would be siblings are nested (the cache below the NUMA node)
+static void _insert_hwloc_child(sys_sage::Component* c, sys_sage::Component* childC)
+{
+    bool inserted_as_sibling = false;
+    if(childC->GetComponentType() == sys_sage::ComponentType::Cache)
+    {//make a cache a child of NUMA, if it is a sibling
+        vector<sys_sage::Component*> siblings = c->GetChildren();
+        for(sys_sage::Component* sibling : siblings){
+            if(sibling->GetComponentType() == sys_sage::ComponentType::Numa) {
+                sibling->InsertChild(childC);
+                inserted_as_sibling = true;
+                break;
+            }
+        }
     }
-    else if(!type.compare("Core"))
-    {
-        s = xmlGetPropStr(node, "os_index");
-        int id = stoi(s.empty()?"0":s);
-        c = (Component*)new Core(id);
+    else if(childC->GetComponentType() == sys_sage::ComponentType::Numa)
+    {//make a (already inserted)cache a child of NUMA, if it is a sibling
+        vector<sys_sage::Component*> siblings = c->GetChildren();
+        for(sys_sage::Component* sibling: siblings){
+            if(sibling->GetComponentType() == sys_sage::ComponentType::Cache) {
+                c->RemoveChild(sibling);
+                c->InsertChild(childC);
+                childC->InsertChild(sibling);
+                inserted_as_sibling = true;
+                break;
+            }
+        }
     }
-    else if(!type.compare("PU"))
+    if(!inserted_as_sibling)
+        c->InsertChild(childC);
+}
+
+//stores the CPUVendor/CPUModel info of an hwloc object on c (if it is a Chip)
+static void _set_hwloc_info(sys_sage::Component* c, const string& name, const string& value)
+{
+    if(c->GetComponentType() != sys_sage::ComponentType::Chip)
+        return;
+    if(!name.compare("CPUVendor"))
+        ((sys_sage::Chip*)c)->SetVendor(value);
+    else if(!name.compare("CPUModel"))
+        ((sys_sage::Chip*)c)->SetModel(value);
+}
+
+sys_sage::Component* sys_sage::createChildC(string type, xmlNode* node)
+{
+    //the relevant object types (see xmlRelevantObjectTypes) and the components created for them
+    static const std::unordered_map<std::string_view, ComponentType::type> componentTypes = {
+        {"Machine", ComponentType::Node},
+        {"Package", ComponentType::Chip},
+        {"Cache", ComponentType::Cache},
+        {"L3Cache", ComponentType::Cache},
+        {"L2Cache", ComponentType::Cache},
+        {"L1Cache", ComponentType::Cache},
+        {"NUMANode", ComponentType::Numa},
+        {"Core", ComponentType::Core},
+        {"PU", ComponentType::Thread}
+    };
+    auto prop = [node](const char* key) {
+        string s = xmlGetPropStr(node, key);
+        return s.empty() ? string("0") : s;
+    };
+
+    HwlocObjectFields o;
+    auto it = componentTypes.find(type);
+    if(it != componentTypes.end())
+        o.type = it->second;
+    if(o.type == ComponentType::Cache)
     {
-        s = xmlGetPropStr(node, "os_index");
-        int id = stoi(s.empty()?"0":s);
-        c = (Component*)new Thread(id, "HW_thread");
+        o.gp_index = stoi(prop("gp_index"));
+        o.cache_size = stoull(prop("cache_size"));
+        o.cache_depth = stoi(prop("depth"));
+        o.cache_associativity = stoi(prop("cache_associativity"));
+        o.cache_linesize = stoi(prop("cache_linesize"));
     }
-    else
+    else if(o.type != ComponentType::Node && o.type != ComponentType::None)
     {
-        c = new Component();
+        o.os_index = stoi(prop("os_index"));
+        if(o.type == ComponentType::Numa)
+            o.local_memory = stoll(prop("local_memory"));
     }
-    return c;
+    return _create_hwloc_component(o);
 }
 
 int sys_sage::xmlProcessChildren(Component* c, xmlNode* parent, int level)
@@ -107,17 +172,7 @@ int sys_sage::xmlProcessChildren(Component* c, xmlNode* parent, int level)
             if(find(xmlRelevantNames.begin(), xmlRelevantNames.end(), name) != xmlRelevantNames.end())
             {
                 if(name == "info"){
-                    string name = xmlGetPropStr(child, "name");
-                    if(!name.compare("CPUVendor")){
-                        string value = xmlGetPropStr(child, "value");
-                        if(c->GetComponentType() == sys_sage::ComponentType::Chip)
-                            ((Chip*)c)->SetVendor(value);
-                    }
-                    else if(!name.compare("CPUModel")){
-                        string value = xmlGetPropStr(child, "value");
-                        if(c->GetComponentType() == sys_sage::ComponentType::Chip)
-                            ((Chip*)c)->SetModel(value);
-                    }
+                    _set_hwloc_info(c, xmlGetPropStr(child, "name"), xmlGetPropStr(child, "value"));
                 }
                 else //name == object, topology
                 {
@@ -141,34 +196,7 @@ int sys_sage::xmlProcessChildren(Component* c, xmlNode* parent, int level)
                             //cout << "inserting " << type << " to " << c->GetName() << endl;
                             childC = createChildC(type, child);
 
-                            bool inserted_as_sibling = false;
-                            if(childC->GetComponentType() == sys_sage::ComponentType::Cache)
-                            {//make a cache a child of NUMA, if it is a sibling
-                                vector<Component*> siblings = c->GetChildren();
-                                for(Component* sibling : siblings){
-                                    if(sibling->GetComponentType() == sys_sage::ComponentType::Numa) {
-                                        sibling->InsertChild(childC);
-                                        inserted_as_sibling = true;
-                                        break;
-                                    }
-                                }
-                            }
-                            else if(childC->GetComponentType() == sys_sage::ComponentType::Numa)
-                            {//make a (already inserted)cache a child of NUMA, if it is a sibling
-                                vector<Component*> siblings = c->GetChildren();
-                                for(Component* sibling: siblings){
-                                    if(sibling->GetComponentType() == sys_sage::ComponentType::Cache) {
-                                        c->RemoveChild(sibling);
-                                        c->InsertChild(childC);
-                                        childC->InsertChild(childC);
-                                        sibling->InsertChild(sibling);
-                                        inserted_as_sibling = true;
-                                        break;
-                                    }
-                                }
-                            }
-                            if(!inserted_as_sibling)
-                                c->InsertChild(childC);
+                            _insert_hwloc_child(c, childC);
                         }
                         xmlProcessChildren(childC, child, level+1);
                         //delete childC;
@@ -219,6 +247,17 @@ int sys_sage::removeUnknownCompoents(Component* c){
     return ret;
 }
 
+//removes the placeholder components and checks the tree (the last steps of all hwloc parsers)
+static int _finish_hwloc_parsing(sys_sage::Node* n, const string& source)
+{
+    int err = sys_sage::removeUnknownCompoents(n);
+    if(err != 0){
+        std::cerr << "parsing hwloc " << source << " failed on removeUnknownCompoents BUT WILL CONTINUE" << std::endl;
+        //return ret;
+    }
+    return n->CheckComponentTreeConsistency();
+}
+
 //parses a hwloc output and adds it to topology
 int sys_sage::parseHwlocOutput(Node* n, string xmlPath)
 {
@@ -235,12 +274,102 @@ int sys_sage::parseHwlocOutput(Node* n, string xmlPath)
         std::cerr << "parseHwlocOutput on file " << xmlPath << " failed on xmlProcessChildren" << std::endl;
         return err;
     }
-    err = removeUnknownCompoents(n);
-    if(err != 0){
-        std::cerr << "parseHwlocOutput on file " << xmlPath << " failed on removeUnknownCompoents BUT WILL CONTINUE" << std::endl;
-        //return ret;
+    xmlFreeDoc(document);
+    return _finish_hwloc_parsing(n, "file " + xmlPath);
+}
+
+int sys_sage::parseHwlocTopology(Node* n, const char* xmlBuffer, int size)
+{
+    //hwloc_topology_export_xmlbuffer() counts the terminating NUL
+    if(size > 0 && xmlBuffer[size - 1] == '\0')
+        size--;
+    xmlDoc *document = xmlReadMemory(xmlBuffer, size, NULL, NULL, 0);
+    if (document == NULL) {
+        cerr << "error: could not parse the hwloc XML buffer" << endl;
+        return 1;
     }
+
+    xmlNode *root= xmlDocGetRootElement(document);
+    int err = xmlProcessChildren(n, root, 0);
     xmlFreeDoc(document);
-    err = n->CheckComponentTreeConsistency();
-    return err;
+    if(err != 0){
+        std::cerr << "parseHwlocTopology on an XML buffer failed on xmlProcessChildren" << std::endl;
+        return err;
+    }
+    return _finish_hwloc_parsing(n, "XML buffer");
+}
+
+#ifdef DS_HWLOC
+static void _process_hwloc_object(sys_sage::Component* c, hwloc_obj_t obj);
+
+//visits the children in the order in which hwloc exports them to XML, so that the result equals that of parseHwlocOutput()
+static void _process_hwloc_children(sys_sage::Component* c, hwloc_obj_t obj)
+{
+    for(hwloc_obj_t child = obj->memory_first_child; child != NULL; child = child->next_sibling)
+        _process_hwloc_object(c, child);
+    for(hwloc_obj_t child = obj->first_child; child != NULL; child = child->next_sibling)
+        _process_hwloc_object(c, child);
+    for(hwloc_obj_t child = obj->io_first_child; child != NULL; child = child->next_sibling)
+        _process_hwloc_object(c, child);
+    for(hwloc_obj_t child = obj->misc_first_child; child != NULL; child = child->next_sibling)
+        _process_hwloc_object(c, child);
+}
+
+//same as xmlProcessChildren() for one object element; the object types of xmlRelevantObjectTypes are mapped by their hwloc type
+static void _process_hwloc_object(sys_sage::Component* c, hwloc_obj_t obj)
+{
+    using namespace sys_sage;
+    HwlocObjectFields o;
+    switch(obj->type)
+    {
+        case HWLOC_OBJ_MACHINE: o.type = ComponentType::Node; break;
+        case HWLOC_OBJ_PACKAGE: o.type = ComponentType::Chip; break;
+        case HWLOC_OBJ_L1CACHE:
+        case HWLOC_OBJ_L2CACHE:
+        case HWLOC_OBJ_L3CACHE: o.type = ComponentType::Cache; break;
+        case HWLOC_OBJ_NUMANODE: o.type = ComponentType::Numa; break;
+        case HWLOC_OBJ_CORE: o.type = ComponentType::Core; break;
+        case HWLOC_OBJ_PU: o.type = ComponentType::Thread; break;
+        case HWLOC_OBJ_GROUP: o.type = ComponentType::None; break;
+        default:
+            //not relevant: its infos and children go to c
+            for(unsigned i = 0; i < obj->infos_count; i++)
+                _set_hwloc_info(c, obj->infos[i].name, obj->infos[i].value);
+            _process_hwloc_children(c, obj);
+            return;
+    }
+
+    Component* childC = c;
+    if(obj->type != HWLOC_OBJ_MACHINE) //node is already existing param
+    {
+        //unknown indexes are not exported to XML, which reads them as 0
+        o.os_index = obj->os_index == HWLOC_UNKNOWN_INDEX ? 0 : static_cast<int>(obj->os_index);
+        if(o.type == ComponentType::Cache)
+        {
+            o.gp_index = static_cast<int>(obj->gp_index);
+            o.cache_size = obj->attr->cache.size;
+            o.cache_depth = static_cast<int>(obj->attr->cache.depth);
+            o.cache_associativity = obj->attr->cache.associativity;
+            o.cache_linesize = static_cast<int>(obj->attr->cache.linesize);
+        }
+        else if(o.type == ComponentType::Numa)
+            o.local_memory = static_cast<long long>(obj->attr->numanode.local_memory);
+        childC = _create_hwloc_component(o);
+        _insert_hwloc_child(c, childC);
+    }
+    for(unsigned i = 0; i < obj->infos_count; i++)
+        _set_hwloc_info(childC, obj->infos[i].name, obj->infos[i].value);
+    _process_hwloc_children(childC, obj);
+}
+
+int sys_sage::parseHwlocTopology(Node* n, hwloc_topology_t topology)
+{
+    hwloc_obj_t root = hwloc_get_root_obj(topology);
+    if(root == NULL) {
+        cerr << "error: parseHwlocTopology got a topology that is not loaded" << endl;
+        return 1;
+    }
+    _process_hwloc_object(n, root);
+    return _finish_hwloc_parsing(n, "topology");
 }
+#endif
@@ -7,6 +7,11 @@
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 
+#include "defines.hpp"
+#ifdef DS_HWLOC
+#include <hwloc.h>
+#endif
+
 #include "Component.hpp"
 #include "Thread.hpp"
 #include "Core.hpp"
@@ -28,6 +33,24 @@ namespace sys_sage {
     @param xmlPath - Path to the XML output of hwloc that should be parsed and uploaded to sys-sage.
     */
     int parseHwlocOutput(Node* n, std::string xmlPath);
+    /**
+    Parser function for importing hwloc XML output from memory, e.g. the buffer of hwloc_topology_export_xmlbuffer(), without writing it to a file first.
+    \n Creates the same components as parseHwlocOutput() on the same XML.
+    @param n - Pointer to an already existing Node where the hwloc topology will get parsed.
+    @param xmlBuffer - XML output of hwloc.
+    @param size - Length of xmlBuffer in bytes (a terminating NUL, as counted by hwloc_topology_export_xmlbuffer(), is ignored).
+    */
+    int parseHwlocTopology(Node* n, const char* xmlBuffer, int size);
+#ifdef DS_HWLOC
+    /**
+    Parser function for importing a loaded hwloc topology to sys-sage directly (no XML is written or parsed). Available if sys-sage is built with DS_HWLOC.
+    \n Walks the hwloc object tree and creates the same components as parseHwlocOutput() on the XML export of the topology.
+    The object types of the default xmlRelevantObjectTypes are considered (by their hwloc type).
+    @param n - Pointer to an already existing Node where the hwloc topology will get parsed.
+    @param topology - Loaded hwloc topology (see hwloc_topology_load()); it is only read.
+    */
+    int parseHwlocTopology(Node* n, hwloc_topology_t topology);
+#endif
     /// @private
     int xmlProcessChildren(Component* c, xmlNode* parent, int level);
     /// @private
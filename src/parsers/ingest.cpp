@@ -0,0 +1,203 @@
+#include "ingest.hpp"
+
+#include "hwloc.hpp"
+#include "caps-numa-benchmark.hpp"
+#include "cccbench.hpp"
+#include "mt4g.hpp"
+#include "table-reader.hpp"
+#include "xml_dump.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+using std::cerr;
+using std::endl;
+
+const char* sys_sage::DataSourceType::ToString(type t)
+{
+    switch(t)
+    {
+        case Hwloc: return "hwloc";
+        case CapsNumaBenchmark: return "caps-numa-benchmark";
+        case Cccbench: return "cccbench";
+        case Mt4g: return "mt4g";
+        default: return "None";
+    }
+}
+
+sys_sage::DataSourceType::type sys_sage::DataSourceType::FromString(const std::string& name)
+{
+    for(type t : {Hwloc, CapsNumaBenchmark, Cccbench, Mt4g})
+        if(name == ToString(t))
+            return t;
+    return None;
+}
+
+//order in which the sources of a node are parsed: the benchmarks reference the components created by hwloc
+static int _data_source_stage(sys_sage::DataSourceType::type t)
+{
+    switch(t)
+    {
+        case sys_sage::DataSourceType::Hwloc: return 0;
+        case sys_sage::DataSourceType::Mt4g: return 1;
+        case sys_sage::DataSourceType::CapsNumaBenchmark: return 2;
+        case sys_sage::DataSourceType::Cccbench: return 3;
+        default: return 4;
+    }
+}
+
+static int _parse_data_source(sys_sage::Node* n, const sys_sage::DataSource& s)
+{
+    try
+    {
+        switch(s.type)
+        {
+            case sys_sage::DataSourceType::Hwloc: return sys_sage::parseHwlocOutput(n, s.path);
+            case sys_sage::DataSourceType::Mt4g: return sys_sage::parseMt4gTopo(n, s.path, s.gpuId, s.delim);
+            case sys_sage::DataSourceType::CapsNumaBenchmark: return sys_sage::parseCapsNumaBenchmark(n, s.path, s.delim);
+            case sys_sage::DataSourceType::Cccbench: return sys_sage::parseCccbenchOutput(n, s.path);
+        }
+        cerr << "ingestDataSources: unknown type of data source " << s.path << endl;
+    }
+    catch(const std::exception& e)
+    {
+        cerr << "ingestDataSources: parsing " << s.path << " failed: " << e.what() << endl;
+    }
+    catch(...)
+    {
+        cerr << "ingestDataSources: parsing " << s.path << " failed" << endl;
+    }
+    return 1;
+}
+
+int sys_sage::ingestDataSources(Component* parent, const std::vector<DataSource>& manifest, unsigned parallelism, std::vector<DataSourceResult>* results)
+{
+    if(parent == NULL){
+        std::cerr << "ingestDataSources: parent is null" << std::endl;
+        return 1;
+    }
+    //group the entries by node, in the order of the first appearance of each node
+    std::vector<int> nodeIds;
+    std::vector<std::vector<size_t>> entries;
+    std::unordered_map<int, size_t> nodeIndex;
+    for(size_t i = 0; i < manifest.size(); i++)
+    {
+        auto [it, inserted] = nodeIndex.try_emplace(manifest[i].nodeId, nodeIds.size());
+        if(inserted)
+        {
+            nodeIds.push_back(manifest[i].nodeId);
+            entries.emplace_back();
+        }
+        entries[it->second].push_back(i);
+    }
+    for(std::vector<size_t>& e : entries)
+        std::stable_sort(e.begin(), e.end(), [&](size_t a, size_t b) { return _data_source_stage(manifest[a].type) < _data_source_stage(manifest[b].type); });
+
+    std::vector<DataSourceResult> rets(manifest.size());
+    //finished nodes are attached in order: a worker finishing node i attaches all consecutive finished nodes starting at the first one not attached yet
+    std::vector<Node*> nodes(nodeIds.size(), nullptr);
+    std::vector<char> finished(nodeIds.size(), 0);
+    size_t nextToAttach = 0;
+    std::mutex attachMutex;
+    auto finish = [&](size_t i) {
+        std::lock_guard<std::mutex> lock(attachMutex);
+        finished[i] = 1;
+        for(; nextToAttach < nodes.size() && finished[nextToAttach]; nextToAttach++)
+            if(nodes[nextToAttach] != nullptr)
+                parent->InsertChild(nodes[nextToAttach]);
+    };
+
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for(size_t i = next++; i < nodes.size(); i = next++)
+        {
+            Node* n = new Node(nodeIds[i]);
+            for(size_t e : entries[i])
+            {
+                auto start = std::chrono::steady_clock::now();
+                rets[e].parsed = true;
+                rets[e].ret = _parse_data_source(n, manifest[e]);
+                rets[e].seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if(rets[e].ret != 0)
+                {
+                    cerr << "ingestDataSources: parsing " << manifest[e].path << " failed; node " << nodeIds[i] << " is not added." << endl;
+                    n->Delete(true);
+                    n = nullptr;
+                    break;
+                }
+            }
+            nodes[i] = n;
+            finish(i);
+        }
+    };
+
+    //hwloc sources are parsed with libxml2, which has to be initialized before it is used from several threads
+    _init_libxml();
+    if(parallelism == 0)
+        parallelism = std::max(1u, std::thread::hardware_concurrency());
+    size_t numThreads = std::min<size_t>(parallelism, nodes.size());
+    std::vector<std::thread> threads;
+    if(numThreads > 1)
+        threads.reserve(numThreads - 1);
+    for(size_t t = 1; t < numThreads; t++)
+        threads.emplace_back(worker);
+    worker();
+    for(std::thread& t : threads)
+        t.join();
+
+    int ret = 0;
+    for(const DataSourceResult& r : rets)
+        if(r.parsed && r.ret != 0)
+        {
+            ret = r.ret;
+            break;
+        }
+    if(results != nullptr)
+        *results = std::move(rets);
+    return ret;
+}
+
+int sys_sage::readDataSourceManifest(std::string manifestPath, std::vector<DataSource>* manifest)
+{
+    TableReader reader(";");
+    if(reader.Open(manifestPath) != 0)
+    {
+        cerr << "readDataSourceManifest: could not open manifest " << manifestPath << endl;
+        return 1;
+    }
+    size_t slash = manifestPath.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "" : manifestPath.substr(0, slash + 1);
+
+    std::vector<std::string_view> row;
+    while(reader.NextRow(&row))
+    {
+        if(row[0].starts_with('#'))
+            continue;
+        DataSource s;
+        if(row.size() >= 3)
+            s.type = DataSourceType::FromString(std::string(row[1]));
+        if(row.size() < 3 || row.size() > 4 || !TableReader::ParseNumber(row[0], &s.nodeId) || s.type == DataSourceType::None || row[2].empty()
+            || (row.size() == 4 && !TableReader::ParseNumber(row[3], &s.gpuId)))
+        {
+            cerr << "readDataSourceManifest: " << manifestPath << " line " << reader.GetLineNumber() << " is malformed (expected nodeId;type;path[;gpuId])" << endl;
+            return 1;
+        }
+        s.path = row[2].front() == '/' ? std::string(row[2]) : dir + std::string(row[2]);
+        manifest->push_back(std::move(s));
+    }
+    return 0;
+}
+
+int sys_sage::ingestDataSources(Component* parent, std::string manifestPath, unsigned parallelism, std::vector<DataSourceResult>* results)
+{
+    std::vector<DataSource> manifest;
+    if(readDataSourceManifest(manifestPath, &manifest) != 0)
+        return 1;
+    return ingestDataSources(parent, manifest, parallelism, results);
+}
@@ -0,0 +1,87 @@
+#ifndef INGEST_PARSER
+#define INGEST_PARSER
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Component.hpp"
+
+/*! \file */
+
+namespace sys_sage {
+    /**
+     * @brief Data sources understood by ingestDataSources().
+     */
+    namespace DataSourceType {
+        using type = int32_t;
+        constexpr type None = 0; /**< Unknown source. */
+        constexpr type Hwloc = 1; /**< hwloc XML output, parsed with parseHwlocOutput(). */
+        constexpr type CapsNumaBenchmark = 2; /**< caps-numa-benchmark CSV, parsed with parseCapsNumaBenchmark(). */
+        constexpr type Cccbench = 3; /**< cccbench output, parsed with parseCccbenchOutput(). */
+        constexpr type Mt4g = 4; /**< mt4g CSV of one GPU, parsed with parseMt4gTopo(). */
+
+        /**
+         * @brief Returns the name of the source type as used in manifest files ("hwloc", "caps-numa-benchmark", "cccbench", "mt4g"; "None" otherwise).
+         */
+        const char* ToString(type t);
+        /**
+         * @brief Returns the source type of a name returned by ToString(), or None.
+         */
+        type FromString(const std::string& name);
+    }
+
+    /**
+     * @brief One entry of the manifest of ingestDataSources(): a data source file of one node.
+     */
+    struct DataSource {
+        int nodeId = 0; /**< Id of the Node the source describes. Entries with the same nodeId are parsed into the same Node. */
+        DataSourceType::type type = DataSourceType::None;
+        std::string path; /**< Path to the output of the tool. */
+        std::string delim = ";"; /**< Delimiter of the CSV (CapsNumaBenchmark, Mt4g). */
+        int gpuId = 0; /**< Id of the new GPU (Chip) component (Mt4g). */
+    };
+
+    /**
+     * @brief Outcome of one manifest entry of ingestDataSources().
+     */
+    struct DataSourceResult {
+        bool parsed = false; /**< False if the entry was skipped because an earlier source of its node failed. */
+        int ret = 0; /**< Return code of the parser (0 = success). */
+        double seconds = 0; /**< Wall-clock time spent in the parser. */
+    };
+
+    /**
+     * Parses the data sources of many nodes (e.g. a whole cluster) concurrently.
+     * \n Each node is parsed by one worker into a new, detached Node, so the workers do not share any component. The sources of a node are parsed in the order
+     * hwloc, mt4g, caps-numa-benchmark and cccbench (the benchmarks reference the components created by hwloc), and in manifest order within each type.
+     * A finished Node is attached to parent under a short lock, as soon as all nodes before it are finished, so the children of parent are always in the order in which
+     * the nodes first appear in the manifest (independent of parallelism).
+     * @param parent - parent Component (e.g. Topology); one new Node per distinct nodeId is created as its child.
+     * @param manifest - the data sources to parse.
+     * @param parallelism (default 0) - number of threads parsing the nodes (0 = std::thread::hardware_concurrency(); 1 = sequential).
+     * @param results (default nullptr) - if not null, output: one DataSourceResult per manifest entry, in manifest order.
+     * @return 0 on success; otherwise the return code of the first source (in manifest order) that failed. The nodes with a failed source are not added to parent.
+     * A parser throwing an exception counts as a failure (return code 1) of its source.
+    */
+    int ingestDataSources(Component* parent, const std::vector<DataSource>& manifest, unsigned parallelism = 0, std::vector<DataSourceResult>* results = nullptr);
+    /**
+     * Reads a manifest file and parses its data sources with ingestDataSources(Component*, const std::vector<DataSource>&, unsigned, std::vector<DataSourceResult>*).
+     * \n Each line of the file describes one source: "nodeId;type;path", optionally followed by ";gpuId" for mt4g sources. The type is a name as returned
+     * by DataSourceType::ToString(). Relative paths are relative to the directory of the manifest. Empty lines and lines starting with '#' are ignored.
+     * @param parent - parent Component (e.g. Topology) of the new Nodes.
+     * @param manifestPath - path to the manifest file.
+     * @param parallelism (default 0) - number of threads parsing the nodes (0 = std::thread::hardware_concurrency(); 1 = sequential).
+     * @param results (default nullptr) - if not null, output: one DataSourceResult per manifest line.
+     * @return 0 on success; 1 if the manifest cannot be read (nothing is parsed); otherwise as ingestDataSources().
+    */
+    int ingestDataSources(Component* parent, std::string manifestPath, unsigned parallelism = 0, std::vector<DataSourceResult>* results = nullptr);
+    /**
+     * Reads a manifest file (see ingestDataSources(Component*, std::string, unsigned, std::vector<DataSourceResult>*)).
+     * @param manifestPath - path to the manifest file.
+     * @param manifest - output: the entries are appended.
+     * @return 0 on success; 1 if the file cannot be opened or a line is malformed.
+    */
+    int readDataSourceManifest(std::string manifestPath, std::vector<DataSource>* manifest);
+} //namespace sys_sage
+#endif
@@ -78,11 +78,11 @@ int sys_sage::IQMParser::CreateQcTopo()
     }
 
     //create attrib keys "T1_max", "T2_max", "q1_fidelity_max", "readout_fidelity_max", "two_q_fidelity_max"
-    backend->attrib["T1_max"] = static_cast<void*>(new double());
-    backend->attrib["T2_max"] = static_cast<void*>(new double());
-    backend->attrib["q1_fidelity_max"] = static_cast<void*>(new double());
-    backend->attrib["readout_fidelity_max"] = static_cast<void*>(new double());
-    backend->attrib["two_q_fidelity_max"] = static_cast<void*>(new double());
+    backend->SetAttribute(AttributeKey::T1_max, 0.0);
+    backend->SetAttribute(AttributeKey::T2_max, 0.0);
+    backend->SetAttribute(AttributeKey::q1_fidelity_max, 0.0);
+    backend->SetAttribute(AttributeKey::readout_fidelity_max, 0.0);
+    backend->SetAttribute(AttributeKey::two_q_fidelity_max, 0.0);
 
     return 0;
 }
@@ -97,7 +97,7 @@ int sys_sage::IQMParser::ParseDynamicData(int tsForHistory)
         T1.push_back(std::stod(element.get<std::string>()));
     }
     max = *(std::max_element(T1.begin(), T1.end()));
-    *static_cast<double*>(backend->attrib["T1_max"]) = max;
+    *backend->GetAttribute<double>(AttributeKey::T1_max) = max;
 
     std::vector<double> T2;
     for (const auto& element : jsonData["T2"]) 
@@ -105,7 +105,7 @@ int sys_sage::IQMParser::ParseDynamicData(int tsForHistory)
         T2.push_back(std::stod(element.get<std::string>()));
     }
     max = *(std::max_element(T2.begin(), T2.end()));
-    *static_cast<double*>(backend->attrib["T2_max"]) = max;
+    *backend->GetAttribute<double>(AttributeKey::T2_max) = max;
 
     std::vector<double> q1_fidelity;
     for (const auto& element : jsonData["1q_fidelity"]) 
@@ -113,7 +113,7 @@ int sys_sage::IQMParser::ParseDynamicData(int tsForHistory)
         q1_fidelity.push_back(std::stod(element.get<std::string>()));
     }
     max = *(std::max_element(q1_fidelity.begin(), q1_fidelity.end()));
-    *static_cast<double*>(backend->attrib["q1_fidelity_max"]) = max;
+    *backend->GetAttribute<double>(AttributeKey::q1_fidelity_max) = max;
 
     std::vector<double> readout_fidelity;
     for (const auto& element : jsonData["readout_fidelity"]) 
@@ -121,7 +121,7 @@ int sys_sage::IQMParser::ParseDynamicData(int tsForHistory)
         readout_fidelity.push_back(std::stod(element.get<std::string>()));
     }
     max = *(std::max_element(readout_fidelity.begin(), readout_fidelity.end()));
-    *static_cast<double*>(backend->attrib["readout_fidelity_max"]) = max;
+    *backend->GetAttribute<double>(AttributeKey::readout_fidelity_max) = max;
 
     auto parse_pair = [](const std::string& pair_str) -> std::pair<int, int>
     {
@@ -139,9 +139,10 @@ int sys_sage::IQMParser::ParseDynamicData(int tsForHistory)
         if(tsForHistory > 0)
         {
             //check if readout_history exists; if not, create it -- vector of tuples <timestamp,t1,t2,readout_fidelity,q1_fidelity>
-            if(! q->attrib.contains("readout_history"))
-                q->attrib["readout_history"] = reinterpret_cast<void*>(new std::vector<std::tuple<int,double,double,double,double>>());
-            auto rh = reinterpret_cast<std::vector<std::tuple<int,double,double,double,double>>*>(q->attrib["readout_history"]);
+            using QubitReadoutHistory = std::vector<std::tuple<int,double,double,double,double>>;
+            QubitReadoutHistory* rh = q->GetAttribute<QubitReadoutHistory>("readout_history");
+            if(rh == nullptr)
+                rh = &q->SetAttribute("readout_history", QubitReadoutHistory());
             rh->emplace_back(tsForHistory, T1[i], T2[i], readout_fidelity[i], q1_fidelity[i]);
         }
     }
@@ -168,9 +169,10 @@ int sys_sage::IQMParser::ParseDynamicData(int tsForHistory)
                 if(tsForHistory > 0)
                 {
                     //check if readout_history exists; if not, create it -- vector of tuples <timestamp,fidelity>
-                    if(! cm->attrib.contains("readout_history"))
-                        cm->attrib["readout_history"] = reinterpret_cast<void*>(new std::vector<std::tuple<int,double>>());
-                    auto rh = reinterpret_cast<std::vector<std::tuple<int,double>>*>(cm->attrib["readout_history"]);
+                    using CouplingReadoutHistory = std::vector<std::tuple<int,double>>;
+                    CouplingReadoutHistory* rh = cm->GetAttribute<CouplingReadoutHistory>("readout_history");
+                    if(rh == nullptr)
+                        rh = &cm->SetAttribute("readout_history", CouplingReadoutHistory());
                     rh->emplace_back(tsForHistory, fidelity);
                 }
 
@@ -181,7 +183,7 @@ int sys_sage::IQMParser::ParseDynamicData(int tsForHistory)
             return 1;        
     }
     
-    *static_cast<double*>(backend->attrib["two_q_fidelity_max"]) = max;
+    *backend->GetAttribute<double>(AttributeKey::two_q_fidelity_max) = max;
 
     return 0;
 }
@@ -2,19 +2,19 @@
 #include "mt4g.hpp"
 
 #include <iostream>
-#include <fstream>
 #include <vector>
-#include <map>
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
 #include <tuple>
 #include <string>
-#include <algorithm>
 
 using std::cout;
 using std::cerr;
 using std::endl;
 
-int sys_sage::parseMt4gTopo(Node* parent, std::string dataSourcePath, int gpuId, std::string delim)
+int sys_sage::parseMt4gTopo(Node* parent, std::string dataSourcePath, int gpuId, std::string delim, bool collapseCores)
 {
     if(parent == NULL){
         std::cerr << "parseMt4gTopo: parent is null" << std::endl;
@@ -22,10 +22,10 @@ int sys_sage::parseMt4gTopo(Node* parent, std::string dataSourcePath, int gpuId,
     }
     Chip * gpu = new Chip(parent, gpuId, "GPU", sys_sage::ChipType::Gpu);
 
-    return parseMt4gTopo(gpu, dataSourcePath, delim);
+    return parseMt4gTopo(gpu, dataSourcePath, delim, collapseCores);
 }
 
-int sys_sage::parseMt4gTopo(Component* parent, std::string dataSourcePath, int gpuId, std::string delim)
+int sys_sage::parseMt4gTopo(Component* parent, std::string dataSourcePath, int gpuId, std::string delim, bool collapseCores)
 {
     if(parent == NULL){
         std::cerr << "parseMt4gTopo: parent is null" << std::endl;
@@ -33,165 +33,179 @@ int sys_sage::parseMt4gTopo(Component* parent, std::string dataSourcePath, int g
     }
     Chip * gpu = new Chip(parent, gpuId, "GPU", sys_sage::ChipType::Gpu);
 
-    return parseMt4gTopo(gpu, dataSourcePath, delim);
+    return parseMt4gTopo(gpu, dataSourcePath, delim, collapseCores);
 }
 
-int sys_sage::parseMt4gTopo(Chip* gpu, std::string dataSourcePath, std::string delim)
+int sys_sage::parseMt4gTopo(Chip* gpu, std::string dataSourcePath, std::string delim, bool collapseCores)
 {
-    Mt4gParser gpuT(gpu, dataSourcePath, delim);
+    if(gpu != NULL)
+        gpu->_MaterializeIfShared();
+    //the collapsed cores (collapseCores) describe all cores of an SM, so their DataPaths apply to all of them
+    SharedWriteScope scope;
+    Mt4gParser gpuT(gpu, dataSourcePath, delim, collapseCores);
     int ret = gpuT.ParseBenchmarkData();
     return ret;
 
 }
 
-sys_sage::Mt4gParser::Mt4gParser(Chip* gpu, std::string dataSourcePath, std::string delim) : dataSourcePath(dataSourcePath), delim(delim), root(gpu), latency_in_cycles(true), Memory_Clock_Frequency(-1), Memory_Bus_Width(-1) { }
-
-int sys_sage::Mt4gParser::ReadBenchmarkFile()
+int sys_sage::parseMt4gTopo(Component* parent, const std::vector<std::string>& dataSourcePaths, int firstGpuId, std::string delim, unsigned parallelism, bool collapseCores)
 {
-    std::ifstream file(dataSourcePath);
-    if (!file.good()){
-        std::cerr << "parseMt4gTopo: could not open data source output file " << dataSourcePath << std::endl;
+    if(parent == NULL){
+        std::cerr << "parseMt4gTopo: parent is null" << std::endl;
         return 1;
     }
-
-    std::string line = "";
-    while (getline(file, line))
+    //each GPU is parsed into a detached Chip, so that the workers do not share any component; the Chips are attached in the order of the files afterwards
+    std::vector<Chip*> gpus;
+    for(size_t i = 0; i < dataSourcePaths.size(); i++)
+        gpus.push_back(new Chip(firstGpuId + (int)i, "GPU", sys_sage::ChipType::Gpu));
+    std::vector<int> rets(gpus.size(), 0);
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::atomic<bool> failed{false};
+    auto worker = [&]() {
+        try
+        {
+            for(size_t i = next++; i < gpus.size() && !failed; i = next++)
+                rets[i] = parseMt4gTopo(gpus[i], dataSourcePaths[i], delim, collapseCores);
+        }
+        catch(...)
+        {
+            if(!failed.exchange(true))
+                error = std::current_exception();
+        }
+    };
+
+    if(parallelism == 0)
+        parallelism = std::max(1u, std::thread::hardware_concurrency());
+    size_t numThreads = std::min<size_t>(parallelism, gpus.size());
+    std::vector<std::thread> threads;
+    if(numThreads > 1)
+        threads.reserve(numThreads - 1);
+    for(size_t t = 1; t < numThreads; t++)
+        threads.emplace_back(worker);
+    worker();
+    for(std::thread& t : threads)
+        t.join();
+
+    int ret = 0;
+    for(size_t i = 0; i < gpus.size(); i++)
     {
-        std::vector<std::string> vec;
-        size_t pos = 0;
-        bool cont = true;
-        std::string s;
-        while (cont) {
-            cont = ((pos = line.find(delim)) != std::string::npos);
-            if(cont)
-                s = line.substr(0, pos); // trim whitespaces
-            else
-                s = line.substr(0, line.length());
-            trim(s);
-            s.erase(std::remove(s.begin(), s.end(), '\"'), s.end());    //remove "" where present
-            //std::cout << "adding " << s << std::endl;
-            vec.push_back(s);
-            line.erase(0, pos + delim.length());
+        if(error == nullptr && rets[i] == 0)
+        {
+            parent->InsertChild(gpus[i]);
+            continue;
         }
-        if(!vec.empty()) {
-            benchmarkData.insert({vec[0], vec});
+        if(ret == 0 && rets[i] != 0)
+        {
+            std::cerr << "parseMt4gTopo: parsing " << dataSourcePaths[i] << " failed; GPU " << gpus[i]->GetId() << " is not added." << std::endl;
+            ret = rets[i];
         }
+        gpus[i]->Delete(true);
     }
-    return 0;
+    if(error)
+        std::rethrow_exception(error);
+    return ret;
 }
 
-int sys_sage::Mt4gParser::ParseBenchmarkData()
+sys_sage::Mt4gParser::Mt4gParser(Chip* gpu, std::string dataSourcePath, std::string delim, bool collapseCores) : reader(delim), dataSourcePath(dataSourcePath), delim(delim), root(gpu), latency_in_cycles(true), L2_shared_on_gpu(true), Memory_Clock_Frequency(-1), Memory_Bus_Width(-1), Number_of_cores_per_SM(-1), collapseCores(collapseCores) { }
+
+//parses the value following key; prints an error if it is not a number of type T
+template <class T>
+static bool _parse_mt4g_value(std::string_view value, T* out, const char* func, std::string_view key)
 {
-    int ret = ReadBenchmarkFile();
-    if(ret != 0)
-        return ret;
+    if(sys_sage::TableReader::ParseNumber(value, out))
+        return true;
+    cerr << func << ": \"" << key << "\" is supposed to be followed by a number, found \"" << value << "\"." << endl;
+    return false;
+}
 
-    if(benchmarkData.find("GPU_INFORMATION") == benchmarkData.end()){
-        cerr << "parseMt4gTopo: Could not find GPU_INFORMATION in file " << dataSourcePath << endl;
-        return 1;
-    } else {
-        if((ret=parseGPU_INFORMATION()) != 0){
-            cerr << "parseMt4gTopo: parseGPU_INFORMATION failed when parsing " << dataSourcePath << endl;
-            return ret;
-        }
-    }
+//multiplier of a size (KiB, MiB, GiB) or frequency (KHz, MHz, GHz) unit; 1 for any other unit
+static double _mt4g_unit_multiplier(std::string_view unit)
+{
+    if(unit == "KiB")
+        return 1024;
+    if(unit == "MiB")
+        return 1024*1024;
+    if(unit == "GiB")
+        return 1024*1024*1024;
+    if(unit == "KHz")
+        return 1000;
+    if(unit == "MHz")
+        return 1000*1000;
+    if(unit == "GHz")
+        return 1000*1000*1000;
+    return 1;
+}
 
-    if(benchmarkData.find("COMPUTE_RESOURCE_INFORMATION") == benchmarkData.end()){
-        cerr << "parseMt4gTopo: Could not find COMPUTE_RESOURCE_INFORMATION in file " << dataSourcePath << endl;
+int sys_sage::Mt4gParser::ReadBenchmarkFile()
+{
+    if (reader.Open(dataSourcePath) != 0){
+        std::cerr << "parseMt4gTopo: could not open data source output file " << dataSourcePath << std::endl;
         return 1;
-    } else {
-        if((ret=parseCOMPUTE_RESOURCE_INFORMATION()) != 0){
-            cerr << "parseMt4gTopo: parseCOMPUTE_RESOURCE_INFORMATION failed when parsing " << dataSourcePath << endl;
-            return ret;
-        }
-    }
-
-    if(benchmarkData.find("REGISTER_INFORMATION") == benchmarkData.end()){
-        cerr << "WARNING: parseMt4gTopo: Could not find REGISTER_INFORMATION in file " << dataSourcePath <<". Will skip."<< endl;
-    } else {
-        if((ret=parseREGISTER_INFORMATION()) != 0){
-            cerr << "parseMt4gTopo: parseREGISTER_INFORMATION failed when parsing " << dataSourcePath << endl;
-            return ret;
-        }
-    }
-
-    if(benchmarkData.find("ADDITIONAL_INFORMATION") == benchmarkData.end()){
-        cerr << "WARNING: parseMt4gTopo: Could not find ADDITIONAL_INFORMATION in file " << dataSourcePath <<". Will skip."<< endl;
-    } else {
-        if((ret=parseADDITIONAL_INFORMATION()) != 0){
-            cerr << "parseMt4gTopo: parseADDITIONAL_INFORMATION failed when parsing " << dataSourcePath << endl;
-            return ret;
-        }
-    }
-
-    if(benchmarkData.find("MAIN_MEMORY") == benchmarkData.end()){
-        cerr << "WARNING: parseMt4gTopo: Could not find MAIN_MEMORY in file " << dataSourcePath <<". Will skip."<< endl;
-    } else {
-        if((ret=parseMemory("MAIN_MEMORY", "GPU Global memory")) != 0){
-            cerr << "parseMt4gTopo: parseMAIN_MEMORY failed when parsing " << dataSourcePath << endl;
-            return ret;
-        }
-    }
-
-    if(benchmarkData.find("L2_DATA_CACHE") == benchmarkData.end()){
-        cerr << "WARNING: parseMt4gTopo: Could not find L2_DATA_CACHE in file " << dataSourcePath <<". Will skip."<< endl;
-    } else {
-        if((ret=parseCaches("L2_DATA_CACHE", "L2")) != 0){
-            cerr << "parseMt4gTopo: parseCaches on L2_DATA_CACHE failed when parsing " << dataSourcePath << endl;
-            return ret;
-        }
-    }
-
-    if(benchmarkData.find("L1_DATA_CACHE") == benchmarkData.end()){
-        cerr << "WARNING: parseMt4gTopo: Could not find L1_DATA_CACHE in file " << dataSourcePath <<". Will skip."<< endl;
-    } else {
-        if((ret=parseCaches("L1_DATA_CACHE", "L1")) != 0){
-            cerr << "parseMt4gTopo: parseCaches failed on L1_DATA_CACHE when parsing " << dataSourcePath << endl;
-            return ret;
-        }
     }
 
-    if(benchmarkData.find("SHARED_MEMORY") == benchmarkData.end()){
-        cerr << "WARNING: parseMt4gTopo: Could not find SHARED_MEMORY in file " << dataSourcePath <<". Will skip."<< endl;
-    } else {
-        if((ret=parseMemory("SHARED_MEMORY", "Shared memory")) != 0){
-            cerr << "parseMt4gTopo: parseCaches failed on SHARED_MEMORY when parsing " << dataSourcePath << endl;
-            return ret;
-        }
-    }
-
-    if(benchmarkData.find("TEXTURE_CACHE") == benchmarkData.end()){
-        cerr << "WARNING: parseMt4gTopo: Could not find TEXTURE_CACHE in file " << dataSourcePath <<". Will skip."<< endl;
-    } else {
-        if((ret=parseCaches("TEXTURE_CACHE", "Texture")) != 0){
-            cerr << "parseMt4gTopo: parseCaches failed on TEXTURE_CACHE when parsing " << dataSourcePath << endl;
-            return ret;
-        }
+    //fields are trimmed and unquoted (e.g. "B"Load_Latency -> BLoad_Latency) by the reader; they stay views into the mapped file unless the reader had to copy them
+    std::string_view text = reader.GetText();
+    auto keep = [&](std::string_view f) -> std::string_view {
+        if(f.empty() || (f.data() >= text.data() && f.data() + f.size() <= text.data() + text.size()))
+            return f;
+        return ownedFields.emplace_back(f);
+    };
+    std::vector<std::string_view> row;
+    while (reader.NextRow(&row))
+    {
+        std::string_view name = keep(row[0]);
+        if(sections.find(name) != sections.end())
+            continue;
+        size_t begin = fields.size();
+        for(size_t i = 1; i < row.size(); i++)
+            fields.push_back(keep(row[i]));
+        sections.emplace(name, std::make_pair(begin, fields.size()));
     }
+    return 0;
+}
 
-    if(benchmarkData.find("READ-ONLY_CACHE") == benchmarkData.end()){
-        cerr << "WARNING: parseMt4gTopo: Could not find READ-ONLY_CACHE in file " << dataSourcePath <<". Will skip."<< endl;
-    } else {
-        if((ret=parseCaches("READ-ONLY_CACHE", "ReadOnly")) != 0){
-            cerr << "parseMt4gTopo: parseCaches failed on READ-ONLY_CACHE when parsing " << dataSourcePath << endl;
-            return ret;
-        }
-    }
+int sys_sage::Mt4gParser::ParseBenchmarkData()
+{
+    int ret = ReadBenchmarkFile();
+    if(ret != 0)
+        return ret;
 
-    if(benchmarkData.find("CONST_L1_5_CACHE") == benchmarkData.end()){
-        cerr << "WARNING: parseMt4gTopo: Could not find CONST_L1_5_CACHE in file " << dataSourcePath <<". Will skip."<< endl;
-    } else {
-        if((ret=parseCaches("CONST_L1_5_CACHE", "Constant_L1.5")) != 0){
-            cerr << "parseMt4gTopo: parseCaches failed on CONST_L1_5_CACHE when parsing " << dataSourcePath << endl;
-            return ret;
+    //sections in the order in which they are applied (independent of their order in the file): memories and caches are placed relative to the SMs, main memory, and L2
+    struct Section {
+        const char* name;
+        bool required;
+        int (*parse)(Mt4gParser* p, Fields data);
+    };
+    static const Section sectionTable[] = {
+        {"GPU_INFORMATION", true, [](Mt4gParser* p, Fields d) { return p->parseGPU_INFORMATION(d); }},
+        {"COMPUTE_RESOURCE_INFORMATION", true, [](Mt4gParser* p, Fields d) { return p->parseCOMPUTE_RESOURCE_INFORMATION(d); }},
+        {"REGISTER_INFORMATION", false, [](Mt4gParser* p, Fields d) { return p->parseREGISTER_INFORMATION(d); }},
+        {"ADDITIONAL_INFORMATION", false, [](Mt4gParser* p, Fields d) { return p->parseADDITIONAL_INFORMATION(d); }},
+        {"MAIN_MEMORY", false, [](Mt4gParser* p, Fields d) { return p->parseMemory(d, "MAIN_MEMORY", "GPU Global memory"); }},
+        {"L2_DATA_CACHE", false, [](Mt4gParser* p, Fields d) { return p->parseCaches(d, "L2_DATA_CACHE", "L2"); }},
+        {"L1_DATA_CACHE", false, [](Mt4gParser* p, Fields d) { return p->parseCaches(d, "L1_DATA_CACHE", "L1"); }},
+        {"SHARED_MEMORY", false, [](Mt4gParser* p, Fields d) { return p->parseMemory(d, "SHARED_MEMORY", "Shared memory"); }},
+        {"TEXTURE_CACHE", false, [](Mt4gParser* p, Fields d) { return p->parseCaches(d, "TEXTURE_CACHE", "Texture"); }},
+        {"READ-ONLY_CACHE", false, [](Mt4gParser* p, Fields d) { return p->parseCaches(d, "READ-ONLY_CACHE", "ReadOnly"); }},
+        {"CONST_L1_5_CACHE", false, [](Mt4gParser* p, Fields d) { return p->parseCaches(d, "CONST_L1_5_CACHE", "Constant_L1.5"); }},
+        {"CONSTANT_L1_CACHE", false, [](Mt4gParser* p, Fields d) { return p->parseCaches(d, "CONSTANT_L1_CACHE", "Constant_L1"); }},
+    };
+
+    for(const Section& section : sectionTable)
+    {
+        auto it = sections.find(section.name);
+        if(it == sections.end()){
+            if(section.required){
+                cerr << "parseMt4gTopo: Could not find " << section.name << " in file " << dataSourcePath << endl;
+                return 1;
+            }
+            cerr << "WARNING: parseMt4gTopo: Could not find " << section.name << " in file " << dataSourcePath <<". Will skip."<< endl;
+            continue;
         }
-    }
-
-    if(benchmarkData.find("CONSTANT_L1_CACHE") == benchmarkData.end()){
-        cerr << "WARNING: parseMt4gTopo: Could not find CONSTANT_L1_CACHE in file " << dataSourcePath <<". Will skip."<< endl;
-    } else {
-        if((ret=parseCaches("CONSTANT_L1_CACHE", "Constant_L1")) != 0){
-            cerr << "parseMt4gTopo: parseCaches failed on CONSTANT_L1_CACHE when parsing " << dataSourcePath << endl;
+        Fields data(fields.data() + it->second.first, it->second.second - it->second.first);
+        if((ret = section.parse(this, data)) != 0){
+            cerr << "parseMt4gTopo: parsing " << section.name << " failed when parsing " << dataSourcePath << endl;
             return ret;
         }
     }
@@ -200,11 +214,8 @@ int sys_sage::Mt4gParser::ParseBenchmarkData()
     return ret;
 }
 
-int sys_sage::Mt4gParser::parseGPU_INFORMATION()
+int sys_sage::Mt4gParser::parseGPU_INFORMATION(Fields data)
 {
-    std::vector<std::string> data = benchmarkData["GPU_INFORMATION"];
-    data.erase(data.begin());
-
     for(size_t i = 0; i<data.size(); i++)
     {
         if(data[i] == "GPU_vendor")
@@ -213,7 +224,7 @@ int sys_sage::Mt4gParser::parseGPU_INFORMATION()
                 cerr << "parseGPU_INFORMATION: \"" << data[i] << "\" is supposed to be followed by 1 additional value." << endl;
                 return 1;
             }
-            root->SetVendor(data[i+1]);
+            root->SetVendor(std::string(data[i+1]));
             i++;
         }
         else if(data[i] == "GPU_name")
@@ -222,18 +233,16 @@ int sys_sage::Mt4gParser::parseGPU_INFORMATION()
                 cerr << "parseGPU_INFORMATION: \"" << data[i] << "\" is supposed to be followed by 1 additional value." << endl;
                 return 1;
             }
-            root->SetModel(data[i+1]);
+            root->SetModel(std::string(data[i+1]));
             i++;
         }
     }
     return 0;
 }
 
-int sys_sage::Mt4gParser::parseCOMPUTE_RESOURCE_INFORMATION()
+int sys_sage::Mt4gParser::parseCOMPUTE_RESOURCE_INFORMATION(Fields data)
 {
-    std::vector<std::string> data = benchmarkData["COMPUTE_RESOURCE_INFORMATION"];
-    data.erase(data.begin());
-
+    int num_sm = -1;
     for(size_t i = 0; i<data.size(); i++)
     {
         //cout << i << " " << data[i] << std::endl;
@@ -243,8 +252,7 @@ int sys_sage::Mt4gParser::parseCOMPUTE_RESOURCE_INFORMATION()
                 cerr << "parseCOMPUTE_RESOURCE_INFORMATION: \"" << data[i] << "\" is supposed to be followed by 1 additional value." << endl;
                 return 1;
             }
-            std::string * val = new std::string(data[i+1]);
-            root->attrib.insert({data[i], (void*)val});
+            root->SetAttribute(AttributeKey::CUDA_compute_capability, std::string(data[i+1]));
             i++;
         }
         else if(data[i]== "Number_of_streaming_multiprocessors" ||
@@ -255,19 +263,36 @@ int sys_sage::Mt4gParser::parseCOMPUTE_RESOURCE_INFORMATION()
                 cerr << "parseCOMPUTE_RESOURCE_INFORMATION: \"" << data[i] << "\" is supposed to be followed by 1 additional value." << endl;
                 return 1;
             }
-            int * val = new int(std::stoi(data[i+1]));
-            root->attrib.insert({data[i], (void*)val});
+            int val;
+            if(!_parse_mt4g_value(data[i+1], &val, "parseCOMPUTE_RESOURCE_INFORMATION", data[i]))
+                return 1;
+            root->SetAttribute(AttributeKey::Find(std::string(data[i])), val);
+            if(data[i] == "Number_of_streaming_multiprocessors")
+                num_sm = val;
+            else if(data[i] == "Number_of_cores_per_SM")
+                Number_of_cores_per_SM = val;
 
             i++;
         }
     }
 
-    for(int i = 0; i < (*(int*)root->attrib["Number_of_streaming_multiprocessors"]); i++)
+    if(num_sm < 0 || Number_of_cores_per_SM < 0){
+        cerr << "parseCOMPUTE_RESOURCE_INFORMATION: \"Number_of_streaming_multiprocessors\" or \"Number_of_cores_per_SM\" missing." << endl;
+        return 1;
+    }
+    for(int i = 0; i < num_sm; i++)
     {
         //cout << "adding SM " << i << std::endl;
         Subdivision * sm = new Subdivision(root, i, "SM (Streaming Multiprocessor)");
         sm->SetSubdivisionType(sys_sage::SubdivisionType::GpuSM);
-        for(int j = 0; j<(*(int*)root->attrib["Number_of_cores_per_SM"]); j++)
+        if(collapseCores)
+        {
+            //one Thread stands for all cores; parseCaches splits it where the cores get different caches
+            Thread* cores = new Thread(sm, 0, "GPU Core");
+            cores->SetCount(Number_of_cores_per_SM);
+            continue;
+        }
+        for(int j = 0; j < Number_of_cores_per_SM; j++)
         {
             new Thread(sm, j, "GPU Core");
         }
@@ -275,16 +300,13 @@ int sys_sage::Mt4gParser::parseCOMPUTE_RESOURCE_INFORMATION()
     return 0;
 }
 
-int sys_sage::Mt4gParser::parseREGISTER_INFORMATION()
+int sys_sage::Mt4gParser::parseREGISTER_INFORMATION(Fields)
 {
     //TODO
     return 0;
 }
-int sys_sage::Mt4gParser::parseADDITIONAL_INFORMATION()
+int sys_sage::Mt4gParser::parseADDITIONAL_INFORMATION(Fields data)
 {
-    std::vector<std::string> data = benchmarkData["ADDITIONAL_INFORMATION"];
-    data.erase(data.begin());
-
     for(size_t i = 0; i<data.size(); i++)
     {
         if(data[i]== "Memory_Clock_Frequency")
@@ -293,14 +315,9 @@ int sys_sage::Mt4gParser::parseADDITIONAL_INFORMATION()
                 cerr << "parseADDITIONAL_INFORMATION: \"" << data[i] << "\" is supposed to be followed by 2 additional values." << endl;
                 return 1;
             }
-            Memory_Clock_Frequency = stod(data[i+1]);
-            std::string unit = data[i+2];
-            if(unit == "KHz")
-                Memory_Clock_Frequency *= 1000;
-            else if(unit == "MHz")
-                Memory_Clock_Frequency *= 1000*1000;
-            else if(unit == "GHz")
-                Memory_Clock_Frequency *= 1000*1000*1000;
+            if(!_parse_mt4g_value(data[i+1], &Memory_Clock_Frequency, "parseADDITIONAL_INFORMATION", data[i]))
+                return 1;
+            Memory_Clock_Frequency *= _mt4g_unit_multiplier(data[i+2]);
             i+=2;
         }
         else if(data[i]== "Memory_Bus_Width")
@@ -309,7 +326,8 @@ int sys_sage::Mt4gParser::parseADDITIONAL_INFORMATION()
                 cerr << "parseADDITIONAL_INFORMATION: \"" << data[i] << "\" is supposed to be followed by 2 additional values." << endl;
                 return 1;
             }
-            Memory_Bus_Width = std::stoi(data[i + 1]);
+            if(!_parse_mt4g_value(data[i+1], &Memory_Bus_Width, "parseADDITIONAL_INFORMATION", data[i]))
+                return 1;
             i+=2;
         }
         else if(data[i]== "GPU_Clock_Rate")
@@ -318,25 +336,18 @@ int sys_sage::Mt4gParser::parseADDITIONAL_INFORMATION()
                 cerr << "parseADDITIONAL_INFORMATION: \"" << data[i] << "\" is supposed to be followed by 2 additional values." << endl;
                 return 1;
             }
-            double * val = new double(std::stod(data[i+1]));
-            std::string unit = data[i+2];
-            if(unit == "KHz")
-                *val *= 1000;
-            else if(unit == "MHz")
-                *val *= 1000*1000;
-            else if(unit == "GHz")
-                *val *= 1000*1000*1000;
-            root->attrib.insert({data[i], (void*)val});
+            double val;
+            if(!_parse_mt4g_value(data[i+1], &val, "parseADDITIONAL_INFORMATION", data[i]))
+                return 1;
+            val *= _mt4g_unit_multiplier(data[i+2]);
+            root->SetAttribute(AttributeKey::GPU_Clock_Rate, val);
             i+=2;
         }
     }
     return 0;
 }
-int sys_sage::Mt4gParser::parseMemory(std::string header_name, std::string memory_name)
+int sys_sage::Mt4gParser::parseMemory(Fields data, std::string_view header_name, std::string memory_name)
 {
-    std::vector<std::string> data = benchmarkData[header_name];
-    data.erase(data.begin());
-
     int shared_on = -1; //0=GPU, 1=SM
     double size = -1;
     double latency = -1;
@@ -350,14 +361,9 @@ int sys_sage::Mt4gParser::parseMemory(std::string header_name, std::string memor
                 cerr << "parseMemory: \"" << data[i] << "\" is supposed to be followed by 3 additional values." << endl;
                 return 1;
             }
-            size = stod(data[i+1]);
-            std::string unit = data[i+2];
-            if(unit == "KiB")
-                size *= 1024;
-            else if(unit == "MiB")
-                size *= 1024*1024;
-            else if(unit == "GiB")
-                size *= 1024*1024*1024;
+            if(!_parse_mt4g_value(data[i+1], &size, __func__, data[i]))
+                return 1;
+            size *= _mt4g_unit_multiplier(data[i+2]);
             i+=3;
         }
         else if(data[i]== "Load_Latency")
@@ -368,7 +374,8 @@ int sys_sage::Mt4gParser::parseMemory(std::string header_name, std::string memor
             }
             if((data[i+2] == "cycles" && latency_in_cycles) || (data[i+2] == "nanoseconds" && !latency_in_cycles))
             {
-                latency = stod(data[i+1]);
+                if(!_parse_mt4g_value(data[i+1], &latency, __func__, data[i]))
+                    return 1;
             }
             i+=2;
         }
@@ -399,12 +406,10 @@ int sys_sage::Mt4gParser::parseMemory(std::string header_name, std::string memor
 
         Memory * mem = new Memory(root, 0, memory_name, (long long)size);
         if(Memory_Clock_Frequency > -1){
-            double * mfreq = new double(Memory_Clock_Frequency);
-            mem->attrib.insert({"Clock_Frequency", (void*)mfreq});
+            mem->SetAttribute(AttributeKey::Clock_Frequency, Memory_Clock_Frequency);
         }
         if(Memory_Bus_Width > -1){
-            int * busW = new int(Memory_Bus_Width);
-            mem->attrib.insert({"Bus_Width", (void*)busW});
+            mem->SetAttribute(AttributeKey::Bus_Width_bit, Memory_Bus_Width);
         }
           
         //make SMs as main memory's children and insert DP with latency
@@ -469,11 +474,8 @@ int sys_sage::Mt4gParser::parseMemory(std::string header_name, std::string memor
     return 0;
 }
 
-int sys_sage::Mt4gParser::parseCaches(std::string header_name, std::string cache_type)
+int sys_sage::Mt4gParser::parseCaches(Fields data, std::string_view header_name, std::string cache_type)
 {
-    std::vector<std::string> data = benchmarkData[header_name];
-    data.erase(data.begin());
-
     //parse_args
     int shared_on = -1; //0=GPU, 1=SM
     int caches_per_sm = 1;
@@ -490,14 +492,9 @@ int sys_sage::Mt4gParser::parseCaches(std::string header_name, std::string cache
                 cerr << "parseCaches: \"" << data[i] << "\" is supposed to be followed by 1 additional value." << endl;
                 return 1;
             }
-            size = stod(data[i+1]);
-            std::string unit = data[i+2];
-            if(unit == "KiB")
-                size *= 1024;
-            else if(unit == "MiB")
-                size *= 1024*1024;
-            else if(unit == "GiB")
-                size *= 1024*1024*1024;
+            if(!_parse_mt4g_value(data[i+1], &size, __func__, data[i]))
+                return 1;
+            size *= _mt4g_unit_multiplier(data[i+2]);
             i+=3;
         }
         else if(data[i]== "Cache_Line_Size")
@@ -506,14 +503,9 @@ int sys_sage::Mt4gParser::parseCaches(std::string header_name, std::string cache
                 cerr << "parseCaches: \"" << data[i] << "\" is supposed to be followed by 1 additional value." << endl;
                 return 1;
             }
-            cache_line_size = stoi(data[i+1]);
-            std::string unit = data[i+2];
-            if(unit == "KiB")
-                size *= 1024;
-            else if(unit == "MiB")
-                size *= 1024*1024;
-            else if(unit == "GiB")
-                size *= 1024*1024*1024;
+            if(!_parse_mt4g_value(data[i+1], &cache_line_size, __func__, data[i]))
+                return 1;
+            cache_line_size = (int)(cache_line_size * _mt4g_unit_multiplier(data[i+2]));
             i+=2;
         }
         else if(data[i]== "Load_Latency")
@@ -524,7 +516,8 @@ int sys_sage::Mt4gParser::parseCaches(std::string header_name, std::string cache
             }
             if((data[i+2] == "cycles" && latency_in_cycles) || (data[i+2] == "nanoseconds" && !latency_in_cycles))
             {
-                latency = stod(data[i+1]);
+                if(!_parse_mt4g_value(data[i+1], &latency, __func__, data[i]))
+                    return 1;
             }
             i+=2;
         }
@@ -551,7 +544,8 @@ int sys_sage::Mt4gParser::parseCaches(std::string header_name, std::string cache
                 cerr << "parseCaches: \"" << data[i] << "\" is supposed to be followed by 1 additional value." << endl;
                 return 1;
             }
-            caches_per_sm = stoi(data[i+1]);
+            if(!_parse_mt4g_value(data[i+1], &caches_per_sm, __func__, data[i]))
+                return 1;
         }
         else if(data[i]== "Share_Cache_With_L1_Data")
         {
@@ -559,7 +553,8 @@ int sys_sage::Mt4gParser::parseCaches(std::string header_name, std::string cache
                 cerr << "parseCaches: \"" << data[i] << "\" is supposed to be followed by 1 additional value." << endl;
                 return 1;
             }
-            share_l1 = stoi(data[i+1]);
+            if(!_parse_mt4g_value(data[i+1], &share_l1, __func__, data[i]))
+                return 1;
         }
         else if(data[i]== "Share_Cache_With_Texture")
         {
@@ -567,7 +562,8 @@ int sys_sage::Mt4gParser::parseCaches(std::string header_name, std::string cache
                 cerr << "parseCaches: \"" << data[i] << "\" is supposed to be followed by 1 additional value." << endl;
                 return 1;
             }
-            share_texture = stoi(data[i+1]);
+            if(!_parse_mt4g_value(data[i+1], &share_texture, __func__, data[i]))
+                return 1;
         }
         else if(data[i]== "Share_Cache_With_Read-Only")
         {
@@ -575,7 +571,8 @@ int sys_sage::Mt4gParser::parseCaches(std::string header_name, std::string cache
                 cerr << "parseCaches: \"" << data[i] << "\" is supposed to be followed by 1 additional value." << endl;
                 return 1;
             }
-            share_ro = stoi(data[i+1]);
+            if(!_parse_mt4g_value(data[i+1], &share_ro, __func__, data[i]))
+                return 1;
         }
         else if(data[i]== "Share_Cache_With_ConstantL1")
         {
@@ -583,7 +580,8 @@ int sys_sage::Mt4gParser::parseCaches(std::string header_name, std::string cache
                 cerr << "parseCaches: \"" << data[i] << "\" is supposed to be followed by 1 additional value." << endl;
                 return 1;
             }
-            share_constant = stoi(data[i+1]);
+            if(!_parse_mt4g_value(data[i+1], &share_constant, __func__, data[i]))
+                return 1;
         }
     }
 
@@ -668,7 +666,6 @@ int sys_sage::Mt4gParser::parseCaches(std::string header_name, std::string cache
     else if(shared_on == 1) //shared on SM
     {
         std::vector<Component*> sms = root->GetAllSubcomponentsByType(sys_sage::ComponentType::Subdivision);
-        cout << endl << endl << endl << "=====      ===== ENTERING elseif for  - " << header_name << "sms (size=:" << sms.size() << endl << endl << endl;
         for(Component * sm : sms)
         {
             if(((Subdivision*)sm)->GetSubdivisionType() == sys_sage::SubdivisionType::GpuSM)
@@ -697,6 +694,14 @@ int sys_sage::Mt4gParser::parseCaches(std::string header_name, std::string cache
                     }
                 }
 
+                int cores_per_cache = Number_of_cores_per_SM/caches_per_sm;
+                //collapsed cores must not span several caches of this level
+                for(int i=1; collapseCores && i<=caches_per_sm; i++)
+                {
+                    for(Component * thread : sm->GetAllSubcomponentsByType(sys_sage::ComponentType::Thread))
+                        thread->SplitCollapsed(cores_per_cache*i);
+                }
+
                 std::vector<Component*> threads = sm->GetAllSubcomponentsByType(sys_sage::ComponentType::Thread);
                 for(int i=0; i<caches_per_sm; i++)
                 {
@@ -706,8 +711,6 @@ int sys_sage::Mt4gParser::parseCaches(std::string header_name, std::string cache
                     if(cache_line_size != -1)
                         cache->SetCacheLineSize(cache_line_size);
 
-                    int cores_per_cache = (*(int*)root->attrib["Number_of_cores_per_SM"])/caches_per_sm;
-
                     for(Component * thread : threads)
                     {
                         //if multiple caches per SM, move 1/n-th of threads (by their ID) under each cache
@@ -735,14 +738,11 @@ int sys_sage::Mt4gParser::parseCaches(std::string header_name, std::string cache
                                 new DataPath(cache, thread, sys_sage::DataPathOrientation::Oriented, sys_sage::DataPathType::Logical, 0, latency);
                         }
                     }
-                    cout << threads.size() << " - threads.size()" << ",   processing " << header_name << " == exited the (Component * thread : threads) " << endl;
                 }
                 //cout << "finished iterating over caches_per_sm:" << caches_per_sm << endl;
             }
         }
-        cout << "=====      ===== FINISHED iterating over sms (size=:" << sms.size() << endl;
     }
-    cout << endl << endl << endl << "FINISHING FUNCTION  - " << header_name << endl << endl << endl;
     return 0;
 }
 
@@ -11,6 +11,14 @@
 #include "Storage.hpp"
 #include "Node.hpp"
 #include "DataPath.hpp"
+#include "table-reader.hpp"
+
+#include <deque>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 /*! \file */
 
@@ -22,34 +30,56 @@ namespace sys_sage {
      * @param dataSourcePath - path to mt4g-generated result file. (.csv)
      * @param gpuId - ID of the new GPU Component.
      * @param delim (default ";") - delimiter in the CSV
+     * @param collapseCores (default false) - if true, the GPU cores (Thread components) that share all caches are represented by one collapsed Thread each (see Component::SetCount()), which shrinks the GPU representation by about 95%.
+     *        Counting queries count the individual cores; use Component::ExpandInstance() to materialize a core.
     */
-    int parseMt4gTopo(Node* parent, std::string dataSourcePath, int gpuId, std::string delim = ";");
+    int parseMt4gTopo(Node* parent, std::string dataSourcePath, int gpuId, std::string delim = ";", bool collapseCores = false);
     /**
      * Parse GPU topology file generated by mt4g.
      * @param parent - parent Component, where the new GPU representation will be created (the GPU will be represented as a child (newly created Chip component) of the parent).
      * @param dataSourcePath - path to mt4g-generated result file. (.csv)
      * @param gpuId - ID of the new GPU Component.
      * @param delim (default ";") - delimiter in the CSV
+     * @param collapseCores (default false) - if true, the GPU cores (Thread components) that share all caches are represented by one collapsed Thread each (see Component::SetCount()), which shrinks the GPU representation by about 95%.
+     *        Counting queries count the individual cores; use Component::ExpandInstance() to materialize a core.
     */
-    int parseMt4gTopo(Component* parent, std::string dataSourcePath, int gpuId, std::string delim = ";");
+    int parseMt4gTopo(Component* parent, std::string dataSourcePath, int gpuId, std::string delim = ";", bool collapseCores = false);
     /**
      * Parse GPU topology file generated by mt4g.
      * @param gpu - the (already existing) Chip* gpu Component, where the topology and other information from mt4g will be inserted.
      * @param dataSourcePath - path to mt4g-generated result file. (.csv)
      * @param delim (default ";") - delimiter in the CSV
+     * @param collapseCores (default false) - if true, the GPU cores (Thread components) that share all caches are represented by one collapsed Thread each (see Component::SetCount()), which shrinks the GPU representation by about 95%.
+     *        Counting queries count the individual cores; use Component::ExpandInstance() to materialize a core.
+    */
+    int parseMt4gTopo(Chip* gpu, std::string dataSourcePath, std::string delim = ";", bool collapseCores = false);
+    /**
+     * Parse the GPU topology files generated by mt4g for several GPUs (e.g. all GPUs of a node). The files are parsed concurrently.
+     * @param parent - parent Component (e.g. Node); one new Chip component per file is created as its child, in the order of dataSourcePaths.
+     * @param dataSourcePaths - paths to the mt4g-generated result files (.csv), one per GPU.
+     * @param firstGpuId (default 0) - ID of the GPU of the first file; the following GPUs get consecutive IDs.
+     * @param delim (default ";") - delimiter in the CSVs
+     * @param parallelism (default 0) - number of threads parsing the files (0 = std::thread::hardware_concurrency(); 1 = sequential).
+     * @param collapseCores (default false) - if true, the GPU cores are collapsed (see parseMt4gTopo(Chip*, std::string, std::string, bool)).
+     * @return 0 on success; otherwise the return code of the first file that failed. The GPUs of the files that failed are not added to parent.
     */
-    int parseMt4gTopo(Chip* gpu, std::string dataSourcePath, std::string delim = ";");
+    int parseMt4gTopo(Component* parent, const std::vector<std::string>& dataSourcePaths, int firstGpuId = 0, std::string delim = ";", unsigned parallelism = 0, bool collapseCores = false);
 
     /// @private
     class Mt4gParser
     {
     public:
-        Mt4gParser(Chip* gpu, std::string dataSourcePath, std::string delim = ";");
+        Mt4gParser(Chip* gpu, std::string dataSourcePath, std::string delim = ";", bool collapseCores = false);
 
         int ParseBenchmarkData();
     private:
+        using Fields = std::span<const std::string_view>;
+
         int ReadBenchmarkFile();
-        std::map<std::string,std::vector<std::string> > benchmarkData;
+        TableReader reader;
+        std::vector<std::string_view> fields; /**< Fields of all sections (without the section names), section after section. */
+        std::unordered_map<std::string_view, std::pair<size_t, size_t> > sections; /**< Section name -> [begin, end) in fields. The first line of a name is used. */
+        std::deque<std::string> ownedFields; /**< Fields that are no views into the file (unquoted with escapes or text appended after the quotes). */
         std::string dataSourcePath;
         std::string delim;
         Chip* root;
@@ -57,13 +87,15 @@ namespace sys_sage {
         bool L2_shared_on_gpu;
         double Memory_Clock_Frequency;
         int Memory_Bus_Width;
+        int Number_of_cores_per_SM;
+        bool collapseCores; /**< Represent the cores of an SM that share all caches by one collapsed Thread. */
 
-        int parseGPU_INFORMATION();
-        int parseCOMPUTE_RESOURCE_INFORMATION();
-        int parseREGISTER_INFORMATION();
-        int parseADDITIONAL_INFORMATION();
-        int parseMemory(std::string header_name, std::string memory_name);
-        int parseCaches(std::string header_name, std::string cache_type);
+        int parseGPU_INFORMATION(Fields data);
+        int parseCOMPUTE_RESOURCE_INFORMATION(Fields data);
+        int parseREGISTER_INFORMATION(Fields data);
+        int parseADDITIONAL_INFORMATION(Fields data);
+        int parseMemory(Fields data, std::string_view header_name, std::string memory_name);
+        int parseCaches(Fields data, std::string_view header_name, std::string cache_type);
     };
 
     /// @private
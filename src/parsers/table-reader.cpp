@@ -0,0 +1,163 @@
+#include "table-reader.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+using namespace sys_sage;
+
+static const char* whitespace = " \f\n\r\t\v";
+
+sys_sage::TableReader::TableReader(std::string _delimiter, bool _trim, char _quote) : delimiter(_delimiter), trim(_trim), quote(_quote) {}
+
+sys_sage::TableReader::~TableReader() { Close(); }
+
+int sys_sage::TableReader::Open(const std::string& path)
+{
+    Close();
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        return 1;
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+        close(fd);
+        return 1;
+    }
+    if(st.st_size > 0) {
+        void* m = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(m == MAP_FAILED) {
+            close(fd);
+            return 1;
+        }
+        madvise(m, st.st_size, MADV_SEQUENTIAL);
+        mapped = static_cast<const char*>(m);
+        mappedSize = st.st_size;
+    }
+    close(fd);
+    OpenBuffer(std::string_view(mapped, mappedSize));
+    return 0;
+}
+
+void sys_sage::TableReader::OpenBuffer(std::string_view _text)
+{
+    text = _text;
+    pos = 0;
+    lineEnd = 0;
+    line = 0;
+    rowLine = 0;
+    unescaped.clear();
+}
+
+void sys_sage::TableReader::Close()
+{
+    if(mapped != nullptr)
+        munmap(const_cast<char*>(mapped), mappedSize);
+    mapped = nullptr;
+    mappedSize = 0;
+    OpenBuffer(std::string_view());
+}
+
+bool sys_sage::TableReader::NextRow(std::vector<std::string_view>* fields)
+{
+    fields->clear();
+    unescaped.clear();
+    while(pos < text.size()) {
+        lineEnd = std::min(text.find('\n', pos), text.size());
+        rowLine = line + 1;
+
+        std::string_view raw = text.substr(pos, lineEnd - pos);
+        if(!raw.empty() && raw.back() == '\r')
+            raw.remove_suffix(1);
+        if(skipEmptyRows && (trim ? raw.find_first_not_of(whitespace) == std::string_view::npos : raw.empty())) {
+            pos = lineEnd + 1;
+            line++;
+            continue;
+        }
+
+        while(_NextField(fields)) {}
+        //a quoted field may have moved lineEnd
+        pos = lineEnd + 1;
+        line++;
+        return true;
+    }
+    return false;
+}
+
+//reads the field starting at pos; returns true if it was ended by a delimiter
+bool sys_sage::TableReader::_NextField(std::vector<std::string_view>* fields)
+{
+    size_t p = pos;
+    if(trim)
+        while(p < lineEnd && std::string_view(whitespace).find(text[p]) != std::string_view::npos)
+            p++;
+
+    if(quote == 0 || p >= lineEnd || text[p] != quote) {
+        size_t end = _FindFieldEnd(p);
+        fields->push_back(_TrimRight(text.substr(p, end - p)));
+        return _Advance(end);
+    }
+
+    //quoted field: ends at the first quote that is not doubled
+    std::string* value = nullptr;
+    size_t start = p + 1, q = start, close;
+    while(true) {
+        close = std::min(text.find(quote, q), text.size());
+        if(close + 1 < text.size() && text[close + 1] == quote) {
+            if(value == nullptr)
+                value = &unescaped.emplace_back();
+            value->append(text.substr(q, close + 1 - q));
+            q = close + 2;
+            continue;
+        }
+        break;
+    }
+    std::string_view content = text.substr(start, close - start);
+    if(value != nullptr)
+        value->append(text.substr(q, close - q));
+
+    if(close > lineEnd) {
+        line += std::count(text.begin() + lineEnd, text.begin() + close, '\n');
+        lineEnd = std::min(text.find('\n', close), text.size());
+    }
+    p = std::min(close + 1, lineEnd);
+    size_t end = _FindFieldEnd(p);
+    std::string_view rest = _TrimRight(text.substr(p, end - p));
+    if(!rest.empty()) {
+        if(value == nullptr)
+            value = &unescaped.emplace_back(content);
+        value->append(rest);
+    }
+    fields->push_back(value != nullptr ? std::string_view(*value) : content);
+    return _Advance(end);
+}
+
+size_t sys_sage::TableReader::_FindFieldEnd(size_t p)
+{
+    if(delimiter.empty())
+        return lineEnd;
+    return std::min(text.substr(0, lineEnd).find(delimiter, p), lineEnd);
+}
+
+bool sys_sage::TableReader::_Advance(size_t end)
+{
+    if(end < lineEnd) {
+        pos = end + delimiter.size();
+        return true;
+    }
+    pos = lineEnd;
+    return false;
+}
+
+std::string_view sys_sage::TableReader::_TrimRight(std::string_view s) const
+{
+    if(trim) {
+        size_t last = s.find_last_not_of(whitespace);
+        return last == std::string_view::npos ? std::string_view() : s.substr(0, last + 1);
+    }
+    if(!s.empty() && s.back() == '\r')
+        s.remove_suffix(1);
+    return s;
+}
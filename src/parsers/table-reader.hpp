@@ -0,0 +1,121 @@
+#ifndef TABLE_READER
+#define TABLE_READER
+
+#include <charconv>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+/*! \file */
+
+namespace sys_sage {
+    /**
+     * @class TableReader
+     * @brief Reader of delimiter-separated text files (CSV and similar) used by the benchmark parsers; can also be used by custom parsers.
+     *
+     * The file is mapped into memory and read row by row. The fields are views into the mapping (no copies), except for quoted fields that contain escaped quotes.
+     * The views are valid until the next call of NextRow() (quoted fields) or until the reader is closed (all other fields).
+     * Numbers are converted with ParseNumber() (std::from_chars: no locale, no allocation).
+     * \n Example:
+     * ```cpp
+     * TableReader reader(";");
+     * if(reader.Open(path) != 0)
+     *     return 1;
+     * std::vector<std::string_view> row;
+     * while(reader.NextRow(&row)) {
+     *     int id;
+     *     if(row.size() < 2 || !TableReader::ParseNumber(row[1], &id))
+     *         std::cerr << "line " << reader.GetLineNumber() << ": no id" << std::endl;
+     * }
+     * ```
+     */
+    class TableReader {
+    public:
+        /**
+         * @param _delimiter Field delimiter; may be several characters long (e.g. ", ").
+         * @param _trim If true, whitespace around the fields (outside of quotes) is removed.
+         * @param _quote Quote character (0 = none). A field starting with it ends at the next single quote character, so it may contain delimiters and line breaks;
+         * two quote characters stand for one. Text between the closing quote and the delimiter is appended to the field.
+         */
+        TableReader(std::string _delimiter = ",", bool _trim = true, char _quote = '"');
+        /**
+         * @brief Unmaps the file.
+         */
+        ~TableReader();
+        TableReader(const TableReader&) = delete;
+        TableReader& operator=(const TableReader&) = delete;
+
+        /**
+         * @brief Maps the file at path and starts reading at its first row.
+         * @return 0 on success, 1 if the file cannot be opened.
+         */
+        int Open(const std::string& path);
+        /**
+         * @brief Reads the rows of text (not copied; it has to stay valid while the reader is used).
+         */
+        void OpenBuffer(std::string_view text);
+        /**
+         * @brief Unmaps the file; the views returned so far become invalid.
+         */
+        void Close();
+        /**
+         * @brief Reads the next row.
+         * @param fields Output: the fields of the row (cleared first). A row without delimiters has one field.
+         * @return false at the end of the input.
+         */
+        bool NextRow(std::vector<std::string_view>* fields);
+        /**
+         * @brief Returns the line number (starting at 1) at which the row returned by the last NextRow() starts.
+         */
+        size_t GetLineNumber() const { return rowLine; }
+        /**
+         * @brief Returns the whole input (e.g. for custom tokenizing).
+         */
+        std::string_view GetText() const { return text; }
+
+        /**
+         * @brief Converts a field to a number with std::from_chars.
+         * @param s Field (the whole field has to be a number; leading '+' is accepted).
+         * @param value Output; unchanged on failure.
+         * @return true on success, false if s is not a number of type T or out of its range.
+         */
+        template <class T>
+        requires std::is_arithmetic_v<T>
+        static bool ParseNumber(std::string_view s, T* value)
+        {
+            if(!s.empty() && s.front() == '+')
+                s.remove_prefix(1);
+            T v{};
+            auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+            if(ec != std::errc() || ptr != s.data() + s.size() || s.empty())
+                return false;
+            *value = v;
+            return true;
+        }
+
+        bool skipEmptyRows = true; /**< If true, empty lines (and lines of whitespace only, if trimming) are skipped. */
+
+    private:
+        bool _NextField(std::vector<std::string_view>* fields);
+        size_t _FindFieldEnd(size_t p);
+        bool _Advance(size_t end);
+        std::string_view _TrimRight(std::string_view s) const;
+
+        std::string delimiter;
+        bool trim;
+        char quote;
+
+        std::string_view text;
+        const char* mapped = nullptr; /**< Mapping of the file opened with Open() (nullptr for OpenBuffer()). */
+        size_t mappedSize = 0;
+        size_t pos = 0; /**< Start of the next field. */
+        size_t lineEnd = 0; /**< Position of the line break (or end of the text) of the current line. */
+        size_t line = 0; /**< Number of line breaks before pos. */
+        size_t rowLine = 0;
+        std::deque<std::string> unescaped; /**< Quoted fields of the current row that had to be copied. */
+    };
+} //namespace sys_sage
+#endif
@@ -18,7 +18,10 @@
 
 namespace py = pybind11;
 
-std::vector<std::string> default_attribs = {"CATcos","CATL3mask","mig_size","Number_of_streaming_multiprocessors","Number_of_cores_in_GPU","Number_of_cores_per_SM","Bus_Width_bit","Clock_Frequency","latency","latency_min","latency_max","CUDA_compute_capability","mig_uuid","freq_history","GPU_Clock_Rate"};
+//built-in attributes are exported by sys-sage itself
+bool is_default_attrib(const std::string& key) {
+    return sys_sage::AttributeKey::GetBuiltinType(sys_sage::AttributeKey::Find(key)) != sys_sage::AttributeType::None;
+}
 
 py::function print_attributes;
 py::function print_complex_attributes;
@@ -28,7 +31,7 @@ py::function read_complex_attributes;
 
 int xmldumper(std::string key, void* value, std::string* ret_value_str) {
     //
-    if(default_attribs.end() != std::find(default_attribs.begin(), default_attribs.end(), key))
+    if(is_default_attrib(key))
         return 0;
     auto * ptr = static_cast<std::shared_ptr<py::object>*>(value);
     py::object res = print_attributes( py::cast(key), *ptr->get());
@@ -40,7 +43,7 @@ int xmldumper(std::string key, void* value, std::string* ret_value_str) {
 }
 
 int xmldumper_complex(std::string key, void* value, xmlNodePtr node) {
-    if(default_attribs.end() != std::find(default_attribs.begin(), default_attribs.end(), key))
+    if(is_default_attrib(key))
         return 0;
     auto * ptr = static_cast<std::shared_ptr<py::object>*>(value);
     //idea: we expect fcn to return xml as a string and write it to node
@@ -95,138 +98,90 @@ int xmlloader_complex(xmlNodePtr node, sys_sage::Component *c) {
     return 0;
 }
 
-//TODO: Add dynamic allocation for values
-//TODO: Delete values only after success
+//built-in keys are stored typed (and owned) in the component's AttributeStore; other python objects are kept in the attrib map
 template <typename T>
 void set_attribute(T &self, const std::string &key, py::object &value) {
-    //std::cout << "set attribute: " << key << " = " << value << std::endl;
+    sys_sage::AttributeKey::type k = sys_sage::AttributeKey::Find(key);
+    switch(sys_sage::AttributeKey::GetBuiltinType(k)) {
+        case sys_sage::AttributeType::UInt64:
+            self.SetAttribute(k, py::cast<uint64_t>(value));
+            return;
+        case sys_sage::AttributeType::LongLong:
+            self.SetAttribute(k, py::cast<long long>(value));
+            return;
+        case sys_sage::AttributeType::Int:
+            self.SetAttribute(k, py::cast<int>(value));
+            return;
+        case sys_sage::AttributeType::Double:
+            self.SetAttribute(k, py::cast<double>(value));
+            return;
+        case sys_sage::AttributeType::Float:
+            self.SetAttribute(k, py::cast<float>(value));
+            return;
+        case sys_sage::AttributeType::String:
+            self.SetAttribute(k, py::cast<std::string>(value));
+            return;
+        case sys_sage::AttributeType::FrequencyHistory: {
+            sys_sage::FrequencyHistory fh;
+            py::dict fh_dict = py::cast<py::dict>(value);
+            for (auto [ts, freq] : fh_dict) {
+                fh.push_back(std::make_tuple(py::cast<long long>(ts), py::cast<double>(freq)));
+            }
+            self.SetAttribute(k, std::move(fh));
+            return;
+        }
+        default:
+            break;
+    }
 
+    void * new_val = static_cast<void*>(new std::shared_ptr<py::object>(
+        std::make_shared<py::object>(value)));
     auto val = self.attrib.find(key);
-    
-    if (!key.compare("CATcos") || !key.compare("CATL3mask")) {
-        void * newval = static_cast<void*>(new uint64_t(py::cast<uint64_t>(value)));
-        if(val != self.attrib.end())
-            delete static_cast<uint64_t*>(val->second);
-        self.attrib[key] = newval;
-    } else if (!key.compare("mig_size")) {
-        void* new_val = static_cast<void*>(new long long(py::cast<long long>(value)));
-        if(val != self.attrib.end())
-            delete static_cast<long long*>(val->second);
-        self.attrib[key] = new_val;
-    } else if (!key.compare("Number_of_streaming_multiprocessors") || 
-               !key.compare("Number_of_cores_in_GPU") || 
-               !key.compare("Number_of_cores_per_SM") || 
-               !key.compare("Bus_Width_bit")) {
-        void* new_val = static_cast<void*>(new int(py::cast<int>(value)));
-        if(val != self.attrib.end())
-            delete static_cast<int*>(val->second);
-        self.attrib[key] = new_val;
-    } else if (!key.compare("Clock_Frequency") || !key.compare("GPU_Clock_Rate")) {
-        void * new_val = static_cast<void*>(new double(py::cast<double>(value)));
-        if(val != self.attrib.end())
-            delete static_cast<double*>(val->second);
-        self.attrib[key] = new_val;
-    } else if (!key.compare("latency") ||
-               !key.compare("latency_min") ||
-               !key.compare("latency_max")) {
-        void * new_val = static_cast<void*>(new float(py::cast<float>(value)));
-        if(val != self.attrib.end())
-            delete static_cast<float*>(val->second);
-        self.attrib[key] = new_val;
-    } else if (!key.compare("CUDA_compute_capability") || 
-               !key.compare("mig_uuid")) {
-        void * new_val= static_cast<void*>(new std::string(py::cast<std::string>(value)));
-        if(val != self.attrib.end())
-            delete static_cast<std::string*>(val->second);
-        self.attrib[key] = new_val;
-    } else if (!key.compare("freq_history")) {
-        auto fh = new std::vector<std::tuple<long long, double>>;
-        py::dict fh_dict = py::cast<py::dict>(value);
-        for (auto [key, value] : fh_dict) {
-            fh->push_back(std::make_tuple(py::cast<long long>(key), py::cast<double>(value)));
+    if (val != self.attrib.end())
+        delete static_cast<std::shared_ptr<py::object>*>(val->second);
+    self.attrib[key] = new_val;
+}
+
+py::object typed_attribute_to_py(const sys_sage::AttributeStore::Entry& e) {
+    switch(e.type) {
+        case sys_sage::AttributeType::Int:
+            return py::cast(e.value.i);
+        case sys_sage::AttributeType::LongLong:
+            return py::cast(e.value.ll);
+        case sys_sage::AttributeType::UInt64:
+            return py::cast(e.value.u64);
+        case sys_sage::AttributeType::Float:
+            return py::cast(e.value.f);
+        case sys_sage::AttributeType::Double:
+            return py::cast(e.value.d);
+        case sys_sage::AttributeType::String:
+            return py::cast(*static_cast<const std::string*>(e.Get()));
+        case sys_sage::AttributeType::FrequencyHistory: {
+            py::dict freq_dict;
+            for(auto [ ts,freq ] : *static_cast<const sys_sage::FrequencyHistory*>(e.Get()))
+                freq_dict[py::cast(ts)] = py::cast(freq);
+            return freq_dict;
         }
-        void * new_val = static_cast<void*>(fh);
-        if(val != self.attrib.end())
-            delete static_cast<std::vector<std::tuple<long long, double>>*>(val->second);
-        self.attrib[key] = new_val;
-    //} else if (!key.compare("GPU_Clock_Rate")) {
-    //    std::cout << "Setting attribute: " << key << std::endl;
-    //    py::object freq = value["freq"];
-    //    py::str unit = value["unit"];
-    //    //double * f = new double(py::cast<double>(freq));
-    //    //std::string * u = new std::string(py::cast<std::string>(unit));
-    //    void * new_val = static_cast<void*>(new std::tuple<double, std::string>(py::cast<double>(freq), py::cast<std::string>(unit)));
-    //    if(val != self.attrib.end())
-    //        delete static_cast<std::tuple<double, std::string>*>(val->second);
-    //    self.attrib[key] = new_val;
-    } else {
-        void * new_val = static_cast<void*>(new std::shared_ptr<py::object>(
-            std::make_shared<py::object>(value)));
-        if (val != self.attrib.end())
-            delete static_cast<std::shared_ptr<py::object>*>(val->second);
-        self.attrib[key] = new_val;
+        default:
+            if(e.ops != nullptr && e.ops->typeInfo == typeid(std::shared_ptr<py::object>))
+                return *static_cast<const std::shared_ptr<py::object>*>(e.Get())->get();
+            return py::none();
     }
-
 }
 
 template <typename T>
 py::object get_attribute(T &self, const std::string &key) {
+    if constexpr (std::is_base_of_v<sys_sage::Component, T>)
+        self.DecodeAttribute(key);
+    const sys_sage::AttributeStore* store = self.GetAttributes();
+    const sys_sage::AttributeStore::Entry* e = store != nullptr ? store->GetEntry(sys_sage::AttributeKey::Find(key)) : nullptr;
+    if (e != nullptr)
+        return typed_attribute_to_py(*e);
+
     auto val = self.attrib.find(key);
     if (val != self.attrib.end()) {
-        if(!key.compare("CATcos") || !key.compare("CATL3mask")){
-            uint64_t retval = *((uint64_t*)val->second); 
-            return py::cast(retval);
-        }
-        else if(!key.compare("mig_size") )
-        {
-            return py::cast(*(long long*)val->second);
-        }
-        //val->secondue: int
-        else if(!key.compare("Number_of_streaming_multiprocessors") || 
-        !key.compare("Number_of_cores_in_GPU") || 
-        !key.compare("Number_of_cores_per_SM")  || 
-        !key.compare("Bus_Width_bit") )
-        {
-            return py::cast(*(int*)val->second);
-        }
-        //value: double
-        else if(!key.compare("Clock_Frequency") || !key.compare("GPU_Clock_Rate"))
-        {
-            return py::cast(*(double*)val->second);
-        }
-        //value: float
-        else if(!key.compare("latency") ||
-        !key.compare("latency_min") ||
-        !key.compare("latency_max") )
-        {
-            return py::cast(*(float*)val->second);
-        }   
-        //value: string
-        else if(!key.compare("CUDA_compute_capability") || 
-        !key.compare("mig_uuid") )
-        {
-            return py::cast(*(std::string*)val->second);
-        }
-        else if(!key.compare("freq_history") ){
-            std::vector<std::tuple<long long,double>>* value = (std::vector<std::tuple<long long,double>>*)(val->second);
-            py::dict freq_dict;
-             for(auto [ ts,freq ] : *value){
-                 freq_dict[py::cast(ts)] = py::cast(freq);
-                 //printf("ts:%lld freq:%f\n",ts,freq);
-             }
-             return freq_dict;
-        //}
-        //else if(!key.compare("GPU_Clock_Rate")){
-        //    auto value = static_cast<std::tuple<double, std::string>*>(val->second);
-        //    auto [ freq, unit ] = *value;
-        //    py::dict freq_dict;
-        //    freq_dict[py::str("freq")] = py::cast(freq);
-        //    freq_dict[py::str("unit")] = py::cast(unit);  
-        //    return freq_dict;     
-        }else{
-            auto * ptr = static_cast<std::shared_ptr<py::object>*>(val->second);
-            return *ptr->get();
-        }
+        auto * ptr = static_cast<std::shared_ptr<py::object>*>(val->second);
+        return *ptr->get();
     } else {
         throw py::attribute_error("Attribute '" + key + "' not found"); 
     }
@@ -234,16 +189,24 @@ py::object get_attribute(T &self, const std::string &key) {
 
 template <typename T>
 py::object get_attribute(T &self, int pos){
-    if (pos < 0 || static_cast<size_t>(pos) >= self.attrib.size())
+    if constexpr (std::is_base_of_v<sys_sage::Component, T>)
+        self.DecodeAllAttributes(); //decoding may move custom attributes to the attrib map
+    const sys_sage::AttributeStore* store = self.GetAttributes();
+    size_t numTyped = store != nullptr ? store->Size() : 0;
+    if (pos < 0 || static_cast<size_t>(pos) >= numTyped + self.attrib.size())
         throw py::index_error("Index out of bounds");
+    if (static_cast<size_t>(pos) < numTyped)
+        return typed_attribute_to_py(store->GetEntries()[pos]);
     auto it = self.attrib.begin();
-    std::advance(it, pos);
+    std::advance(it, pos - numTyped);
     return get_attribute(self, it->first);
 }
 
 
 template <typename T>
 void remove_attribute(T &self, const std::string &key) {
+    if (self.RemoveAttribute(key))
+        return;
     auto val = self.attrib.find(key);
     if (val != self.attrib.end()) {
         delete static_cast<std::shared_ptr<py::object>*>(val->second);
@@ -310,6 +273,22 @@ PYBIND11_MODULE(sys_sage, m) {
     m.attr("QUANTUMGATE_TYPE_SX") = QuantumGateType::Sx;
     m.attr("QUANTUMGATE_TYPE_TOFFOLI") = QuantumGateType::Toffoli;
 
+    //bind memory footprint (dict keys are the COMPONENT_* / RELATION_TYPE_* constants and attribute names)
+    py::class_<MemoryFootprint>(m, "MemoryFootprint")
+        .def_readonly("totalBytes", &MemoryFootprint::totalBytes)
+        .def_readonly("componentCount", &MemoryFootprint::componentCount)
+        .def_readonly("relationCount", &MemoryFootprint::relationCount)
+        .def_readonly("componentBytes", &MemoryFootprint::componentBytes)
+        .def_readonly("componentCounts", &MemoryFootprint::componentCounts)
+        .def_readonly("relationBytes", &MemoryFootprint::relationBytes)
+        .def_readonly("relationCounts", &MemoryFootprint::relationCounts)
+        .def_readonly("attributeBytes", &MemoryFootprint::attributeBytes)
+        .def_readonly("stringBytes", &MemoryFootprint::stringBytes)
+        .def_readonly("vectorSlackBytes", &MemoryFootprint::vectorSlackBytes)
+        .def_readonly("indexBytes", &MemoryFootprint::indexBytes)
+        .def_readonly("arenaSlackBytes", &MemoryFootprint::arenaSlackBytes)
+        .def("Print", &MemoryFootprint::Print, "Print the footprint and its breakdown");
+
     //bind component class
     py::class_<Component, std::unique_ptr<Component, py::nodelete>>(m, "Component")
         .def(py::init<int, std::string>(), py::arg("id") = 0, py::arg("name") = "unknown")
@@ -329,13 +308,21 @@ PYBIND11_MODULE(sys_sage, m) {
         .def("InsertChild", &Component::InsertChild, py::arg("child"), "Insert a child component")
         .def("InsertBetweenParentAndChild", &Component::InsertBetweenParentAndChild, py::arg("parent"), py::arg("child"), py::arg("alreadyParentsChild"),"Insert a component between parent and child")
         .def("InsertBetweenParentAndChildren", &Component::InsertBetweenParentAndChildren, py::arg("parent"), py::arg("children"), py::arg("alreadyParentsChildren"), "Insert a component between parent and children")
-        .def("RemoveChild", &Component::RemoveChild, py::arg("child"),"Remove a child component")
+        .def("RemoveChild", &Component::RemoveChild, py::arg("child"), py::arg("preserveOrder") = true, "Remove a child component; with preserveOrder=False, the last child takes its place (O(1))")
         .def_property("parent", &Component::GetParent, &Component::SetParent, "The parent of the component")
         .def("SetParent", &Component::SetParent, py::arg("parent"), "Set the parent of the component")
         .def("PrintSubtree", &Component::PrintSubtree, "Print the subtree of the component up to level 0")
         .def("PrintAllRelationsInSubtree", &Component::PrintAllRelationsInSubtree, py::arg("relationType") = RelationType::Any, "Print all relations in the subtree")
         .def_property("name", &Component::GetName, &Component::SetName, "The name of the component")
         .def_property_readonly("id", &Component::GetId, "The id of the component")
+        .def_property_readonly("count", &Component::GetCount, "The number of identical components represented by the component (1 unless collapsed)")
+        .def("SetCount", &Component::SetCount, py::arg("count"), "Collapse identical siblings into the component (only for leaf components)")
+        .def("IsCollapsed", &Component::IsCollapsed, "Whether the component represents more than one component")
+        .def("IsShared", &Component::IsShared, "Whether the component is stored once for several represented components (it or an ancestor is collapsed); writes to it materialize a private copy first")
+        .def("SplitCollapsed", &Component::SplitCollapsed, py::arg("id"), "Split a collapsed component; returns the component representing the ids from id on")
+        .def("ExpandInstance", &Component::ExpandInstance, py::arg("id"), "Materialize one instance of a collapsed component")
+        .def("ExpandAll", &Component::ExpandAll, "Materialize all instances of a collapsed component")
+        .def("CollapseIdenticalSubtrees", &Component::CollapseIdenticalSubtrees, py::arg("typeMask") = ComponentType::AnyMask, "Collapse runs of siblings with identical subtrees; returns the number of deleted components")
         .def_property_readonly("type", &Component::GetComponentType, "The type of the component")
         .def("GetComponentTypeStr", &Component::GetComponentTypeStr, "The type of the component as string")
         .def("GetChildren", &Component::GetChildren, "The children of the component")
@@ -349,6 +336,8 @@ PYBIND11_MODULE(sys_sage, m) {
         .def("CountAllSubcomponentsByType", &Component::CountAllSubcomponentsByType, py::arg("type"),"Count sub components by type")
         .def("CountChildrenByType", &Component::CountAllChildrenByType,py::arg("type"),"Count children by type")
         .def("GetAncestorByType", &Component::GetAncestorByType, py::arg("type"),"Get the first ancestor component by type")
+        .def("GetLowestCommonAncestor", &Component::GetLowestCommonAncestor, py::arg("other"), "Get the lowest common ancestor of this and the other component")
+        .def("GetSharedComponents", (std::vector<Component*> (Component::*)(const Component*, ComponentType::mask) const)&Component::GetSharedComponents, py::arg("other"), py::arg("typeMask") = ComponentType::AnyMask, "Get the lowest common ancestor of this and the other component and all its ancestors, filtered by a type mask")
         .def("GetSubtreeDepth", &Component::GetSubtreeDepth, "Get the depth of the subtree")
         .def("GetNthAncestor", &Component::GetNthAncestor, py::arg("n"),"Get the nth ancestor of the component")
         .def("GetNthDescendents", (std::vector<Component*> (Component::*)(int))&Component::GetNthDescendents,py::arg("n"),"Get all the nth descendents of the component")
@@ -368,7 +357,8 @@ PYBIND11_MODULE(sys_sage, m) {
             int total_bytes = self.GetTopologySize(&out_component_size, &out_dataPathSize);
             return std::make_tuple(total_bytes, out_component_size, out_dataPathSize);
         }, "Get the size of the topology")
-        .def("GetDepth", &Component::GetDepth,py::arg("refresh"),"Get the depth of the component, if refresh is true it will update the depth")
+        .def("GetMemoryFootprint", [](Component& self) { return GetMemoryFootprint(&self); }, "Get the memory footprint of the subtree, broken down by component type, relation type, attribute key, strings and vector slack")
+        .def("GetDepth", &Component::GetDepth,py::arg("refresh") = false,"Get the depth of the component, if refresh is true it will update the depth")
         .def("DeleteRelation", &Component::DeleteRelation, py::arg("relation"), "Delete the given relation from the component")
         .def("DeleteAllRelations", &Component::DeleteAllRelations, py::arg("type") = RelationType::Any,"Delete all relations of that type from the component")
         .def("DeleteSubtree", &Component::DeleteSubtree,"Delete the subtree of the component")
@@ -383,7 +373,10 @@ PYBIND11_MODULE(sys_sage, m) {
             });
 
     py::class_<Topology, std::unique_ptr<Topology, py::nodelete>,Component>(m, "Topology")
-        .def(py::init<>());
+        .def(py::init<>())
+        .def("EnableConcurrentReads", &Topology::EnableConcurrentReads, "Enable lock-free concurrent readers with epoch-based reclamation of replaced relations and attributes")
+        .def("DisableConcurrentReads", &Topology::DisableConcurrentReads, "Disable concurrent reads (waits for the active readers)")
+        .def("IsConcurrentReadsEnabled", &Topology::IsConcurrentReadsEnabled, "Check whether concurrent reads are enabled");
 
     py::class_<Node, std::unique_ptr<Node, py::nodelete>, Component>(m, "Node")
         #ifdef INTEL_PQOS
@@ -564,9 +557,10 @@ PYBIND11_MODULE(sys_sage, m) {
         .def("SetGateProperties", &QuantumGate::SetGateProperties, py::arg("name"), py::arg("fidelity"), py::arg("unitary"), "Sets the name, fidelity, unitary and type of the quantum gate")
         .def("Print", &QuantumGate::Print, "Print basic information about the quantum gate to stdout");
 
-    m.def("parseMt4gTopo", (int (*) (Node*,std::string,int, std::string)) &parseMt4gTopo, "parseMt4gTopo", py::arg("parent"), py::arg("dataSourcePath"), py::arg("gpuID"), py::arg("delim") = ";");
-    m.def("parseMt4gTopo", (int (*) (Component*,std::string,int, std::string)) &parseMt4gTopo, "parseMt4gTopo", py::arg("parent"), py::arg("dataSourcePath"), py::arg("gpuID"), py::arg("delim") = ";");
-    m.def("parseMt4gTopo", (int (*) (Chip*,std::string, std::string)) &parseMt4gTopo, "parseMt4gTopo", py::arg("parent"), py::arg("dataSourcePath"),  py::arg("delim") = ";");
+    m.def("parseMt4gTopo", (int (*) (Node*,std::string,int, std::string, bool)) &parseMt4gTopo, "parseMt4gTopo", py::arg("parent"), py::arg("dataSourcePath"), py::arg("gpuID"), py::arg("delim") = ";", py::arg("collapseCores") = false);
+    m.def("parseMt4gTopo", (int (*) (Component*,std::string,int, std::string, bool)) &parseMt4gTopo, "parseMt4gTopo", py::arg("parent"), py::arg("dataSourcePath"), py::arg("gpuID"), py::arg("delim") = ";", py::arg("collapseCores") = false);
+    m.def("parseMt4gTopo", (int (*) (Chip*,std::string, std::string, bool)) &parseMt4gTopo, "parseMt4gTopo", py::arg("parent"), py::arg("dataSourcePath"),  py::arg("delim") = ";", py::arg("collapseCores") = false);
+    m.def("parseMt4gTopo", (int (*) (Component*, const std::vector<std::string>&, int, std::string, unsigned, bool)) &parseMt4gTopo, "parseMt4gTopo", py::arg("parent"), py::arg("dataSourcePaths"), py::arg("firstGpuId") = 0, py::arg("delim") = ";", py::arg("parallelism") = 0, py::arg("collapseCores") = false);
 
     m.def("parseHwlocOutput", &parseHwlocOutput, "parseHwlocOutput", py::arg("root"), py::arg("xmlPath"));
 
@@ -574,6 +568,8 @@ PYBIND11_MODULE(sys_sage, m) {
 
     m.def("parseCapsNumaBenchmark", &parseCapsNumaBenchmark,  py::arg("root"), py::arg("benchmarkPath"), py::arg("delim") = ";");
 
+    m.def("ingestDataSources", [](Component* parent, std::string manifestPath, unsigned parallelism) { return ingestDataSources(parent, manifestPath, parallelism); }, "Parses the data sources listed in a manifest file (nodeId;type;path[;gpuId] per line) concurrently into one Node per node id", py::arg("parent"), py::arg("manifestPath"), py::arg("parallelism") = 0);
+
     m.def("parseIQM", (int (*) (Component *, std::string, int, int)) &parseIQM, "parseIQM", py::arg("parent"), py::arg("dataSourcePath"), py::arg("qcId"), py::arg("tsForHistory") = -1);
     m.def("parseIQM", (int (*) (QuantumBackend *, std::string, int, int, bool)) &parseIQM, "parseIQM", py::arg("parent"), py::arg("dataSourcePath"), py::arg("qcId"), py::arg("tsForHistory") = -1, py::arg("createTopo") = true);
 
@@ -587,13 +583,13 @@ PYBIND11_MODULE(sys_sage, m) {
         exportToXml(&root, xmlPath,print_att ? xmldumper : nullptr,print_catt ? xmldumper_complex : nullptr);
     },py::arg("root"), py::arg("xmlPath") = "", py::arg("print_att") = py::none(), py::arg("print_catt") = py::none());
     
-    m.def("importFromXml",[](std::string path, std::optional<py::function> search_custom_attrib_key_fcn = std::nullopt, std::optional<py::function> search_custom_complex_attrib_key_fcn = std::nullopt) {
+    m.def("importFromXml",[](std::string path, std::optional<py::function> search_custom_attrib_key_fcn = std::nullopt, std::optional<py::function> search_custom_complex_attrib_key_fcn = std::nullopt, bool lazy_attributes = false) {
         if(search_custom_attrib_key_fcn)
             read_attributes = *search_custom_attrib_key_fcn;
         if(search_custom_complex_attrib_key_fcn)
             read_complex_attributes = *search_custom_complex_attrib_key_fcn;
-        return importFromXml(path,search_custom_attrib_key_fcn ? xmlloader : nullptr, search_custom_complex_attrib_key_fcn ? xmlloader_complex : nullptr );
-    }, py::arg("path"), py::arg("search_custom_attrib_key_fcn") = py::none(), py::arg("search_custom_complex_attrib_key_fcn") = py::none());
+        return importFromXml(path,search_custom_attrib_key_fcn ? xmlloader : nullptr, search_custom_complex_attrib_key_fcn ? xmlloader_complex : nullptr, lazy_attributes);
+    }, py::arg("path"), py::arg("search_custom_attrib_key_fcn") = py::none(), py::arg("search_custom_complex_attrib_key_fcn") = py::none(), py::arg("lazy_attributes") = false);
 }
 
 
@@ -4,6 +4,12 @@
 //includes all other headers
 #include "Topology.hpp"
 #include "Component.hpp"
+#include "ComponentTraversal.hpp"
+#include "Arena.hpp"
+#include "FrozenTopology.hpp"
+#include "MemoryFootprint.hpp"
+#include "Epoch.hpp"
+#include "Attribute.hpp"
 #include "Thread.hpp"
 #include "Core.hpp"
 #include "Cache.hpp"
@@ -22,10 +28,14 @@
 #include "CouplingMap.hpp"
 #include "xml_dump.hpp"
 #include "xml_load.hpp"
+#include "binary_dump.hpp"
+#include "binary_load.hpp"
 #include "parsers/hwloc.hpp"
 #include "parsers/caps-numa-benchmark.hpp"
 #include "parsers/mt4g.hpp"
 #include "parsers/cccbench.hpp"
 #include "parsers/qdmi-parser.hpp"
 #include "parsers/iqm-parser.hpp"
+#include "parsers/table-reader.hpp"
+#include "parsers/ingest.hpp"
 #endif //SYS_SAGE
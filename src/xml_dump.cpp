@@ -1,5 +1,10 @@
-#include <sstream>
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <thread>
 
 #include "xml_dump.hpp"
 #include <libxml/parser.h>
@@ -23,405 +28,870 @@
 #include "QuantumGate.hpp"
 #include "CouplingMap.hpp"
 
-std::function<int(std::string,void*,std::string*)> store_custom_attrib_fcn = NULL;
-std::function<int(std::string,void*,xmlNodePtr)> store_custom_complex_attrib_fcn = NULL;
+//libxml2 caps the indentation of formatted output at 60 columns
+static constexpr size_t maxIndentLevel = 30;
+
+sys_sage::XmlStreamWriter::XmlStreamWriter(FILE* _out, size_t _baseLevel) : out(_out), baseLevel(_baseLevel)
+{
+    if(out != NULL)
+        buf.reserve(1 << 20);
+}
+
+sys_sage::XmlStreamWriter::~XmlStreamWriter()
+{
+    Flush();
+    if(nodeDoc != nullptr)
+        xmlFreeDoc(nodeDoc);
+}
+
+int sys_sage::XmlStreamWriter::Flush()
+{
+    if(out == NULL)
+        return writeError ? 1 : 0;
+    if(!buf.empty() && fwrite(buf.data(), 1, buf.size(), out) != buf.size())
+        writeError = true;
+    buf.clear();
+    return writeError ? 1 : 0;
+}
+
+std::string sys_sage::XmlStreamWriter::TakeOutput()
+{
+    _CloseStartTag();
+    std::string ret = std::move(buf);
+    buf.clear();
+    return ret;
+}
+
+void sys_sage::XmlStreamWriter::WriteRaw(std::string_view xml)
+{
+    _CloseStartTag();
+    if(out != NULL && buf.size() + xml.size() >= (1 << 20))
+    {
+        //large chunks go to the file directly instead of through the buffer
+        Flush();
+        if(fwrite(xml.data(), 1, xml.size(), out) != xml.size())
+            writeError = true;
+    }
+    else
+        buf += xml;
+}
+
+void sys_sage::XmlStreamWriter::WriteRawElement(std::string_view xml)
+{
+    _CloseStartTag();
+    //re-indent the lines: the least indented line after the first (normally the end tag) gets the indentation of the first one, the others keep their relative indentation
+    size_t base = std::string_view::npos;
+    for(size_t pos = xml.find('\n'); pos != std::string_view::npos; pos = xml.find('\n', pos + 1))
+    {
+        size_t text = xml.find_first_not_of(" \t", pos + 1);
+        if(text != std::string_view::npos && xml[text] != '\n')
+            base = std::min(base, text - pos - 1);
+    }
+    for(size_t start = 0; start < xml.size(); )
+    {
+        size_t end = std::min(xml.find('\n', start), xml.size());
+        std::string_view line = xml.substr(start, end - start);
+        if(start > 0)
+            line.remove_prefix(std::min({base, line.find_first_not_of(" \t"), line.size()}));
+        if(!line.empty())
+        {
+            _Indent(GetLevel());
+            buf += line;
+        }
+        buf += '\n';
+        start = end + 1;
+    }
+}
+
+void sys_sage::XmlStreamWriter::StartDocument() { buf += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"; }
+
+void sys_sage::XmlStreamWriter::_Indent(size_t level) { buf.append(2 * std::min(level, maxIndentLevel), ' '); }
+
+void sys_sage::XmlStreamWriter::_CloseStartTag()
+{
+    if(startTagOpen)
+    {
+        buf += ">\n";
+        startTagOpen = false;
+    }
+}
+
+void sys_sage::XmlStreamWriter::StartElement(std::string_view name)
+{
+    _CloseStartTag();
+    if(buf.size() >= (1 << 20))
+        Flush();
+    _Indent(GetLevel());
+    buf += '<';
+    buf += name;
+    openElements.emplace_back(name);
+    startTagOpen = true;
+}
+
+void sys_sage::XmlStreamWriter::WriteAttribute(std::string_view name, std::string_view value)
+{
+    buf += ' ';
+    buf += name;
+    buf += "=\"";
+    //like libxml2, which gets C strings: the value ends at the first NUL character
+    value = value.substr(0, value.find('\0'));
+    //the same escaping as libxml2 applies to attribute values
+    size_t plain = 0;
+    for(size_t i = 0; i < value.size(); i++)
+    {
+        const char* esc;
+        switch(value[i])
+        {
+            case '<': esc = "&lt;"; break;
+            case '>': esc = "&gt;"; break;
+            case '&': esc = "&amp;"; break;
+            case '"': esc = "&quot;"; break;
+            case '\n': esc = "&#10;"; break;
+            case '\r': esc = "&#13;"; break;
+            case '\t': esc = "&#9;"; break;
+            default: continue;
+        }
+        buf.append(value.data() + plain, i - plain);
+        buf += esc;
+        plain = i + 1;
+    }
+    buf.append(value.data() + plain, value.size() - plain);
+    buf += '"';
+}
+
+void sys_sage::XmlStreamWriter::_WriteRawAttribute(std::string_view name, std::string_view value)
+{
+    buf += ' ';
+    buf += name;
+    buf += "=\"";
+    buf += value;
+    buf += '"';
+}
+
+void sys_sage::XmlStreamWriter::EndElement()
+{
+    if(startTagOpen)
+    {
+        buf += "/>\n";
+        startTagOpen = false;
+    }
+    else
+    {
+        _Indent(GetLevel() - 1);
+        buf += "</";
+        buf += openElements.back();
+        buf += ">\n";
+    }
+    openElements.pop_back();
+}
+
+void sys_sage::XmlStreamWriter::WriteNode(xmlNodePtr n)
+{
+    _CloseStartTag();
+    _Indent(GetLevel());
+    xmlBufferPtr nodeBuf = xmlBufferCreate();
+    xmlOutputBufferPtr nodeOut = xmlOutputBufferCreateBuffer(nodeBuf, NULL);
+    //with UTF-8 output encoding, non-ASCII characters are written as they are (not as character references)
+    xmlNodeDumpOutput(nodeOut, n->doc, n, GetLevel(), 1, "UTF-8");
+    xmlOutputBufferClose(nodeOut);
+    buf.append(reinterpret_cast<const char*>(xmlBufferContent(nodeBuf)), xmlBufferLength(nodeBuf));
+    buf += '\n';
+    xmlBufferFree(nodeBuf);
+}
+
+xmlDocPtr sys_sage::XmlStreamWriter::GetNodeDocument()
+{
+    if(nodeDoc == nullptr)
+    {
+        //attribute values of nodes in a UTF-8 document are serialized as they are (not as character references), like in the exported document
+        nodeDoc = xmlNewDoc(BAD_CAST "1.0");
+        nodeDoc->encoding = xmlStrdup(BAD_CAST "UTF-8");
+    }
+    return nodeDoc;
+}
+
+void sys_sage::XmlStreamWriter::AppendAddress(std::string* s, const void* p)
+{
+    uintptr_t v = reinterpret_cast<uintptr_t>(p);
+    if(v == 0)
+    {
+        *s += '0';
+        return;
+    }
+    char tmp[2 * sizeof(uintptr_t)];
+    char* end = std::to_chars(tmp, tmp + sizeof(tmp), v, 16).ptr;
+    *s += "0x";
+    s->append(tmp, end - tmp);
+}
+
+//formats a value of a simple attribute type as a string to be printed in the xml
+//returns 1 if the type is a simple one, 0 otherwise (complex or custom types)
+static int _attrib_value_to_string(sys_sage::AttributeType::type type, const void* value, std::string* ret_value_str)
+{
+    switch(type)
+    {
+        case sys_sage::AttributeType::Int:
+            *ret_value_str=std::to_string(*(const int*)value);
+            return 1;
+        case sys_sage::AttributeType::LongLong:
+            *ret_value_str=std::to_string(*(const long long*)value);
+            return 1;
+        case sys_sage::AttributeType::UInt64:
+            *ret_value_str=std::to_string(*(const uint64_t*)value);
+            return 1;
+        case sys_sage::AttributeType::Float:
+            *ret_value_str=std::to_string(*(const float*)value);
+            return 1;
+        case sys_sage::AttributeType::Double:
+            *ret_value_str=std::to_string(*(const double*)value);
+            return 1;
+        case sys_sage::AttributeType::String:
+            *ret_value_str=*(const std::string*)value;
+            return 1;
+    }
+    return 0;
+}
+
+static bool _is_simple_attrib_type(sys_sage::AttributeType::type type)
+{
+    switch(type)
+    {
+        case sys_sage::AttributeType::Int:
+        case sys_sage::AttributeType::LongLong:
+        case sys_sage::AttributeType::UInt64:
+        case sys_sage::AttributeType::Float:
+        case sys_sage::AttributeType::Double:
+        case sys_sage::AttributeType::String:
+            return true;
+    }
+    return false;
+}
+
+//writes a value of a simple attribute type as the value of the "value" XML attribute
+//returns 1 if the type is a simple one, 0 otherwise (complex or custom types)
+static int _write_attrib_value(sys_sage::AttributeType::type type, const void* value, sys_sage::XmlStreamWriter* w)
+{
+    switch(type)
+    {
+        case sys_sage::AttributeType::Int: w->WriteAttribute("value", *(const int*)value); return 1;
+        case sys_sage::AttributeType::LongLong: w->WriteAttribute("value", *(const long long*)value); return 1;
+        case sys_sage::AttributeType::UInt64: w->WriteAttribute("value", *(const uint64_t*)value); return 1;
+        case sys_sage::AttributeType::Float: w->WriteAttribute("value", *(const float*)value); return 1;
+        case sys_sage::AttributeType::Double: w->WriteAttribute("value", *(const double*)value); return 1;
+        case sys_sage::AttributeType::String: w->WriteAttribute("value", *(const std::string*)value); return 1;
+    }
+    return 0;
+}
+
+//value: std::vector<std::tuple<long long,double>>*
+static void _print_frequency_history(const std::string& key, const sys_sage::FrequencyHistory* val, xmlNodePtr n)
+{
+    xmlNodePtr attrib_node = xmlNewNode(NULL, (const unsigned char *)"Attribute");
+    xmlNewProp(attrib_node, (const unsigned char *)"name", (const unsigned char *)key.c_str());
+    xmlAddChild(n, attrib_node);
+    for(auto [ ts,freq ] : *val)
+    {
+        xmlNodePtr attrib = xmlNewNode(NULL, (const unsigned char *)key.c_str());
+        xmlNewProp(attrib, (const unsigned char *)"timestamp", (const unsigned char *)std::to_string(ts).c_str());
+        xmlNewProp(attrib, (const unsigned char *)"frequency", (const unsigned char *)std::to_string(freq).c_str());
+        xmlNewProp(attrib, (const unsigned char *)"unit", (const unsigned char *)"MHz");
+        xmlAddChild(attrib_node, attrib);
+    }
+}
+
+static void _print_frequency_history(const std::string& key, const sys_sage::FrequencyHistory* val, sys_sage::XmlStreamWriter* w)
+{
+    w->StartElement("Attribute");
+    w->WriteAttribute("name", key);
+    for(auto [ ts,freq ] : *val)
+    {
+        w->StartElement(key);
+        w->WriteAttribute("timestamp", ts);
+        w->WriteAttribute("frequency", freq);
+        w->WriteAttribute("unit", "MHz");
+        w->EndElement();
+    }
+    w->EndElement();
+}
 
 //methods for printing out default attributes, i.e. those 
 //for a specific key, return the value as a string to be printed in the xml
 int sys_sage::_search_default_attrib_key(std::string key, void* value, std::string* ret_value_str)
 {
-    //value: uint64_t 
-    if(!key.compare("CATcos") || 
-    !key.compare("CATL3mask") )
+    //the predefined keys have a fixed value type -> one hash lookup instead of comparing against every known key
+    return _attrib_value_to_string(AttributeKey::GetBuiltinType(AttributeKey::Find(key)), value, ret_value_str);
+}
+
+int sys_sage::_search_default_complex_attrib_key(std::string key, void* value, xmlNodePtr n)
+{
+    if(AttributeKey::GetBuiltinType(AttributeKey::Find(key)) == AttributeType::FrequencyHistory)
     {
-        *ret_value_str=std::to_string(*(uint64_t*)value);
+        _print_frequency_history(key, (FrequencyHistory*)value, n);
         return 1;
     }
-    //value: long long
-    else if(!key.compare("mig_size") )
+    return 0;
+}
+
+//prints one attribute: custom functions first, then the default handling based on the value type
+static void _print_one_attrib(const std::string& key, void* val, sys_sage::AttributeType::type type, sys_sage::XmlStreamWriter* w)
+{
+    //a lazily imported attribute is written as it was read
+    if(type == sys_sage::AttributeType::Lazy)
     {
-        *ret_value_str=std::to_string(*(long long*)value);
-        return 1;
+        w->WriteRawElement(static_cast<const sys_sage::LazyAttribute*>(val)->payload);
+        return;
     }
-    //value: int
-    else if(!key.compare("Number_of_streaming_multiprocessors") || 
-    !key.compare("Number_of_cores_in_GPU") || 
-    !key.compare("Number_of_cores_per_SM")  || 
-    !key.compare("Bus_Width_bit") )
+    std::string attrib_value;
+    int ret = 0;
+    const sys_sage::XmlExportContext* ctx = w->context;
+    if(ctx != nullptr && ctx->customAttribFcn != NULL)
+        ret=ctx->customAttribFcn(key,val,&attrib_value);
+
+    if(ret==1)//attrib found
     {
-        *ret_value_str=std::to_string(*(int*)value);
-        return 1;
+        w->StartElement("Attribute");
+        w->WriteAttribute("name", key);
+        w->WriteAttribute("value", attrib_value);
+        w->EndElement();
+        return;
     }
-    //value: double
-    else if(!key.compare("Clock_Frequency") || !key.compare("GPU_Clock_Rate") )
+    if(ret==0 && _is_simple_attrib_type(type))
     {
-        *ret_value_str=std::to_string(*(double*)value);
-        return 1;
+        w->StartElement("Attribute");
+        w->WriteAttribute("name", key);
+        _write_attrib_value(type, val, w);
+        w->EndElement();
+        return;
     }
-    //value: float
-    else if(!key.compare("latency") ||
-    !key.compare("latency_min") ||
-    !key.compare("latency_max") )
+
+    if(ret == 0 && ctx != nullptr && ctx->customComplexAttribFcn != NULL) //try looking in search_custom_complex_attrib_key
     {
-        *ret_value_str=std::to_string(*(float*)value);
+        //the custom function appends its nodes to a stand-in for the component/relation node
+        xmlNodePtr n = xmlNewDocNode(w->GetNodeDocument(), NULL, BAD_CAST "tmp", NULL);
+        ret=ctx->customComplexAttribFcn(key,val,n);
+        for(xmlNodePtr child = n->children; child != NULL; child = child->next)
+            w->WriteNode(child);
+        xmlFreeNode(n);
+    }
+    if(ret==0 && type == sys_sage::AttributeType::FrequencyHistory)
+        _print_frequency_history(key, (sys_sage::FrequencyHistory*)val, w);
+}
+
+int sys_sage::_print_attrib(const AttributeStore* attributes, XmlStreamWriter* w)
+{
+    if(attributes == nullptr)
         return 1;
-    }   
-    //value: string
-    else if(!key.compare("CUDA_compute_capability") || 
-    !key.compare("mig_uuid") )
+    for(const AttributeStore::Entry& e : attributes->GetEntries())
     {
-        *ret_value_str=*(std::string*)value;
-        return 1;
+        const std::string& key = AttributeKey::GetName(e.key);
+        if(w->filter == nullptr || w->filter->IncludesAttribute(key))
+            _print_one_attrib(key, const_cast<void*>(e.Get()), e.type, w);
     }
+    return 1;
+}
 
-    return 0;
+int sys_sage::_print_attrib(const std::map<std::string,void*>& attrib, XmlStreamWriter* w)
+{
+    for (auto const& [key, val] : attrib)
+        if(w->filter == nullptr || w->filter->IncludesAttribute(key))
+            _print_one_attrib(key, val, AttributeKey::GetBuiltinType(AttributeKey::Find(key)), w);
+    return 1;
 }
 
-int sys_sage::_search_default_complex_attrib_key(std::string key, void* value, xmlNodePtr n)
+//writes c (at depth w->depth below the export root) if its type passes the filter of the export; otherwise, its children are written in its place
+static void _write_filtered(sys_sage::Component* c, sys_sage::XmlStreamWriter* w)
 {
-    //value: std::vector<std::tuple<long long,double>>*
-    if(!key.compare("freq_history"))
+    const sys_sage::XmlExportFilter* f = w->filter;
+    if(f == nullptr || sys_sage::ComponentType::InMask(c->GetComponentType(), f->componentTypes))
     {
-        std::vector<std::tuple<long long,double>>* val = (std::vector<std::tuple<long long,double>>*)value;
+        c->_WriteXml(w);
+        return;
+    }
+    if(f->maxDepth >= 0 && w->depth >= f->maxDepth)
+        return;
+    w->depth++;
+    for(sys_sage::Component* child : c->GetChildren())
+        _write_filtered(child, w);
+    w->depth--;
+}
 
-        xmlNodePtr attrib_node = xmlNewNode(NULL, (const unsigned char *)"Attribute");
-        xmlNewProp(attrib_node, (const unsigned char *)"name", (const unsigned char *)key.c_str());
-        xmlAddChild(n, attrib_node);
-        for(auto [ ts,freq ] : *val)
-        {
-            xmlNodePtr attrib = xmlNewNode(NULL, (const unsigned char *)key.c_str());
-            xmlNewProp(attrib, (const unsigned char *)"timestamp", (const unsigned char *)std::to_string(ts).c_str());
-            xmlNewProp(attrib, (const unsigned char *)"frequency", (const unsigned char *)std::to_string(freq).c_str());
-            xmlNewProp(attrib, (const unsigned char *)"unit", (const unsigned char *)"MHz");
-            xmlAddChild(attrib_node, attrib);
-        }
-        return 1;
+bool sys_sage::XmlExportFilter::IncludesComponent(const Component* c, const Component* root) const
+{
+    if(c != root && !ComponentType::InMask(c->GetComponentType(), componentTypes))
+        return false;
+    int d = 0;
+    for(const Component* a = c; a != root; a = a->GetParent(), d++)
+    {
+        if(a == nullptr)
+            return false; //not in the subtree of root
     }
-    //value: std::tuple<double, std::string>
-    //else if(!key.compare("GPU_Clock_Rate"))
-    //{
-    //    xmlNodePtr attrib_node = xmlNewNode(NULL, (const unsigned char *)"Attribute");
-    //    xmlNewProp(attrib_node, (const unsigned char *)"name", (const unsigned char *)key.c_str());
-    //    xmlAddChild(n, attrib_node);
-
-    //    auto [ freq, unit ] = *(std::tuple<double, std::string>*)value;
-    //    xmlNodePtr attrib = xmlNewNode(NULL, (const unsigned char *)key.c_str());
-    //    xmlNewProp(attrib, (const unsigned char *)"frequency", (const unsigned char *)std::to_string(freq).c_str());
-    //    xmlNewProp(attrib, (const unsigned char *)"unit", (const unsigned char *)unit.c_str());
-    //    xmlAddChild(attrib_node, attrib);
-    //    return 1;
-    //}
+    return maxDepth < 0 || d <= maxDepth;
+}
 
-    return 0;
+//below this number of components, the buffering of a parallel export costs more than the threads save
+static constexpr size_t _parallelExportMinComponents = 4096;
+
+//true if the subtree of root has fewer than n components (stops counting at n)
+static bool _is_smaller_than(sys_sage::Component* root, size_t n)
+{
+    size_t count = 0;
+    for([[maybe_unused]] sys_sage::Component* c : root->PreOrder())
+    {
+        if(++count >= n)
+            return false;
+    }
+    return true;
 }
 
-int sys_sage::_print_attrib(std::map<std::string,void*> attrib, xmlNodePtr n)
+//writes the subtrees of the components in parallel (see exportToXml(): parallelism)
+//each worker writes whole subtrees and their Relations into in-memory writers; the results are then written in the order of the components, so that the output is the same as that of a serial export
+static void _write_subtrees_parallel(const std::vector<sys_sage::Component*>& subtrees, unsigned parallelism, sys_sage::XmlStreamWriter* w)
 {
-    std::string attrib_value;
-    for (auto const& [key, val] : attrib){
-        int ret = 0;
-        if(store_custom_attrib_fcn != NULL)
-            ret=store_custom_attrib_fcn(key,val,&attrib_value);
-        if(ret==0)
-            ret = _search_default_attrib_key(key,val,&attrib_value);
-
-        if(ret==1)//attrib found
+    using sys_sage::XmlStreamWriter;
+    struct SubtreeOutput {
+        std::string components;
+        std::string relations;
+        size_t numComponents = 0;
+    };
+    std::vector<SubtreeOutput> outputs(subtrees.size());
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::atomic<bool> failed{false};
+    size_t level = w->GetLevel();
+    auto worker = [&]() {
+        try
         {
-            xmlNodePtr attrib_node = xmlNewNode(NULL, (const unsigned char *)"Attribute");
-            xmlNewProp(attrib_node, (const unsigned char *)"name", (const unsigned char *)key.c_str());
-            xmlNewProp(attrib_node, (const unsigned char *)"value", (const unsigned char *)attrib_value.c_str());
-            xmlAddChild(n, attrib_node);
-            continue;
+            for(size_t i = next++; i < subtrees.size() && !failed; i = next++)
+            {
+                XmlStreamWriter cw(NULL, level);
+                cw.context = w->context;
+                cw.filter = w->filter;
+                cw.exportRoot = w->exportRoot;
+                cw.depth = w->depth;
+                _write_filtered(subtrees[i], &cw);
+                //Relations are written into <sys-sage><Relations>
+                XmlStreamWriter rw(NULL, 2);
+                rw.context = w->context;
+                rw.filter = w->filter;
+                for(sys_sage::Relation* r : cw.relations)
+                    r->_WriteXmlEntry(&rw);
+                outputs[i].components = cw.TakeOutput();
+                outputs[i].relations = rw.TakeOutput();
+                outputs[i].numComponents = cw.numComponents;
+            }
         }
-
-        if(ret == 0 && store_custom_complex_attrib_fcn != NULL) //try looking in search_custom_complex_attrib_key
-            ret=store_custom_complex_attrib_fcn(key,val,n);
-        if(ret==0)
-            ret = _search_default_complex_attrib_key(key,val,n);
+        catch(...)
+        {
+            //only the first exception is kept; it is rethrown after all workers finished
+            if(!failed.exchange(true))
+                error = std::current_exception();
+        }
+    };
+
+    size_t numThreads = std::min<size_t>(parallelism, subtrees.size());
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    for(size_t t = 1; t < numThreads; t++)
+        threads.emplace_back(worker);
+    worker();
+    for(std::thread& t : threads)
+        t.join();
+    if(error)
+        std::rethrow_exception(error);
+
+    for(SubtreeOutput& o : outputs)
+    {
+        w->WriteRaw(o.components);
+        std::string().swap(o.components);
+        w->numComponents += o.numComponents;
+        if(!o.relations.empty())
+            w->relationOutput.push_back(std::move(o.relations));
     }
-
-    return 1;
 }
 
-xmlNodePtr sys_sage::Memory::_CreateXmlSubtree()
+void sys_sage::Memory::_WriteXml(XmlStreamWriter* w)
 {
-    xmlNodePtr n = Component::_CreateXmlSubtree();
+    _WriteXmlStart(w);
     if(size > 0)
-        xmlNewProp(n, (const unsigned char *)"size", (const unsigned char *)(std::to_string(size)).c_str());
-    xmlNewProp(n, (const unsigned char *)"is_volatile", (const unsigned char *)(std::to_string(is_volatile?1:0)).c_str());
-    return n;
+        w->WriteAttribute("size", size);
+    w->WriteAttribute("is_volatile", is_volatile?1:0);
+    _WriteXmlContent(w);
+    w->EndElement();
 }
-xmlNodePtr sys_sage::Storage::_CreateXmlSubtree()
+void sys_sage::Storage::_WriteXml(XmlStreamWriter* w)
 {
-    xmlNodePtr n = Component::_CreateXmlSubtree();
+    _WriteXmlStart(w);
     if(size > 0)
-        xmlNewProp(n, (const unsigned char *)"size", (const unsigned char *)(std::to_string(size)).c_str());
-    return n;
+        w->WriteAttribute("size", size);
+    _WriteXmlContent(w);
+    w->EndElement();
 }
-xmlNodePtr sys_sage::Chip::_CreateXmlSubtree()
+void sys_sage::Chip::_WriteXml(XmlStreamWriter* w)
 {
-    xmlNodePtr n = Component::_CreateXmlSubtree();
+    _WriteXmlStart(w);
     if(!vendor.empty())
-        xmlNewProp(n, (const unsigned char *)"vendor", (const unsigned char *)(vendor.c_str()));
+        w->WriteAttribute("vendor", vendor);
     if(!model.empty())
-        xmlNewProp(n, (const unsigned char *)"model", (const unsigned char *)(model.c_str()));
-    xmlNewProp(n, (const unsigned char *)"type", (const unsigned char *)(std::to_string(type).c_str()));
-    return n;
+        w->WriteAttribute("model", model);
+    w->WriteAttribute("type", type);
+    _WriteXmlContent(w);
+    w->EndElement();
 }
-xmlNodePtr sys_sage::Cache::_CreateXmlSubtree()
+void sys_sage::Cache::_WriteXml(XmlStreamWriter* w)
 {
-    xmlNodePtr n = Component::_CreateXmlSubtree();
-    xmlNewProp(n, (const unsigned char *)"cache_type", (const unsigned char *)cache_type.c_str());
+    _WriteXmlStart(w);
+    w->WriteAttribute("cache_type", cache_type);
     if(cache_size >= 0)
-        xmlNewProp(n, (const unsigned char *)"cache_size", (const unsigned char *)(std::to_string(cache_size)).c_str());
+        w->WriteAttribute("cache_size", cache_size);
     if(cache_associativity_ways >= 0)
-        xmlNewProp(n, (const unsigned char *)"cache_associativity_ways", (const unsigned char *)(std::to_string(cache_associativity_ways)).c_str());
+        w->WriteAttribute("cache_associativity_ways", cache_associativity_ways);
     if(cache_line_size >= 0)
-        xmlNewProp(n, (const unsigned char *)"cache_line_size", (const unsigned char *)(std::to_string(cache_line_size)).c_str());
-    return n;
+        w->WriteAttribute("cache_line_size", cache_line_size);
+    _WriteXmlContent(w);
+    w->EndElement();
 }
-xmlNodePtr sys_sage::Subdivision::_CreateXmlSubtree()
+void sys_sage::Subdivision::_WriteXml(XmlStreamWriter* w)
 {
-    xmlNodePtr n = Component::_CreateXmlSubtree();
-    xmlNewProp(n, (const unsigned char *)"subdivision_type", (const unsigned char *)(std::to_string(type)).c_str());
-    return n;
+    _WriteXmlStart(w);
+    w->WriteAttribute("subdivision_type", type);
+    _WriteXmlContent(w);
+    w->EndElement();
 }
-xmlNodePtr sys_sage::Numa::_CreateXmlSubtree()
+void sys_sage::Numa::_WriteXml(XmlStreamWriter* w)
 {
-    xmlNodePtr n = Component::_CreateXmlSubtree();
+    _WriteXmlStart(w);
     if(size > 0)
-        xmlNewProp(n, (const unsigned char *)"size", (const unsigned char *)(std::to_string(size)).c_str());
-    return n;
+        w->WriteAttribute("size", size);
+    _WriteXmlContent(w);
+    w->EndElement();
 }
-xmlNodePtr sys_sage::Qubit::_CreateXmlSubtree()
+void sys_sage::Qubit::_WriteXml(XmlStreamWriter* w)
 {
-    xmlNodePtr n = Component::_CreateXmlSubtree();
-    xmlNewProp(n, (const unsigned char *)"q1_fidelity", (const unsigned char *)(std::to_string(q1_fidelity)).c_str());
-    xmlNewProp(n, (const unsigned char *)"t1", (const unsigned char *)(std::to_string(t1)).c_str());
-    xmlNewProp(n, (const unsigned char *)"t2", (const unsigned char *)(std::to_string(t2)).c_str());
-    xmlNewProp(n, (const unsigned char *)"readout_fidelity", (const unsigned char *)(std::to_string(readout_fidelity)).c_str());
-    xmlNewProp(n, (const unsigned char *)"readout_length", (const unsigned char *)(std::to_string(readout_length)).c_str());
-    xmlNewProp(n, (const unsigned char *)"frequency", (const unsigned char *)(std::to_string(frequency)).c_str());
-    xmlNewProp(n, (const unsigned char *)"calibration_time", (const unsigned char *)(calibration_time).c_str());
-    return n;
+    _WriteXmlStart(w);
+    w->WriteAttribute("q1_fidelity", q1_fidelity);
+    w->WriteAttribute("t1", t1);
+    w->WriteAttribute("t2", t2);
+    w->WriteAttribute("readout_fidelity", readout_fidelity);
+    w->WriteAttribute("readout_length", readout_length);
+    w->WriteAttribute("frequency", frequency);
+    w->WriteAttribute("calibration_time", calibration_time);
+    _WriteXmlContent(w);
+    w->EndElement();
 }
-xmlNodePtr sys_sage::QuantumBackend::_CreateXmlSubtree()
+void sys_sage::QuantumBackend::_WriteXml(XmlStreamWriter* w)
 {
     //SVTODO deal with gate_types -- can this go into Relations?
-    xmlNodePtr n = Component::_CreateXmlSubtree();
-    xmlNewProp(n, (const unsigned char *)"num_qubits", (const unsigned char *)(std::to_string(num_qubits)).c_str());
-    // if(gate_types.size() > 0)
-    // {
-    //     xmlNodePtr xml_gt = xmlNewNode(NULL, (const unsigned char *)"gateTypes");
-    //     xmlAddChild(n, xml_gt);
-    //     for(QuantumGate* : gate_types)
-    //     {
-    //         xmlNodePtr attrib = xmlNewNode(NULL, (const unsigned char *)key.c_str());
-    //         xmlNewProp(attrib, (const unsigned char *)"timestamp", (const unsigned char *)std::to_string(ts).c_str());
-    //         xmlNewProp(attrib, (const unsigned char *)"frequency", (const unsigned char *)std::to_string(freq).c_str());
-    //         xmlNewProp(attrib, (const unsigned char *)"unit", (const unsigned char *)"MHz");
-    //         xmlAddChild(xml_gt, attrib);
-    //     }
-    // }
-
-    return n;
-}
-xmlNodePtr sys_sage::AtomSite::_CreateXmlSubtree()
-{
-    xmlNodePtr n = Component::_CreateXmlSubtree();
-    
-    xmlNodePtr xml_siteprops = xmlNewNode(NULL, (const unsigned char *)"SiteProperties");
-    xmlNewProp(xml_siteprops, (const unsigned char *)"nRows", (const unsigned char *)(std::to_string(properties.nRows)).c_str());
-    xmlNewProp(xml_siteprops, (const unsigned char *)"nColumns", (const unsigned char *)(std::to_string(properties.nColumns)).c_str());
-    xmlNewProp(xml_siteprops, (const unsigned char *)"nAods", (const unsigned char *)(std::to_string(properties.nAods)).c_str());
-    xmlNewProp(xml_siteprops, (const unsigned char *)"nAodIntermediateLevels", (const unsigned char *)(std::to_string(properties.nAodIntermediateLevels)).c_str());
-    xmlNewProp(xml_siteprops, (const unsigned char *)"nAodCoordinates", (const unsigned char *)(std::to_string(properties.nAodCoordinates)).c_str());
-    xmlNewProp(xml_siteprops, (const unsigned char *)"interQubitDistance", (const unsigned char *)(std::to_string(properties.interQubitDistance)).c_str());
-    xmlNewProp(xml_siteprops, (const unsigned char *)"interactionRadius", (const unsigned char *)(std::to_string(properties.interactionRadius)).c_str());
-    xmlNewProp(xml_siteprops, (const unsigned char *)"blockingFactor", (const unsigned char *)(std::to_string(properties.blockingFactor)).c_str());
-    xmlAddChild(n, xml_siteprops);
+    _WriteXmlStart(w);
+    w->WriteAttribute("num_qubits", num_qubits);
+    _WriteXmlContent(w);
+    w->EndElement();
+}
+void sys_sage::AtomSite::_WriteXml(XmlStreamWriter* w)
+{
+    _WriteXmlStart(w);
+    _WriteXmlContent(w);
+
+    w->StartElement("SiteProperties");
+    w->WriteAttribute("nRows", properties.nRows);
+    w->WriteAttribute("nColumns", properties.nColumns);
+    w->WriteAttribute("nAods", properties.nAods);
+    w->WriteAttribute("nAodIntermediateLevels", properties.nAodIntermediateLevels);
+    w->WriteAttribute("nAodCoordinates", properties.nAodCoordinates);
+    w->WriteAttribute("interQubitDistance", properties.interQubitDistance);
+    w->WriteAttribute("interactionRadius", properties.interactionRadius);
+    w->WriteAttribute("blockingFactor", properties.blockingFactor);
+    w->EndElement();
 
     //SVTODO handle shuttlingTimes, shuttlingAverageFidelities
 
-    return n;
+    w->EndElement();
 }
-xmlNodePtr sys_sage::Component::_CreateXmlSubtree()
+void sys_sage::Component::_WriteXml(XmlStreamWriter* w)
 {
-    xmlNodePtr n = xmlNewNode(NULL, (const unsigned char *)GetComponentTypeStr().c_str());
-    xmlNewProp(n, (const unsigned char *)"id", (const unsigned char *)(std::to_string(id)).c_str());
-    xmlNewProp(n, (const unsigned char *)"name", (const unsigned char *)name.c_str());
-    if(count > 0)
-        xmlNewProp(n, (const unsigned char *)"count", (const unsigned char *)(std::to_string(count)).c_str());
-    std::ostringstream addr;
-    addr << this;
-    xmlNewProp(n, (const unsigned char *)"addr", (const unsigned char *)(addr.str().c_str()));
-
-    _print_attrib(attrib, n);
+    _WriteXmlStart(w);
+    _WriteXmlContent(w);
+    w->EndElement();
+}
 
-    for(Component * c : children)
+void sys_sage::Component::_WriteXmlStart(XmlStreamWriter* w)
+{
+    w->StartElement(GetComponentTypeStr());
+    w->WriteAttribute("id", id);
+    w->WriteAttribute("name", name);
+    if(count > 0)
+        w->WriteAttribute("count", count);
+    std::string addr;
+    XmlStreamWriter::AppendAddress(&addr, this);
+    w->WriteAttribute("addr", addr);
+    if(w->shallow && parent != NULL)
     {
-        xmlNodePtr child = _buildComponentSubtree(c);
-        xmlAddChild(n, child);
+        addr.clear();
+        XmlStreamWriter::AppendAddress(&addr, parent);
+        w->WriteAttribute("parent", addr);
     }
-
-    return n;
 }
 
-xmlNodePtr sys_sage::_buildComponentSubtree(Component* c)
+void sys_sage::Component::_WriteXmlContent(XmlStreamWriter* w)
 {
-    switch(c->GetComponentType()) //not all necessarily have their specific implementation; if not, it will just call the default Component->_CreateXmlSubtree 
+    w->numComponents++;
+    _print_attrib(GetAttributes(), w);
+    _print_attrib(attrib, w);
+    if(w->shallow)
+        return;
+
+    //collect the Relations in the same pass; they are written after the component tree
+    const XmlExportFilter* f = w->filter;
+    for(RelationType::type rt : RelationType::RelationTypeList)
     {
-        case ComponentType::None:
-            return reinterpret_cast<Component*>(c)->_CreateXmlSubtree();
-        case ComponentType::Thread:
-            return reinterpret_cast<Thread*>(c)->_CreateXmlSubtree();
-        case ComponentType::Core:
-            return reinterpret_cast<Core*>(c)->_CreateXmlSubtree();
-        case ComponentType::Cache:
-            return reinterpret_cast<Cache*>(c)->_CreateXmlSubtree();
-        case ComponentType::Subdivision:
-            return reinterpret_cast<Subdivision*>(c)->_CreateXmlSubtree();
-        case ComponentType::Numa:
-            return reinterpret_cast<Numa*>(c)->_CreateXmlSubtree();
-        case ComponentType::Chip:
-            return reinterpret_cast<Chip*>(c)->_CreateXmlSubtree();
-        case ComponentType::Memory:
-            return reinterpret_cast<Memory*>(c)->_CreateXmlSubtree();
-        case ComponentType::Storage:
-            return reinterpret_cast<Storage*>(c)->_CreateXmlSubtree();
-        case ComponentType::Node:
-            return reinterpret_cast<Node*>(c)->_CreateXmlSubtree();
-        case ComponentType::QuantumBackend:
-            return reinterpret_cast<QuantumBackend*>(c)->_CreateXmlSubtree();
-        case ComponentType::Qubit:
-            return reinterpret_cast<Qubit*>(c)->_CreateXmlSubtree();
-        case ComponentType::AtomSite:
-            return reinterpret_cast<AtomSite*>(c)->_CreateXmlSubtree();
-        case ComponentType::Topology:
-            return reinterpret_cast<Topology*>(c)->_CreateXmlSubtree();
-        default:
-            std::cerr << "ERROR: sys_sage::_buildComponentSubtree -- unknown Component Type" << std::endl;
-            return NULL;
+        if(f != nullptr && !RelationType::InMask(rt, f->relationTypes))
+            continue;
+        const std::vector<Relation*>& rList = GetRelations(rt);
+        for(size_t i = 0; i < rList.size(); i++)
+        {
+            Relation* r = rList[i];
+            //print only at the first component's own link (back-index of position 0) => print each Relation once only
+            if(r->GetComponent(0) != this || r->_GetComponentSlot(0) != static_cast<int32_t>(i))
+                continue;
+            if(f != nullptr && f->internalRelationsOnly)
+            {
+                const std::vector<Component*>& rc = r->GetComponents();
+                if(!std::all_of(rc.begin() + 1, rc.end(), [&](const Component* c) { return f->IncludesComponent(c, w->exportRoot); }))
+                    continue;
+            }
+            w->relations.push_back(r);
+        }
     }
-    return NULL;
-}
 
+    if(f != nullptr && f->maxDepth >= 0 && w->depth >= f->maxDepth)
+        return;
+    w->depth++;
+    if(this == w->parallelRoot && w->context != nullptr && children.size() > 1)
+    {
+        //more threads than cores only add the cost of the buffers; with automatic parallelism, small trees are written serially, too
+        unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+        unsigned parallelism = w->context->parallelism == 0 ? cores : w->context->_limitParallelismToCores ? std::min(w->context->parallelism, cores) : w->context->parallelism;
+        if(parallelism > 1 && (w->context->parallelism != 0 || !_is_smaller_than(this, _parallelExportMinComponents)))
+        {
+            _write_subtrees_parallel(children, parallelism, w);
+            w->depth--;
+            return;
+        }
+    }
+    for(Component * c : children)
+        _write_filtered(c, w);
+    w->depth--;
+}
 
-xmlNodePtr sys_sage::DataPath::_CreateXmlEntry()
+void sys_sage::DataPath::_WriteXmlEntry(XmlStreamWriter* w)
 {
-    xmlNodePtr r_xml = Relation::_CreateXmlEntry();
-
-    xmlNewProp(r_xml, (const unsigned char *)"DataPathType", (const unsigned char *)(std::to_string(dp_type)).c_str());
-    xmlNewProp(r_xml, (const unsigned char *)"bw", (const unsigned char *)(std::to_string(bw)).c_str());
-    xmlNewProp(r_xml, (const unsigned char *)"latency", (const unsigned char *)(std::to_string(latency)).c_str());
-    return r_xml;
+    _WriteXmlEntryStart(w);
+    w->WriteAttribute("DataPathType", dp_type);
+    w->WriteAttribute("bw", bw);
+    w->WriteAttribute("latency", latency);
+    _WriteXmlEntryContent(w);
+    w->EndElement();
 }
-xmlNodePtr sys_sage::QuantumGate::_CreateXmlEntry()
+void sys_sage::QuantumGate::_WriteXmlEntry(XmlStreamWriter* w)
 {
-    xmlNodePtr r_xml = Relation::_CreateXmlEntry();
-
-    xmlNewProp(r_xml, (const unsigned char *)"gate_size", (const unsigned char *)(std::to_string(gate_size)).c_str());
-    xmlNewProp(r_xml, (const unsigned char *)"name", (const unsigned char *)name.c_str());
-    xmlNewProp(r_xml, (const unsigned char *)"gate_length", (const unsigned char *)(std::to_string(gate_length)).c_str());
-    xmlNewProp(r_xml, (const unsigned char *)"gate_type", (const unsigned char *)(std::to_string(gate_type)).c_str());
-    xmlNewProp(r_xml, (const unsigned char *)"fidelity", (const unsigned char *)(std::to_string(fidelity)).c_str());
-    xmlNewProp(r_xml, (const unsigned char *)"unitary", (const unsigned char *)unitary.c_str());    
-    return r_xml;
+    _WriteXmlEntryStart(w);
+    w->WriteAttribute("gate_size", gate_size);
+    w->WriteAttribute("name", name);
+    w->WriteAttribute("gate_length", gate_length);
+    w->WriteAttribute("gate_type", gate_type);
+    w->WriteAttribute("fidelity", fidelity);
+    w->WriteAttribute("unitary", unitary);
+    _WriteXmlEntryContent(w);
+    w->EndElement();
 }
-xmlNodePtr sys_sage::CouplingMap::_CreateXmlEntry()
+void sys_sage::CouplingMap::_WriteXmlEntry(XmlStreamWriter* w)
 {
-    xmlNodePtr r_xml = Relation::_CreateXmlEntry();
-
-    xmlNewProp(r_xml, (const unsigned char *)"fidelity", (const unsigned char *)(std::to_string(fidelity)).c_str());
-    return r_xml;
+    _WriteXmlEntryStart(w);
+    w->WriteAttribute("fidelity", fidelity);
+    _WriteXmlEntryContent(w);
+    w->EndElement();
 }
-xmlNodePtr sys_sage::Relation::_CreateXmlEntry()
+void sys_sage::Relation::_WriteXmlEntry(XmlStreamWriter* w)
+{
+    _WriteXmlEntryStart(w);
+    _WriteXmlEntryContent(w);
+    w->EndElement();
+}
+
+void sys_sage::Relation::_WriteXmlEntryStart(XmlStreamWriter* w)
 {
-    xmlNodePtr r_xml = xmlNewNode(NULL, BAD_CAST GetTypeStr().c_str());
+    w->StartElement(GetTypeStr());
+    std::string addr;
+    XmlStreamWriter::AppendAddress(&addr, this);
+    w->WriteAttribute("addr", addr);
 
     if (components.size() > 0) {
-        std::ostringstream c_addr;
-        c_addr << components[0];
+        std::string c_addr;
+        XmlStreamWriter::AppendAddress(&c_addr, components[0]);
         for (size_t s = 1; s < components.size(); s++)
-            c_addr << ' ' << components[s];
-        xmlNewProp(r_xml, BAD_CAST "components", BAD_CAST (c_addr.str().c_str()));
+        {
+            c_addr += ' ';
+            XmlStreamWriter::AppendAddress(&c_addr, components[s]);
+        }
+        w->WriteAttribute("components", c_addr);
     }
 
-    xmlNewProp(r_xml, (const unsigned char *)"ordered", (const unsigned char *)(std::to_string(ordered).c_str()));
-    xmlNewProp(r_xml, (const unsigned char *)"id", (const unsigned char *)(std::to_string(id).c_str()));
-    //xmlNewProp(r_xml, (const unsigned char *)"RelationType", (const unsigned char *)(std::to_string(type).c_str()));
+    w->WriteAttribute("ordered", ordered);
+    w->WriteAttribute("id", id);
     //RelationType provided through the xml node name
+}
+
+void sys_sage::Relation::_WriteXmlEntryContent(XmlStreamWriter* w)
+{
+    _print_attrib(GetAttributes(), w);
+    _print_attrib(attrib, w);
+}
 
-    _print_attrib(attrib, r_xml);
+void sys_sage::_init_libxml()
+{
+    static std::once_flag once;
+    std::call_once(once, [] { xmlInitParser(); });
+}
 
-    return r_xml;
+sys_sage::XmlExportContext::XmlExportContext(
+    std::function<int(std::string,void*,std::string*)> _customAttribFcn,
+    std::function<int(std::string,void*,xmlNodePtr)> _customComplexAttribFcn,
+    unsigned _parallelism)
+    : customAttribFcn(std::move(_customAttribFcn)), customComplexAttribFcn(std::move(_customComplexAttribFcn)), parallelism(_parallelism)
+{
+    _init_libxml();
 }
 
 int sys_sage::exportToXml(
     Component* root, 
     std::string path, 
     std::function<int(std::string,void*,std::string*)> _store_custom_attrib_fcn, 
-    std::function<int(std::string,void*,xmlNodePtr)> _store_custom_complex_attrib_fcn)
+    std::function<int(std::string,void*,xmlNodePtr)> _store_custom_complex_attrib_fcn,
+    unsigned parallelism)
 {
-    store_custom_attrib_fcn=_store_custom_attrib_fcn;
-    store_custom_complex_attrib_fcn=_store_custom_complex_attrib_fcn;
-
-    xmlDocPtr doc = xmlNewDoc(BAD_CAST "1.0");
+    return XmlExportContext(std::move(_store_custom_attrib_fcn), std::move(_store_custom_complex_attrib_fcn), parallelism).Export(root, path);
+}
 
-    xmlNodePtr sys_sage_root = xmlNewNode(NULL, BAD_CAST "sys-sage");
-    xmlDocSetRootElement(doc, sys_sage_root);
-    xmlNodePtr components_root = xmlNewNode(NULL, BAD_CAST "Components");
-    xmlAddChild(sys_sage_root, components_root);
-    xmlNodePtr relations_root = xmlNewNode(NULL, BAD_CAST "Relations");
-    xmlAddChild(sys_sage_root, relations_root);
+//opens path (stdout if empty), writes the document with write(XmlStreamWriter*) and closes the file
+template <class WriteFcn>
+static int _write_xml_file(const std::string& path, const char* fcnName, WriteFcn write)
+{
+    FILE* out = path.empty() ? stdout : fopen(path.c_str(), "wb");
+    if(out == NULL)
+    {
+        std::cerr << fcnName << ": cannot open " << path << " for writing." << std::endl;
+        return 1;
+    }
 
-    //build a tree for Components
-    xmlNodePtr c = _buildComponentSubtree(root);
-    xmlAddChild(components_root, c);
-    ////
+    int ret;
+    {
+        sys_sage::XmlStreamWriter w(out);
+        write(&w);
+        ret = w.Flush();
+    }
 
-    //scan all Components for their relations
-    std::vector<Component*> components;
-    root->GetComponentsInSubtree(&components);
-    std::cout << "Number of components to export: " << components.size() << std::endl;
-    for(Component* cPtr : components)
+    if(out != stdout)
     {
-        //iterate over different relation types and process them separately
-        for(RelationType::type rt : RelationType::RelationTypeList)
+        if(fclose(out) != 0)
+            ret = 1;
+    }
+    else
+        fflush(out);
+    if(ret != 0)
+        std::cerr << fcnName << ": writing " << (path.empty() ? "to stdout" : path) << " failed." << std::endl;
+    return ret;
+}
+
+int sys_sage::XmlExportContext::Export(Component* root, std::string path) const
+{
+    return _write_xml_file(path, "exportToXml", [&](XmlStreamWriter* w) {
+        w->context = this;
+        w->parallelRoot = root;
+        w->filter = &filter;
+        w->exportRoot = root;
+        w->StartDocument();
+        w->StartElement("sys-sage");
+        w->StartElement("Components");
+        //components are written (and their Relations collected) in a single traversal
+        root->_WriteXml(w);
+        w->EndElement();
+        std::cout << "Number of components to export: " << w->numComponents << std::endl;
+
+        w->StartElement("Relations");
+        for(Relation* r : w->relations)
+            r->_WriteXmlEntry(w);
+        for(const std::string& rs : w->relationOutput)
+            w->WriteRaw(rs);
+        w->EndElement();
+        w->EndElement();
+    });
+}
+
+int sys_sage::exportDeltaToXml(
+    Component* root,
+    uint64_t sinceVersion,
+    std::string path,
+    std::function<int(std::string,void*,std::string*)> _store_custom_attrib_fcn,
+    std::function<int(std::string,void*,xmlNodePtr)> _store_custom_complex_attrib_fcn)
+{
+    return XmlExportContext(std::move(_store_custom_attrib_fcn), std::move(_store_custom_complex_attrib_fcn)).ExportDelta(root, sinceVersion, path);
+}
+
+int sys_sage::XmlExportContext::ExportDelta(Component* root, uint64_t sinceVersion, std::string path) const
+{
+    uint64_t version = GetCurrentVersion();
+    return _write_xml_file(path, "exportDeltaToXml", [&](XmlStreamWriter* w) {
+        w->context = this;
+        w->shallow = true;
+        w->StartDocument();
+        w->StartElement("sys-sage-delta");
+        w->WriteAttribute("since", sinceVersion);
+        w->WriteAttribute("version", version);
+
+        //deletions come first: the address of a deleted object may have been reused by a new one
+        w->StartElement("Deleted");
+        Topology* tracking = root->_FindChangeTracking();
+        if(tracking != nullptr)
         {
-            std::vector<Relation*> rList = cPtr->GetRelations(rt);
+            std::string addr;
+            for(const DeletionRecord& d : tracking->GetDeletionLog())
+            {
+                if(d.version <= sinceVersion)
+                    continue;
+                w->StartElement(d.isRelation ? "Relation" : "Component");
+                addr.clear();
+                XmlStreamWriter::AppendAddress(&addr, reinterpret_cast<const void*>(d.addr));
+                w->WriteAttribute("addr", addr);
+                if(!d.isRelation)
+                    w->WriteAttribute("subtree", d.withSubtree);
+                w->EndElement();
+            }
+        }
+        w->EndElement();
 
-            for(Relation* r: rList)
+        //changed components without their children, in pre-order (parents before children)
+        w->StartElement("Components");
+        std::vector<Relation*> relations;
+        for(Component* c : root->PreOrder())
+        {
+            if(c->GetVersion() > sinceVersion)
+                c->_WriteXml(w);
+            for(RelationType::type rt : RelationType::RelationTypeList)
             {
-                //print only if this component has index 0 => print each Relation once only
-                if(r->GetComponent(0) == cPtr)
+                const std::vector<Relation*>& rList = c->GetRelations(rt);
+                for(size_t i = 0; i < rList.size(); i++)
                 {
-                    xmlNodePtr r_xml = nullptr;
-                    switch(r->GetType()) //not all necessarily have their specific implementation; if not, it will just call the default Relation->_CreateXmlEntry 
-                    {
-                        case RelationType::Relation:
-                            r_xml = reinterpret_cast<Relation*>(r)->_CreateXmlEntry();
-                            break;
-                        case RelationType::DataPath:
-                            r_xml = reinterpret_cast<DataPath*>(r)->_CreateXmlEntry();
-                        break;
-                        case RelationType::QuantumGate:
-                            r_xml = reinterpret_cast<QuantumGate*>(r)->_CreateXmlEntry();
-                            break;
-                        case RelationType::CouplingMap:
-                            r_xml = reinterpret_cast<CouplingMap*>(r)->_CreateXmlEntry();
-                            break;
-                    }
-                    xmlAddChild(relations_root, r_xml);
+                    Relation* r = rList[i];
+                    if(r->GetComponent(0) == c && r->_GetComponentSlot(0) == static_cast<int32_t>(i) && r->GetVersion() > sinceVersion)
+                        relations.push_back(r);
                 }
-            }  
+            }
         }
-    }
-
-    xmlSaveFormatFileEnc(path=="" ? "-" : path.c_str(), doc, "UTF-8", 1);
-
-    xmlFreeDoc(doc);
-    xmlCleanupParser();
-
-    return 0;
+        w->EndElement();
+
+        w->StartElement("Relations");
+        for(Relation* r : relations)
+            r->_WriteXmlEntry(w);
+        w->EndElement();
+        w->EndElement();
+    });
 }
@@ -1,7 +1,16 @@
 #ifndef XML_DUMP
 #define XML_DUMP
 
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
 #include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
 
 #include "Component.hpp"
 #include "DataPath.hpp"
@@ -12,14 +21,117 @@ namespace sys_sage{
      *
      * Traverses the component hierarchy starting from the given root and serializes the structure,
      * including all components, their attributes, and relations, into an XML file.
+     * The XML is streamed to the file in a single traversal of the tree (no DOM is built), see XmlStreamWriter.
      *
      * @param root Pointer to the root Component of the tree to export.
-     * @param path Output file path (if empty, returns the XML tree in memory).
+     * @param path Output file path (if empty, the XML is written to stdout).
      * @param search_custom_attrib_key_fcn Optional user-provided function for custom attribute serialization (string attributes).
      * @param search_custom_complex_attrib_key_fcn Optional user-provided function for custom attribute serialization (complex attributes, e.g., XML nodes).
+     * The function gets a temporary XML node standing for the component/relation; the child nodes it adds are exported.
+     * @param parallelism Number of threads serializing the subtrees of the children of root (0 = std::thread::hardware_concurrency(); 1 = no parallelism).
+     * It is capped at std::thread::hardware_concurrency(), so a single core always gets the serial export. With 0, trees with fewer than 4096 components are written serially as well,
+     * since the buffering costs more than the threads save there.
+     * Each subtree (and the Relations whose first component lies in it) is written into its own in-memory buffer; the buffers are then written in the order of the children,
+     * so the output is the same as with a serial export. With parallelism > 1, the custom functions may be called concurrently from several threads.
      * @return 0 on success, nonzero on error.
+     * @see XmlExportContext (same export with a reusable context)
      */
-    int exportToXml(Component *root, std::string path = "", std::function<int(std::string, void *, std::string *)> search_custom_attrib_key_fcn = NULL, std::function<int(std::string, void *, xmlNodePtr)> search_custom_complex_attrib_key_fcn = NULL);
+    int exportToXml(Component *root, std::string path = "", std::function<int(std::string, void *, std::string *)> search_custom_attrib_key_fcn = NULL, std::function<int(std::string, void *, xmlNodePtr)> search_custom_complex_attrib_key_fcn = NULL, unsigned parallelism = 1);
+    /**
+     * @brief Exports the changes of the Component Tree since a given version to an XML file (a delta), which XmlImportContext::ApplyDelta() applies onto a previously imported copy.
+     *
+     * The delta lists
+     * - the deletions recorded since sinceVersion by the nearest Topology with enabled change tracking (see Topology::EnableChangeTracking()), i.e. the addresses of the deleted Components and Relations,
+     * - the components of the subtree of root with a version > sinceVersion (see Component::GetVersion()): each as an element of its own, without its children, with the address of its parent in the "parent" XML attribute,
+     * - the Relations owned by these components (i.e. having their first component there) with a version > sinceVersion.
+     *
+     * Elements are written like in exportToXml(), so the delta of a topology with a few changed attributes is a few elements long. Finding the changes still visits every component (without writing it).
+     * \n Usage: take v = GetCurrentVersion() before a full export, then export deltas with sinceVersion = the "version" XML attribute of the previous delta (or v).
+     * \n Changes not covered: subtrees that were detached (RemoveChild()) but not deleted, deletions without change tracking, and changes of the legacy attrib map without MarkModified().
+     * Components that moved or were created are appended to the children of their parent when the delta is applied, so the order of the siblings may differ.
+     *
+     * @param root Pointer to the root Component of the exported tree.
+     * @param sinceVersion Version of the previous export (0 = everything).
+     * @param path Output file path (if empty, the XML is written to stdout).
+     * @param search_custom_attrib_key_fcn See exportToXml().
+     * @param search_custom_complex_attrib_key_fcn See exportToXml().
+     * @return 0 on success, nonzero on error.
+     * @see XmlExportContext::ExportDelta()
+     */
+    int exportDeltaToXml(Component *root, uint64_t sinceVersion, std::string path = "", std::function<int(std::string, void *, std::string *)> search_custom_attrib_key_fcn = NULL, std::function<int(std::string, void *, xmlNodePtr)> search_custom_complex_attrib_key_fcn = NULL);
+    /**
+     * @brief Selects the parts of the Component Tree and the Relations written by XmlExportContext::Export() (see XmlExportContext::filter). The default selects everything.
+     *
+     * The filter is applied while the tree is written; nothing is copied. The root of the export is always written. Components of other types are left out,
+     * but their children are still visited, so an exported component appears as a child of its nearest exported ancestor.
+     * \n Example (the cache hierarchy of the CPUs, without Relations):
+     * ```cpp
+     * XmlExportContext ctx;
+     * ctx.filter.componentTypes = ComponentType::ToMask(ComponentType::Chip) | ComponentType::ToMask(ComponentType::Cache);
+     * ctx.filter.relationTypes = 0;
+     * ctx.Export(node, "caches.xml");
+     * ```
+     */
+    struct XmlExportFilter {
+        ComponentType::mask componentTypes = ComponentType::AnyMask; /**< Component types to write. */
+        int maxDepth = -1; /**< Components more than maxDepth levels below the root are not visited (-1 = no limit, 0 = the root only). */
+        RelationType::mask relationTypes = RelationType::AnyMask; /**< Relation types to write (e.g. RelationType::ToMask(RelationType::DataPath)). */
+        bool internalRelationsOnly = false; /**< If true, only Relations whose components are all written are exported; otherwise, a Relation is exported if its first component is written. */
+        std::unordered_set<std::string> attributes; /**< If not empty, only the attributes with these names are written (typed and legacy attributes of components and Relations). */
+
+        /**
+         * @brief Returns true if Component c is written by an export of the subtree of root with this filter.
+         */
+        bool IncludesComponent(const Component* c, const Component* root) const;
+        /**
+         * @brief Returns true if the attribute called name is written with this filter.
+         */
+        bool IncludesAttribute(const std::string& name) const { return attributes.empty() || attributes.count(name) != 0; }
+    };
+    /**
+     * @class XmlExportContext
+     * @brief Settings of XML exports: the custom attribute functions and the parallelism (see exportToXml()).
+     *
+     * An export only reads its context and keeps all other state local, so several threads can export at the same time, each with its own context or with a shared one
+     * (then the custom functions must be thread-safe).
+     * \n Example:
+     * ```cpp
+     * XmlExportContext ctx(my_attrib_fcn, NULL, 8);
+     * ctx.Export(topo, "topo.xml");
+     * ```
+     */
+    class XmlExportContext {
+    public:
+        /**
+         * @param _customAttribFcn See exportToXml(): search_custom_attrib_key_fcn.
+         * @param _customComplexAttribFcn See exportToXml(): search_custom_complex_attrib_key_fcn.
+         * @param _parallelism See exportToXml(): parallelism.
+         */
+        XmlExportContext(std::function<int(std::string, void *, std::string *)> _customAttribFcn = NULL, std::function<int(std::string, void *, xmlNodePtr)> _customComplexAttribFcn = NULL, unsigned _parallelism = 1);
+        /**
+         * @brief Exports the Component Tree to an XML file, see exportToXml(). Only the components, Relations and attributes selected by filter are written.
+         * @param root Pointer to the root Component of the tree to export.
+         * @param path Output file path (if empty, the XML is written to stdout).
+         * @return 0 on success, nonzero on error.
+         */
+        int Export(Component* root, std::string path = "") const;
+        /**
+         * @brief Exports the changes of the Component Tree since sinceVersion, see exportDeltaToXml(). The parallelism and the filter are not used.
+         * @return 0 on success, nonzero on error.
+         */
+        int ExportDelta(Component* root, uint64_t sinceVersion, std::string path = "") const;
+
+        std::function<int(std::string, void *, std::string *)> customAttribFcn; /**< Custom function for simple attributes (may be NULL). */
+        std::function<int(std::string, void *, xmlNodePtr)> customComplexAttribFcn; /**< Custom function for complex attributes (may be NULL). */
+        unsigned parallelism; /**< Number of threads writing the subtrees of the children of root (0 = std::thread::hardware_concurrency()). */
+        XmlExportFilter filter; /**< Parts of the tree written by Export() (default: everything). */
+        bool _limitParallelismToCores = true; /**< @private If false, parallelism is not limited to std::thread::hardware_concurrency() (lets tests use the parallel export on machines with a single core). */
+    };
+    /**
+     * @private
+     * @brief Initializes libxml2 (once per process); called by XmlExportContext and XmlImportContext. libxml2 is never cleaned up by sys-sage, as other users in the process may still need it.
+     */
+    void _init_libxml();
     /**
      * @private
      * @brief Default handler for complex attribute serialization. Can be used as a reference for creating custom handlers.
@@ -48,25 +160,135 @@ namespace sys_sage{
     int _search_default_attrib_key(std::string key, void *value, std::string *ret_value_str);
     /**
      * @private
-     * @brief Builds the XML subtree for a given component.
-     *
-     * Recursively serializes the component and its children into an XML subtree.
-     * Used internally by exportToXml.
+     * @brief Streaming XML writer used by exportToXml().
      *
-     * @param root Pointer to the root Component.
-     * @return Pointer to the created XML node.
+     * Writes the elements directly to a buffered output stream instead of building a libxml2 DOM first. The output is byte-identical to the formatted serialization of libxml2
+     * (xmlSaveFormatFileEnc() with UTF-8 encoding): 2-space indentation (capped at 60 columns, like libxml2), empty elements as <name/>, attribute values escaped like libxml2 does.
+     * Numbers are formatted with std::to_chars; floating-point values like std::to_string (fixed, 6 decimals).
      */
-    xmlNodePtr _buildComponentSubtree(Component* root);
+    class XmlStreamWriter {
+    public:
+        /**
+         * @param _out Output stream (not closed by the writer). If NULL, the output is kept in memory (see TakeOutput()).
+         * @param _baseLevel Indentation level of the outermost element (for output that is inserted into another document).
+         */
+        XmlStreamWriter(FILE* _out, size_t _baseLevel = 0);
+        /**
+         * @brief Flushes the buffered output.
+         */
+        ~XmlStreamWriter();
+        /**
+         * @brief Writes the XML declaration.
+         */
+        void StartDocument();
+        /**
+         * @brief Opens an element; XML attributes can be written until the next element is started or this one is ended.
+         */
+        void StartElement(std::string_view name);
+        /**
+         * @brief Writes an XML attribute of the open element; the value is escaped (and, like in libxml2, ends at the first NUL character).
+         */
+        void WriteAttribute(std::string_view name, std::string_view value);
+        /**
+         * @brief Writes a numeric XML attribute of the open element (integers as is, floating-point values like std::to_string()).
+         */
+        template <class T>
+        requires std::is_arithmetic_v<T>
+        void WriteAttribute(std::string_view name, T value)
+        {
+            char tmp[std::numeric_limits<double>::max_exponent10 + 16]; //fixed notation of the largest double: 309 digits + "." + 6 decimals
+            char* end;
+            if constexpr(std::is_floating_point_v<T>)
+                end = std::to_chars(tmp, tmp + sizeof(tmp), static_cast<double>(value), std::chars_format::fixed, 6).ptr;
+            else if constexpr(std::is_same_v<T, bool>)
+                end = std::to_chars(tmp, tmp + sizeof(tmp), static_cast<int>(value)).ptr;
+            else
+                end = std::to_chars(tmp, tmp + sizeof(tmp), value).ptr;
+            _WriteRawAttribute(name, std::string_view(tmp, end - tmp));
+        }
+        /**
+         * @brief Closes the innermost open element.
+         */
+        void EndElement();
+        /**
+         * @brief Writes a libxml2 node (and its subtree) as a child of the open element, formatted like libxml2 does. Used for the output of the custom complex attribute functions.
+         */
+        void WriteNode(xmlNodePtr n);
+        /**
+         * @brief Returns the (lazily created) document in which the nodes passed to WriteNode() should be created, so that they are serialized like in the exported UTF-8 document.
+         */
+        xmlDocPtr GetNodeDocument();
+        /**
+         * @brief Writes already formatted XML (e.g. the output of another writer, see TakeOutput()) as children of the open element.
+         */
+        void WriteRaw(std::string_view xml);
+        /**
+         * @brief Writes one already formatted element (e.g. the payload of a LazyAttribute) as a child of the open element; its lines are re-indented to the current level, keeping their relative indentation.
+         */
+        void WriteRawElement(std::string_view xml);
+        /**
+         * @brief Flushes the buffered output (no-op for an in-memory writer).
+         * @return 0 on success, 1 on a write error.
+         */
+        int Flush();
+        /**
+         * @brief Returns the output of an in-memory writer and clears it.
+         */
+        std::string TakeOutput();
+        /**
+         * @brief Returns the indentation level of the next element.
+         */
+        size_t GetLevel() const { return baseLevel + openElements.size(); }
+
+        /**
+         * @brief Appends a pointer formatted like std::ostream << (const void*) does ("0x..." or "0").
+         */
+        static void AppendAddress(std::string* s, const void* p);
+
+        size_t numComponents = 0; /**< Number of components written so far. */
+        std::vector<Relation*> relations; /**< Relations collected while writing the components (each once, at its first component), written after the component tree. */
+        std::vector<std::string> relationOutput; /**< Relations already serialized by the workers of a parallel export; written after the ones in relations. */
+
+        const XmlExportContext* context = nullptr; /**< Settings of this export (custom functions, parallelism); may be nullptr. */
+        const Component* parallelRoot = nullptr; /**< Component whose children are written in parallel (see exportToXml()). */
+        bool shallow = false; /**< If true, components are written without their children and with the address of their parent (see exportDeltaToXml()); their Relations are not collected. */
+        const XmlExportFilter* filter = nullptr; /**< Parts of the tree to write (nullptr = everything). */
+        const Component* exportRoot = nullptr; /**< Root of the export (for filter). */
+        int depth = 0; /**< Depth of the component being written below exportRoot (for filter). */
+    private:
+        void _CloseStartTag();
+        void _Indent(size_t level);
+        void _WriteRawAttribute(std::string_view name, std::string_view value);
+
+        FILE* out;
+        size_t baseLevel;
+        std::string buf;
+        std::vector<std::string> openElements;
+        bool startTagOpen = false;
+        bool writeError = false;
+        xmlDocPtr nodeDoc = nullptr; /**< See GetNodeDocument(). */
+    };
     /**
      * @private
-     * @brief Prints the attributes of a component or relation to XML.
+     * @brief Prints the (legacy, untyped) attributes of a component or relation to XML.
      *
      * Used for debugging or for custom XML output.
      *
      * @param attrib Map of attribute key-value pairs.
-     * @param n XML node to attach the attributes to.
+     * @param w XML writer; the attributes are written into its open element.
+     * @return 0 on success, nonzero on error.
+     */
+    int _print_attrib(const std::map<std::string, void *>& attrib, XmlStreamWriter* w);
+    /**
+     * @private
+     * @brief Prints the typed attributes of a component or relation to XML.
+     *
+     * Values of simple types are printed based on their type tag; custom (and complex) values are passed to the custom export functions.
+     *
+     * @param attributes Typed attributes (may be nullptr).
+     * @param w XML writer; the attributes are written into its open element.
      * @return 0 on success, nonzero on error.
      */
-    int _print_attrib(std::map<std::string, void *> attrib, xmlNodePtr n);
+    int _print_attrib(const AttributeStore* attributes, XmlStreamWriter* w);
 } //namespace sys_sage
 #endif
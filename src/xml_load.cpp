@@ -1,14 +1,28 @@
+#include <cctype>
+#include <charconv>
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <filesystem>
 #include <functional>
+#include <iostream>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "xml_load.hpp"
+#include "xml_dump.hpp"
 
 #include "Topology.hpp"
 #include "Component.hpp"
@@ -34,24 +48,236 @@ using std::endl;
 
 
 #include <libxml/parser.h>
+#include <libxml/xmlreader.h>
 
-// Function pointer for custom attribute key search
-std::function<void*(xmlNodePtr)> load_custom_attrib_fcn = NULL;
-// Function pointer for custom complex attribute key search
-std::function<int(xmlNodePtr, sys_sage::Component *)> load_custom_complex_attrib_fcn = NULL;
-
-// Create map of addresses to Components created
-// this is used to create the Datapaths
-std::map<std::string, sys_sage::Component *> addr_to_component;
-
-//Helper-Function to retrieve string from xml-node
+//Helper-Function to retrieve string from xml-node (empty if the property is missing)
 std::string sys_sage::_getStringFromProp(xmlNodePtr n, std::string prop) {
-	const unsigned char *v = xmlGetProp(n, (const unsigned char *)prop.c_str());
+	xmlChar *v = xmlGetProp(n, (const xmlChar *)prop.c_str());
+	if (v == NULL)
+		return std::string();
 	std::string value(reinterpret_cast<char const *>(v));
+	xmlFree(v);
+	return value;
+}
+
+namespace {
+	// Properties of the element the xmlTextReader is positioned on.
+	//
+	// The values are views into the current node of the reader (no copies); they are
+	// valid until the reader moves on.
+	class ElementProps {
+	public:
+		~ElementProps() { _FreeOwned(); }
+
+		void Load(xmlNodePtr n) {
+			props.clear();
+			_FreeOwned();
+			if (n == NULL)
+				return;
+			for (xmlAttrPtr a = n->properties; a != NULL; a = a->next) {
+				std::string_view name(reinterpret_cast<const char *>(a->name));
+				xmlNodePtr text = a->children;
+				if (text == NULL)
+					props.emplace_back(name, std::string_view());
+				else if (text->next == NULL && text->type == XML_TEXT_NODE && text->content != NULL)
+					props.emplace_back(name, reinterpret_cast<const char *>(text->content));
+				else { //value split into several nodes (e.g. entity references) -- rare, needs a copy
+					xmlChar *v = xmlNodeListGetString(n->doc, text, 1);
+					owned.push_back(v);
+					props.emplace_back(name, v != NULL ? reinterpret_cast<const char *>(v) : "");
+				}
+			}
+		}
+
+		// Returns false if the element has no property called name.
+		bool Get(std::string_view name, std::string_view *value) const {
+			for (const auto &[n, v] : props) {
+				if (n == name) {
+					*value = v;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// Returns the value, or an empty view if the property is missing.
+		std::string_view Get(std::string_view name) const {
+			std::string_view value;
+			Get(name, &value);
+			return value;
+		}
+
+	private:
+		void _FreeOwned() {
+			for (xmlChar *v : owned)
+				xmlFree(v);
+			owned.clear();
+		}
+
+		std::vector<std::pair<std::string_view, std::string_view>> props;
+		std::vector<xmlChar *> owned;
+	};
+
+	// Read-only mapping of a whole file (for lazy attributes, which keep views into the file text).
+	class MappedFile {
+	public:
+		explicit MappedFile(const std::string &path) {
+			int fd = open(path.c_str(), O_RDONLY);
+			if (fd < 0)
+				return;
+			struct stat st;
+			if (fstat(fd, &st) == 0 && st.st_size > 0) {
+				void *m = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (m != MAP_FAILED) {
+					data = static_cast<const char *>(m);
+					size = st.st_size;
+				}
+			}
+			close(fd); //the mapping stays valid
+		}
+		~MappedFile() {
+			if (data != NULL)
+				munmap(const_cast<char *>(data), size);
+		}
+		MappedFile(const MappedFile &) = delete;
+		MappedFile &operator=(const MappedFile &) = delete;
+
+		std::string_view Text() const { return std::string_view(data != NULL ? data : "", size); }
+
+	private:
+		const char *data = NULL;
+		size_t size = 0;
+	};
+
+	// Finds the text of the Attribute elements of the Components section in the file (for lazy attributes).
+	//
+	// The reader does not report file offsets, so the elements are searched in document order:
+	// Locate() has to be called for every Attribute element of the section, also for the ones
+	// that are loaded eagerly or skipped. If an element does not match (e.g. its name differs),
+	// the locator gives up for the rest of the file and the attributes are loaded eagerly.
+	class AttributeLocator {
+	public:
+		explicit AttributeLocator(std::string_view _text) : text(_text) {}
+
+		// Continue after the next start tag called tag (the start of the Components section).
+		void Start(std::string_view tag) {
+			size_t pos = text.find(tag, cursor);
+			if (pos == npos)
+				lost = true;
+			else
+				cursor = pos + tag.size();
+		}
+
+		// Returns the text of the next Attribute element (whose name property is name, if not empty),
+		// or an empty view if it cannot be located.
+		std::string_view Locate(std::string_view name, bool isEmpty) {
+			if (lost)
+				return std::string_view();
+			size_t start = _FindStartTag(cursor, text.size());
+			size_t tagEnd = start == npos ? npos : _FindTagEnd(start);
+			size_t end = npos;
+			if (tagEnd != npos && _HasName(text.substr(start, tagEnd - start), name))
+				end = isEmpty ? (text[tagEnd - 1] == '/' ? tagEnd + 1 : npos) : _FindEnd(tagEnd + 1);
+			if (end == npos) {
+				lost = true;
+				return std::string_view();
+			}
+			cursor = end;
+			return text.substr(start, end - start);
+		}
+
+	private:
+		static constexpr size_t npos = std::string_view::npos;
+		static constexpr std::string_view startTag = "<Attribute";
+		static constexpr std::string_view endTag = "</Attribute>";
+
+		// Position of the next Attribute start tag in [pos, limit), or npos.
+		size_t _FindStartTag(size_t pos, size_t limit) const {
+			std::string_view range = text.substr(0, limit);
+			for (pos = range.find(startTag, pos); pos != npos; pos = range.find(startTag, pos + 1)) {
+				size_t after = pos + startTag.size();
+				if (after < text.size() && (text[after] == '>' || text[after] == '/' || std::isspace(static_cast<unsigned char>(text[after]))))
+					return pos;
+			}
+			return npos;
+		}
+
+		// Position of the '>' that ends the tag starting at pos ('>' may appear in quoted values), or npos.
+		size_t _FindTagEnd(size_t pos) const {
+			char quote = 0;
+			for (; pos < text.size(); pos++) {
+				char ch = text[pos];
+				if (quote != 0) {
+					if (ch == quote)
+						quote = 0;
+				} else if (ch == '"' || ch == '\'') {
+					quote = ch;
+				} else if (ch == '>') {
+					return pos;
+				}
+			}
+			return npos;
+		}
+
+		// Position after the end tag of an element whose start tag ends before pos (nested Attribute elements are skipped), or npos.
+		size_t _FindEnd(size_t pos) const {
+			for (int depth = 1; depth > 0;) {
+				size_t close = text.find(endTag, pos);
+				if (close == npos)
+					return npos;
+				size_t nested = _FindStartTag(pos, close);
+				if (nested != npos) {
+					size_t tagEnd = _FindTagEnd(nested);
+					if (text[tagEnd - 1] != '/')
+						depth++;
+					pos = tagEnd + 1;
+				} else {
+					depth--;
+					pos = close + endTag.size();
+				}
+			}
+			return pos;
+		}
+
+		// The exporter writes name="..." (see _print_one_attrib()); anything else is not matched.
+		static bool _HasName(std::string_view tag, std::string_view name) {
+			if (name.empty())
+				return true;
+			size_t pos = tag.find(" name=\"");
+			if (pos == npos)
+				return false;
+			pos += 7;
+			return tag.compare(pos, name.size(), name) == 0 && tag.size() > pos + name.size() && tag[pos + name.size()] == '"';
+		}
+
+		std::string_view text;
+		size_t cursor = 0;
+		bool lost = false;
+	};
+}
+
+// Parse a number without copying the text; returns fallback if s is not a number.
+template <class T>
+static T _parse_number(std::string_view s, T fallback = T()) {
+	T value = fallback;
+	std::from_chars(s.data(), s.data() + s.size(), value);
+	return value;
+}
+
+// Parse a component address as written by exportToXml ("0x55d1..." or "0").
+// Addresses only identify components within one file, so the integer is used as the key.
+static uintptr_t _parse_addr(std::string_view s) {
+	if (s.size() > 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X'))
+		s.remove_prefix(2);
+	uintptr_t value = 0;
+	std::from_chars(s.data(), s.data() + s.size(), value, 16);
 	return value;
 }
 
 // Extract attribute value from xml-node based on attribute name
+//
+// Returns a newly allocated value for the predefined keys (see AttributeKey); the value type is
+// looked up by the key (one hash lookup) instead of comparing the key against every known name.
 void* sys_sage::_search_default_attrib_key(xmlNodePtr n) {
 	std::string key, value;
 	//check if the node has a name-attribute
@@ -65,48 +291,62 @@ void* sys_sage::_search_default_attrib_key(xmlNodePtr n) {
 		return NULL;
 	}
 
-
-	// Handle attributes with uint64_t values
-	if (!key.compare("CATcos") || !key.compare("CATL3mask")) 
-	{
-		return new long long (std::strtoull((const char *)value.c_str(), NULL, 16));
-	}
-	// Handle attributes with long long values
-	else if (!key.compare("mig_size")) 
-	{
-		return new long long (std::strtoull((const char *)value.c_str(), NULL, 10));
-	}
-
-	// Handle attributes with int values
-	else if (!key.compare("Number_of_streaming_multiprocessors") ||
-		!key.compare("Number_of_cores_in_GPU") ||
-		!key.compare("Number_of_cores_per_SM") ||
-		!key.compare("Bus_Width_bit")) 
-	{
-		return (new int(std::stoi(value)));
-	}
-
-	// Handle attributes with double values
-	else if (!key.compare("Clock_Frequency") || !key.compare("GPU_Clock_Rate")) 
-	{
-		return new double(std::stod(value));
-	}
-
-	// Handle attributes with float values
-	else if (!key.compare("latency") || !key.compare("latency_min") ||
-		!key.compare("latency_max"))
+	switch (AttributeKey::GetBuiltinType(AttributeKey::Find(key)))
 	{
-		return new float(std::stof(value));
+		case AttributeType::Int:
+			return new int(std::stoi(value));
+		case AttributeType::LongLong:
+			return new long long(std::strtoll(value.c_str(), NULL, 10));
+		case AttributeType::UInt64:
+			return new uint64_t(std::strtoull(value.c_str(), NULL, 10));
+		case AttributeType::Float:
+			return new float(std::stof(value));
+		case AttributeType::Double:
+			return new double(std::stod(value));
+		case AttributeType::String:
+			return new std::string(value);
 	}
+	return NULL; // Attribute not found or not handled
+}
 
-	// Handle attributes with string values
-	else if (!key.compare("CUDA_compute_capability") ||
-		!key.compare("mig_uuid"))
+// Load an attribute with a predefined key (see AttributeKey) given by its name and
+// value into the typed attributes of Component c.
+// Returns 1 if the attribute was handled.
+static int _load_default_attrib(std::string_view name, std::string_view value, sys_sage::Component *c) {
+	using namespace sys_sage;
+	AttributeKey::type key = AttributeKey::Find(std::string(name));
+	switch (AttributeKey::GetBuiltinType(key))
 	{
-		return new std::string(value);
+		case AttributeType::Int:
+			c->SetAttribute(key, _parse_number<int>(value));
+			return 1;
+		case AttributeType::LongLong:
+			c->SetAttribute(key, _parse_number<long long>(value));
+			return 1;
+		case AttributeType::UInt64:
+			c->SetAttribute(key, _parse_number<uint64_t>(value));
+			return 1;
+		case AttributeType::Float:
+			c->SetAttribute(key, _parse_number<float>(value));
+			return 1;
+		case AttributeType::Double:
+			c->SetAttribute(key, _parse_number<double>(value));
+			return 1;
+		case AttributeType::String:
+			c->SetAttribute(key, std::string(value));
+			return 1;
 	}
+	return 0;
+}
 
-	return NULL; // Attribute not found or not handled
+// Same as above, with name and value taken from the properties of xml-node n.
+static int _load_default_attrib(xmlNodePtr n, sys_sage::Component *c) {
+	ElementProps props;
+	props.Load(n);
+	std::string_view name, value;
+	if (!props.Get("name", &name) || !props.Get("value", &value))
+		return 0;
+	return _load_default_attrib(name, value, c);
 }
 
 // Search for custom complex attributes in xmlNode n and add them to Component c
@@ -125,8 +365,9 @@ int sys_sage::_search_default_complex_attrib_key(xmlNodePtr n, Component *c) {
 	}
 	// freq_history is a vector of tuples containing the timestamp and the
 	// frequency
-	if (!key.compare("freq_history")) {
-		std::vector<std::tuple<long long, double>>* val = new std::vector<std::tuple<long long, double>>();
+	AttributeKey::type attribKey = AttributeKey::Find(key);
+	if (AttributeKey::GetBuiltinType(attribKey) == AttributeType::FrequencyHistory) {
+		FrequencyHistory val;
 		for (xmlNodePtr cur = n->children; cur != NULL; cur = cur->next) 
 		{
 			// skip text nodes
@@ -139,9 +380,9 @@ int sys_sage::_search_default_complex_attrib_key(xmlNodePtr n, Component *c) {
 			long long ts_ll = std::strtoll((const char *)ts.c_str(), NULL, 10);
 			double freq_d = std::stod(freq);
 
-			val->push_back(std::make_tuple(ts_ll, freq_d));
+			val.push_back(std::make_tuple(ts_ll, freq_d));
 		}
-		c->attrib[key] = (void*) val;
+		c->SetAttribute(attribKey, std::move(val));
 		return 1;
 	} 
 	//else if (!key.compare("GPU_Clock_Rate"))
@@ -172,263 +413,543 @@ int sys_sage::_search_default_complex_attrib_key(xmlNodePtr n, Component *c) {
 // The attributes are added to the Component c.
 // If the custom functions are not null, they are called first. If they
 // can not handle the attribute, the default functions are used.
-int sys_sage::_collect_attrib(xmlNodePtr n, Component *c) {
+int sys_sage::_collect_attrib(xmlNodePtr n, Component *c, const XmlImportContext *ctx) {
 	void *attrib_value = NULL;
 	// try custom attribute search function
-	if (load_custom_attrib_fcn != NULL)
-		attrib_value = load_custom_attrib_fcn(n);
-	// if custom function could not handle attribute, try default
-	if (attrib_value == NULL)
-		attrib_value = _search_default_attrib_key(n);
+	if (ctx != NULL && ctx->customAttribFcn != NULL)
+		attrib_value = ctx->customAttribFcn(n);
 	// if attribute was handled, add it to Component
 	if (attrib_value != NULL) {
 		std::string key = _getStringFromProp(n, "name");
 		c->attrib[key] = attrib_value;
+		return 0;
 	}
+	// if custom function could not handle attribute, try default (stored as typed attribute)
+	if (_load_default_attrib(n, c))
+		return 0;
 	int ret = 0;
 	// try custom complex attribute search function
-	if (attrib_value == NULL && load_custom_complex_attrib_fcn != NULL)
-		ret = load_custom_complex_attrib_fcn(n, c);
+	if (ctx != NULL && ctx->customComplexAttribFcn != NULL)
+		ret = ctx->customComplexAttribFcn(n, c);
 	// if custom function could not handle attribute, try default
-	if (attrib_value == NULL && ret == 0)
+	if (ret == 0)
 		return _search_default_complex_attrib_key(n, c);
 
 	return 0;
 }
 
-// Create ComponentSubtree from xmlNodes
+// Load the Attribute element the reader is positioned on into Component c.
 //
-// This function creates a ComponentSubtree from the xmlNode n by creating
-// a Component and then recursively calling itself for all children of n.
-sys_sage::Component* sys_sage::_CreateComponentSubtree(xmlNodePtr n) {
-	Component *c = NULL;
+// Simple values of predefined keys are read directly from the element; everything else
+// (custom functions, complex attributes) gets the expanded subtree of the element.
+//
+// For lazy imports, raw is the text of the element: everything but simple values of predefined
+// keys is stored as a LazyAttribute with that text, which decode loads on the first access.
+// With custom functions, user-defined keys are still loaded here, as the functions may store
+// them in the attrib map, which cannot decode on access.
+static void _load_attrib(xmlTextReaderPtr reader, const ElementProps &props, sys_sage::Component *c, const sys_sage::XmlImportContext *ctx,
+	std::string_view raw = std::string_view(), const std::function<int(const std::string &, sys_sage::Component *)> &decode = nullptr) {
+	std::string_view name;
+	bool hasName = props.Get("name", &name);
+	if (ctx->customAttribFcn == NULL) {
+		std::string_view value;
+		if (hasName && props.Get("value", &value) && _load_default_attrib(name, value, c))
+			return;
+	}
+	bool customFcns = ctx->customAttribFcn != NULL || ctx->customComplexAttribFcn != NULL;
+	if (!raw.empty() && hasName && !name.empty()
+		&& (!customFcns || sys_sage::AttributeKey::GetBuiltinType(sys_sage::AttributeKey::Find(std::string(name))) != sys_sage::AttributeType::None)) {
+		c->SetAttribute(sys_sage::AttributeKey::Intern(std::string(name)), sys_sage::LazyAttribute{std::string(raw), decode});
+		return;
+	}
+	xmlNodePtr n = xmlTextReaderExpand(reader);
+	if (n != NULL)
+		sys_sage::_collect_attrib(n, c, ctx);
+}
 
-	std::string nodeName(reinterpret_cast<const char *>(n->name));
-	// cout << "_CreateComponentSubtree nodeName = " << nodeName << endl;
+// Decode the text of an Attribute element that was imported lazily (see _load_attrib()).
+static int _decode_lazy_attrib(const std::string &payload, sys_sage::Component *c, const sys_sage::XmlImportContext *ctx) {
+	xmlDocPtr doc = xmlReadMemory(payload.data(), static_cast<int>(payload.size()), NULL, NULL, XML_PARSE_NOBLANKS | XML_PARSE_COMPACT);
+	if (doc == NULL)
+		return 1;
+	xmlNodePtr n = xmlDocGetRootElement(doc);
+	std::string key = sys_sage::_getStringFromProp(n, "name");
+	sys_sage::_collect_attrib(n, c, ctx);
+	xmlFreeDoc(doc);
+	// the LazyAttribute itself is still stored under key until the decoding succeeded
+	const sys_sage::AttributeStore *store = c->GetAttributes();
+	const sys_sage::AttributeStore::Entry *e = store != NULL ? store->GetEntry(sys_sage::AttributeKey::Find(key)) : NULL;
+	return (e != NULL && e->type != sys_sage::AttributeType::Lazy) || c->attrib.count(key) != 0 ? 0 : 1;
+}
 
-	// entrypoint is 'Components' -- just scan for a non-'text' child and process that"
-	if(nodeName.compare("Components") == 0)
-	{
-		for (xmlNodePtr xml_child = n->children; xml_child != NULL; xml_child = xml_child->next)
-		{
-			std::string childName(reinterpret_cast<const char *>(xml_child->name));
-			if (childName.compare("text") == 0)
-				continue;
-			else
-				return _CreateComponentSubtree(xml_child);
-		}
+// Set the properties of a component element on Component c (created from an element with the same name).
+// Used for new components and for the changed components of a delta.
+static void _load_component_props(sys_sage::Component *c, const ElementProps &props) {
+	using namespace sys_sage;
+	std::string_view value;
+	ComponentType::type type = c->GetComponentType();
+
+	c->SetCount(props.Get("count", &value) ? _parse_number<int>(value) : -1);
+	if (type == ComponentType::Cache) {
+		Cache *cache = static_cast<Cache *>(c);
+		if (props.Get("cache_level", &value))
+			cache->SetCacheLevel(_parse_number<int>(value));
+		if (props.Get("cache_size", &value))
+			cache->SetCacheSize(_parse_number<long long>(value));
+		if (props.Get("cache_associativity_ways", &value))
+			cache->SetCacheAssociativityWays(_parse_number<int>(value));
+		if (props.Get("cache_line_size", &value))
+			cache->SetCacheLineSize(_parse_number<int>(value));
 	}
+	else if (type == ComponentType::Subdivision) {
+		static_cast<Subdivision *>(c)->SetSubdivisionType(_parse_number<int>(props.Get("subdivision_type")));
+	}
+	else if (type == ComponentType::Numa) {
+		if (props.Get("size", &value))
+			static_cast<Numa *>(c)->SetSize(_parse_number<long long>(value));
+	}
+	else if (type == ComponentType::Chip) {
+		Chip *chip = static_cast<Chip *>(c);
+		// check for vendor and model
+		if (props.Get("vendor", &value))
+			chip->SetVendor(std::string(value));
+		if (props.Get("model", &value))
+			chip->SetModel(std::string(value));
+	}
+	else if (type == ComponentType::Memory) {
+		Memory *memory = static_cast<Memory *>(c);
+		std::string_view is_volatile = props.Get("is_volatile");
+		memory->SetName(std::string(props.Get("name")));
+		memory->SetSize(_parse_number<long long>(props.Get("size")));
+		memory->SetIsVolatile(is_volatile == "true" || is_volatile == "1");
+	}
+	else if (type == ComponentType::Storage) {
+		// Same as with memory
+		static_cast<Storage *>(c)->SetSize(_parse_number<long long>(props.Get("size")));
+	}
+}
 
-	//from here processing real Components
-
-	std::string name = _getStringFromProp(n, "name");
-	int id = std::stoi(_getStringFromProp(n, "id"));
-	std::string addr = _getStringFromProp(n, "addr");
+// Create a Component (without parent) from the element name and properties of a component element.
+// Returns NULL for unknown element names.
+static sys_sage::Component *_create_component(std::string_view nodeName, const ElementProps &props) {
+	using namespace sys_sage;
+	Component *c = NULL;
+	int id = _parse_number<int>(props.Get("id"));
 
 	// Check the type of Component and create the corresponding Component
-	if (nodeName.compare("None") == 0) {
-		c = new Component((id));
+	if (nodeName == "None" || nodeName == "GenericComponent") {
+		c = new Component(id);
 	}
-	if (nodeName.compare("HW_Thread") == 0) {
+	else if (nodeName == "HW_Thread") {
 		c = new Thread(id);
 	}
-	if (nodeName.compare("Core") == 0) {
+	else if (nodeName == "Core") {
 		c = new Core(id);
 	}
-	if (nodeName.compare("Cache") == 0) {
+	else if (nodeName == "Cache") {
 		c = new Cache(id);
-		if (xmlHasProp(n, (const xmlChar *)"cache_level")) {
-			std::string value = _getStringFromProp(n, "cache_level");
-			((Cache *)c)->SetCacheLevel(std::stoi(value));
-		}
-		if (xmlHasProp(n, (const xmlChar *)"cache_size")) {
-			std::string value = _getStringFromProp(n, "cache_size");
-			((Cache *)c)->SetCacheSize(std::stoi(value));
-		}
-		if (xmlHasProp(n, (const xmlChar *)"cache_associativity_ways")) {
-			std::string value = _getStringFromProp(n, "cache_associativity_ways");
-			((Cache *)c)->SetCacheAssociativityWays(std::stoi(value));
-		}
-		if (xmlHasProp(n, (const xmlChar *)"cache_line_size")) {
-			std::string value = _getStringFromProp(n, "cache_line_size");
-			((Cache *)c)->SetCacheLineSize(std::stoi(value));
-		}
 	}
-	if (nodeName.compare("Subdivision") == 0) {
+	else if (nodeName == "Subdivision") {
 		c = new Subdivision(id);
-		int sd_type = std::stoi(_getStringFromProp(n, "type"));
-
-		((Subdivision *)c)->SetSubdivisionType(sd_type);
 	}
-	if (nodeName.compare("NUMA") == 0) {
+	else if (nodeName == "NUMA") {
 		c = new Numa(id);
-		if (xmlHasProp(n, (const xmlChar *)"size")) {
-			std::string value = _getStringFromProp(n, "size");
-			((Numa *)c)->SetSize(std::stoll(value));
-		}
 	}
-	if (nodeName.compare("Chip") == 0) {
+	else if (nodeName == "Chip") {
 		c = new Chip(id);
-		// check for vendor and model
-		if (xmlHasProp(n, (const xmlChar *)"vendor")) {
-			std::string value = _getStringFromProp(n, "vendor");
-			((Chip *)c)->SetVendor(value);
-		}
-		if (xmlHasProp(n, (const xmlChar *)"model")) {
-			std::string model = _getStringFromProp(n, "model");
-			((Chip *)c)->SetModel(model);
-		}
 	}
-	if (nodeName.compare("Memory") == 0) {
-		long long size = 0;
-		bool is_volatile = false;
-		if (xmlHasProp(n, (const xmlChar *)"size")) {
-			std::string value = _getStringFromProp(n, "size");
-			size = std::stoll(value);
-		}
-		if (xmlHasProp(n, (const xmlChar *)"is_volatile")) {
-			std::string value = _getStringFromProp(n, "is_volatile");
-			is_volatile = (std::string(value) == "true");
-		}
-		c = new Memory(NULL, id, name, size, is_volatile);
+	else if (nodeName == "Memory") {
+		c = new Memory(NULL, id);
 	}
-	if (nodeName.compare("Storage") == 0) {
-		// Same as with memory
-		long long size = 0;
-		if (xmlHasProp(n, (const xmlChar *)"size")) {
-			std::string value = _getStringFromProp(n, "size");
-			size = std::stoll(value);
-		}
+	else if (nodeName == "Storage") {
 		c = new Storage();
-		((Storage *)c)->SetSize(size);
 	}
-	if (nodeName.compare("Node") == 0) {
+	else if (nodeName == "Node") {
 		c = new Node(id);
 	}
-	if (nodeName.compare("QuantumBackend") == 0) {
+	else if (nodeName == "QuantumBackend") {
 		c = new QuantumBackend(id);
 	}
-	if (nodeName.compare("Qubit") == 0) {
+	else if (nodeName == "Qubit") {
 		c = new Qubit(id);
 	}
-	if (nodeName.compare("Topology") == 0) {
+	else if (nodeName == "Topology") {
 		c = new Topology();
 	}
+	if (c != NULL)
+		_load_component_props(c, props);
+	return c;
+}
 
-	// Recursively traverse all children of n and create Components
-	for (xmlNodePtr xml_child = n->children; xml_child != NULL; xml_child = xml_child->next)
-	{
-		std::string childName(reinterpret_cast<const char *>(xml_child->name));
-
-		// Skip Text nodes
-		if (childName.compare("text") == 0)
+// Create the Relation described by a relation element (element name and properties)
+// and add it to the corresponding Components.
+// Returns NULL if the relation could not be created.
+static sys_sage::Relation *_create_relation(std::string_view nodeName, const ElementProps &props, const std::unordered_map<uintptr_t, sys_sage::Component *> &addrToComponent) {
+	using namespace sys_sage;
+
+	std::vector<Component *> components;
+	std::string_view addrs = props.Get("components");
+	while (!addrs.empty()) {
+		size_t end = addrs.find(' ');
+		std::string_view addr = addrs.substr(0, end);
+		addrs.remove_prefix(end == std::string_view::npos ? addrs.size() : end + 1);
+		if (addr.empty())
 			continue;
-		// Check if cur is Attribute-Node
-		if (childName.compare("Attribute") == 0) {
-			_collect_attrib(xml_child, c);
-		} else {
-			Component *child = _CreateComponentSubtree(xml_child);
-			// cout << "nodeName = " << nodeName << "   childName = " << childName << ", childPtr = " << child << endl;
-			if (child != NULL) {
-				c->InsertChild(child);
-			}
+		auto it = addrToComponent.find(_parse_addr(addr));
+		if (it == addrToComponent.end()) {
+			std::cerr << "importFromXml: " << nodeName << " refers to unknown component " << addr << " -- skipping it." << std::endl;
+			return NULL;
 		}
+		components.push_back(it->second);
 	}
-	// Add the Component to the hashmap
-	addr_to_component[addr] = c;
-	return c;
-}
 
-// Create Relation objects from xmlNode dpNode and add them to the
-// corresponding Components
-int sys_sage::_CreateRelations(xmlNodePtr relationNode) {
+	bool ordered = (props.Get("ordered") == "1");
+	int id = _parse_number<int>(props.Get("id"));
 
-	// cout << "_CreateRelations name = " << relationNode->name << endl; 
-	for (xmlNodePtr xml_child = relationNode->children; xml_child != NULL; xml_child = xml_child->next) {
+	Relation *r = NULL;
+	if (nodeName == "Relation") {
+		r = new Relation(components, id, ordered);
+	}
+	else if (nodeName == "DataPath") {
+		if (components.size() != 2) {
+			std::cerr << "importFromXml: DataPath needs exactly 2 components -- skipping it." << std::endl;
+			return NULL;
+		}
+		int dataPathType = _parse_number<int>(props.Get("DataPathType"));
+		double bw = _parse_number<double>(props.Get("bw"));
+		double latency = _parse_number<double>(props.Get("latency"));
+		DataPathOrientation::type dpo = (ordered ? DataPathOrientation::Oriented : DataPathOrientation::Bidirectional);
 
-		// skip non-element nodes
-		if (xml_child->type != XML_ELEMENT_NODE)
-			continue;
+		r = new DataPath(components[0], components[1], dpo, dataPathType, bw, latency);
+	}
+	else if (nodeName == "QuantumGate") {
+		size_t gate_size = _parse_number<size_t>(props.Get("gate_size"));
+		std::string name(props.Get("name"));
+		int gate_length = _parse_number<int>(props.Get("gate_length"));
+		QuantumGateType::type gate_type = _parse_number<int>(props.Get("gate_type"));
+		double fidelity = _parse_number<double>(props.Get("fidelity"));
+		std::string unitary(props.Get("unitary"));
+
+		r = new QuantumGate(components, id, ordered, gate_size, name, gate_length, gate_type, fidelity, unitary);
+	}
+	else if (nodeName == "CouplingMap") {
+		CouplingMap *cm = new CouplingMap(components, id, ordered);
+		cm->SetFidelity(_parse_number<double>(props.Get("fidelity")));
+		r = cm;
+	}
+	return r;
+}
 
-		std::string childName(reinterpret_cast<const char *>(xml_child->name));
-		// cout << "_CreateRelations childName = " << childName << endl;
+// Import a topology with a pull parser (xmlTextReader).
+//
+// Components are created while the file is read, in document order; only the currently
+// open component elements are kept (one per nesting level). Attribute elements are expanded
+// one at a time if a custom function or a complex attribute needs the node.
+// Relation endpoints are resolved through a hash map keyed by the parsed component address.
+//
+// With lazyAttributes, the file is mapped and read from memory, so that the text of the
+// Attribute elements can be stored instead of decoding them (libxml2 still tokenizes them).
+// Skipped subtrees are then read through, as the locator has to see all Attribute elements.
+sys_sage::Component* sys_sage::XmlImportContext::Import(std::string path)
+{
+	Clear();
+	// collapsed components are restored with their shared subtrees and Relations
+	SharedWriteScope scope;
+	std::unique_ptr<MappedFile> file;
+	std::unique_ptr<AttributeLocator> locator;
+	std::function<int(const std::string &, Component *)> decode;
+	xmlTextReaderPtr reader;
+	if (lazyAttributes) {
+		file = std::make_unique<MappedFile>(path);
+		std::string_view text = file->Text();
+		reader = text.empty() ? NULL : xmlReaderForMemory(text.data(), static_cast<int>(text.size()), path.c_str(), NULL, XML_PARSE_NOBLANKS | XML_PARSE_COMPACT);
+		locator = std::make_unique<AttributeLocator>(text);
+		// the attributes may be decoded after this context is gone
+		auto decodeCtx = std::make_shared<const XmlImportContext>(customAttribFcn, customComplexAttribFcn);
+		decode = [decodeCtx](const std::string &payload, Component *c) { return _decode_lazy_attrib(payload, c, decodeCtx.get()); };
+	} else {
+		reader = xmlReaderForFile(path.c_str(), NULL, XML_PARSE_NOBLANKS | XML_PARSE_COMPACT);
+	}
+	if (reader == NULL) {
+		std::cerr << "importFromXml: cannot open " << path << std::endl;
+		return NULL;
+	}
 
-    std::vector<Component *> components;
-		xmlChar *str = xmlGetProp(xml_child, BAD_CAST "components");
-    if (str != nullptr) {
-        std::istringstream stream (reinterpret_cast<const char *>(str));
-        std::string component;
-        while (std::getline(stream, component, ' '))
-          components.push_back(addr_to_component[component]);
-    }
+	enum { OTHER, COMPONENTS, RELATIONS } section = OTHER;
+	Component *root = NULL;
+	// open component elements; open[i] is the element at depth i+2 (sys-sage/Components/...)
+	std::vector<Component *> open;
+	ElementProps props;
 
-		std::string ordered_str = _getStringFromProp(xml_child, "ordered");
-		bool ordered = (ordered_str == "1");
-		int id = std::stoi(_getStringFromProp(xml_child, "id"));
+	int ret = xmlTextReaderRead(reader);
+	while (ret == 1) {
+		if (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT) {
+			ret = xmlTextReaderRead(reader);
+			continue;
+		}
+		int depth = xmlTextReaderDepth(reader);
+		std::string_view nodeName(reinterpret_cast<const char *>(xmlTextReaderConstName(reader)));
+
+		if (depth == 1) {
+			section = nodeName == "Components" ? COMPONENTS : nodeName == "Relations" ? RELATIONS : OTHER;
+			if (section == COMPONENTS && locator != NULL)
+				locator->Start("<Components");
+			ret = xmlTextReaderRead(reader);
+			continue;
+		}
+		if (depth < 2 || section == OTHER) {
+			ret = xmlTextReaderRead(reader);
+			continue;
+		}
 
+		if (section == RELATIONS) {
+			if (depth == 2) {
+				props.Load(xmlTextReaderCurrentNode(reader));
+				Relation *r = _create_relation(nodeName, props, addrToComponent);
+				std::string_view addr;
+				if (r != NULL && props.Get("addr", &addr))
+					addrToRelation[_parse_addr(addr)] = r;
+			}
+			ret = xmlTextReaderNext(reader);
+			continue;
+		}
 
-		if (childName.compare("Relation") == 0)
-		{
-			new Relation(components, id, ordered);
+		// Components: close the elements that ended before this one
+		size_t level = depth - 2;
+		if (open.size() > level)
+			open.resize(level);
+		// a second component tree, or the inside of a skipped element
+		bool skipped = open.size() != level || (level == 0 && root != NULL);
+		if (skipped && (locator == NULL || nodeName != "Attribute")) {
+			ret = locator != NULL ? xmlTextReaderRead(reader) : xmlTextReaderNext(reader);
+			continue;
 		}
-		if (childName.compare("DataPath") == 0)
-		{
-			int dataPathType = std::stoi(_getStringFromProp(xml_child, "DataPathType"));
-			double bw = std::stod(_getStringFromProp(xml_child, "bw"));
-			double latency = std::stod(_getStringFromProp(xml_child, "latency"));
-			DataPathOrientation::type dpo = (ordered ? DataPathOrientation::Oriented : DataPathOrientation::Bidirectional);
 
-			new DataPath(components[0], components[1], dpo, dataPathType, bw, latency);
+		props.Load(xmlTextReaderCurrentNode(reader));
+		if (nodeName == "Attribute") {
+			std::string_view raw;
+			if (locator != NULL)
+				raw = locator->Locate(props.Get("name"), xmlTextReaderIsEmptyElement(reader) == 1);
+			if (!skipped && !open.empty())
+				_load_attrib(reader, props, open.back(), this, raw, decode);
+			ret = xmlTextReaderNext(reader);
+			continue;
 		}
-		if (childName.compare("QuantumGate") == 0)
-		{
-			int gate_size = std::stoi(_getStringFromProp(xml_child, "gate_size"));
-			std::string name = _getStringFromProp(xml_child, "name");
-			int gate_length = std::stoi(_getStringFromProp(xml_child, "gate_length"));
-			QuantumGateType::type gate_type = std::stoi(_getStringFromProp(xml_child, "gate_type"));
-			double fidelity = std::stod(_getStringFromProp(xml_child, "fidelity"));
-			std::string unitary = _getStringFromProp(xml_child, "unitary");
-
-			new QuantumGate(components, id, ordered, gate_size, name, gate_length, gate_type, fidelity, unitary);
+
+		Component *c = _create_component(nodeName, props);
+		if (c == NULL) {
+			std::cerr << "importFromXml: unknown component element " << nodeName << " -- skipping its subtree." << std::endl;
+			ret = locator != NULL ? xmlTextReaderRead(reader) : xmlTextReaderNext(reader);
+			continue;
 		}
-		if (childName.compare("CouplingMap") == 0)
-		{
-			CouplingMap* cm = new CouplingMap(components, id, ordered);
+		addrToComponent[_parse_addr(props.Get("addr"))] = c;
+		if (open.empty())
+			root = c;
+		else
+			open.back()->InsertChild(c);
+		open.push_back(c);
+		ret = xmlTextReaderRead(reader);
+	}
+	xmlFreeTextReader(reader);
 
-			double fidelity = std::stod(_getStringFromProp(xml_child, "fidelity"));
-			cm->SetFidelity(fidelity);
-		}		
+	if (ret != 0) {
+		std::cerr << "importFromXml: failed to parse " << path << std::endl;
+		if (root != NULL)
+			root->Delete(true);
+		Clear();
+		return NULL;
 	}
-	return 1;
+	return root;
 }
 
-sys_sage::Component* sys_sage::importFromXml(
-	std::string path,
-	std::function<void*(xmlNodePtr)> _load_custom_attrib_fcn,
-	std::function<int(xmlNodePtr, Component *)> _load_custom_complex_attrib_fcn) 
-{
+// Collect Component c (and, if withSubtree, its subtree) and all Relations of the collected components.
+static void _collect_doomed(sys_sage::Component *c, bool withSubtree, std::unordered_set<const void *> *doomed) {
+	using namespace sys_sage;
+	std::vector<Component *> stack{c};
+	while (!stack.empty()) {
+		Component *cur = stack.back();
+		stack.pop_back();
+		doomed->insert(cur);
+		for (RelationType::type rt : RelationType::RelationTypeList)
+			for (Relation *r : cur->GetRelations(rt))
+				doomed->insert(r);
+		if (withSubtree)
+			stack.insert(stack.end(), cur->GetChildren().begin(), cur->GetChildren().end());
+	}
+}
 
-	load_custom_attrib_fcn = _load_custom_attrib_fcn;
-	load_custom_complex_attrib_fcn = _load_custom_complex_attrib_fcn;
+// Apply a delta written by exportDeltaToXml (pull parser, like Import).
+//
+// Sections are processed in document order: deletions first (the address of a deleted object
+// may have been reused by a new one), then the changed/new components (parents before children),
+// then the changed/new relations, whose components are known by then.
+int sys_sage::XmlImportContext::ApplyDelta(std::string path)
+{
+	// the changes were recorded on the (possibly collapsed) components as they are
+	SharedWriteScope scope;
+	xmlTextReaderPtr reader = xmlReaderForFile(path.c_str(), NULL, XML_PARSE_NOBLANKS | XML_PARSE_COMPACT);
+	if (reader == NULL) {
+		std::cerr << "XmlImportContext::ApplyDelta: cannot open " << path << std::endl;
+		return 1;
+	}
 
-	xmlInitParser();
-	xmlDocPtr doc = xmlReadFile(path.c_str(), NULL, 0);
-	xmlNodePtr sys_sage_root = xmlDocGetRootElement(doc);
-	// cout << "sys_sage_root->name = " << sys_sage_root->name << endl;
+	enum { OTHER, DELETED, COMPONENTS, RELATIONS } section = OTHER;
+	// objects destroyed by the deletions; their addresses are dropped from the tables after the Deleted section
+	std::unordered_set<const void *> doomed;
+	Component *current = NULL; // component of the current element in Components (NULL if skipped)
+	auto dropDoomed = [&]() {
+		if (doomed.empty())
+			return;
+		std::erase_if(addrToComponent, [&](const auto &e) { return doomed.count(e.second) > 0; });
+		std::erase_if(addrToRelation, [&](const auto &e) { return doomed.count(e.second) > 0; });
+		doomed.clear();
+	};
+	ElementProps props;
+	int status = 0;
+
+	int ret = xmlTextReaderRead(reader);
+	while (ret == 1) {
+		if (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT) {
+			ret = xmlTextReaderRead(reader);
+			continue;
+		}
+		int depth = xmlTextReaderDepth(reader);
+		std::string_view nodeName(reinterpret_cast<const char *>(xmlTextReaderConstName(reader)));
+
+		if (depth == 0) {
+			if (nodeName != "sys-sage-delta") {
+				std::cerr << "XmlImportContext::ApplyDelta: " << path << " is not a sys-sage delta." << std::endl;
+				status = 1;
+				break;
+			}
+			ret = xmlTextReaderRead(reader);
+			continue;
+		}
+		if (depth == 1) {
+			dropDoomed();
+			section = nodeName == "Deleted" ? DELETED : nodeName == "Components" ? COMPONENTS : nodeName == "Relations" ? RELATIONS : OTHER;
+			ret = section == OTHER ? xmlTextReaderNext(reader) : xmlTextReaderRead(reader);
+			continue;
+		}
 
-	Component *c = NULL;
-	for (xmlNodePtr n = sys_sage_root->children; n != NULL; n = n->next) {
-		if (xmlStrcmp(n->name, (const xmlChar *)"text") == 0) {
-			//do nothing
+		props.Load(xmlTextReaderCurrentNode(reader));
+		uintptr_t addr = _parse_addr(props.Get("addr"));
+		if (section == DELETED) {
+			// deleting a subtree may already have destroyed (but not yet unmapped) the object
+			if (nodeName == "Component") {
+				Component *c = GetComponentByAddr(addr);
+				if (c != NULL && !doomed.count(c)) {
+					bool withSubtree = props.Get("subtree") != "0";
+					_collect_doomed(c, withSubtree, &doomed);
+					c->Delete(withSubtree);
+				}
+			}
+			else if (nodeName == "Relation") {
+				Relation *r = GetRelationByAddr(addr);
+				if (r != NULL && !doomed.count(r)) {
+					doomed.insert(r);
+					r->Delete();
+				}
+			}
 		}
-		else if (xmlStrcmp(n->name, (const xmlChar *)"Components") == 0) {
-			c = _CreateComponentSubtree(n);
+		else if (section == COMPONENTS && depth == 2) {
+			current = GetComponentByAddr(addr);
+			Component *parent = NULL;
+			std::string_view parentAddr;
+			if (props.Get("parent", &parentAddr))
+				parent = GetComponentByAddr(_parse_addr(parentAddr));
+			if (current != NULL && current->GetComponentTypeStr() != nodeName) {
+				std::cerr << "XmlImportContext::ApplyDelta: component " << props.Get("addr") << " changed its type -- skipping it." << std::endl;
+				current = NULL;
+			}
+			else if (current != NULL) {
+				// the element lists all attributes of the component
+				std::vector<AttributeKey::type> keys;
+				if (current->GetAttributes() != nullptr)
+					for (const AttributeStore::Entry &e : current->GetAttributes()->GetEntries())
+						keys.push_back(e.key);
+				for (AttributeKey::type key : keys)
+					current->RemoveAttribute(key);
+				_load_component_props(current, props);
+				if (parent != NULL && parent != current->GetParent()) {
+					if (current->GetParent() != NULL)
+						current->GetParent()->RemoveChild(current);
+					parent->InsertChild(current);
+				}
+			}
+			else if (parent == NULL) {
+				std::cerr << "XmlImportContext::ApplyDelta: new component " << props.Get("addr") << " has no known parent -- skipping it." << std::endl;
+				status = 1;
+			}
+			else {
+				current = _create_component(nodeName, props);
+				if (current == NULL)
+					std::cerr << "XmlImportContext::ApplyDelta: unknown component element " << nodeName << " -- skipping it." << std::endl;
+				else {
+					parent->InsertChild(current);
+					addrToComponent[addr] = current;
+				}
+			}
+			// descend into the Attribute elements
+			ret = xmlTextReaderRead(reader);
+			continue;
 		}
-		else if (xmlStrcmp(n->name, (const xmlChar *)"Relations") == 0) {
-			_CreateRelations(n);
+		else if (section == COMPONENTS && depth == 3 && nodeName == "Attribute") {
+			if (current != NULL)
+				_load_attrib(reader, props, current, this);
 		}
+		else if (section == RELATIONS && depth == 2) {
+			// a changed Relation is replaced as a whole
+			Relation *old = GetRelationByAddr(addr);
+			if (old != NULL) {
+				addrToRelation.erase(addr);
+				old->Delete();
+			}
+			Relation *r = _create_relation(nodeName, props, addrToComponent);
+			if (r != NULL)
+				addrToRelation[addr] = r;
+		}
+		ret = xmlTextReaderNext(reader);
 	}
+	xmlFreeTextReader(reader);
+	dropDoomed();
 
-	return c;
+	if (ret == -1) {
+		std::cerr << "XmlImportContext::ApplyDelta: failed to parse " << path << std::endl;
+		return 1;
 	}
+	return status;
+}
+
+sys_sage::XmlImportContext::XmlImportContext(
+	std::function<void*(xmlNodePtr)> _customAttribFcn,
+	std::function<int(xmlNodePtr, Component *)> _customComplexAttribFcn,
+	bool _lazyAttributes)
+	: customAttribFcn(std::move(_customAttribFcn)), customComplexAttribFcn(std::move(_customComplexAttribFcn)), lazyAttributes(_lazyAttributes)
+{
+	_init_libxml();
+}
 
+sys_sage::Component* sys_sage::XmlImportContext::GetComponentByAddr(uintptr_t addr) const {
+	auto it = addrToComponent.find(addr);
+	return it == addrToComponent.end() ? NULL : it->second;
+}
+
+sys_sage::Relation* sys_sage::XmlImportContext::GetRelationByAddr(uintptr_t addr) const {
+	auto it = addrToRelation.find(addr);
+	return it == addrToRelation.end() ? NULL : it->second;
+}
+
+void sys_sage::XmlImportContext::Clear() {
+	addrToComponent.clear();
+	addrToRelation.clear();
+}
+
+sys_sage::Component* sys_sage::importFromXml(
+	std::string path,
+	std::function<void*(xmlNodePtr)> _load_custom_attrib_fcn,
+	std::function<int(xmlNodePtr, Component *)> _load_custom_complex_attrib_fcn,
+	bool lazyAttributes) 
+{
+	return XmlImportContext(std::move(_load_custom_attrib_fcn), std::move(_load_custom_complex_attrib_fcn), lazyAttributes).Import(path);
+}
@@ -1,7 +1,9 @@
 #ifndef XML_LOAD
 #define XML_LOAD
 
+#include <cstdint>
 #include <functional>
+#include <unordered_map>
 
 #include "Component.hpp"
 #include "DataPath.hpp"
@@ -14,37 +16,88 @@ namespace sys_sage {
      *
      * Parses the XML file at the given path and reconstructs both the Component tree and the Relations graph,
      * including all components, their attributes, and relations.
+     * The file is read with a streaming (pull) parser: components are created while reading, so the import needs memory for the created topology
+     * and the currently open elements only. The custom functions get the node of one Attribute element at a time.
      *
      * @param path Path to the XML file.
      * @param search_custom_attrib_key_fcn Optional user-provided function for custom attribute deserialization (string attributes).
      * @param search_custom_complex_attrib_key_fcn Optional user-provided function for custom attribute deserialization (complex attributes, e.g., XML nodes).
-     * @return Pointer to the root Component of the imported tree.
+     * @param lazyAttributes If true, attributes other than simple values of predefined keys are decoded on the first access (see XmlImportContext::lazyAttributes).
+     * @return Pointer to the root Component of the imported tree, or NULL if the file cannot be opened or parsed.
+     * @see XmlImportContext (same import with a reusable context)
      */
-    Component* importFromXml(std::string path, std::function<void*(xmlNodePtr)> search_custom_attrib_key_fcn = NULL, std::function<int(xmlNodePtr, Component*)> search_custom_complex_attrib_key_fcn = NULL);
+    Component* importFromXml(std::string path, std::function<void*(xmlNodePtr)> search_custom_attrib_key_fcn = NULL, std::function<int(xmlNodePtr, Component*)> search_custom_complex_attrib_key_fcn = NULL, bool lazyAttributes = false);
 
     /**
-     * @private
-     * @brief Extracts a string property from an XML node.
-     * @param n XML node pointer.
-     * @param prop Name of the property to extract.
-     * @return The property value as a string.
+     * @class XmlImportContext
+     * @brief State of XML imports: the custom attribute functions and the address tables of the last imported file (see importFromXml()), which ApplyDelta() keeps up to date.
+     *
+     * All state of an import lives in its context, so several threads can import at the same time, each with its own context.
+     * \n Example:
+     * ```cpp
+     * XmlImportContext ctx(my_attrib_fcn);
+     * Component* root = ctx.Import("topo.xml");
+     * Component* c = ctx.GetComponentByAddr(0x55d1c0a8e2f0); //"addr" of a component element in the file
+     * ```
      */
-    std::string _getStringFromProp(xmlNodePtr n, std::string prop);
-    /**
-     * @private
-     * @brief Creates Relation objects from an XML node.
-     * @param relationNode XML node representing the relation(s).
-     * @return 0 on success, nonzero on error.
-     */   
-    int _CreateRelations(xmlNodePtr relationNode);
+    class XmlImportContext {
+    public:
+        /**
+         * @param _customAttribFcn See importFromXml(): search_custom_attrib_key_fcn.
+         * @param _customComplexAttribFcn See importFromXml(): search_custom_complex_attrib_key_fcn.
+         * @param _lazyAttributes See lazyAttributes.
+         */
+        XmlImportContext(std::function<void*(xmlNodePtr)> _customAttribFcn = NULL, std::function<int(xmlNodePtr, Component*)> _customComplexAttribFcn = NULL, bool _lazyAttributes = false);
+        /**
+         * @brief Imports a topology from an XML file, see importFromXml(). Replaces the address table of the previous import.
+         * @param path Path to the XML file.
+         * @return Pointer to the root Component of the imported tree, or NULL if the file cannot be opened or parsed.
+         */
+        Component* Import(std::string path);
+        /**
+         * @brief Applies a delta written by exportDeltaToXml() onto the topology imported by the last Import() (deltas are applied in the order they were exported).
+         * Deleted components and relations are deleted, changed components are updated in place (properties and typed attributes; moved if their parent changed),
+         * new components are inserted below their parent, and changed relations are replaced. The address table is updated, so the next delta can be applied.
+         * @param path Path to the delta file.
+         * @return 0 on success; 1 if the file cannot be opened or parsed or some new component could not be placed (the rest of the delta is applied).
+         */
+        int ApplyDelta(std::string path);
+        /**
+         * @brief Returns the component imported from the element with the given "addr" in the last imported file (or an applied delta), or NULL.
+         */
+        Component* GetComponentByAddr(uintptr_t addr) const;
+        /**
+         * @brief Returns the Relation imported from the element with the given "addr" in the last imported file (or an applied delta), or NULL.
+         */
+        Relation* GetRelationByAddr(uintptr_t addr) const;
+        /**
+         * @brief Drops the address tables of the last import.
+         */
+        void Clear();
+
+        std::function<void*(xmlNodePtr)> customAttribFcn; /**< Custom function for simple attributes (may be NULL). */
+        std::function<int(xmlNodePtr, Component*)> customComplexAttribFcn; /**< Custom function for complex attributes (may be NULL). */
+        /**
+         * If true, Import() stores the XML text of complex and custom attributes (e.g. freq_history) as a LazyAttribute instead of decoding it;
+         * Component::GetAttribute() or Component::DecodeAttribute() decode it (with copies of the custom functions) on the first access.
+         * Simple values of predefined keys are always decoded. With custom functions, attributes with user-defined keys are decoded as well, so the values the functions
+         * store in the attrib map are there right after the import; the custom functions see lazy attributes of predefined keys only when those are decoded.
+         * Saves the decoding of large attributes that are never read. ApplyDelta() decodes eagerly.
+         */
+        bool lazyAttributes = false;
+    private:
+        std::unordered_map<uintptr_t, Component*> addrToComponent;
+        std::unordered_map<uintptr_t, Relation*> addrToRelation;
+    };
 
     /**
      * @private
-     * @brief Recursively creates a Component subtree from an XML node.
+     * @brief Extracts a string property from an XML node.
      * @param n XML node pointer.
-     * @return Pointer to the root Component of the created subtree.
+     * @param prop Name of the property to extract.
+     * @return The property value as a string (empty if the node has no such property).
      */
-    Component* _CreateComponentSubtree(xmlNodePtr n);
+    std::string _getStringFromProp(xmlNodePtr n, std::string prop);
     /**
      * @private
      * @brief Searches for and deserializes a default attribute from an XML node. Can be used as a reference for creating custom handlers.
@@ -67,9 +120,10 @@ namespace sys_sage {
      * @brief Collects all attributes from an XML node and adds them to a Component.
      * @param n XML node pointer.
      * @param c Pointer to the Component to attach the attributes to.
+     * @param ctx Import context with the custom functions (may be nullptr).
      * @return 0 on success, nonzero on error.
      */
-    int _collect_attrib(xmlNodePtr n, Component* c);
+    int _collect_attrib(xmlNodePtr n, Component* c, const XmlImportContext* ctx = nullptr);
 } //namespace sys_sage
 #endif
 
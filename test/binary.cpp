@@ -0,0 +1,198 @@
+#include <boost/ut.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+
+#include "sys-sage.hpp"
+
+using namespace boost::ut;
+using namespace sys_sage;
+
+//XML export of a topology with the addresses replaced by their order of first appearance (they differ between the original and the imported topology)
+static std::string _MaskedXml(Component* root, const std::string& path)
+{
+    exportToXml(root, path);
+    std::ifstream f(path);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    std::string xml = ss.str();
+    std::remove(path.c_str());
+
+    std::regex addr("0x[0-9a-f]+");
+    std::map<std::string, size_t> seen;
+    std::string out;
+    auto last = xml.cbegin();
+    for(std::sregex_iterator it(xml.begin(), xml.end(), addr), end; it != end; ++it)
+    {
+        out.append(last, (*it)[0].first);
+        auto [pos, inserted] = seen.try_emplace(it->str(), seen.size());
+        out += "@" + std::to_string(pos->second);
+        last = (*it)[0].second;
+    }
+    out.append(last, xml.cend());
+    return out;
+}
+
+//a topology with every component type, typed attributes and every relation type
+static Topology* _BuildTopology()
+{
+    Topology* topo = new Topology();
+    Node* node = new Node(topo, 1);
+    node->SetAttribute(AttributeKey::mig_uuid, std::string("MIG-1234"));
+    node->SetAttribute("custom_int", 42);
+    node->SetAttribute("custom_u64", uint64_t{1} << 40);
+    Chip* cpu = new Chip(node, 0, "CPU", ChipType::Cpu);
+    Numa* numa = new Numa(cpu, 0, 1LL << 33);
+    Cache* l3 = new Cache(numa, 0, 3, 32LL << 20, 16, 64);
+    Core* core = new Core(l3, 0);
+    core->SetAttribute(AttributeKey::freq_history, FrequencyHistory{{1000, 2.4e3}, {2000, 3.1e3}});
+    Thread* t0 = new Thread(core, 0);
+    Thread* t1 = new Thread(core, 1);
+    t1->SetAttribute("custom_double", 0.25);
+    Memory* mem = new Memory(node, 2, "DRAM", 1LL << 34);
+    new Storage(node, 1LL << 40);
+    Chip* gpu = new Chip(node, 1, "GPU", ChipType::Gpu);
+    Subdivision* sm = new Subdivision(gpu, 3, "SM");
+    sm->SetSubdivisionType(SubdivisionType::GpuSM);
+    new Component(sm, 7, "generic");
+
+    QuantumBackend* qb = new QuantumBackend(topo, 2, "qpu");
+    qb->SetNumQubits(2);
+    Qubit* q0 = new Qubit(qb, 0);
+    Qubit* q1 = new Qubit(qb, 1);
+    q0->SetProperties(100.5, 80.25, 0.97, 0.999, 1.5);
+    AtomSite* site = new AtomSite();
+    topo->InsertChild(site);
+    site->properties.nRows = 4;
+    site->properties.interactionRadius = 2.5;
+    site->shuttlingTimes["move"] = 12.5;
+    site->shuttlingAverageFidelities["move"] = 0.99;
+    site->shuttlingAverageFidelities["load"] = 0.95;
+
+    new DataPath(t0, mem, DataPathOrientation::Oriented, DataPathType::Physical, 1.5, 200);
+    DataPath* dp = new DataPath(mem, sm, DataPathOrientation::Bidirectional, DataPathType::Logical, 3, 40);
+    dp->SetAttribute("hops", 2LL);
+    dp->SetAttribute(AttributeKey::latency, 12.5f);
+    new DataPath(t1, t1, DataPathOrientation::Oriented, DataPathType::Logical);
+    new Relation({t0, t1, core}, 5, false);
+    new QuantumGate(2, std::vector<Qubit*>{q0, q1}, "cx", 0.98, "u");
+    CouplingMap* cm = new CouplingMap(q0, q1);
+    cm->SetFidelity(0.9);
+    return topo;
+}
+
+static suite<"binary"> _ = [] {
+
+  "round trip"_test = [] {
+    Topology* topo = _BuildTopology();
+    expect(that % 0 == exportToBinary(topo, "test_roundtrip.bin"));
+    Component* imported = importFromBinary("test_roundtrip.bin");
+    std::remove("test_roundtrip.bin");
+    expect(that % (imported != nullptr) >> fatal);
+    if(imported == nullptr)
+      return;
+
+    //same result as the XML export of the original topology
+    expect(_MaskedXml(topo, "test_binary_a.xml") == _MaskedXml(imported, "test_binary_b.xml"));
+
+    //members that the XML export does not cover
+    Qubit* q0 = (Qubit*)imported->GetSubcomponentById(0, ComponentType::Qubit);
+    expect(that % (q0 != nullptr) >> fatal);
+    if(q0 != nullptr)
+    {
+      expect(that % 100.5 == q0->GetT1());
+      expect(that % 80.25 == q0->GetT2());
+      expect(that % 1.5 == q0->GetReadoutLength());
+    }
+    AtomSite* site = nullptr;
+    for(Component* c : imported->GetChildren())
+      if(dynamic_cast<AtomSite*>(c) != nullptr)
+        site = (AtomSite*)c;
+    expect(that % (site != nullptr) >> fatal);
+    if(site != nullptr)
+    {
+      expect(that % 4 == site->properties.nRows);
+      expect(that % 2.5 == site->properties.interactionRadius);
+      expect(that % 12.5 == site->shuttlingTimes["move"]);
+      expect(that % 0.95 == site->shuttlingAverageFidelities["load"]);
+      expect(that % (site->shuttlingAverageFidelities.size() == 2));
+    }
+    Thread* t1 = (Thread*)imported->GetSubcomponentById(1, ComponentType::Thread);
+    expect(that % (t1 != nullptr) >> fatal);
+    if(t1 != nullptr)
+    {
+      expect(that % 0.25 == *t1->GetAttribute<double>("custom_double"));
+      expect(that % (t1->GetRelations(RelationType::Relation).size() == 1));
+    }
+
+    topo->Delete(true);
+    imported->Delete(true);
+  };
+
+  "view"_test = [] {
+    Topology* topo = _BuildTopology();
+    expect(that % 0 == exportToBinary(topo, "test_view.bin"));
+    size_t numComponents = 0;
+    for(Component* c : topo->PreOrder())
+    {
+      (void)c;
+      numComponents++;
+    }
+    topo->Delete(true);
+
+    BinaryTopologyView v;
+    expect(that % 0 == v.Open("test_view.bin") >> fatal);
+    std::remove("test_view.bin"); //the mapping stays valid
+    expect(that % numComponents == v.GetNumComponents());
+    expect(that % 6u == v.GetNumRelations());
+    const BinaryComponentRecord& root = v.GetComponent(0);
+    expect(that % ComponentType::Topology == static_cast<ComponentType::type>(root.componentType));
+    expect(that % BinaryFormat::npos == root.parent);
+    expect(that % v.GetNumComponents() == root.subtreeEnd);
+    const BinaryComponentRecord& node = v.GetComponent(1);
+    expect(v.GetString(node.name) == "Node");
+    const BinaryAttributeRecord* attrs = v.GetAttributes(node.firstAttribute, node.numAttributes);
+    expect(that % (attrs != nullptr) >> fatal);
+    expect(that % 3u == node.numAttributes);
+    if(attrs != nullptr)
+    {
+      expect(v.GetString(attrs[0].key) == "mig_uuid");
+      expect(v.GetString(attrs[0].value) == "MIG-1234");
+    }
+    //the children of the node are the ranges between the subtree ends
+    size_t numChildren = 0;
+    for(uint32_t c = 2; c < node.subtreeEnd; c = v.GetComponent(c).subtreeEnd)
+    {
+      expect(that % 1u == v.GetComponent(c).parent);
+      numChildren++;
+    }
+    expect(that % 4 == numChildren);
+    v.Close();
+    expect(!v.IsOpen());
+  };
+
+  "invalid file"_test = [] {
+    expect(importFromBinary("does-not-exist.bin") == nullptr);
+    Topology topo;
+    exportToXml(&topo, "test_not_binary.xml");
+    expect(importFromBinary("test_not_binary.xml") == nullptr);
+    std::remove("test_not_binary.xml");
+
+    //truncated file
+    Topology* t = _BuildTopology();
+    exportToBinary(t, "test_truncated.bin");
+    t->Delete(true);
+    std::ifstream in("test_truncated.bin", std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    std::ofstream out("test_truncated.bin", std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), bytes.size() / 2);
+    out.close();
+    expect(importFromBinary("test_truncated.bin") == nullptr);
+    std::remove("test_truncated.bin");
+  };
+};
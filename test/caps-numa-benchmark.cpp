@@ -101,3 +101,70 @@ static suite<"caps-numa-benchmark"> _ = []
         expect(that % 246 == dp(3, 3)->GetLatency());
     };
 };
+
+static suite<"table-reader"> table_reader = []
+{
+    "Quotes, delimiters, and line breaks"_test = []
+    {
+        TableReader reader("; ");
+        reader.OpenBuffer("a; \"b; c\"; \"d\"\"e\"\r\n\n  x ; \"B\"Load; \"multi\nline\"\nlast; "sv);
+        std::vector<std::string_view> row;
+
+        expect(that % reader.NextRow(&row) >> fatal);
+        expect(that % 1u == reader.GetLineNumber());
+        expect(that % 3u == row.size() >> fatal);
+        expect(that % "a"sv == row[0]);
+        expect(that % "b; c"sv == row[1]);
+        expect(that % "d\"e"sv == row[2]);
+
+        expect(that % reader.NextRow(&row) >> fatal);
+        expect(that % 3u == reader.GetLineNumber());
+        expect(that % 3u == row.size() >> fatal);
+        expect(that % "x"sv == row[0]);
+        expect(that % "BLoad"sv == row[1]);
+        expect(that % "multi\nline"sv == row[2]);
+
+        expect(that % reader.NextRow(&row) >> fatal);
+        expect(that % 5u == reader.GetLineNumber());
+        expect(that % 2u == row.size() >> fatal);
+        expect(that % "last"sv == row[0]);
+        expect(that % ""sv == row[1]);
+        expect(!reader.NextRow(&row));
+    };
+
+    "Raw fields and empty rows"_test = []
+    {
+        TableReader reader(",", false, 0);
+        reader.skipEmptyRows = false;
+        reader.OpenBuffer(" a ,\"b\"\n\n"sv);
+        std::vector<std::string_view> row;
+
+        expect(that % reader.NextRow(&row) >> fatal);
+        expect(that % 2u == row.size() >> fatal);
+        expect(that % " a "sv == row[0]);
+        expect(that % "\"b\""sv == row[1]);
+        expect(that % reader.NextRow(&row) >> fatal);
+        expect(that % 1u == row.size() >> fatal);
+        expect(that % ""sv == row[0]);
+        expect(!reader.NextRow(&row));
+    };
+
+    "Numbers"_test = []
+    {
+        int i = 0;
+        double d = 0;
+        unsigned long long u = 0;
+        expect(TableReader::ParseNumber("-42"sv, &i) && i == -42);
+        expect(TableReader::ParseNumber("+2.5"sv, &d) && d == 2.5);
+        expect(TableReader::ParseNumber("24904642560"sv, &u) && u == 24904642560ull);
+        expect(!TableReader::ParseNumber("12x"sv, &i) && i == -42);
+        expect(!TableReader::ParseNumber(""sv, &i));
+        expect(!TableReader::ParseNumber("-1"sv, &u));
+    };
+
+    "Missing file"_test = []
+    {
+        TableReader reader;
+        expect(that % 1 == reader.Open("/nonexistent/table.csv"));
+    };
+};
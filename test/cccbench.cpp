@@ -0,0 +1,47 @@
+#include <boost/ut.hpp>
+
+#include "sys-sage.hpp"
+
+using namespace boost::ut;
+using namespace sys_sage;
+
+static suite<"cccbench"> _ = []
+{
+    Topology topo;
+    Node node{&topo};
+    Core c1{&node, 1};
+    Core c2{&node, 2};
+    Core c3{&node, 3};
+    expect(that % (0 == parseCccbenchOutput(&node, SYS_SAGE_TEST_RESOURCE_DIR "/cccbench.csv")) >> fatal);
+
+    "Latency statistics"_test = [&]
+    {
+        CccbenchParser parser(SYS_SAGE_TEST_RESOURCE_DIR "/cccbench.csv");
+        const LatencyMatrix &m = parser.GetLatencyMatrix();
+        expect(that % 2u == m.GetDimension() >> fatal);
+        expect(that % 3u == m.GetCount(0, 1));
+        expect(that % 0u == m.GetCount(0, 0));
+        expect(that % 11.5f == m.GetMean(0, 1));
+        expect(that % 10.5f == m.GetMin(0, 1));
+        expect(that % 12.5f == m.GetMax(0, 1));
+        expect(that % 1.0f == m.GetVariance(0, 1));
+        expect(that % 21.0f == m.GetMean(1, 0));
+        expect(that % 2.0f == m.GetVariance(1, 0));
+    };
+
+    "Data paths"_test = [&]
+    {
+        expect(that % 0u == c1.GetAllDataPaths(DataPathType::Any, DataPathDirection::Any).size());
+        const auto &dps = c2.GetAllDataPaths(DataPathType::Any, DataPathDirection::Outgoing);
+        expect(that % 1u == dps.size() >> fatal);
+        DataPath *dp = dps[0];
+        expect(that % DataPathType::C2C == dp->GetDataPathType());
+        expect(that % &c3 == dp->GetTarget());
+        expect(that % 11.5 == dp->GetLatency());
+        expect(that % 11.5f == *dp->GetAttribute<float>(AttributeKey::latency));
+        expect(that % 10.5f == *dp->GetAttribute<float>(AttributeKey::latency_min));
+        expect(that % 12.5f == *dp->GetAttribute<float>(AttributeKey::latency_max));
+        expect(that % 3u == *dp->GetAttribute<uint64_t>(AttributeKey::latency_count));
+        expect(that % 1.0f == *dp->GetAttribute<float>(AttributeKey::latency_variance));
+    };
+};
@@ -0,0 +1,195 @@
+#include <boost/ut.hpp>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sys-sage.hpp"
+
+using namespace boost::ut;
+using namespace sys_sage;
+
+namespace {
+    //counts the live instances to check when retired attribute values are destroyed
+    struct Counted
+    {
+        static inline int alive = 0;
+        int v;
+        Counted(int _v) : v(_v) { alive++; }
+        Counted(const Counted& o) : v(o.v) { alive++; }
+        ~Counted() { alive--; }
+    };
+}
+
+static suite<"concurrency"> _ = []
+{
+    "Enable and disable concurrent reads"_test = []
+    {
+        Topology* topo = new Topology();
+        Node* node = new Node(topo, 0);
+        Chip* chip = new Chip(node, 0);
+        Memory* mem = new Memory(node, 0);
+        new DataPath(chip, mem, DataPathOrientation::Oriented, DataPathType::Physical);
+
+        expect(!topo->IsConcurrentReadsEnabled());
+        expect(that % 0 == topo->EnableConcurrentReads());
+        expect(that % 1 == topo->EnableConcurrentReads());
+        expect(topo->IsConcurrentReadsEnabled());
+        expect(that % 1 == chip->GetRelations(RelationType::DataPath).size());
+
+        {
+            WriteGuard guard(topo);
+            new DataPath(mem, chip, DataPathOrientation::Oriented, DataPathType::Physical);
+            //the writer sees its own changes immediately...
+            expect(that % 2 == chip->GetRelations(RelationType::DataPath).size());
+        }
+        //...the readers once the outermost guard is released
+        {
+            ReadGuard guard(topo);
+            expect(that % 2 == chip->GetRelations(RelationType::DataPath).size());
+            expect(that % 2 == mem->GetRelations(RelationType::DataPath).size());
+        }
+
+        //components attached later are covered as well
+        Memory* mem2 = new Memory(node, 1);
+        {
+            WriteGuard guard(topo);
+            new DataPath(chip, mem2, DataPathOrientation::Oriented, DataPathType::Physical);
+        }
+        {
+            ReadGuard guard(topo);
+            expect(that % 1 == mem2->GetRelations(RelationType::DataPath).size());
+            expect(that % 3 == chip->GetRelations(RelationType::DataPath).size());
+        }
+
+        topo->DisableConcurrentReads();
+        expect(!topo->IsConcurrentReadsEnabled());
+        chip->DeleteAllRelations(RelationType::DataPath);
+        expect(that % 0 == chip->GetRelations(RelationType::DataPath).size());
+        expect(that % 0 == mem2->GetRelations(RelationType::DataPath).size());
+        topo->Delete(true);
+    };
+
+    "Deferred reclamation"_test = []
+    {
+        Topology* topo = new Topology();
+        Node* node = new Node(topo, 0);
+        Chip* chip = new Chip(node, 0);
+        Memory* mem = new Memory(node, 0);
+        DataPath* dp = new DataPath(chip, mem, DataPathOrientation::Oriented, DataPathType::MIG);
+        dp->SetAttribute("counted", Counted{1});
+        chip->SetAttribute(AttributeKey::mig_uuid, std::string("MIG-old"));
+        topo->EnableConcurrentReads();
+        EpochDomain* domain = topo->GetEpochDomain();
+        expect(domain != nullptr);
+
+        {
+            ReadGuard reader(topo);
+            Relation* seen = chip->GetRelations(RelationType::DataPath)[0];
+            std::string* seenUuid = chip->GetAttribute<std::string>(AttributeKey::mig_uuid);
+            {
+                WriteGuard writer(topo);
+                dp->Delete();
+                chip->SetAttribute(AttributeKey::mig_uuid, std::string("MIG-new"));
+            }
+            //unlinked and replaced...
+            expect(that % 0 == chip->GetRelations(RelationType::DataPath).size());
+            expect(that % "MIG-new" == *chip->GetAttribute<std::string>(AttributeKey::mig_uuid));
+            //...but not destroyed while the reader may still use them
+            expect(that % 1 == Counted::alive);
+            expect(that % 1 == seen->GetAttribute<Counted>("counted")->v);
+            expect(that % "MIG-old" == *seenUuid);
+            expect(domain->GetNumRetired() > 0_u);
+        }
+        domain->Synchronize();
+        expect(that % 0 == Counted::alive);
+        expect(that % 0 == domain->GetNumRetired());
+        topo->Delete(true);
+    };
+
+    "Concurrent readers and a refresher"_test = []
+    {
+        constexpr int numSMs = 8;
+        constexpr int numReaders = 4;
+        constexpr long long numGenerations = 300;
+
+        Topology* topo = new Topology();
+        Node* node = new Node(topo, 0);
+        Chip* gpu = new Chip(node, 0, "GPU", ChipType::Gpu);
+        std::vector<Subdivision*> sms;
+        for(int i = 0; i < numSMs; i++)
+        {
+            sms.push_back(new Subdivision(gpu, i, "SM"));
+            sms.back()->SetSubdivisionType(SubdivisionType::GpuSM);
+        }
+
+        //one generation of MIG settings: a DataPath gpu -> SM per SM, all carrying the same generation
+        auto publishGeneration = [&](long long generation) {
+            WriteGuard guard(topo);
+            gpu->DeleteAllRelations(RelationType::DataPath);
+            for(Subdivision* sm : sms)
+            {
+                DataPath* dp = new DataPath(gpu, sm, DataPathOrientation::Oriented, DataPathType::MIG);
+                dp->SetAttribute(AttributeKey::mig_size, generation);
+                dp->SetAttribute(AttributeKey::mig_uuid, "MIG-" + std::to_string(generation));
+            }
+            gpu->SetAttribute(AttributeKey::mig_size, generation);
+        };
+        publishGeneration(0);
+        topo->EnableConcurrentReads();
+
+        std::atomic<bool> done{false};
+        std::atomic<int> errors{0};
+        std::atomic<long long> snapshots{0};
+        std::vector<std::thread> readers;
+        for(int r = 0; r < numReaders; r++)
+        {
+            readers.emplace_back([&] {
+                do
+                {
+                    ReadGuard guard(topo);
+                    const std::vector<Relation*>& dps = gpu->GetRelations(RelationType::DataPath);
+                    if(dps.size() != numSMs)
+                    {
+                        errors++;
+                        continue;
+                    }
+                    long long* first = dps[0]->GetAttribute<long long>(AttributeKey::mig_size);
+                    if(first == nullptr)
+                    {
+                        errors++;
+                        continue;
+                    }
+                    for(Relation* dp : dps)
+                    {
+                        long long* generation = dp->GetAttribute<long long>(AttributeKey::mig_size);
+                        std::string* uuid = dp->GetAttribute<std::string>(AttributeKey::mig_uuid);
+                        if(dp->GetComponents().size() != 2 || generation == nullptr || *generation != *first || uuid == nullptr || *uuid != "MIG-" + std::to_string(*first))
+                            errors++;
+                    }
+                    if(gpu->GetAttribute<long long>(AttributeKey::mig_size) == nullptr)
+                        errors++;
+                    snapshots++;
+                } while(!done.load());
+            });
+        }
+
+        std::thread refresher([&] {
+            for(long long generation = 1; generation <= numGenerations; generation++)
+                publishGeneration(generation);
+            done.store(true);
+        });
+        refresher.join();
+        for(std::thread& t : readers)
+            t.join();
+
+        expect(that % 0 == errors.load());
+        expect(snapshots.load() > 0ll);
+        expect(that % numGenerations == *gpu->GetAttribute<long long>(AttributeKey::mig_size));
+        topo->GetEpochDomain()->Synchronize();
+        expect(that % 0 == topo->GetEpochDomain()->GetNumRetired());
+        for(Subdivision* sm : sms)
+            expect(that % 1 == sm->GetRelations(RelationType::DataPath).size());
+        topo->Delete(true);
+    };
+};
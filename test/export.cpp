@@ -7,8 +7,10 @@
 
 #include "sys-sage.hpp"
 
+#include <fstream>
 #include <memory>
 #include <set>
+#include <sstream>
 #include <string>
 
 using namespace sys_sage;
@@ -265,4 +267,193 @@ static suite<"export"> _ = []
             }
         }
     };
+
+    "Escaping, deep nesting and write errors"_test = []
+    {
+        const std::string name = "<a & \"b\">\tc\nd\r";
+        {
+            Topology topo;
+            Component* parent = &topo;
+            for (int i = 0; i < 40; ++i)
+                parent = new Component(parent, i, name);
+            expect(that % 0 == exportToXml(&topo, "test_escaping.xml"));
+            expect(that % 1 == exportToXml(&topo, "/nonexistent-dir/test.xml"));
+            topo.DeleteSubtree();
+        }
+
+        auto doc = raii<xmlDoc>{xmlParseFile("test_escaping.xml"), xmlFreeDoc};
+        expect(that % (doc != nullptr) >> fatal);
+        auto pathContext = raii<xmlXPathContext>{xmlXPathNewContext(doc.get()), xmlXPathFreeContext};
+        auto deepest = raii<xmlXPathObject>{xmlXPathEvalExpression(BAD_CAST("//GenericComponent[@id='39']"), pathContext.get()), xmlXPathFreeObject};
+        expect(that % (deepest->nodesetval != nullptr && deepest->nodesetval->nodeNr == 1) >> fatal);
+        auto value = raii<xmlChar>{xmlGetProp(deepest->nodesetval->nodeTab[0], BAD_CAST("name")), [](xmlChar *p) { xmlFree(p); }};
+        expect(that % XmlStringView{BAD_CAST(name.c_str())} == XmlStringView{value.get()});
+    };
+
+    "Typed attributes round trip"_test = []
+    {
+        {
+            Topology topo;
+            Node node{&topo, 1};
+            node.SetAttribute(AttributeKey::CATcos, uint64_t{12});
+            node.SetAttribute(AttributeKey::mig_size, 1LL << 40);
+            node.SetAttribute(AttributeKey::Clock_Frequency, 1.25);
+            node.SetAttribute(AttributeKey::latency, 7.5f);
+            node.SetAttribute(AttributeKey::CUDA_compute_capability, std::string("8.6"));
+            node.SetAttribute(AttributeKey::freq_history, FrequencyHistory{{100, 2400.5}, {200, 1200.0}});
+            exportToXml(&topo, "test_typed.xml");
+        }
+        validate("test_typed.xml");
+
+        Component* topo = importFromXml("test_typed.xml");
+        expect(that % (topo != nullptr) >> fatal);
+        Component* node = topo->GetChild(1);
+        expect(that % (node != nullptr) >> fatal);
+        expect(that % uint64_t{12} == *node->GetAttribute<uint64_t>(AttributeKey::CATcos));
+        expect(that % (1LL << 40) == *node->GetAttribute<long long>(AttributeKey::mig_size));
+        expect(that % 1.25 == *node->GetAttribute<double>(AttributeKey::Clock_Frequency));
+        expect(that % 7.5f == *node->GetAttribute<float>(AttributeKey::latency));
+        expect(that % std::string("8.6") == *node->GetAttribute<std::string>(AttributeKey::CUDA_compute_capability));
+        const FrequencyHistory* fh = node->GetAttribute<FrequencyHistory>(AttributeKey::freq_history);
+        expect(that % (fh != nullptr) >> fatal);
+        expect(that % 2 == fh->size());
+        expect(that % 200 == std::get<0>(fh->at(1)));
+        expect(that % 1200.0 == std::get<1>(fh->at(1)));
+        topo->DeleteSubtree();
+        delete topo;
+    };
+
+    "Parallel export"_test = []
+    {
+        auto read = [](const std::string& path) {
+            std::ifstream f(path);
+            std::stringstream ss;
+            ss << f.rdbuf();
+            return ss.str();
+        };
+        auto print_custom = [](std::string key, void *value, xmlNode *xml) -> int
+        {
+            if (key != "rack")
+                return 0;
+            xmlNode *attrib = xmlNewNode(nullptr, BAD_CAST("Attribute"));
+            xmlNewProp(attrib, BAD_CAST("name"), BAD_CAST(key.c_str()));
+            xmlNewProp(attrib, BAD_CAST("value"), BAD_CAST(std::to_string(*(int *)value).c_str()));
+            xmlAddChild(xml, attrib);
+            return 1;
+        };
+
+        Topology topo;
+        topo.SetAttribute("cluster", std::string("test"));
+        std::vector<int> racks(16);
+        std::vector<Thread*> firstThreads;
+        for (int n = 0; n < 16; ++n)
+        {
+            Node* node = new Node(&topo, n);
+            racks[n] = n / 4;
+            node->attrib["rack"] = &racks[n];
+            Memory* mem = new Memory(node, 0, "DRAM", 1LL << 34);
+            for (int c = 0; c < 8; ++c)
+            {
+                Core* core = new Core(node, c);
+                core->SetAttribute(AttributeKey::freq_history, FrequencyHistory{{100, 2400.5}});
+                Thread* t = new Thread(core, c);
+                new DataPath(t, mem, DataPathOrientation::Oriented, DataPathType::Physical, 10, 100);
+                if (c == 0)
+                    firstThreads.push_back(t);
+            }
+        }
+        //Relations across subtrees are written with the subtree of their first component
+        for (size_t n = 1; n < firstThreads.size(); ++n)
+            new DataPath(firstThreads[n], firstThreads[n - 1], DataPathOrientation::Bidirectional, DataPathType::Logical, 1, 1000);
+        new Relation({&topo, firstThreads[0]}, 0, true);
+
+        expect(that % 0 == exportToXml(&topo, "test_serial.xml", nullptr, print_custom));
+        //not limited to the cores, so the threads are used even on a single-core machine
+        XmlExportContext ctx(nullptr, print_custom, 4);
+        ctx._limitParallelismToCores = false;
+        expect(that % 0 == ctx.Export(&topo, "test_parallel.xml"));
+        expect(that % 0 == exportToXml(&topo, "test_parallel_auto.xml", nullptr, print_custom, 0));
+        std::string serial = read("test_serial.xml");
+        expect(that % serial.size() > 0u);
+        expect(serial == read("test_parallel.xml"));
+        expect(serial == read("test_parallel_auto.xml"));
+        validate("test_parallel.xml");
+        topo.DeleteSubtree();
+    };
+
+    "Filtered export"_test = []
+    {
+        Topology topo;
+        Node* node = new Node(&topo, 0);
+        Chip* chip = new Chip(node, 0);
+        Numa* numa0 = new Numa(chip, 0, 1LL << 30);
+        Numa* numa1 = new Numa(chip, 1, 1LL << 30);
+        Cache* l3 = new Cache(chip, 0, "3", 1 << 25);
+        l3->SetAttribute(AttributeKey::Clock_Frequency, 2.5);
+        l3->SetAttribute("vendor_note", std::string("x"));
+        for (int c = 0; c < 2; ++c)
+        {
+            Cache* l2 = new Cache(l3, c, "2", 1 << 20);
+            Core* core = new Core(l2, c);
+            new Thread(core, c);
+        }
+        new DataPath(numa0, numa1, DataPathOrientation::Bidirectional, DataPathType::Physical, 10, 100);
+        new DataPath(numa0, chip, DataPathOrientation::Oriented, DataPathType::Physical, 10, 100);
+        new Relation({l3, numa0}, 0, true);
+
+        XmlExportContext ctx;
+        ctx.filter.componentTypes = ComponentType::ToMask(ComponentType::Cache) | ComponentType::ToMask(ComponentType::Numa);
+        ctx.filter.relationTypes = RelationType::ToMask(RelationType::DataPath);
+        ctx.filter.internalRelationsOnly = true;
+        ctx.filter.attributes = {"Clock_Frequency"};
+        expect(that % 0 == ctx.Export(node, "test_filtered.xml"));
+        validate("test_filtered.xml");
+
+        Component* imported = importFromXml("test_filtered.xml");
+        expect(that % (imported != nullptr) >> fatal);
+        expect(that % ComponentType::Node == imported->GetComponentType());
+        //the Chip is left out, its children are written below the Node
+        expect(that % 3 == imported->GetChildren().size());
+        expect(that % 0 == imported->CountAllSubcomponentsByType(ComponentType::Core));
+        expect(that % 0 == imported->CountAllSubcomponentsByType(ComponentType::Thread));
+        expect(that % 3 == imported->CountAllSubcomponentsByType(ComponentType::Cache));
+        Component* l3i = imported->GetChild(0);
+        for (Component* c : imported->GetChildren())
+            if (c->GetComponentType() == ComponentType::Cache)
+                l3i = c;
+        expect(that % ComponentType::Cache == l3i->GetComponentType());
+        expect(l3i->HasAttribute(AttributeKey::Clock_Frequency));
+        expect(!l3i->HasAttribute("vendor_note"));
+        //only the DataPath between the two NUMA nodes is inside the exported set
+        std::set<DataPath*> dataPaths;
+        for (Component* c : imported->PreOrder())
+            for (DataPath* dp : c->GetAllDataPaths())
+                dataPaths.insert(dp);
+        expect(that % 1 == dataPaths.size());
+        imported->Delete(true);
+
+        XmlExportContext shallow;
+        shallow.filter.maxDepth = 1;
+        expect(that % 0 == shallow.Export(node, "test_filtered.xml"));
+        imported = importFromXml("test_filtered.xml");
+        expect(that % (imported != nullptr) >> fatal);
+        expect(that % 1 == imported->GetChildren().size());
+        expect(that % 0 == imported->GetChild(0)->GetChildren().size());
+        imported->Delete(true);
+        std::remove("test_filtered.xml");
+
+        //user-defined types are selected by their own ToMask() bit
+        struct Custom : Component
+        {
+            Custom(Component *parent, int id) : Component(parent, id, "custom", 100) {}
+        };
+        Custom* custom = new Custom(chip, 0);
+        XmlExportFilter f;
+        f.componentTypes = ComponentType::ToMask(100);
+        expect(f.IncludesComponent(custom, node));
+        expect(!f.IncludesComponent(l3, node));
+        f.componentTypes = ComponentType::ToMask(ComponentType::Cache);
+        expect(!f.IncludesComponent(custom, node));
+        topo.DeleteSubtree();
+    };
 };
@@ -1,12 +1,31 @@
 #include "sys-sage.hpp"
 
 #include <boost/ut.hpp>
+#include <fstream>
+#include <sstream>
+#include <string>
 #include <string_view>
 
 using namespace boost::ut;
 using namespace sys_sage;
 using namespace std::string_view_literals;
 
+// Describes the subtree of c (types, ids, names, hwloc fields) for comparing the results of the parsers.
+static std::string describe(Component *c)
+{
+    std::string s = c->GetComponentTypeStr() + " " + std::to_string(c->GetId()) + " " + c->GetName();
+    if (auto cache = dynamic_cast<Cache *>(c))
+        s += " " + std::to_string(cache->GetCacheLevel()) + " " + std::to_string(cache->GetCacheSize()) + " " + std::to_string(cache->GetCacheAssociativityWays()) + " " + std::to_string(cache->GetCacheLineSize());
+    else if (auto numa = dynamic_cast<Numa *>(c))
+        s += " " + std::to_string(numa->GetSize());
+    else if (auto chip = dynamic_cast<Chip *>(c))
+        s += " " + chip->GetVendor() + " " + chip->GetModel();
+    s += " {";
+    for (Component *child : c->GetChildren())
+        s += describe(child) + ",";
+    return s + "}";
+}
+
 static suite<"hwloc"> _ = []
 {
     Topology topo;
@@ -60,4 +79,67 @@ static suite<"hwloc"> _ = []
 
     auto thread = dynamic_cast<Thread *>(core->GetChildByType(ComponentType::Thread));
     expect(that % (thread != nullptr) >> fatal);
+
+    "xml buffer"_test = [&]
+    {
+        std::ifstream f(SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml");
+        std::stringstream ss;
+        ss << f.rdbuf();
+        std::string xml = ss.str();
+
+        Topology topo2;
+        Node node2{&topo2};
+        expect(that % 0 == parseHwlocTopology(&node2, xml.c_str(), static_cast<int>(xml.size()) + 1) >> fatal);
+        expect(describe(&node) == describe(&node2));
+        topo2.RemoveChild(&node2);
+        node2.DeleteSubtree();
+    };
+
+    "cache before numa"_test = []
+    {
+        Topology topo2;
+        Node *node2 = new Node(&topo2);
+        expect(that % 0 == parseHwlocOutput(node2, SYS_SAGE_TEST_RESOURCE_DIR "/hwloc_cache_before_numa.xml") >> fatal);
+
+        auto chip2 = node2->GetChildByType(ComponentType::Chip);
+        expect(that % (chip2 != nullptr) >> fatal);
+        auto numa2 = chip2->GetChildByType(ComponentType::Numa);
+        expect(that % (numa2 != nullptr) >> fatal);
+        expect(that % _u(1) == chip2->GetChildren().size());
+        auto cache2 = numa2->GetChildByType(ComponentType::Cache);
+        expect(that % (cache2 != nullptr) >> fatal);
+        expect(that % (numa2 == cache2->GetParent()));
+        expect(that % (numa2 != numa2->GetParent()));
+        expect(that % 2 == node2->CountAllSubcomponentsByType(ComponentType::Thread));
+        topo2.DeleteSubtree();
+    };
+
+#ifdef DS_HWLOC
+    "hwloc topology"_test = []
+    {
+        for (const char *synthetic : {"pack:2 [numa] l3:1 core:4 pu:2", "pack:2 l3:1 numa:2 core:2 pu:1", "node:2 pack:1 l2:2 core:1 pu:2"})
+        {
+            hwloc_topology_t ht;
+            hwloc_topology_init(&ht);
+            expect(that % 0 == hwloc_topology_set_synthetic(ht, synthetic) >> fatal);
+            expect(that % 0 == hwloc_topology_load(ht) >> fatal);
+            char *buf;
+            int len;
+            expect(that % 0 == hwloc_topology_export_xmlbuffer(ht, &buf, &len, 0) >> fatal);
+
+            Topology t1, t2;
+            Node *n1 = new Node(&t1);
+            Node *n2 = new Node(&t2);
+            expect(that % 0 == parseHwlocTopology(n1, ht) >> fatal);
+            expect(that % 0 == parseHwlocTopology(n2, buf, len) >> fatal);
+            expect(describe(n1) == describe(n2)) << synthetic;
+            expect(that % 0 < n1->CountAllSubcomponentsByType(ComponentType::Thread));
+
+            hwloc_free_xmlbuffer(ht, buf);
+            hwloc_topology_destroy(ht);
+            t1.DeleteSubtree();
+            t2.DeleteSubtree();
+        }
+    };
+#endif
 };
@@ -1,6 +1,8 @@
 #include <boost/ut.hpp>
 
 #include <cstdio>
+#include <filesystem>
+#include <fstream>
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 #include <libxml/xmlschemas.h>
@@ -9,8 +11,11 @@
 #include "sys-sage.hpp"
 
 #include <memory>
+#include <regex>
 #include <set>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 // Test that we can import XML files
@@ -54,6 +59,319 @@ static suite<"import"> _ = [] {
 
 
   };
+
+  "round trip"_test = [] {
+    {
+      Topology topo;
+      Node* node = new Node(&topo, 1);
+      Chip* gpu = new Chip(node, 0, "GPU", ChipType::Gpu);
+      Subdivision* sm = new Subdivision(gpu, 3, "SM");
+      sm->SetSubdivisionType(SubdivisionType::GpuSM);
+      Memory* mem = new Memory(node, 2, "HBM", 1LL << 34);
+      new Component(sm, 7, "generic");
+      (new Thread(sm, 64, "GPU Core"))->SetCount(64);
+      sm->SetAttribute(AttributeKey::CUDA_compute_capability, std::string("8.6"));
+      new DataPath(gpu, mem, DataPathOrientation::Oriented, DataPathType::Physical, 1.5, 200);
+      new DataPath(mem, sm, DataPathOrientation::Bidirectional, DataPathType::Logical, 3, 40);
+      exportToXml(&topo, "test_roundtrip.xml");
+      topo.DeleteSubtree();
+    }
+
+    Component* topo = importFromXml("test_roundtrip.xml");
+    expect(that % (topo != nullptr) >> fatal);
+    Component* node = topo->GetChild(1);
+    expect(that % (node != nullptr) >> fatal);
+    Subdivision* sm = (Subdivision*)topo->GetSubcomponentById(3, ComponentType::Subdivision);
+    expect(that % (sm != nullptr) >> fatal);
+    expect(that % SubdivisionType::GpuSM == sm->GetSubdivisionType());
+    expect(that % std::string("8.6") == *sm->GetAttribute<std::string>(AttributeKey::CUDA_compute_capability));
+    expect(sm->GetChild(7) != nullptr);
+    Component* cores = sm->GetChild(100);
+    expect(that % (cores != nullptr) >> fatal);
+    expect(that % 64 == cores->GetId());
+    expect(that % 64 == cores->GetCount());
+    expect(that % 64 == sm->CountAllChildrenByType(ComponentType::Thread));
+    Memory* mem = (Memory*)node->GetChild(2);
+    expect(that % (mem != nullptr) >> fatal);
+    expect(that % (1LL << 34) == mem->GetSize());
+
+    std::vector<DataPath*> in = mem->GetAllDataPaths(DataPathType::Physical, DataPathDirection::Incoming);
+    expect(that % (in.size() == 1) >> fatal);
+    expect(that % ComponentType::Chip == in[0]->GetSource()->GetComponentType());
+    expect(that % 1.5 == in[0]->GetBandwidth());
+    expect(that % 200.0 == in[0]->GetLatency());
+    std::vector<DataPath*> all = sm->GetAllDataPaths(DataPathType::Any, DataPathDirection::Any);
+    expect(that % (all.size() == 1) >> fatal);
+    expect(that % DataPathOrientation::Bidirectional == all[0]->GetOrientation());
+    expect(that % 40.0 == all[0]->GetLatency());
+
+    topo->Delete(true);
+  };
+
+  "lazy attributes"_test = [] {
+    {
+      // the Widget subtree is skipped; its attribute must not be taken for the one of the Core
+      FILE* f = std::fopen("test_lazy.xml", "w");
+      std::fputs(R"(<?xml version="1.0" encoding="UTF-8"?>
+<sys-sage>
+  <Components>
+    <Topology id="0" addr="0x1">
+      <Node id="0" addr="0x2">
+        <Widget id="5">
+          <Attribute name="freq_history">
+            <freq_history timestamp="1" frequency="100.000000" unit="MHz"/>
+          </Attribute>
+        </Widget>
+        <Core id="0" addr="0x3">
+          <Attribute name="freq_history">
+            <freq_history timestamp="2" frequency="200.000000" unit="MHz"/>
+            <freq_history timestamp="3" frequency="300.000000" unit="MHz"/>
+          </Attribute>
+          <Attribute name="Clock_Frequency" value="2.5"/>
+        </Core>
+      </Node>
+    </Topology>
+  </Components>
+</sys-sage>
+)", f);
+      std::fclose(f);
+    }
+
+    Component* topo = importFromXml("test_lazy.xml", NULL, NULL, true);
+    expect(that % (topo != nullptr) >> fatal);
+    Component* core = topo->GetSubcomponentById(0, ComponentType::Core);
+    expect(that % (core != nullptr) >> fatal);
+    const AttributeStore::Entry* e = core->GetAttributes()->GetEntry(AttributeKey::freq_history);
+    expect(that % (e != nullptr) >> fatal);
+    expect(that % AttributeType::Lazy == e->type);
+    expect(that % AttributeType::Double == core->GetAttributes()->GetEntry(AttributeKey::Clock_Frequency)->type);
+
+    // exported without decoding
+    exportToXml(topo, "test_lazy_2.xml");
+
+    // the kept text is re-indented like the output of an eager import (which has other addresses)
+    {
+      Component* eager = importFromXml("test_lazy.xml");
+      expect(that % (eager != nullptr) >> fatal);
+      exportToXml(eager, "test_lazy_3.xml");
+      eager->Delete(true);
+      std::ifstream lazyOut("test_lazy_2.xml"), eagerOut("test_lazy_3.xml");
+      std::stringstream lazyText, eagerText;
+      lazyText << lazyOut.rdbuf();
+      eagerText << eagerOut.rdbuf();
+      std::regex addr(" addr=\"[^\"]*\"");
+      expect(std::regex_replace(lazyText.str(), addr, "") == std::regex_replace(eagerText.str(), addr, ""));
+      std::remove("test_lazy_3.xml");
+    }
+
+    FrequencyHistory* fh = core->GetAttribute<FrequencyHistory>(AttributeKey::freq_history);
+    expect(that % (fh != nullptr) >> fatal);
+    expect(that % 2 == fh->size());
+    expect(that % 3LL == std::get<0>((*fh)[1]));
+    expect(that % AttributeType::FrequencyHistory == core->GetAttributes()->GetEntry(AttributeKey::freq_history)->type);
+    expect(that % 0 == core->DecodeAllAttributes());
+
+    // a failed decoding keeps the lazy attribute
+    core->SetAttribute(AttributeKey::freq_history, LazyAttribute{"<broken", [](const std::string&, Component*) { return 1; }});
+    expect(that % -1 == core->DecodeAttribute(AttributeKey::freq_history));
+    expect(that % AttributeType::Lazy == core->GetAttributes()->GetEntry(AttributeKey::freq_history)->type);
+    expect(that % (core->GetAttribute<FrequencyHistory>(AttributeKey::freq_history) == nullptr));
+    expect(that % 0 == core->DecodeAllAttributes());
+    topo->Delete(true);
+
+    topo = importFromXml("test_lazy_2.xml");
+    expect(that % (topo != nullptr) >> fatal);
+    core = topo->GetSubcomponentById(0, ComponentType::Core);
+    expect(that % (core != nullptr) >> fatal);
+    fh = core->GetAttribute<FrequencyHistory>(AttributeKey::freq_history);
+    expect(that % (fh != nullptr) >> fatal);
+    expect(that % 2 == fh->size());
+    expect(that % 200.0 == std::get<1>((*fh)[0]));
+    topo->Delete(true);
+
+    // with a custom function, user-defined keys are loaded into attrib during the import
+    {
+      FILE* f = std::fopen("test_lazy.xml", "w");
+      std::fputs(R"(<?xml version="1.0" encoding="UTF-8"?>
+<sys-sage>
+  <Components>
+    <Topology id="0" addr="0x1">
+      <Attribute name="rack" value="3"/>
+      <Attribute name="freq_history">
+        <freq_history timestamp="1" frequency="100.000000" unit="MHz"/>
+      </Attribute>
+    </Topology>
+  </Components>
+</sys-sage>
+)", f);
+      std::fclose(f);
+    }
+    auto load_rack = [](xmlNodePtr n) -> void* {
+      if (_getStringFromProp(n, "name") != "rack")
+        return NULL;
+      return new int(std::stoi(_getStringFromProp(n, "value")));
+    };
+    topo = importFromXml("test_lazy.xml", load_rack, NULL, true);
+    expect(that % (topo != nullptr) >> fatal);
+    expect(that % (topo->attrib.count("rack") == 1) >> fatal);
+    expect(that % 3 == *static_cast<int*>(topo->attrib["rack"]));
+    expect(that % AttributeType::Lazy == topo->GetAttributes()->GetEntry(AttributeKey::freq_history)->type);
+    delete static_cast<int*>(topo->attrib["rack"]);
+    topo->attrib.erase("rack");
+    topo->Delete(true);
+    std::remove("test_lazy.xml");
+    std::remove("test_lazy_2.xml");
+  };
+
+  "missing file"_test = [] {
+    expect(importFromXml("does-not-exist.xml") == nullptr);
+  };
+
+  "concurrent contexts"_test = [] {
+    Topology topo;
+    std::string rack = "r1";
+    Node* node = new Node(&topo, 4);
+    node->attrib["rack"] = &rack;
+    new Core(node, 0);
+    XmlExportContext exportCtx([](std::string key, void* value, std::string* ret) {
+      if (key != "rack")
+        return 0;
+      *ret = *(std::string*)value;
+      return 1;
+    });
+    expect(that % 0 == exportCtx.Export(&topo, "test_contexts.xml"));
+
+    //the address table of a context maps the "addr" of the file to the imported components
+    XmlImportContext ctx;
+    Component* imported = ctx.Import("test_contexts.xml");
+    expect(that % (imported != nullptr) >> fatal);
+    Component* importedNode = ctx.GetComponentByAddr(reinterpret_cast<uintptr_t>(node));
+    expect(that % (importedNode != nullptr) >> fatal);
+    expect(that % 4 == importedNode->GetId());
+    expect(ctx.GetComponentByAddr(0) == nullptr);
+    imported->Delete(true);
+    ctx.Clear();
+    expect(ctx.GetComponentByAddr(reinterpret_cast<uintptr_t>(node)) == nullptr);
+
+    //each thread imports with its own custom function and exports the result again
+    std::vector<std::string> results(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < results.size(); ++t) {
+      threads.emplace_back([t, &results] {
+        std::string prefix = "thread" + std::to_string(t) + ":";
+        XmlImportContext in([prefix](xmlNodePtr n) -> void* {
+          if (_getStringFromProp(n, "name") != "rack")
+            return nullptr;
+          return new std::string(prefix + _getStringFromProp(n, "value"));
+        });
+        XmlExportContext out([](std::string key, void* value, std::string* ret) {
+          if (key != "rack")
+            return 0;
+          *ret = *(std::string*)value;
+          return 1;
+        });
+        std::string path = "test_contexts_" + std::to_string(t) + ".xml";
+        for (int i = 0; i < 20; ++i) {
+          Component* c = in.Import("test_contexts.xml");
+          if (c == nullptr)
+            return;
+          Component* n = c->GetChild(4);
+          results[t] = n != nullptr && n->attrib.count("rack") ? *(std::string*)n->attrib["rack"] : "";
+          out.Export(c, path);
+          if (n != nullptr) {
+            delete (std::string*)n->attrib["rack"];
+            n->attrib.erase("rack");
+          }
+          c->Delete(true);
+        }
+        std::remove(path.c_str());
+      });
+    }
+    for (std::thread& t : threads)
+      t.join();
+    for (size_t t = 0; t < results.size(); ++t)
+      expect(results[t] == "thread" + std::to_string(t) + ":r1");
+    std::remove("test_contexts.xml");
+    topo.DeleteSubtree();
+  };
+
+  "delta"_test = [] {
+    Topology topo;
+    topo.EnableChangeTracking();
+    Node* node = new Node(&topo, 1);
+    Chip* chip = new Chip(node, 0);
+    Cache* l3 = new Cache(chip, 0, 3, 1 << 20);
+    Core* c0 = new Core(l3, 0);
+    Core* c1 = new Core(l3, 1);
+    Core* c2 = new Core(l3, 2);
+    new Thread(c2, 2);
+    DataPath* dp01 = new DataPath(c0, c1, DataPathOrientation::Oriented, 10.0, 1.0);
+    DataPath* dp12 = new DataPath(c1, c2, DataPathOrientation::Oriented, 20.0, 2.0);
+
+    uint64_t v0 = GetCurrentVersion();
+    expect(that % 0 == exportToXml(&topo, "test_delta_base.xml"));
+    XmlImportContext ctx;
+    Component* imported = ctx.Import("test_delta_base.xml");
+    expect(that % (imported != nullptr) >> fatal);
+    auto copyOf = [&](const void* p) { return ctx.GetComponentByAddr(reinterpret_cast<uintptr_t>(p)); };
+
+    //nothing changed
+    expect(that % 0 == exportDeltaToXml(&topo, v0, "test_delta_1.xml"));
+    expect(that % 0 == ctx.ApplyDelta("test_delta_1.xml"));
+    expect(that % 3 == copyOf(l3)->GetChildren().size());
+
+    uint64_t v1 = GetCurrentVersion();
+    c0->SetAttribute(AttributeKey::Clock_Frequency, 2.4e9);
+    l3->SetCacheSize(2 << 20);
+    Core* c3 = new Core(l3, 3);
+    c3->SetAttribute(AttributeKey::Clock_Frequency, 1.2e9);
+    DataPath* dp03 = new DataPath(c0, c3, DataPathOrientation::Oriented, 30.0, 3.0);
+    dp12->Delete();
+    c2->Delete(true);
+    dp01->SetBandwidth(15.0);
+    expect(that % 0 == exportDeltaToXml(&topo, v1, "test_delta_2.xml"));
+    expect(that % 0 == ctx.ApplyDelta("test_delta_2.xml"));
+
+    Cache* l3Copy = (Cache*)copyOf(l3);
+    expect(that % (l3Copy != nullptr) >> fatal);
+    expect(that % 3 == l3Copy->GetChildren().size());
+    expect(that % (2 << 20) == l3Copy->GetCacheSize());
+    double* f = copyOf(c0)->GetAttribute<double>(AttributeKey::Clock_Frequency);
+    expect(that % (f != nullptr) >> fatal);
+    expect(*f == 2.4e9);
+    expect(copyOf(c2) == nullptr);
+    Component* c3Copy = copyOf(c3);
+    expect(that % (c3Copy != nullptr) >> fatal);
+    expect(c3Copy->GetParent() == l3Copy);
+    expect(that % 3 == c3Copy->GetId());
+    expect(c3Copy->GetAttribute<double>(AttributeKey::Clock_Frequency) != nullptr);
+    expect(ctx.GetRelationByAddr(reinterpret_cast<uintptr_t>(dp12)) == nullptr);
+    DataPath* dp01Copy = (DataPath*)ctx.GetRelationByAddr(reinterpret_cast<uintptr_t>(dp01));
+    expect(that % (dp01Copy != nullptr) >> fatal);
+    expect(dp01Copy->GetBandwidth() == 15.0);
+    DataPath* dp03Copy = (DataPath*)ctx.GetRelationByAddr(reinterpret_cast<uintptr_t>(dp03));
+    expect(that % (dp03Copy != nullptr) >> fatal);
+    expect(dp03Copy->GetSource() == copyOf(c0));
+    expect(dp03Copy->GetTarget() == c3Copy);
+    expect(that % 2 == copyOf(c0)->GetRelations(RelationType::DataPath).size());
+
+    //only the changed elements are written
+    expect(std::filesystem::file_size("test_delta_2.xml") < std::filesystem::file_size("test_delta_base.xml"));
+    //a removed attribute is removed from the copy as well
+    uint64_t v2 = GetCurrentVersion();
+    c0->RemoveAttribute(AttributeKey::Clock_Frequency);
+    expect(that % 0 == exportDeltaToXml(&topo, v2, "test_delta_3.xml"));
+    expect(that % 0 == ctx.ApplyDelta("test_delta_3.xml"));
+    expect(!copyOf(c0)->HasAttribute(AttributeKey::Clock_Frequency));
+
+    topo.TrimDeletionLog(v2);
+    expect(topo.GetDeletionLog().empty());
+
+    imported->Delete(true);
+    for (const char* p : {"test_delta_base.xml", "test_delta_1.xml", "test_delta_2.xml", "test_delta_3.xml"})
+      std::remove(p);
+    topo.DeleteSubtree();
+  };
 };
 // Compare two XML files
 // TODO: Add more tests
@@ -0,0 +1,83 @@
+#include <boost/ut.hpp>
+
+#include "sys-sage.hpp"
+
+using namespace boost::ut;
+using namespace sys_sage;
+
+static suite<"ingest"> _ = []
+{
+    "Manifest"_test = []
+    {
+        std::vector<DataSource> manifest;
+        expect(that % 0 == readDataSourceManifest(SYS_SAGE_TEST_RESOURCE_DIR "/ingest_manifest.txt", &manifest));
+        expect(that % 4u == manifest.size() >> fatal);
+        expect(that % 2 == manifest[0].nodeId);
+        expect(that % DataSourceType::CapsNumaBenchmark == manifest[0].type);
+        expect(SYS_SAGE_TEST_RESOURCE_DIR "/skylake_caps_numa_benchmark.csv" == manifest[0].path);
+        expect(that % DataSourceType::Mt4g == manifest[3].type);
+        expect(that % 3 == manifest[3].gpuId);
+        expect(that % 1 == readDataSourceManifest(SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml", &manifest));
+    };
+
+    "Ingest nodes"_test = []
+    {
+        Topology reference;
+        Node n2{&reference, 2};
+        Node n1{&reference, 1};
+        expect(that % 0 == parseHwlocOutput(&n2, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml"));
+        expect(that % 0 == parseCapsNumaBenchmark(&n2, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_caps_numa_benchmark.csv"));
+        expect(that % 0 == parseHwlocOutput(&n1, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml"));
+        expect(that % 0 == parseMt4gTopo(&n1, SYS_SAGE_TEST_RESOURCE_DIR "/pascal_gpu_topo.csv", 3));
+
+        for(unsigned parallelism : {1u, 4u})
+        {
+            Topology topo;
+            std::vector<DataSourceResult> results;
+            expect(that % 0 == ingestDataSources(&topo, SYS_SAGE_TEST_RESOURCE_DIR "/ingest_manifest.txt", parallelism, &results));
+
+            //nodes in the order of their first appearance; caps-numa-benchmark parsed after hwloc
+            expect(that % 2u == topo.GetChildren().size() >> fatal);
+            expect(that % 2 == topo.GetChildren()[0]->GetId());
+            expect(that % 1 == topo.GetChildren()[1]->GetId());
+            expect(that % n2.CountAllSubcomponents() == topo.GetChildren()[0]->CountAllSubcomponents());
+            expect(that % n1.CountAllSubcomponents() == topo.GetChildren()[1]->CountAllSubcomponents());
+            expect(that % n2.GetSubcomponentById(0, ComponentType::Numa)->GetAllDataPaths(DataPathType::Any, DataPathDirection::Outgoing).size()
+                == topo.GetChildren()[0]->GetSubcomponentById(0, ComponentType::Numa)->GetAllDataPaths(DataPathType::Any, DataPathDirection::Outgoing).size());
+            expect(nullptr != topo.GetChildren()[1]->GetChildById(3));
+
+            expect(that % 4u == results.size() >> fatal);
+            for(const DataSourceResult& r : results)
+            {
+                expect(r.parsed);
+                expect(that % 0 == r.ret);
+                expect(r.seconds >= 0.0);
+            }
+        }
+    };
+
+    "Failed sources"_test = []
+    {
+        Topology topo;
+        std::vector<DataSource> manifest = {
+            {1, DataSourceType::Hwloc, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml"},
+            {2, DataSourceType::CapsNumaBenchmark, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_caps_numa_benchmark.csv"},
+            {2, DataSourceType::Mt4g, SYS_SAGE_TEST_RESOURCE_DIR "/nonexistent.csv"},
+            {2, DataSourceType::Hwloc, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml"},
+            {3, DataSourceType::Hwloc, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml"},
+        };
+        std::vector<DataSourceResult> results;
+        expect(that % 0 != ingestDataSources(&topo, manifest, 2, &results));
+
+        expect(that % 2u == topo.GetChildren().size() >> fatal);
+        expect(that % 1 == topo.GetChildren()[0]->GetId());
+        expect(that % 3 == topo.GetChildren()[1]->GetId());
+        //node 2: hwloc is parsed first, mt4g fails, caps-numa-benchmark is skipped
+        expect(that % 5u == results.size() >> fatal);
+        expect(results[0].parsed && results[0].ret == 0);
+        expect(!results[1].parsed);
+        expect(results[2].parsed && results[2].ret != 0);
+        expect(results[3].parsed && results[3].ret == 0);
+        expect(results[4].parsed && results[4].ret == 0);
+    };
+};
@@ -51,3 +51,61 @@ static suite<"mt4g"> _ = []
     expect(that % (nullptr != thread) >> fatal);
     //topo.Delete(true);
 };
+
+static suite<"mt4g multiple GPUs"> multi_gpu = []
+{
+    Topology topo;
+    Node node{&topo};
+    const std::string path = SYS_SAGE_TEST_RESOURCE_DIR "/pascal_gpu_topo.csv";
+    expect(that % (0 == parseMt4gTopo(&node, std::vector<std::string>{path, path, path, path}, 2, ";", 3)) >> fatal);
+
+    std::vector<Component *> gpus = node.GetAllChildrenByType(ComponentType::Chip);
+    expect(that % 4_u == gpus.size() >> fatal);
+    for (int i = 0; i < 4; i++)
+    {
+        expect(that % (i + 2) == gpus[i]->GetId());
+        expect(that % "Quadro P6000"sv == static_cast<Chip *>(gpus[i])->GetModel());
+        expect(that % 3840_u == gpus[i]->GetAllSubcomponentsByType(ComponentType::Thread).size());
+        expect(that % 121_u == gpus[i]->GetAllSubcomponentsByType(ComponentType::Cache).size());
+    }
+
+    "Failed files are not added"_test = [&]
+    {
+        Node other{&topo, 1};
+        expect(that % (0 != parseMt4gTopo(&other, std::vector<std::string>{path, "/nonexistent/mt4g.csv"}, 0, ";", 2)));
+        std::vector<Component *> added = other.GetAllChildrenByType(ComponentType::Chip);
+        expect(that % 1_u == added.size() >> fatal);
+        expect(that % 0 == added[0]->GetId());
+    };
+};
+
+static suite<"mt4g collapsed cores"> collapsed = []
+{
+    Topology topo;
+    Chip* gpu = new Chip(&topo);
+    expect(that % (0 == parseMt4gTopo(gpu, SYS_SAGE_TEST_RESOURCE_DIR "/pascal_gpu_topo.csv", ";", true)) >> fatal);
+
+    //one Thread per L1 cache (2 per SM) stands for 64 cores
+    expect(that % 3840 == topo.CountAllSubcomponentsByType(ComponentType::Thread));
+    expect(that % 60_u == topo.GetAllSubcomponentsByType(ComponentType::Thread).size());
+    expect(that % 121_u == topo.GetAllSubcomponentsByType(ComponentType::Cache).size());
+    expect(that % 4022 == gpu->CountAllSubcomponents());
+    expect(that % gpu->GetComponentsInSubtree().size() * 10 < 4023_u);
+
+    Component* sm = gpu->GetSubcomponentById(3, ComponentType::Subdivision);
+    expect(that % (nullptr != sm) >> fatal);
+    Component* core = sm->GetSubcomponentById(100, ComponentType::Thread);
+    expect(that % (nullptr != core) >> fatal);
+    expect(that % 64 == core->GetId());
+    expect(that % 64 == core->GetCount());
+    expect(that % core->GetAllDataPaths(DataPathType::Any, DataPathDirection::Incoming).size() > 0_u);
+
+    Component* expanded = core->ExpandInstance(100);
+    expect(that % (nullptr != expanded) >> fatal);
+    expect(that % 100 == expanded->GetId());
+    expect(that % expanded == sm->GetSubcomponentById(100, ComponentType::Thread));
+    expect(that % core->GetParent() == expanded->GetParent());
+    expect(that % core->GetAllDataPaths(DataPathType::Any, DataPathDirection::Incoming).size() == expanded->GetAllDataPaths(DataPathType::Any, DataPathDirection::Incoming).size());
+    expect(that % 3840 == topo.CountAllSubcomponentsByType(ComponentType::Thread));
+    gpu->Delete(true);
+};
@@ -51,6 +51,72 @@ ut::suite<"relation"> _ = []
     ut::expect(ut::that % bar.GetRelations(RelationType::Relation).size() == 0U);
   };
 
+  ut::test("deletion keeps back-indices consistent") = []
+  {
+    Component hub, a, b, c, d;
+    std::vector<Relation *> rs;
+    for (Component *other : {&a, &b, &c, &d})
+      rs.push_back(new Relation({&hub, other}));
+    Relation *twice = new Relation({&hub, &hub}); //listed twice by hub
+    DataPath *loop = new DataPath(&a, &a, DataPathOrientation::Oriented); //listed once by a
+
+    ut::expect(ut::that % hub.GetRelations(RelationType::Relation).size() == 6U);
+    rs[1]->Delete();
+    twice->Delete();
+    ut::expect(ut::that % hub.GetRelations(RelationType::Relation).size() == 3U);
+    ut::expect(ut::that % b.GetRelations(RelationType::Relation).size() == 0U);
+    for (Component *comp : {&hub, &a, &c, &d})
+    {
+      const std::vector<Relation *> &rv = comp->GetRelations(RelationType::Relation);
+      for (size_t i = 0; i < rv.size(); i++)
+      {
+        int pos = rv[i]->GetComponent(0) == comp ? 0 : 1;
+        ut::expect(ut::that % rv[i]->_GetComponentSlot(pos) == static_cast<int32_t>(i));
+      }
+    }
+
+    ut::expect(ut::that % a.GetRelations(RelationType::DataPath) == std::vector<Relation *> {loop});
+    a.DeleteAllRelations();
+    ut::expect(ut::that % a.GetRelations(RelationType::DataPath).size() == 0U);
+    ut::expect(ut::that % hub.GetRelations(RelationType::Relation).size() == 2U);
+    hub.DeleteAllRelations();
+    for (Component *comp : {&hub, &a, &b, &c, &d})
+      ut::expect(ut::that % comp->GetRelations(RelationType::Relation).size() == 0U);
+  };
+
+  ut::test("relation registry") = []
+  {
+    Topology topo;
+    Node n0 (&topo, 0), n1 (&topo, 1);
+    Relation *r0 = new Relation({&n0, &n1});
+    ut::expect(ut::that % topo.GetRegisteredRelations().size() == 0U);
+
+    ut::expect(ut::that % topo.EnableRelationRegistry() == 1);
+    ut::expect(ut::that % r0->_GetRegistry() == &topo);
+    DataPath *dp = new DataPath(&n1, &n0, DataPathOrientation::Bidirectional);
+    Relation *r1 = new Relation({&n1, &n1});
+    ut::expect(ut::that % topo.GetRegisteredRelations() == std::vector<Relation *> {r0, dp, r1});
+
+    //deletion swaps the last Relation into the freed position
+    r0->Delete();
+    ut::expect(ut::that % topo.GetRegisteredRelations() == std::vector<Relation *> {r1, dp});
+    ut::expect(ut::that % r1->_GetRegistryIndex() == 0);
+
+    //detaching a subtree moves its Relations out of the registry; attaching it to a Topology moves them in
+    Topology other;
+    other.EnableRelationRegistry();
+    topo.RemoveChild(&n1);
+    ut::expect(ut::that % topo.GetRegisteredRelations().size() == 0U);
+    other.InsertChild(&n1);
+    ut::expect(ut::that % other.GetRegisteredRelations().size() == 2U);
+    ut::expect(ut::that % dp->_GetRegistry() == &other);
+
+    other.DisableRelationRegistry();
+    ut::expect(ut::that % dp->_GetRegistry() == nullptr);
+    n1.DeleteAllRelations();
+    other.RemoveChild(&n1);
+  };
+
   ut::test("getters & setters") = []
   {
     std::vector<Component *> v;
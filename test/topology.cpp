@@ -1,4 +1,6 @@
 #include <boost/ut.hpp>
+#include <algorithm>
+#include <iterator>
 #include <string_view>
 
 #include "sys-sage.hpp"
@@ -7,6 +9,16 @@ using namespace boost::ut;
 using namespace sys_sage;
 using namespace std::string_view_literals;
 
+//counts the live instances to check that an AttributeStore owns (and destroys) its values
+struct Tracked
+{
+    static inline int alive = 0;
+    int v;
+    Tracked(int _v) : v(_v) { alive++; }
+    Tracked(const Tracked& o) : v(o.v) { alive++; }
+    ~Tracked() { alive--; }
+};
+
 static suite<"topology"> _ = []
 {
     "Node"_test = []
@@ -199,6 +211,29 @@ static suite<"topology"> _ = []
         expect(that % (std::find(a.GetChildren().begin(), a.GetChildren().end(), &d) != a.GetChildren().end()));
     };
 
+    "Unordered child removal"_test = []
+    {
+        Node a;
+        std::vector<Core *> cores;
+        for (int i = 0; i < 40; ++i)
+            cores.push_back(new Core(&a, i));
+        expect(that % cores[5] == a.GetChildById(5)); //builds the id map
+
+        expect(that % 1 == a.RemoveChild(cores[3], false));
+        expect(that % (39_u == a.GetChildren().size()) >> fatal);
+        expect(that % cores[39] == a.GetChildren()[3]);
+        expect(that % cores[38] == a.GetChildren()[38]);
+        expect(that % nullptr == a.GetChildById(3));
+        expect(that % cores[39] == a.GetChildById(39));
+        //the moved child has an up-to-date sibling index
+        expect(that % 1 == a.RemoveChild(cores[39], false));
+        expect(that % cores[38] == a.GetChildren()[3]);
+        expect(that % 0 == a.RemoveChild(cores[39], false));
+        cores[3]->Delete(true);
+        cores[39]->Delete(true);
+        a.DeleteSubtree();
+    };
+
     "Get child"_test = []
     {
         Node a{1};
@@ -215,6 +250,74 @@ static suite<"topology"> _ = []
         expect(that % a.GetChild(4) == nullptr);
     };
 
+    "Get child of a wide component"_test = []
+    {
+        Node a{0};
+        std::vector<Thread*> threads;
+        for(int i = 0; i < 100; i++)
+            threads.push_back(new Thread(&a, i));
+        Thread dup{&a, 50};
+
+        expect(that % threads[10] == a.GetChild(10));
+        expect(that % threads[50] == a.GetChild(50));
+        expect(that % nullptr == a.GetChild(100));
+        Thread late{&a, 100};
+        expect(that % &late == a.GetChild(100));
+
+        expect(that % 1 == a.RemoveChild(threads[10]));
+        expect(that % 0 == a.RemoveChild(threads[10]));
+        expect(that % nullptr == a.GetChild(10));
+        expect(that % threads[11] == a.GetChildren()[10]);
+        expect(that % 1 == a.RemoveChild(threads[50]));
+        expect(that % &dup == a.GetChild(50));
+        expect(that % 1 == a.RemoveChild(threads[99]));
+        expect(that % 1 == a.RemoveChild(threads[0]));
+        expect(that % 98_u == a.GetChildren().size());
+        expect(that % threads[1] == a.GetChildren()[0]);
+        expect(that % 0 == a.CheckComponentTreeConsistency());
+
+        for(int i : {0, 10, 50, 99})
+            delete threads[i];
+        a.RemoveChild(&dup);
+        a.RemoveChild(&late);
+        a.DeleteSubtree();
+    };
+
+    "Reparent children"_test = []
+    {
+        Node a{0};
+        Node other{1};
+        std::vector<Thread*> threads;
+        for(int i = 0; i < 40; i++)
+            threads.push_back(new Thread(&a, i));
+
+        expect(that % 1 == a.ReparentChildren({threads[0], &other}, &other));
+        expect(that % 40_u == a.GetChildren().size());
+
+        expect(that % 0 == a.ReparentChildren({threads[30], threads[3], threads[30], threads[39]}, &other));
+        expect(that % 37_u == a.GetChildren().size());
+        expect(that % std::vector<Component*>{threads[30], threads[3], threads[39]} == other.GetChildren());
+        expect(that % &other == threads[3]->GetParent());
+        expect(that % threads[4] == a.GetChildren()[3]);
+        expect(that % nullptr == a.GetChild(30));
+        expect(that % threads[31] == a.GetChild(31));
+        expect(that % 1 == a.RemoveChild(threads[38]));
+        expect(that % 0 == a.CheckComponentTreeConsistency());
+        expect(that % 0 == other.CheckComponentTreeConsistency());
+
+        Core c{7};
+        expect(that % 0 == c.InsertBetweenParentAndChildren(&a, {threads[5], threads[6]}, false));
+        expect(that % &c == a.GetChildren().back());
+        expect(that % std::vector<Component*>{threads[5], threads[6]} == c.GetChildren());
+        expect(that % 1 == c.InsertBetweenParentAndChildren(&a, {threads[5]}, true));
+
+        delete threads[38];
+        a.RemoveChild(&c);
+        c.DeleteSubtree();
+        a.DeleteSubtree();
+        other.DeleteSubtree();
+    };
+
     "Get child by type"_test = []
     {
         Node a;
@@ -345,4 +448,637 @@ static suite<"topology"> _ = []
 
         expect(that % 3 == a.GetSubtreeDepth());
     };
+
+    "Subtree iterators"_test = []
+    {
+        Node a;
+        Core b{&a};
+        Thread c{&b};
+        Thread d{&b};
+        Core e{&a};
+        Thread f{&e};
+
+        std::vector<Component *> pre;
+        std::ranges::copy(a.PreOrder(), std::back_inserter(pre));
+        expect(that % pre == (std::vector<Component *>{&a, &b, &c, &d, &e, &f}));
+
+        std::vector<Component *> post;
+        for (Component *x : a.PostOrder())
+            post.push_back(x);
+        expect(that % post == (std::vector<Component *>{&c, &d, &b, &f, &e, &a}));
+
+        std::vector<Component *> bfs;
+        for (Component *x : a.BreadthFirst())
+            bfs.push_back(x);
+        expect(that % bfs == (std::vector<Component *>{&a, &b, &e, &c, &d, &f}));
+
+        std::vector<Component *> threads;
+        for (Component *x : a.PreOrder(ComponentType::ToMask(ComponentType::Thread)))
+            threads.push_back(x);
+        expect(that % threads == (std::vector<Component *>{&c, &d, &f}));
+
+        std::vector<Component *> cores;
+        for (Component *x : a.BreadthFirst(ComponentType::AnyMask, 1))
+            cores.push_back(x);
+        expect(that % cores == (std::vector<Component *>{&a, &b, &e}));
+
+        expect(that % 3 == std::ranges::count_if(a.PostOrder(ComponentType::ToMask(ComponentType::Thread) | ComponentType::ToMask(ComponentType::Node)), [](Component *x) { return x->GetChildren().empty(); }));
+    };
+
+    "Subtree visitor"_test = []
+    {
+        Node a;
+        Core b{&a, 1};
+        Thread c{&b, 2};
+        Core d{&a, 3};
+        Thread e{&d, 4};
+
+        int visited = 0;
+        Component *found = nullptr;
+        bool completed = a.VisitSubtree([&](Component *x)
+                                        {
+            visited++;
+            if (x->GetId() == 3)
+            {
+                found = x;
+                return false;
+            }
+            return true; },
+                                        ComponentType::ToMask(ComponentType::Core));
+        expect(that % !completed);
+        expect(that % &d == found);
+        expect(that % 2 == visited);
+
+        visited = 0;
+        expect(that % a.VisitSubtree([&](Component *) { visited++; return true; }));
+        expect(that % 5 == visited);
+    };
+
+    "User-defined component types"_test = []
+    {
+        //types outside of the mask share ComponentType::OtherTypesMask
+        struct Custom : Component
+        {
+            Custom(Component *parent, int id, ComponentType::type t) : Component(parent, id, "custom", t) {}
+        };
+        Node a;
+        Core b{&a, 1};
+        Custom c{&b, 7, 100};
+        Custom d{&a, 8, 200};
+
+        expect(that % ComponentType::OtherTypesMask == ComponentType::ToMask(100));
+        expect(that % 1 == a.GetAllSubcomponentsByType(100).size());
+        expect(that % &c == a.GetSubcomponentById(7, 100));
+        expect(that % nullptr == a.GetSubcomponentById(8, 100));
+        expect(that % &d == a.GetSubcomponentById(8, 200));
+        expect(that % 1 == a.CountAllSubcomponentsByType(100));
+        expect(that % 2 == std::ranges::distance(a.PreOrder(ComponentType::ToMask(100))));
+        expect(that % 0 == std::ranges::distance(a.PreOrder(ComponentType::ToMask(ComponentType::Thread))));
+    };
+
+    "Delete wide subtree"_test = []
+    {
+        Topology topo;
+        topo.EnableComponentIndex();
+        Node *n = new Node(&topo, 1);
+        for (int i = 0; i < 1000; i++)
+            new Thread(n, i);
+        new DataPath(n->GetChild(0), n->GetChild(999), DataPathOrientation::Oriented);
+
+        n->DeleteSubtree();
+        expect(that % n->GetChildren().empty());
+        expect(that % nullptr == topo.GetSubcomponentById(5, ComponentType::Thread));
+        n->Delete();
+        expect(that % topo.GetChildren().empty());
+    };
+
+    "Topology arena"_test = []
+    {
+        Topology *topo = new Topology();
+        expect(that % nullptr == topo->GetArena());
+        expect(that % 0 == topo->EnableArena());
+        expect(that % 1 == topo->EnableArena());
+
+        Node *outside = new Node(99);
+        {
+            ArenaScope scope(topo);
+            expect(that % topo->GetArena() == TopologyArena::GetCurrent());
+            Node *n = new Node(topo, 1);
+            for (int i = 0; i < 100; i++)
+            {
+                Thread *t = new Thread(n, i);
+                new DataPath(t, n, DataPathOrientation::Oriented);
+            }
+            new DataPath(n, outside, DataPathOrientation::Oriented);
+            Thread *t = new Thread(n, 100);
+            t->Delete(); //memory stays in the arena until it is released
+            expect(that % topo->GetArena() == _GetOwningArena(n));
+            expect(that % nullptr == _GetOwningArena(outside));
+        }
+        expect(that % nullptr == TopologyArena::GetCurrent());
+        expect(that % topo->GetArena()->GetAllocatedBytes() > 100 * sizeof(Thread));
+        expect(that % 101 == topo->CountAllSubcomponentsByType(ComponentType::Thread) + topo->CountAllSubcomponentsByType(ComponentType::Node));
+        expect(that % 1_u == outside->GetRelations(RelationType::DataPath).size());
+
+        topo->Delete();
+        expect(that % 0_u == outside->GetRelations(RelationType::DataPath).size());
+        outside->Delete();
+    };
+
+    "Component index"_test = []
+    {
+        Topology topo;
+        Node n0{&topo, 0};
+        Node n1{&topo, 1};
+        Thread t0{&n0, 7};
+        Thread t1{&n1, 7};
+        Thread t2{&n1, 8};
+
+        expect(that % 6 == topo.EnableComponentIndex());
+        expect(that % topo.IsComponentIndexEnabled());
+        expect(that % &t2 == topo.GetSubcomponentById(8, ComponentType::Thread));
+        expect(that % &t0 == n0.GetSubcomponentById(7, ComponentType::Thread));
+        expect(that % &t1 == n1.GetSubcomponentById(7, ComponentType::Thread));
+        expect(that % &t0 == topo.GetSubcomponentById(7, ComponentType::Thread)); //two matches -> first in DFS order
+        expect(that % nullptr == n0.GetSubcomponentById(8, ComponentType::Thread));
+
+        Thread t3{&n0, 9};
+        expect(that % &t3 == topo.GetSubcomponentById(9, ComponentType::Thread));
+
+        n1.RemoveChild(&t2);
+        expect(that % nullptr == topo.GetSubcomponentById(8, ComponentType::Thread));
+
+        Core c{5};
+        c.InsertBetweenParentAndChild(&n0, &t3, false);
+        expect(that % &c == n0.GetSubcomponentById(5, ComponentType::Core));
+        expect(that % &t3 == topo.GetSubcomponentById(9, ComponentType::Thread));
+
+        Core* c2 = new Core(6);
+        expect(that % 0 == c2->InsertBetweenParentAndChildren(&n1, {&t1}, false));
+        expect(that % c2 == topo.GetSubcomponentById(6, ComponentType::Core));
+        c2->Delete(false);
+        expect(that % nullptr == topo.GetSubcomponentById(6, ComponentType::Core));
+        expect(that % &t1 == n1.GetSubcomponentById(7, ComponentType::Thread));
+
+        //many candidates: the index returns the first match in pre-order of any subtree, also right after changes
+        Node n2{&topo, 2};
+        std::vector<Core*> cores;
+        for(int i = 0; i < 8; i++)
+        {
+            cores.push_back(new Core(i % 2 == 0 ? static_cast<Component*>(&n2) : static_cast<Component*>(cores.back()), 3));
+            new Thread(cores.back(), 7);
+        }
+        expect(that % cores[0] == topo.GetSubcomponentById(3, ComponentType::Core));
+        expect(that % &t0 == topo.GetSubcomponentById(7, ComponentType::Thread));
+        expect(that % cores[0]->GetChildren()[0] == n2.GetSubcomponentById(7, ComponentType::Thread));
+        expect(that % cores[5] == cores[5]->GetSubcomponentById(3, ComponentType::Core));
+        expect(that % cores[5]->GetChildren()[0] == cores[5]->GetSubcomponentById(7, ComponentType::Thread));
+        n2.RemoveChild(cores[0]);
+        expect(that % cores[2]->GetChildren()[0] == n2.GetSubcomponentById(7, ComponentType::Thread));
+        expect(that % nullptr == cores[1]->GetSubcomponentById(3, ComponentType::Thread));
+        n2.InsertChild(cores[0]);
+        expect(that % cores[2] == n2.GetSubcomponentById(3, ComponentType::Core));
+        expect(that % cores[0] == cores[0]->GetSubcomponentById(3, ComponentType::Core));
+        cores[0]->Delete(true);
+
+        topo.DisableComponentIndex();
+        expect(that % !topo.IsComponentIndexEnabled());
+        expect(that % &t3 == topo.GetSubcomponentById(9, ComponentType::Thread));
+        expect(that % cores[2]->GetChildren()[0] == n2.GetSubcomponentById(7, ComponentType::Thread));
+        n2.DeleteSubtree();
+    };
+
+    "Frozen topology"_test = []
+    {
+        Topology topo;
+        Node n0{&topo, 0};
+        Node n1{&topo, 1};
+        Numa m0{&n0, 0};
+        Core c0{&m0, 0};
+        Thread t0{&c0, 0};
+        Thread t1{&c0, 1};
+        Thread t2{&n1, 2};
+        DataPath* dp0 = new DataPath(&t0, &m0, DataPathOrientation::Oriented, 10, 20);
+        DataPath* dp1 = new DataPath(&t2, &m0, DataPathOrientation::Bidirectional, 5, 50);
+
+        FrozenTopology ft = FreezeTopology(&topo);
+        expect(that % 8 == ft.Size());
+        expect(that % 0 == ft.GetIndex(&topo));
+        expect(that % FrozenTopology::npos == ft.GetParent(0));
+        expect(that % FrozenTopology::npos == ft.GetIndex(nullptr));
+        for(int32_t i = 0; i < ft.Size(); i++)
+        {
+            Component* c = ft.GetComponent(i);
+            expect(that % i == ft.GetIndex(c));
+            expect(that % c->GetComponentType() == ft.GetType(i));
+            expect(that % c->GetId() == ft.GetId(i));
+            if(i > 0)
+                expect(that % c->GetParent() == ft.GetComponent(ft.GetParent(i)));
+            expect(that % c->GetDepth(true) - topo.GetDepth(true) == ft.GetDepth(i));
+        }
+
+        int32_t in0 = ft.GetIndex(&n0), ic0 = ft.GetIndex(&c0), it2 = ft.GetIndex(&t2);
+        expect(that % ft.GetIndex(&m0) == ft.GetFirstChild(in0));
+        expect(that % ft.GetIndex(&t1) == ft.GetNextSibling(ft.GetIndex(&t0)));
+        expect(that % FrozenTopology::npos == ft.GetNextSibling(ft.GetIndex(&t1)));
+        expect(that % ft.GetIndex(&n1) == ft.GetNextSibling(in0));
+        expect(that % ft.IsAncestor(in0, ft.GetIndex(&t1)));
+        expect(that % !ft.IsAncestor(in0, it2));
+        expect(that % !ft.IsAncestor(ic0, in0));
+        expect(that % 3 == ft.CountByType(0, ComponentType::Thread));
+        expect(that % 2 == ft.CountByType(in0, ComponentType::Thread));
+        expect(that % in0 == ft.GetAncestorByType(ft.GetIndex(&t1), ComponentType::Node));
+        expect(that % FrozenTopology::npos == ft.GetAncestorByType(it2, ComponentType::Core));
+        expect(that % it2 == ft.FindById(0, 2, ComponentType::Thread));
+        expect(that % FrozenTopology::npos == ft.FindById(in0, 2, ComponentType::Thread));
+        std::vector<int32_t> threads;
+        ft.GetSubcomponentsByType(0, ComponentType::Thread, &threads);
+        expect(that % std::vector<int32_t>{ft.GetIndex(&t0), ft.GetIndex(&t1), it2} == threads);
+
+        //oriented DataPath at its source only, bidirectional at both ends
+        expect(that % 3 == ft.GetNumDataPathEdges());
+        auto [b0, e0] = ft.GetDataPathRange(ft.GetIndex(&t0));
+        expect(that % 1 == e0 - b0);
+        expect(that % ft.GetIndex(&m0) == ft.GetDataPathTarget(b0));
+        expect(that % 10.0 == ft.GetDataPathBw(b0));
+        expect(that % 20.0 == ft.GetDataPathLatency(b0));
+        expect(that % dp0 == ft.GetDataPath(b0));
+        auto [bm, em] = ft.GetDataPathRange(ft.GetIndex(&m0));
+        expect(that % 1 == em - bm);
+        expect(that % it2 == ft.GetDataPathTarget(bm));
+        expect(that % dp1 == ft.GetDataPath(bm));
+
+        //DataPaths leaving the snapshot are not part of it
+        FrozenTopology sub = FreezeTopology(&n0);
+        expect(that % 5 == sub.Size());
+        expect(that % 1 == sub.GetNumDataPathEdges());
+        expect(that % 0 == sub.GetDepth(0));
+
+        dp0->Delete();
+        dp1->Delete();
+
+        //collapsed components count with the multiplicities of their collapsed ancestors
+        Core c1{&n1, 4};
+        Thread t3{&c1, 0};
+        Thread t4{&c1, 1};
+        n1.SetCount(2);
+        c1.SetCount(3);
+        FrozenTopology fc = FreezeTopology(&topo);
+        int32_t in1 = fc.GetIndex(&n1), ic1 = fc.GetIndex(&c1);
+        expect(that % 3 == fc.GetCount(ic1));
+        expect(that % 1 == fc.GetCount(0));
+        expect(that % topo.CountAllSubcomponentsByType(ComponentType::Thread) == fc.CountByType(0, ComponentType::Thread));
+        expect(that % 16 == fc.CountByType(0, ComponentType::Thread));
+        expect(that % 14 == fc.CountByType(in1, ComponentType::Thread));
+        expect(that % 6 == fc.CountByType(ic1, ComponentType::Thread));
+        expect(that % 7 == fc.CountByType(0, ComponentType::Core));
+        expect(that % 3 == fc.CountByType(ic1, ComponentType::Core));
+        expect(that % ic1 == fc.FindById(0, 6, ComponentType::Core));
+        expect(that % FrozenTopology::npos == fc.FindById(0, 7, ComponentType::Core));
+        expect(that % in1 == fc.FindById(0, 2, ComponentType::Node));
+        n1.SetCount(1);
+        c1.SetCount(1);
+    };
+
+    "Typed attributes"_test = []
+    {
+        {
+            Node node{1};
+            expect(that % nullptr == node.GetAttributes());
+            expect(that % !node.HasAttribute(AttributeKey::CATcos));
+
+            node.SetAttribute(AttributeKey::CATcos, uint64_t{3});
+            node.SetAttribute("codename", std::string("marsupial"));
+            expect(that % node.HasAttribute("CATcos"));
+            expect(that % uint64_t{3} == *node.GetAttribute<uint64_t>(AttributeKey::CATcos));
+            expect(that % "marsupial"sv == *node.GetAttribute<std::string>("codename"));
+            //type mismatch and unknown keys
+            expect(that % nullptr == node.GetAttribute<int>(AttributeKey::CATcos));
+            expect(that % nullptr == node.GetAttribute<double>("codename"));
+            expect(that % nullptr == node.GetAttribute<int>("never_set_attribute"));
+
+            //overwriting may change the type
+            node.SetAttribute("codename", 42);
+            expect(that % 42 == *node.GetAttribute<int>("codename"));
+            expect(that % nullptr == node.GetAttribute<std::string>("codename"));
+            expect(that % 2 == node.GetAttributes()->Size());
+
+            expect(that % AttributeKey::Intern("codename") == AttributeKey::Find("codename"));
+            expect(that % "codename"sv == AttributeKey::GetName(AttributeKey::Find("codename")));
+            expect(that % AttributeType::None == AttributeKey::GetBuiltinType(AttributeKey::Find("codename")));
+            expect(that % AttributeType::UInt64 == AttributeKey::GetBuiltinType(AttributeKey::CATcos));
+
+            node.SetAttribute("tracked", Tracked{7});
+            expect(that % 1 == Tracked::alive);
+            expect(that % 7 == node.GetAttribute<Tracked>("tracked")->v);
+            node.SetAttribute("tracked", Tracked{8});
+            expect(that % 1 == Tracked::alive);
+
+            expect(that % 1 == node.RemoveAttribute("codename"));
+            expect(that % 0 == node.RemoveAttribute("codename"));
+            expect(that % !node.HasAttribute("codename"));
+            expect(that % 2 == node.GetAttributes()->Size());
+        }
+        expect(that % 0 == Tracked::alive);
+
+        Core c0{0}, c1{1};
+        {
+            Relation* r = new Relation({&c0, &c1});
+            r->SetAttribute(AttributeKey::latency, 1.5f);
+            r->SetAttribute("tracked", Tracked{1});
+            expect(that % 1.5f == *r->GetAttribute<float>(AttributeKey::latency));
+            expect(that % 1 == Tracked::alive);
+            r->Delete();
+        }
+        expect(that % 0 == Tracked::alive);
+    };
+
+    "Lowest common ancestor"_test = []
+    {
+        Topology topo;
+        Node node{&topo, 0};
+        Chip chip0{&node, 0}, chip1{&node, 1};
+        Cache l3{&chip0, 0, 3};
+        Core c0{&l3, 0}, c1{&l3, 1}, c2{&chip1, 2};
+        Cache l2{&c0, 0, 2};
+        Thread t0{&l2, 0}, t1{&c1, 1}, t2{&c2, 2};
+        Thread loose{9};
+
+        expect(that % 6 == t0.GetDepth());
+        expect(that % &l3 == t0.GetLowestCommonAncestor(&t1));
+        expect(that % &c0 == t0.GetLowestCommonAncestor(&c0));
+        expect(that % &node == t1.GetLowestCommonAncestor(&t2));
+        expect(that % &t0 == t0.GetLowestCommonAncestor(&t0));
+        expect(that % nullptr == t0.GetLowestCommonAncestor(&loose));
+        expect(that % std::vector<Component*>{&l3} == t0.GetSharedComponents(&t1, ComponentType::ToMask(ComponentType::Cache)));
+        expect(that % std::vector<Component*>{&l3, &chip0, &node, &topo} == t0.GetSharedComponents(&t1));
+
+        //moving a subtree updates the cached depths
+        c1.RemoveChild(&t1);
+        expect(that % 0 == t1.GetDepth());
+        expect(that % nullptr == t1.GetParent());
+        expect(that % nullptr == t1.GetLowestCommonAncestor(&t0));
+        l2.InsertChild(&t1);
+        chip1.RemoveChild(&c2);
+        expect(that % 0 == c2.GetDepth());
+        expect(that % 1 == t2.GetDepth());
+        t0.InsertChild(&c2);
+        expect(that % 6 == t1.GetDepth());
+        expect(that % 8 == t2.GetDepth());
+        expect(that % t2.GetDepth(true) == 8);
+        expect(that % &l2 == t1.GetLowestCommonAncestor(&t2));
+        expect(that % &t0 == t2.GetLowestCommonAncestor(&t0));
+        t0.RemoveChild(&c2);
+        l2.RemoveChild(&t1);
+    };
+    "Memory footprint"_test = []
+    {
+        Topology topo;
+        Node node{&topo, 0};
+        Chip chip0{&node, 0, "Chip", ChipType::None, std::string(100, 'v')};
+        Chip chip1{&node, 1};
+        Thread t0{&chip0, 0}, t1{&chip1, 1};
+        QuantumBackend qb{&node, 2};
+        Qubit q0{&qb, 0}, q1{&qb, 1};
+        AtomSite* site = new AtomSite();
+        site->shuttlingTimes["move"] = 1.0;
+        node.InsertChild(site);
+        //a DataPath between two children of node, which the old accounting counted twice
+        DataPath* dp = new DataPath(&t0, &t1, DataPathOrientation::Oriented);
+        t0.SetAttribute("blob", std::string(200, 'x'));
+
+        MemoryFootprint f = GetMemoryFootprint(&node);
+        expect(that % 9_u == f.componentCount);
+        expect(that % 2_u == f.componentCounts[ComponentType::Qubit]);
+        expect(that % 2_u == f.componentCounts[ComponentType::QuantumBackend]);
+        expect(that % 1_u == f.relationCount);
+        expect(that % 1_u == f.relationCounts[RelationType::DataPath]);
+        expect(that % f.componentBytes[ComponentType::QuantumBackend] >= sizeof(QuantumBackend) + sizeof(AtomSite));
+        expect(that % f.attributeBytes["blob"] >= sizeof(std::string) + 200);
+        expect(that % f.stringBytes >= 301_u);
+        size_t sum = f.indexBytes + f.arenaSlackBytes;
+        for(const auto& [componentType, bytes] : f.componentBytes)
+            sum += bytes;
+        for(const auto& [relationType, bytes] : f.relationBytes)
+            sum += bytes;
+        expect(that % f.totalBytes == sum);
+
+        unsigned componentSize = 0, relationSize = 0;
+        int total = node.GetTopologySize(&componentSize, &relationSize);
+        expect(that % static_cast<size_t>(total) == f.totalBytes);
+        expect(that % componentSize + relationSize == static_cast<unsigned>(total));
+        expect(that % f.relationBytes[RelationType::DataPath] == relationSize);
+
+        //topology-level indices are accounted separately
+        MemoryFootprint before = GetMemoryFootprint(&topo);
+        topo.EnableComponentIndex();
+        MemoryFootprint after = GetMemoryFootprint(&topo);
+        expect(that % after.indexBytes > before.indexBytes);
+        expect(that % after.componentBytes[ComponentType::Topology] == before.componentBytes[ComponentType::Topology]);
+
+        dp->Delete();
+        node.RemoveChild(site);
+        delete site;
+    };
+
+    "Collapsed components"_test = []
+    {
+        Topology topo;
+        Node* node = new Node(&topo, 0);
+        Memory* mem = new Memory(node, 0);
+        Core* core = new Core(node, 0);
+        Thread* t = new Thread(core, 10, "GPU Core");
+        t->SetAttribute(AttributeKey::Clock_Frequency, 1.5e9);
+        new DataPath(mem, t, DataPathOrientation::Oriented, DataPathType::Logical, 0, 200);
+
+        expect(that % 1 == t->GetCount());
+        expect(that % 0 == t->SetCount(8));
+        expect(that % t->IsCollapsed());
+        expect(that % 8 == core->CountAllChildrenByType(ComponentType::Thread));
+        expect(that % 8 == topo.CountAllSubcomponentsByType(ComponentType::Thread));
+        expect(that % 11 == topo.CountAllSubcomponents());
+        expect(that % 0 == t->CountAllSubcomponents());
+        expect(that % t == core->GetChildById(17));
+        expect(that % nullptr == core->GetChildById(18));
+        expect(that % t == topo.GetSubcomponentById(13, ComponentType::Thread));
+        expect(that % 5 == topo.EnableComponentIndex());
+        expect(that % t == topo.GetSubcomponentById(13, ComponentType::Thread));
+
+        Component* t13 = t->ExpandInstance(13);
+        expect(that % (nullptr != t13 && t13 != t) >> fatal);
+        expect(that % ComponentType::Thread == t13->GetComponentType());
+        expect(that % 13 == t13->GetId());
+        expect(that % 1 == t13->GetCount());
+        expect(that % "GPU Core"sv == t13->GetName());
+        expect(that % 3 == t->GetCount());
+        expect(that % 3_u == core->GetChildren().size());
+        expect(that % t13 == core->GetChildren()[1]);
+        Component* rest = core->GetChildren()[2];
+        expect(that % 14 == rest->GetId());
+        expect(that % 4 == rest->GetCount());
+        expect(that % 8 == topo.CountAllSubcomponentsByType(ComponentType::Thread));
+        expect(that % t13 == topo.GetSubcomponentById(13, ComponentType::Thread));
+        expect(that % rest == topo.GetSubcomponentById(15, ComponentType::Thread));
+        expect(that % t == core->GetChildById(12));
+
+        //the instance shares the attributes and DataPaths of the collapsed component, but owns them
+        expect(that % (nullptr != t13->GetAttribute<double>(AttributeKey::Clock_Frequency)) >> fatal);
+        expect(that % 1.5e9 == *t13->GetAttribute<double>(AttributeKey::Clock_Frequency));
+        t13->SetAttribute(AttributeKey::Clock_Frequency, 1.0e9);
+        expect(that % 1.5e9 == *t->GetAttribute<double>(AttributeKey::Clock_Frequency));
+        std::vector<DataPath*> dps = t13->GetAllDataPaths(DataPathType::Any, DataPathDirection::Incoming);
+        expect(that % 1_u == dps.size() >> fatal);
+        expect(that % mem == dps[0]->GetSource());
+        expect(that % 200.0 == dps[0]->GetLatency());
+        expect(that % 3_u == mem->GetAllDataPaths(DataPathType::Any, DataPathDirection::Outgoing).size());
+
+        std::vector<Component*> all = rest->ExpandAll();
+        expect(that % 4_u == all.size() >> fatal);
+        for (int i = 0; i < 4; i++)
+        {
+            expect(that % 14 + i == all[i]->GetId());
+            expect(that % 1 == all[i]->GetCount());
+        }
+        expect(that % nullptr == t->ExpandInstance(13));
+        expect(that % 6_u == core->GetChildren().size());
+        expect(that % 8 == topo.CountAllSubcomponentsByType(ComponentType::Thread));
+
+        //Components of classes without copies cannot be split
+        Qubit* q = new Qubit(node, 0);
+        q->SetCount(4);
+        expect(that % 4 == node->CountAllChildrenByType(ComponentType::Qubit));
+        expect(that % nullptr == q->ExpandInstance(1));
+        expect(that % 1_u == q->ExpandAll().size());
+
+        node->Delete(true);
+    };
+
+    "Collapsed components in the id lookups"_test = []
+    {
+        Topology topo;
+        expect(that % 1 == topo.EnableComponentIndex());
+        Node* node = new Node(&topo, 0);
+        std::vector<Thread*> threads;
+        for (int i = 0; i < 40; i++)
+            threads.push_back(new Thread(node, 10 * i));
+        //builds the childIdMap and the index intervals before any component is collapsed
+        expect(that % nullptr == node->GetChildById(15));
+        expect(that % nullptr == topo.GetSubcomponentById(15, ComponentType::Thread));
+
+        threads[1]->SetCount(8);
+        expect(that % threads[1] == node->GetChildById(15));
+        expect(that % threads[1] == topo.GetSubcomponentById(15, ComponentType::Thread));
+        expect(that % threads[1] == node->GetSubcomponentById(17, ComponentType::Thread));
+        expect(that % nullptr == topo.GetSubcomponentById(18, ComponentType::Thread));
+        expect(that % 47 == topo.CountAllSubcomponentsByType(ComponentType::Thread));
+
+        threads[1]->SetCount(1);
+        expect(that % nullptr == node->GetChildById(15));
+        expect(that % nullptr == topo.GetSubcomponentById(15, ComponentType::Thread));
+        node->Delete(true);
+    };
+
+    "Collapsing identical subtrees"_test = []
+    {
+        Topology topo;
+        Memory* mem = new Memory(&topo, 100);
+        //nodes 0...3 are identical, node 4 has a different attribute, node 5 a different id gap
+        for (int id : {0, 1, 2, 3, 4, 6})
+        {
+            Node* node = new Node(&topo, id);
+            Chip* chip = new Chip(node, 0, "CPU");
+            Cache* l3 = new Cache(chip, 0, 3, 1 << 20);
+            for (int t = 0; t < 4; t++)
+                new Thread(new Core(l3, t), t);
+            new DataPath(l3, chip->GetChildren()[0]->GetChildren()[0], DataPathOrientation::Oriented, DataPathType::Logical, 10, 20);
+            new DataPath(mem, chip, DataPathOrientation::Oriented, DataPathType::Physical, 5, 100);
+            node->SetAttribute(AttributeKey::Clock_Frequency, id == 4 ? 2.0e9 : 1.0e9);
+        }
+        int components = topo.CountAllSubcomponents();
+        int threads = topo.CountAllSubcomponentsByType(ComponentType::Thread);
+
+        expect(that % 33 == topo.CollapseIdenticalSubtrees(ComponentType::ToMask(ComponentType::Node)));
+        expect(that % 4_u == topo.GetChildren().size());
+        Component* n0 = topo.GetChildById(0);
+        expect(that % (nullptr != n0) >> fatal);
+        expect(that % 4 == n0->GetCount());
+        expect(that % n0 == topo.GetChildById(3));
+        expect(that % 1 == topo.GetChildById(4)->GetCount());
+        expect(that % 1 == topo.GetChildById(6)->GetCount());
+        expect(that % nullptr == topo.GetChildById(5));
+        expect(that % components == topo.CountAllSubcomponents());
+        expect(that % threads == topo.CountAllSubcomponentsByType(ComponentType::Thread));
+        expect(that % 16 == n0->CountAllSubcomponentsByType(ComponentType::Thread) * n0->GetCount());
+        expect(that % 3_u == mem->GetAllDataPaths(DataPathType::Any, DataPathDirection::Outgoing).size());
+        expect(that % 0 == topo.CollapseIdenticalSubtrees());
+
+        //copy-on-write: the expanded node gets a private copy of the subtree, including its DataPaths
+        Component* n2 = n0->ExpandInstance(2);
+        expect(that % (nullptr != n2 && n2 != n0) >> fatal);
+        expect(that % 6_u == topo.GetChildren().size());
+        expect(that % components == topo.CountAllSubcomponents());
+        expect(that % 10 == n2->CountAllSubcomponents());
+        Component* l3 = n2->GetSubcomponentById(0, ComponentType::Cache);
+        expect(that % (nullptr != l3) >> fatal);
+        expect(that % n2 == l3->GetAncestorByType(ComponentType::Node));
+        expect(that % 3 == static_cast<Cache*>(l3)->GetCacheLevel());
+        std::vector<DataPath*> inner = l3->GetAllDataPaths(DataPathType::Logical, DataPathDirection::Outgoing);
+        expect(that % 1_u == inner.size() >> fatal);
+        expect(that % n2 == inner[0]->GetTarget()->GetAncestorByType(ComponentType::Node));
+        expect(that % 5_u == mem->GetAllDataPaths(DataPathType::Any, DataPathDirection::Outgoing).size()); //nodes 0-1, 2, 3, 4, 6
+        expect(that % 1.0e9 == *n2->GetAttribute<double>(AttributeKey::Clock_Frequency));
+        n2->SetAttribute(AttributeKey::Clock_Frequency, 3.0e9);
+        expect(that % 1.0e9 == *n0->GetAttribute<double>(AttributeKey::Clock_Frequency));
+
+        expect(that % n0->IsShared());
+        expect(that % n0->GetSubcomponentById(0, ComponentType::Cache)->IsShared());
+        expect(that % !n2->IsShared());
+        expect(that % !l3->IsShared());
+        expect(that % !topo.IsShared());
+
+        //node 3 is identical to nodes 0 and 1 again, but not adjacent to them
+        expect(that % 0 == topo.CollapseIdenticalSubtrees(ComponentType::ToMask(ComponentType::Node)));
+        n2->SetAttribute(AttributeKey::Clock_Frequency, 1.0e9);
+        expect(that % 22 == topo.CollapseIdenticalSubtrees(ComponentType::ToMask(ComponentType::Node)));
+        expect(that % n0 == topo.GetChildById(0));
+        expect(that % 4 == n0->GetCount());
+        expect(that % components == topo.CountAllSubcomponents());
+
+        //copy-on-write: a write to a shared component applies to the first represented instance only
+        Component* cache0 = n0->GetSubcomponentById(0, ComponentType::Cache);
+        cache0->SetAttribute(AttributeKey::Clock_Frequency, 2.0e9);
+        expect(that % !cache0->IsShared());
+        expect(that % 1 == n0->GetCount());
+        Component* n1 = topo.GetChildById(1);
+        expect(that % (nullptr != n1 && n1 != n0) >> fatal);
+        expect(that % 3 == n1->GetCount());
+        expect(that % nullptr == n1->GetSubcomponentById(0, ComponentType::Cache)->GetAttribute<double>(AttributeKey::Clock_Frequency));
+        expect(that % 4_u == mem->GetAllDataPaths(DataPathType::Any, DataPathDirection::Outgoing).size()); //nodes 0, 1-3, 4, 6
+        expect(that % components == topo.CountAllSubcomponents());
+
+        //data of one machine is parsed into its own instance
+        expect(that % 0 == parseHwlocOutput(static_cast<Node*>(n1), SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml"));
+        expect(that % 1 == n1->GetCount());
+        Component* n3 = topo.GetChildById(3);
+        expect(that % (nullptr != n3 && n3 == topo.GetChildById(2)) >> fatal);
+        expect(that % 2 == n3->GetCount());
+        expect(that % 10 == n3->CountAllSubcomponents());
+        expect(that % 10 < n1->CountAllSubcomponents());
+
+        //within a SharedWriteScope, a write applies to all represented components
+        {
+            SharedWriteScope scope;
+            n3->SetAttribute(AttributeKey::Clock_Frequency, 1.5e9);
+        }
+        expect(that % 2 == n3->GetCount());
+        expect(that % 1.5e9 == *topo.GetChildById(2)->GetAttribute<double>(AttributeKey::Clock_Frequency));
+
+        //subtrees with Relations between each other are not identical
+        Node* a = new Node(&topo, 10);
+        Node* b = new Node(&topo, 11);
+        new DataPath(a, b, DataPathOrientation::Bidirectional);
+        expect(that % 0 == topo.CollapseIdenticalSubtrees(ComponentType::ToMask(ComponentType::Node)));
+
+        topo.DeleteSubtree();
+    };
 };